@@ -18,6 +18,50 @@ typedef unsigned long u_register_t;
 
 #define COMPILER_BARRIER() __asm__ volatile ("" ::: "memory")
 
+#ifdef LINUX_NATIVE_BUILD
+/**********************************************************************
+ * Native builds have no system registers or system instructions, the
+ * accessors are routed to the native PAL which emulates them.
+ *********************************************************************/
+u_register_t pal_native_sysreg_read(const char *name);
+void pal_native_sysreg_write(const char *name, u_register_t v);
+void pal_native_sysop(const char *op, uint64_t v);
+void pal_native_smc_call(uint64_t *regs, size_t count);
+
+#define _DEFINE_SYSREG_READ_FUNC(_name, _reg_name)        \
+static inline u_register_t read_ ## _name(void)            \
+{                                \
+    return pal_native_sysreg_read(#_reg_name);        \
+}
+
+#define _DEFINE_SYSREG_WRITE_FUNC(_name, _reg_name)            \
+static inline void write_ ## _name(u_register_t v)            \
+{                                    \
+    pal_native_sysreg_write(#_reg_name, v);            \
+}
+
+#define SYSREG_WRITE_CONST(reg_name, v)                \
+    pal_native_sysreg_write(#reg_name, v)
+
+#define DEFINE_SYSOP_FUNC(_op)                \
+static inline void _op(void)                \
+{                            \
+    pal_native_sysop(#_op, 0);            \
+}
+
+#define DEFINE_SYSOP_TYPE_FUNC(_op, _type)        \
+static inline void _op ## _type(void)            \
+{                            \
+    pal_native_sysop(#_op " " #_type, 0);        \
+}
+
+#define DEFINE_SYSOP_TYPE_PARAM_FUNC(_op, _type)    \
+static inline void _op ## _type(uint64_t v)        \
+{                            \
+    pal_native_sysop(#_op " " #_type, v);        \
+}
+
+#else
 /**********************************************************************
  * Macros which create inline functions to read or write CPU system
  * registers
@@ -40,6 +84,8 @@ static inline void write_ ## _name(u_register_t v)            \
 #define SYSREG_WRITE_CONST(reg_name, v)                \
     __asm__ volatile ("msr " #reg_name ", %0" : : "i" (v))
 
+#endif /* LINUX_NATIVE_BUILD */
+
 /* Define read function for system register */
 #define DEFINE_SYSREG_READ_FUNC(_name)             \
     _DEFINE_SYSREG_READ_FUNC(_name, _name)
@@ -62,6 +108,7 @@ static inline void write_ ## _name(u_register_t v)            \
 #define DEFINE_RENAME_SYSREG_WRITE_FUNC(_name, _reg_name)    \
     _DEFINE_SYSREG_WRITE_FUNC(_name, _reg_name)
 
+#ifndef LINUX_NATIVE_BUILD
 /**********************************************************************
  * Macros to create inline functions for system instructions
  *********************************************************************/
@@ -86,6 +133,7 @@ static inline void _op ## _type(uint64_t v)        \
 {                            \
      __asm__ (#_op " " #_type ", %0" : : "r" (v));    \
 }
+#endif /* LINUX_NATIVE_BUILD */
 
 /*******************************************************************************
  * TLB maintenance accessor prototypes
@@ -191,6 +239,7 @@ DEFINE_SYSREG_READ_FUNC(id_aa64dfr0_el1)
 DEFINE_SYSREG_READ_FUNC(id_afr0_el1)
 DEFINE_SYSREG_READ_FUNC(CurrentEl)
 DEFINE_SYSREG_READ_FUNC(ctr_el0)
+DEFINE_SYSREG_READ_FUNC(dczid_el0)
 DEFINE_SYSREG_RW_FUNCS(daif)
 DEFINE_SYSREG_RW_FUNCS(nzcv)
 DEFINE_SYSREG_READ_FUNC(spsel)
@@ -380,6 +429,7 @@ DEFINE_SYSREG_RW_FUNCS(cntv_ctl_el0)
 DEFINE_SYSREG_RW_FUNCS(cntv_tval_el0)
 DEFINE_SYSREG_RW_FUNCS(cntv_cval_el0)
 DEFINE_SYSREG_RW_FUNCS(cnthctl_el2)
+DEFINE_SYSREG_RW_FUNCS(cntkctl_el1)
 
 #define get_cntp_ctl_enable(x)  (((x) >> CNTP_CTL_ENABLE_SHIFT) & \
                     CNTP_CTL_ENABLE_MASK)
@@ -27,6 +27,14 @@
 **/
 uint32_t pal_printf(const char *msg, uint64_t data1, uint64_t data2);
 
+/**
+ *   @brief    - This function writes the given bytes onto the uart as they are
+ *   @param    - buffer  : Pointer to source address
+ *   @param    - size    : Number of bytes
+ *   @return   - SUCCESS(0)/FAILURE(Any positive number)
+**/
+uint32_t pal_uart_write(const uint8_t *buffer, size_t size);
+
 /**
  *   @brief    - Writes into given non-volatile address.
  *   @param    - offset  : Offset into nvmem
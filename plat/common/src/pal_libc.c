@@ -36,10 +36,84 @@ size_t pal_strlen(char *str)
 
 /* Libc functions definition */
 
+/*
+ * The word loops only run when both buffers have the same offset within a
+ * word. The images are built with -mstrict-align and run with the MMU off
+ * for a while, where an unaligned access faults. Copies are done two words
+ * per iteration so that the compiler uses LDP/STP.
+ */
+typedef uint64_t __attribute__((may_alias)) pal_word_t;
+
+#define PAL_WORD_SIZE       sizeof(pal_word_t)
+#define PAL_WORD_MASK       (PAL_WORD_SIZE - 1)
+
+/* Buffers shorter than this are handled byte by byte */
+#define PAL_WORD_MIN_LEN    (2 * PAL_WORD_SIZE)
+
+#define PAL_SAME_WORD_OFFSET(a, b)  ((((size_t)(a) ^ (size_t)(b)) & PAL_WORD_MASK) == 0)
+
+#ifndef LINUX_NATIVE_BUILD
+/* SCTLR_ELx.M, not in pal_arch.h as VAL defines SCTLR_M_BIT as well */
+#define PAL_SCTLR_M_BIT     (ULL(1) << 0)
+
+/**
+ * @brief        - Return the size of the block zeroed by DC ZVA
+ * @return       - Block size in bytes, 0 when DC ZVA is prohibited or the data
+ *                 accesses are not cacheable yet
+**/
+static size_t pal_zva_block_size(void)
+{
+    u_register_t sctlr, dczid;
+
+    sctlr = IS_IN_EL2() ? read_sctlr_el2() : read_sctlr_el1();
+    if (!(sctlr & PAL_SCTLR_M_BIT) || !(sctlr & SCTLR_C_BIT))
+        return 0;
+
+    dczid = read_dczid_el0();
+    if (dczid & DCZID_DZP_BIT)
+        return 0;
+
+    return (size_t)4 << ((dczid >> DCZID_BS_SHIFT) & DCZID_BS_MASK);
+}
+#endif
+
 void *memcpy(void *dst, const void *src, size_t len)
 {
     const char *s = src;
     char *d = dst;
+    const pal_word_t *ws;
+    pal_word_t *wd, w0, w1;
+
+    if (len >= PAL_WORD_MIN_LEN && PAL_SAME_WORD_OFFSET(d, s))
+    {
+        while ((size_t)d & PAL_WORD_MASK)
+        {
+            *d++ = *s++;
+            len--;
+        }
+
+        ws = (const pal_word_t *)(const void *)s;
+        wd = (pal_word_t *)(void *)d;
+
+        for (; len >= 2 * PAL_WORD_SIZE; len -= 2 * PAL_WORD_SIZE)
+        {
+            w0 = ws[0];
+            w1 = ws[1];
+            wd[0] = w0;
+            wd[1] = w1;
+            ws += 2;
+            wd += 2;
+        }
+
+        if (len >= PAL_WORD_SIZE)
+        {
+            *wd++ = *ws++;
+            len -= PAL_WORD_SIZE;
+        }
+
+        s = (const char *)ws;
+        d = (char *)wd;
+    }
 
     while (len--)
     {
@@ -52,6 +126,53 @@ void *memcpy(void *dst, const void *src, size_t len)
 void *memset(void *dst, int val, size_t count)
 {
     unsigned char *ptr = dst;
+    pal_word_t *wp, word;
+#ifndef LINUX_NATIVE_BUILD
+    size_t block;
+#endif
+
+    if (count >= PAL_WORD_MIN_LEN)
+    {
+        while ((size_t)ptr & PAL_WORD_MASK)
+        {
+            *ptr++ = (unsigned char)val;
+            count--;
+        }
+
+        word = (unsigned char)val * 0x0101010101010101ULL;
+        wp = (pal_word_t *)(void *)ptr;
+
+#ifndef LINUX_NATIVE_BUILD
+        /* Zero whole blocks with DC ZVA, words up to the first block boundary */
+        block = (word == 0) ? pal_zva_block_size() : 0;
+        if (block >= PAL_WORD_SIZE && count >= 2 * block)
+        {
+            for (; (size_t)wp & (block - 1); count -= PAL_WORD_SIZE)
+                *wp++ = 0;
+
+            for (; count >= block; count -= block)
+            {
+                dczva((uint64_t)wp);
+                wp += block / PAL_WORD_SIZE;
+            }
+        }
+#endif
+
+        for (; count >= 2 * PAL_WORD_SIZE; count -= 2 * PAL_WORD_SIZE)
+        {
+            wp[0] = word;
+            wp[1] = word;
+            wp += 2;
+        }
+
+        if (count >= PAL_WORD_SIZE)
+        {
+            *wp++ = word;
+            count -= PAL_WORD_SIZE;
+        }
+
+        ptr = (unsigned char *)wp;
+    }
 
     while (count--)
     {
@@ -67,6 +188,31 @@ int memcmp(void *s1, void *s2, size_t len)
     unsigned char *d = s2;
     unsigned char sc;
     unsigned char dc;
+    const pal_word_t *ws, *wd;
+
+    if (len >= PAL_WORD_MIN_LEN && PAL_SAME_WORD_OFFSET(s, d))
+    {
+        for (; (size_t)s & PAL_WORD_MASK; len--)
+        {
+            sc = *s++;
+            dc = *d++;
+            if (sc - dc)
+                return (sc - dc);
+        }
+
+        ws = (const pal_word_t *)(void *)s;
+        wd = (const pal_word_t *)(void *)d;
+
+        /* The bytes of the first differing word are compared one by one */
+        for (; len >= PAL_WORD_SIZE && *ws == *wd; len -= PAL_WORD_SIZE)
+        {
+            ws++;
+            wd++;
+        }
+
+        s = (unsigned char *)ws;
+        d = (unsigned char *)wd;
+    }
 
     while (len--)
     {
@@ -89,6 +235,22 @@ void *memmove(void *dst, const void *src, size_t len)
                 const char *end = dst;
                 const char *s = (const char *)src + len;
                 char *d = (char *)dst + len;
+                const pal_word_t *ws;
+                pal_word_t *wd;
+
+                if (len >= PAL_WORD_MIN_LEN && PAL_SAME_WORD_OFFSET(d, s)) {
+                        while ((size_t)d & PAL_WORD_MASK)
+                                *--d = *--s;
+
+                        ws = (const pal_word_t *)(const void *)s;
+                        wd = (pal_word_t *)(void *)d;
+                        while ((size_t)((char *)wd - end) >= PAL_WORD_SIZE)
+                                *--wd = *--ws;
+
+                        s = (const char *)ws;
+                        d = (char *)wd;
+                }
+
                 while (d != end)
                         *--d = *--s;
         }
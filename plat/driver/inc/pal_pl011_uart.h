@@ -41,6 +41,11 @@ typedef struct {
 #define UART_PL011_UARTCR_TX_EN_MASK       (0x1u << UART_PL011_UARTCR_TXE_OFF)
 #define UART_PL011_UARTFR_TX_FIFO_FULL_OFF 0x5u
 #define UART_PL011_UARTFR_TX_FIFO_FULL     (0x1u << UART_PL011_UARTFR_TX_FIFO_FULL_OFF)
+#define UART_PL011_UARTFR_TX_FIFO_EMPTY_OFF 0x7u
+#define UART_PL011_UARTFR_TX_FIFO_EMPTY    (0x1u << UART_PL011_UARTFR_TX_FIFO_EMPTY_OFF)
+
+/* Transmit FIFO depth of every PL011 revision, r1p5 has 32 entries */
+#define UART_PL011_TX_FIFO_DEPTH           16
 
 #define UART_PL011_INTR_TX_OFF             0x5u
 #define UART_PL011_TX_INTR_MASK            (0x1u << UART_PL011_INTR_TX_OFF)
@@ -56,5 +61,6 @@ typedef struct {
 
 /* function prototypes */
 extern void pal_driver_uart_pl011_putc(uint8_t c);
+extern void pal_driver_uart_pl011_write(const uint8_t *buffer, size_t size);
 
 #endif /* _PAL_UART_PL011_H_ */
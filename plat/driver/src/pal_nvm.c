@@ -10,26 +10,58 @@
 
 static addr_t nvm_base = PLATFORM_NVM_BASE;
 
+/*
+ * The NVM is moved a 64-bit word at a time when the NVM address and the
+ * buffer have the same offset within a word, the bytes before the first
+ * aligned word and after the last one byte by byte.
+ */
+#define NVM_WORD_SIZE   sizeof(uint64_t)
+#define NVM_WORD_MASK   (NVM_WORD_SIZE - 1)
+
 uint32_t pal_driver_nvm_write(uint32_t offset, void *buffer, size_t size)
 {
-    size_t b_cnt;
+    addr_t addr = nvm_base + offset;
+    uint8_t *src = buffer;
 
-    for (b_cnt = 0; b_cnt < size; b_cnt++)
+    if (((addr ^ (addr_t)src) & NVM_WORD_MASK) == 0)
     {
-        pal_mmio_write8(nvm_base + offset + b_cnt, *((uint8_t *)buffer + b_cnt));
+        for (; size && (addr & NVM_WORD_MASK); size--)
+            pal_mmio_write8(addr++, *src++);
+
+        for (; size >= NVM_WORD_SIZE; size -= NVM_WORD_SIZE)
+        {
+            pal_mmio_write64(addr, *(uint64_t *)(void *)src);
+            addr += NVM_WORD_SIZE;
+            src += NVM_WORD_SIZE;
+        }
     }
 
+    for (; size; size--)
+        pal_mmio_write8(addr++, *src++);
+
     return PAL_SUCCESS;
 }
 
 uint32_t pal_driver_nvm_read(uint32_t offset, void *buffer, size_t size)
 {
-    size_t b_cnt;
+    addr_t addr = nvm_base + offset;
+    uint8_t *dst = buffer;
 
-    for (b_cnt = 0; b_cnt < size; b_cnt++)
+    if (((addr ^ (addr_t)dst) & NVM_WORD_MASK) == 0)
     {
-        *((uint8_t *)buffer + b_cnt) = pal_mmio_read8(nvm_base + offset + b_cnt);
+        for (; size && (addr & NVM_WORD_MASK); size--)
+            *dst++ = pal_mmio_read8(addr++);
+
+        for (; size >= NVM_WORD_SIZE; size -= NVM_WORD_SIZE)
+        {
+            *(uint64_t *)(void *)dst = pal_mmio_read64(addr);
+            addr += NVM_WORD_SIZE;
+            dst += NVM_WORD_SIZE;
+        }
     }
 
+    for (; size; size--)
+        *dst++ = pal_mmio_read8(addr++);
+
     return PAL_SUCCESS;
 }
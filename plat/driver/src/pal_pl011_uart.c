@@ -81,3 +81,36 @@ void pal_driver_uart_pl011_putc(uint8_t c)
     /* write the data (upper 24 bits are reserved) */
     ((pal_uart_t *)g_uart)->uartdr = pdata;
 }
+
+/**
+ *   @brief    - This function writes a buffer to the uart in bursts. It waits
+ *               for the TX FIFO to drain and then fills it without reading the
+ *               flag register for every byte. The last byte is still being
+ *               shifted out when the FIFO is flagged empty, the line does not
+ *               go idle between two bursts.
+ *   @param    - buffer: Bytes to be written
+ *   @param    - size: Number of bytes
+ *   @return   - none
+**/
+void pal_driver_uart_pl011_write(const uint8_t *buffer, size_t size)
+{
+    size_t burst;
+
+    if (is_uart_init_done == 0)
+    {
+        pal_driver_uart_pl011_init();
+        is_uart_init_done = 1;
+    }
+
+    while (size)
+    {
+        while (!(((pal_uart_t *)g_uart)->uartfr & UART_PL011_UARTFR_TX_FIFO_EMPTY))
+          ;
+
+        burst = (size < UART_PL011_TX_FIFO_DEPTH) ? size : UART_PL011_TX_FIFO_DEPTH;
+        size -= burst;
+
+        while (burst--)
+            ((pal_uart_t *)g_uart)->uartdr = *buffer++;
+    }
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _PAL_NATIVE_H_
+#define _PAL_NATIVE_H_
+
+#include "pal_interfaces.h"
+
+/* Emulated generic timer frequency */
+#define PAL_NATIVE_CNTFRQ        100000000ULL
+
+/* SMC function ID fields */
+#define PAL_SMC_FID_OWNER(fid)   (((fid) >> 24) & 0x3F)
+#define PAL_SMC_FID_FUNC(fid)    ((fid) & 0xFFFF)
+#define PAL_SMC_OWNER_STD        4
+#define PAL_SMC_RMI_FUNC_MIN     0x150
+#define PAL_SMC_RMI_FUNC_MAX     0x18F
+#define PAL_SMC_PSCI_FUNC_MAX    0x1F
+#define PAL_SMC_NOT_SUPPORTED    0xFFFFFFFFFFFFFFFFULL
+
+/* PSCI function numbers and status codes */
+#define PSCI_FUNC_VERSION          0x0
+#define PSCI_FUNC_CPU_SUSPEND      0x1
+#define PSCI_FUNC_CPU_OFF          0x2
+#define PSCI_FUNC_CPU_ON           0x3
+#define PSCI_FUNC_AFFINITY_INFO    0x4
+#define PSCI_FUNC_SYSTEM_OFF       0x8
+#define PSCI_FUNC_SYSTEM_RESET     0x9
+#define PSCI_FUNC_FEATURES         0xA
+
+#define PSCI_VERSION_1_1           0x10001
+#define PSCI_E_SUCCESS             0
+#define PSCI_E_NOT_SUPPORTED       (-1)
+#define PSCI_E_INVALID_PARAMS      (-2)
+#define PSCI_E_DENIED              (-3)
+#define PSCI_E_ALREADY_ON          (-4)
+#define PSCI_E_INTERN_FAIL         (-6)
+#define PSCI_E_INVALID_ADDRESS     (-9)
+
+/* Set in the environment of a restarted executable, NVM content is kept */
+#define PAL_NATIVE_RESET_ENV     "RMM_ACS_NATIVE_RESET"
+
+/* Host entry point, the native equivalent of the image entry */
+void acs_host_entry(void);
+
+/* Realm entry point, run by the RMM model on the thread of every REC */
+void acs_realm_entry(void);
+
+/**
+ *   @brief    Set the MPIDR seen by the calling thread
+ *   @param    mpidr   - MPIDR of the emulated cpu
+ *   @return   void
+**/
+void pal_native_set_mpidr(uint64_t mpidr);
+
+/**
+ *   @brief    Return the MPIDR seen by the calling thread
+ *   @param    void
+ *   @return   MPIDR of the emulated cpu
+**/
+uint64_t pal_native_get_mpidr(void);
+
+/**
+ *   @brief    Monotonic time used for the emulated system counter
+ *   @param    void
+ *   @return   Time in nanoseconds
+**/
+uint64_t pal_native_time_ns(void);
+
+/**
+ *   @brief    Map the file backing the NVM
+ *   @param    keep    - Keep the content, otherwise the NVM starts zeroed
+ *   @return   SUCCESS/FAILURE
+**/
+uint32_t pal_native_nvm_init(bool keep);
+
+/**
+ *   @brief    Restart the executable, the emulation of a system reset
+ *   @param    void
+ *   @return   Does not return
+**/
+void pal_native_reset(void);
+
+/**
+ *   @brief    Handle a PSCI call made through the SMC conduit
+ *   @param    regs    - x0-x3 on entry, x0 updated with the result
+ *   @return   void
+**/
+void pal_native_psci_call(uint64_t *regs);
+
+/**
+ *   @brief    Map normal world memory at a second address, the view a realm
+ *             has of the granules its stage 2 tables map
+ *   @param    va      - Page aligned address of the alias
+ *   @param    pa      - Page aligned address in the normal world window
+ *   @param    size    - Size of the alias
+ *   @return   SUCCESS/FAILURE
+**/
+uint32_t pal_native_map_alias(uint64_t va, uint64_t pa, uint64_t size);
+
+/**
+ *   @brief    Remove an alias set up by pal_native_map_alias
+ *   @param    va      - Address of the alias
+ *   @param    size    - Size of the alias
+ *   @return   void
+**/
+void pal_native_unmap_alias(uint64_t va, uint64_t size);
+
+#endif /* _PAL_NATIVE_H_ */
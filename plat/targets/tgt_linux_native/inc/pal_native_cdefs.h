@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _PAL_NATIVE_CDEFS_H_
+#define _PAL_NATIVE_CDEFS_H_
+
+/*
+ * Attribute shorthands the bare-metal C library provides through sys/cdefs.h
+ * and glibc does not. Forced into every native translation unit.
+ */
+#ifndef __aligned
+#define __aligned(x)     __attribute__((__aligned__(x)))
+#endif
+
+#ifndef __section
+#define __section(x)     __attribute__((__section__(x)))
+#endif
+
+#endif /* _PAL_NATIVE_CDEFS_H_ */
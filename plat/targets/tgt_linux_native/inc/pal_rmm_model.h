@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _PAL_RMM_MODEL_H_
+#define _PAL_RMM_MODEL_H_
+
+#include "pal_interfaces.h"
+
+/* Number of SMC registers exchanged with the model, x0-x7 */
+#define PAL_RMM_MODEL_REGS 8
+
+/* Number of SMC registers of an RSI or PSCI call made by a realm, x0-x10 */
+#define PAL_RMM_MODEL_REALM_REGS 11
+
+/* Binary trace written by tools/scripts/smc_trace.py */
+#define PAL_RMM_TRACE_MAGIC        "RMMSMCTR"
+#define PAL_RMM_TRACE_VERSION      1
+#define PAL_RMM_TRACE_IN_REGS      10
+#define PAL_RMM_TRACE_OUT_REGS     11
+#define PAL_RMM_TRACE_FLAG_PAGE    (1U << 0)
+#define PAL_RMM_TRACE_PAGE_SIZE    0x1000
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t rec_size;
+} pal_rmm_trace_hdr_t;
+
+/* Layout of val_smc_trace_rec_ts, a page follows when FLAG_PAGE is set */
+typedef struct {
+    uint64_t fid;
+    uint64_t in[PAL_RMM_TRACE_IN_REGS];
+    uint64_t out[PAL_RMM_TRACE_OUT_REGS];
+    uint64_t timestamp;
+    uint16_t cpu;
+    uint8_t  security_state;
+    uint8_t  flags;
+    uint32_t page;
+} pal_rmm_trace_rec_t;
+
+/**
+ *   @brief    Reset the RMM model, every granule of the memory pool starts
+ *             undelegated
+ *   @param    void
+ *   @return   SUCCESS/FAILURE
+**/
+uint32_t pal_rmm_model_init(void);
+
+/**
+ *   @brief    Handle an RMI call made through the SMC conduit
+ *   @param    regs    - x0-x7 on entry, updated with the RMI outputs
+ *   @return   void
+**/
+void pal_rmm_model_call(uint64_t *regs);
+
+/**
+ *   @brief    Check whether the calling thread runs a REC
+ *   @param    void
+ *   @return   True on the thread of a REC
+**/
+bool pal_rmm_model_realm_thread(void);
+
+/**
+ *   @brief    Handle an RSI or PSCI call made by the realm code of a REC
+ *   @param    regs    - x0-x(count-1) on entry, updated with the outputs
+ *   @param    count   - Number of registers
+ *   @return   void
+**/
+void pal_rmm_model_realm_call(uint64_t *regs, size_t count);
+
+/**
+ *   @brief    Stop the REC of the calling thread, its next REC enter fails.
+ *             This is the realm view of the end of the simulation.
+ *   @param    void
+ *   @return   Does not return
+**/
+void pal_rmm_model_realm_stop(void);
+
+/**
+ *   @brief    Replay the RMI calls of a binary trace against the model and
+ *             print every response that differs from the recorded one
+ *   @param    path    - Trace file
+ *   @return   SUCCESS if every response matched, FAILURE otherwise
+**/
+uint32_t pal_rmm_model_replay(const char *path);
+
+#endif /* _PAL_RMM_MODEL_H_ */
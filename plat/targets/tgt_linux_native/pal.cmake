@@ -0,0 +1,33 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+set(PAL_SRC
+    ${ROOT_DIR}/plat/targets/${TARGET}/src/pal_interface.c
+    ${ROOT_DIR}/plat/targets/${TARGET}/src/pal_irq.c
+    ${ROOT_DIR}/plat/targets/${TARGET}/src/pal_native_arch.c
+    ${ROOT_DIR}/plat/targets/${TARGET}/src/pal_native_boot.c
+    ${ROOT_DIR}/plat/targets/${TARGET}/src/pal_rmm_model.c
+    ${ROOT_DIR}/plat/targets/${TARGET}/src/pal_rmm_replay.c
+    ${ROOT_DIR}/plat/common/src/pal_smc.c
+    ${ROOT_DIR}/plat/common/src/pal_libc.c
+)
+
+#Create compile list files
+list(APPEND COMPILE_LIST ${PAL_SRC})
+set(COMPILE_LIST ${COMPILE_LIST} PARENT_SCOPE)
+
+# Create PAL library
+add_library(${PAL_LIB} STATIC ${PAL_SRC})
+
+target_include_directories(${PAL_LIB} PRIVATE
+    ${CMAKE_CURRENT_BINARY_DIR}
+    ${ROOT_DIR}/plat/common/inc/
+    ${ROOT_DIR}/plat/targets/${TARGET}/inc/
+    ${ROOT_DIR}/plat/driver/inc/
+)
+
+unset(PAL_SRC)
@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "pal_native.h"
+#include "pal_rmm_model.h"
+
+static const uint64_t phy_mpidr_array[PLATFORM_CPU_COUNT] = {
+    PLATFORM_PHY_MPIDR_CPU0,
+    PLATFORM_PHY_MPIDR_CPU1,
+#if (PLATFORM_CPU_COUNT > 2)
+    PLATFORM_PHY_MPIDR_CPU2,
+#endif
+#if (PLATFORM_CPU_COUNT > 3)
+    PLATFORM_PHY_MPIDR_CPU3,
+#endif
+#if (PLATFORM_CPU_COUNT > 4)
+    PLATFORM_PHY_MPIDR_CPU4,
+#endif
+#if (PLATFORM_CPU_COUNT > 5)
+    PLATFORM_PHY_MPIDR_CPU5,
+#endif
+#if (PLATFORM_CPU_COUNT > 6)
+    PLATFORM_PHY_MPIDR_CPU6,
+#endif
+#if (PLATFORM_CPU_COUNT > 7)
+    PLATFORM_PHY_MPIDR_CPU7,
+#endif
+};
+
+static uint8_t *nvm;
+static timer_t wdog_timer;
+static bool wdog_created;
+
+uint32_t pal_printf(const char *msg, uint64_t data1, uint64_t data2)
+{
+    uint8_t buffer[16];
+    uint64_t j, i = 0;
+    uint64_t data = data1;
+
+    for (; *msg != '\0'; ++msg)
+    {
+        if (*msg == '%')
+        {
+            ++msg;
+            if (*msg == 'l' || *msg == 'L')
+                ++msg;
+
+            if (*msg == 'd')
+            {
+                while (data != 0)
+                {
+                    j         = data % 10;
+                    data      = data / 10;
+                    buffer[i] = (uint8_t)(j + 48);
+                    i        += 1;
+                }
+                data = data2;
+            } else if (*msg == 'x' || *msg == 'X')
+            {
+                while (data != 0)
+                {
+                    j         = data & 0xf;
+                    data      = data >> 4;
+                    buffer[i] = (uint8_t)(j + ((j > 9) ? 55 : 48));
+                    i        += 1;
+                }
+                data = data2;
+            }
+            if (i > 0)
+            {
+                while (i > 0)
+                    putchar(buffer[--i]);
+            } else
+            {
+                putchar('0');
+            }
+        } else
+        {
+            putchar(*msg);
+        }
+    }
+
+    return PAL_SUCCESS;
+}
+
+uint32_t pal_uart_write(const uint8_t *buffer, size_t size)
+{
+    fwrite(buffer, 1, size, stdout);
+    return PAL_SUCCESS;
+}
+
+uint32_t pal_native_nvm_init(bool keep)
+{
+    const char *path = getenv(PLATFORM_NVM_FILE_ENV);
+    int fd;
+
+    if (path == NULL)
+        path = PLATFORM_NVM_FILE;
+
+    fd = open(path, O_RDWR | O_CREAT | (keep ? 0 : O_TRUNC), 0644);
+    if (fd < 0 || ftruncate(fd, PLATFORM_NVM_SIZE))
+    {
+        perror(path);
+        return PAL_ERROR;
+    }
+
+    nvm = mmap(NULL, PLATFORM_NVM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (nvm == MAP_FAILED)
+    {
+        perror("mmap");
+        return PAL_ERROR;
+    }
+
+    return PAL_SUCCESS;
+}
+
+uint32_t pal_nvm_write(uint32_t offset, void *buffer, size_t size)
+{
+    if (offset + size > PLATFORM_NVM_SIZE)
+        return PAL_ERROR;
+
+    memcpy(nvm + offset, buffer, size);
+    return PAL_SUCCESS;
+}
+
+uint32_t pal_nvm_read(uint32_t offset, void *buffer, size_t size)
+{
+    if (offset + size > PLATFORM_NVM_SIZE)
+        return PAL_ERROR;
+
+    memcpy(buffer, nvm + offset, size);
+    return PAL_SUCCESS;
+}
+
+static void pal_native_wdog_expired(union sigval sv)
+{
+    (void)sv;
+    pal_printf("\n\tWatchdog timeout, restarting\n", 0, 0);
+    pal_native_reset();
+}
+
+uint32_t pal_watchdog_enable(void)
+{
+    struct itimerspec its = { .it_value = { .tv_sec = PLATFORM_WDOG_TIMEOUT_SEC } };
+    struct sigevent sev = {
+        .sigev_notify = SIGEV_THREAD,
+        .sigev_notify_function = pal_native_wdog_expired,
+    };
+
+    if (!wdog_created)
+    {
+        if (timer_create(CLOCK_MONOTONIC, &sev, &wdog_timer))
+            return PAL_ERROR;
+        wdog_created = true;
+    }
+
+    return timer_settime(wdog_timer, 0, &its, NULL) ? PAL_ERROR : PAL_SUCCESS;
+}
+
+uint32_t pal_watchdog_disable(void)
+{
+    struct itimerspec its = { 0 };
+
+    if (!wdog_created)
+        return PAL_SUCCESS;
+
+    return timer_settime(wdog_timer, 0, &its, NULL) ? PAL_ERROR : PAL_SUCCESS;
+}
+
+/* The non-secure and trusted watchdog interrupts are not emulated */
+void pal_ns_wdog_enable(uint32_t ms)
+{
+    (void)ms;
+}
+
+void pal_ns_wdog_disable(void)
+{
+}
+
+uint32_t pal_twdog_enable(uint32_t ms)
+{
+    (void)ms;
+    return PAL_ERROR;
+}
+
+uint32_t pal_twdog_disable(void)
+{
+    return PAL_ERROR;
+}
+
+uint32_t pal_terminate_simulation(void)
+{
+    /* The end of a realm stops its REC, the host carries on */
+    if (pal_rmm_model_realm_thread())
+        pal_rmm_model_realm_stop();
+
+    fflush(stdout);
+    exit(EXIT_SUCCESS);
+    return PAL_SUCCESS;
+}
+
+uint32_t pal_get_cpu_count(void)
+{
+    return PLATFORM_CPU_COUNT;
+}
+
+uint64_t *pal_get_phy_mpidr_list_base(void)
+{
+    return (uint64_t *)&phy_mpidr_array[0];
+}
+
+uint32_t pal_verify_signature(__attribute__ ((unused)) uint64_t *token)
+{
+    return PAL_SUCCESS;
+}
+
+/* There is no secure world on the native target */
+uint32_t pal_register_acs_service(void)
+{
+    return PAL_ERROR;
+}
+
+uint32_t pal_wait_for_sync_call(void)
+{
+    return PAL_ERROR;
+}
+
+uint32_t pal_sync_resp_call_to_host(void)
+{
+    return PAL_ERROR;
+}
+
+uint32_t pal_sync_resp_call_to_preempted_host(void)
+{
+    return PAL_ERROR;
+}
+
+uint32_t pal_sync_req_call_to_secure(void)
+{
+    return PAL_ERROR;
+}
+
+uint8_t pal_mmio_read8(uint64_t addr)
+{
+  return *(volatile uint8_t *)addr;
+}
+
+uint16_t pal_mmio_read16(uint64_t addr)
+{
+  return *(volatile uint16_t *)addr;
+}
+
+uint64_t pal_mmio_read64(uint64_t addr)
+{
+  return *(volatile uint64_t *)addr;
+}
+
+uint32_t pal_mmio_read32(uint64_t addr)
+{
+  return *(volatile uint32_t *)addr;
+}
+
+void pal_mmio_write8(uint64_t addr, uint8_t data)
+{
+    *(volatile uint8_t *)addr = data;
+}
+
+void pal_mmio_write16(uint64_t addr, uint16_t data)
+{
+    *(volatile uint16_t *)addr = data;
+}
+
+void pal_mmio_write64(uint64_t addr, uint64_t data)
+{
+    *(volatile uint64_t *)addr = data;
+}
+
+void pal_mmio_write32(uint64_t addr, uint32_t data)
+{
+    *(volatile uint32_t *)addr = data;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "pal_native.h"
+
+/*
+ * There is no interrupt controller on the native target. Handlers are kept so
+ * that registration behaves as on hardware, SGIs are delivered synchronously
+ * to the handler and no other interrupt is ever raised.
+ */
+#define PAL_NATIVE_MAX_IRQ 1024
+#define PAL_NATIVE_MAX_SGI 16
+#define PAL_NATIVE_SPURIOUS_IRQ 1023
+
+static handler_irq_t irq_handler[PAL_NATIVE_MAX_IRQ];
+static s_lock_t irq_lock;
+
+void pal_irq_setup(void)
+{
+    pal_init_spinlock(&irq_lock);
+    pal_memset(irq_handler, 0, sizeof(irq_handler));
+}
+
+void pal_irq_enable(unsigned int irq_num, uint8_t irq_priority)
+{
+    (void)irq_num;
+    (void)irq_priority;
+}
+
+void pal_configure_secure_irq_enable(unsigned int irq_num)
+{
+    (void)irq_num;
+}
+
+void pal_irq_disable(unsigned int irq_num)
+{
+    (void)irq_num;
+}
+
+static int pal_irq_update_handler(unsigned int irq_num, handler_irq_t handler,
+                                  bool expect_handler)
+{
+    int ret = -1;
+
+    if (irq_num >= PAL_NATIVE_MAX_IRQ)
+        return ret;
+
+    pal_spin_lock(&irq_lock);
+    if ((irq_handler[irq_num] != NULL) == expect_handler)
+    {
+        irq_handler[irq_num] = handler;
+        ret = 0;
+    }
+    pal_spin_unlock(&irq_lock);
+
+    return ret;
+}
+
+int pal_irq_register_handler(unsigned int irq_num, handler_irq_t irq_handler_fn)
+{
+    return pal_irq_update_handler(irq_num, irq_handler_fn, false);
+}
+
+int pal_irq_unregister_handler(unsigned int irq_num)
+{
+    return pal_irq_update_handler(irq_num, NULL, true);
+}
+
+void pal_send_sgi(unsigned int sgi_id, unsigned int core_pos)
+{
+    sgi_data_t sgi_data = { .irq_id = sgi_id };
+
+    (void)core_pos;
+    if (sgi_id < PAL_NATIVE_MAX_SGI && irq_handler[sgi_id] != NULL)
+        (void)irq_handler[sgi_id](&sgi_data);
+}
+
+uint32_t pal_get_irq_num(void)
+{
+    return PAL_NATIVE_SPURIOUS_IRQ;
+}
+
+void pal_gic_end_of_intr(unsigned int irq_num)
+{
+    (void)irq_num;
+}
+
+int pal_irq_handler_dispatcher(void)
+{
+    return PAL_ERROR;
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+
+#include "pal_native.h"
+#include "pal_smc.h"
+#include "pal_rmm_model.h"
+
+/* Block size zeroed by DC ZVA */
+#define PAL_NATIVE_DCZVA_SIZE 64
+
+/* Number of distinct system registers a cpu can hold */
+#define PAL_NATIVE_SYSREG_MAX 128
+
+typedef struct {
+    const char *name;
+    u_register_t value;
+} pal_native_sysreg_t;
+
+/* System registers are banked per cpu, every emulated cpu is a thread */
+static __thread pal_native_sysreg_t sysreg[PAL_NATIVE_SYSREG_MAX];
+static __thread uint32_t sysreg_count;
+static __thread uint64_t native_mpidr;
+
+/* Reset values of the identification registers */
+static const pal_native_sysreg_t sysreg_reset[] = {
+    {"midr_el1",         0x410FD0F0},
+    {"CurrentEl",        MODE_EL2 << MODE_EL_SHIFT},
+    /* 40 bit PA, 4KB and 64KB granules */
+    {"id_aa64mmfr0_el1", 0x2},
+    /* AArch64 at EL0-EL3, RME implemented */
+    {"id_aa64pfr0_el1",  (1ULL << 52) | 0x1111},
+    /* Debug v8, no PMU */
+    {"id_aa64dfr0_el1",  0x6},
+    {"ctr_el0",          0x8444C004},
+    {"cntfrq_el0",       PAL_NATIVE_CNTFRQ},
+};
+
+void pal_native_set_mpidr(uint64_t mpidr)
+{
+    native_mpidr = mpidr;
+}
+
+uint64_t pal_native_get_mpidr(void)
+{
+    return native_mpidr;
+}
+
+uint64_t pal_native_time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ *   @brief    Find the storage of a system register of the calling cpu
+ *   @param    name    - Register name
+ *   @return   Register storage, NULL if the bank is full
+**/
+static pal_native_sysreg_t *pal_native_sysreg_find(const char *name)
+{
+    uint32_t i;
+
+    for (i = 0; i < sysreg_count; i++)
+    {
+        if (sysreg[i].name == name || !strcmp(sysreg[i].name, name))
+            return &sysreg[i];
+    }
+
+    if (sysreg_count == PAL_NATIVE_SYSREG_MAX)
+        return NULL;
+
+    sysreg[sysreg_count].name = name;
+    sysreg[sysreg_count].value = 0;
+    for (i = 0; i < sizeof(sysreg_reset) / sizeof(sysreg_reset[0]); i++)
+    {
+        if (!strcmp(sysreg_reset[i].name, name))
+            sysreg[sysreg_count].value = sysreg_reset[i].value;
+    }
+
+    return &sysreg[sysreg_count++];
+}
+
+u_register_t pal_native_sysreg_read(const char *name)
+{
+    pal_native_sysreg_t *reg;
+
+    /* Registers backed by the host */
+    if (!strcmp(name, "cntpct_el0") || !strcmp(name, "cntvct_el0"))
+        return pal_native_time_ns() / (1000000000ULL / PAL_NATIVE_CNTFRQ);
+    if (!strcmp(name, "mpidr_el1"))
+        return native_mpidr;
+
+    reg = pal_native_sysreg_find(name);
+    return reg ? reg->value : 0;
+}
+
+void pal_native_sysreg_write(const char *name, u_register_t v)
+{
+    pal_native_sysreg_t *reg = pal_native_sysreg_find(name);
+
+    if (reg)
+        reg->value = v;
+}
+
+void pal_native_sysop(const char *op, uint64_t v)
+{
+    if (!strcmp(op, "wfi") || !strcmp(op, "wfe"))
+        sched_yield();
+    else if (!strcmp(op, "dc zva"))
+        memset((void *)v, 0, PAL_NATIVE_DCZVA_SIZE);
+    else if (!strncmp(op, "dsb", 3) || !strncmp(op, "dmb", 3) || !strcmp(op, "isb"))
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    else if (!strcmp(op, "hvc"))
+    {
+        pal_printf("\tHVC is not modelled on the native target, hvc #%d ignored\n", v, 0);
+    }
+}
+
+void pal_init_spinlock(s_lock_t *lock)
+{
+    __atomic_store_n(&lock->lock, 0, __ATOMIC_RELEASE);
+}
+
+void pal_spin_lock(s_lock_t *lock)
+{
+    while (__atomic_exchange_n(&lock->lock, 1, __ATOMIC_ACQUIRE))
+        sched_yield();
+}
+
+void pal_spin_unlock(s_lock_t *lock)
+{
+    __atomic_store_n(&lock->lock, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ *   @brief    SMC conduit. Calls of a realm go to the RMM model as RSI or
+ *             PSCI calls. Otherwise RMI calls go to the RMM model and PSCI
+ *             calls to the native cpu emulation, anything else is not
+ *             supported.
+ *   @param    regs    - x0-x(count-1), updated with the return values
+ *   @param    count   - Number of registers
+ *   @return   void
+**/
+void pal_native_smc_call(uint64_t *regs, size_t count)
+{
+    uint64_t fid = regs[0];
+    uint64_t func = PAL_SMC_FID_FUNC(fid);
+
+    if (count < PAL_RMM_MODEL_REGS || PAL_SMC_FID_OWNER(fid) != PAL_SMC_OWNER_STD)
+        regs[0] = PAL_SMC_NOT_SUPPORTED;
+    else if (pal_rmm_model_realm_thread())
+        pal_rmm_model_realm_call(regs, count);
+    else if (func >= PAL_SMC_RMI_FUNC_MIN && func <= PAL_SMC_RMI_FUNC_MAX)
+        pal_rmm_model_call(regs);
+    else if (func <= PAL_SMC_PSCI_FUNC_MAX)
+        pal_native_psci_call(regs);
+    else
+        regs[0] = PAL_SMC_NOT_SUPPORTED;
+}
+
+void pal_smc_call_asm(pal_smc_param_t *args)
+{
+    uint64_t regs[PAL_RMM_MODEL_REGS] = {args->x0, args->x1, args->x2, args->x3,
+                                         args->x4, args->x5, args->x6, args->x7};
+
+    pal_native_smc_call(regs, PAL_RMM_MODEL_REGS);
+    memcpy(args, regs, sizeof(*args));
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "pal_native.h"
+#include "pal_rmm_model.h"
+
+typedef enum {
+    CPU_STATE_ON = 0,
+    CPU_STATE_OFF = 1,
+    CPU_STATE_ON_PENDING = 2
+} pal_native_cpu_state_t;
+
+typedef struct {
+    pthread_t thread;
+    uint64_t entry;
+    uint64_t context_id;
+    volatile uint32_t state;
+} pal_native_cpu_t;
+
+static pal_native_cpu_t cpu[PLATFORM_CPU_COUNT];
+static s_lock_t cpu_lock;
+static char **native_argv;
+/* Memory file backing the normal world window, mapped again by aliases */
+static int memory_fd = -1;
+
+/**
+ *   @brief    Map the normal world image window and the memory pool at the
+ *             addresses used by the rest of the ACS.
+ *   @param    void
+ *   @return   SUCCESS/FAILURE
+**/
+static uint32_t pal_native_map_memory(void)
+{
+    size_t size = PLATFORM_NORMAL_WORLD_IMAGE_SIZE + PLATFORM_MEMORY_POOL_SIZE;
+    void *base = (void *)PLATFORM_NORMAL_WORLD_IMAGE_BASE;
+    void *va;
+
+    memory_fd = memfd_create("rmm_acs_memory", MFD_CLOEXEC);
+    if (memory_fd < 0 || ftruncate(memory_fd, (off_t)size))
+    {
+        perror("memfd");
+        return PAL_ERROR;
+    }
+
+    va = mmap(base, size, PROT_READ | PROT_WRITE,
+              MAP_SHARED | MAP_FIXED_NOREPLACE, memory_fd, 0);
+    if (va != base)
+    {
+        perror("mmap");
+        return PAL_ERROR;
+    }
+
+    return PAL_SUCCESS;
+}
+
+uint32_t pal_native_map_alias(uint64_t va, uint64_t pa, uint64_t size)
+{
+    uint64_t base = PLATFORM_NORMAL_WORLD_IMAGE_BASE;
+    uint64_t top = PLATFORM_MEMORY_POOL_BASE + PLATFORM_MEMORY_POOL_SIZE;
+    void *alias;
+
+    if (pa < base || pa + size > top)
+        return PAL_ERROR;
+
+    alias = mmap((void *)va, size, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_FIXED_NOREPLACE, memory_fd, (off_t)(pa - base));
+    if (alias == MAP_FAILED)
+        return PAL_ERROR;
+
+    /* Kernels before 4.17 take the address as a hint only */
+    if (alias != (void *)va)
+    {
+        munmap(alias, size);
+        return PAL_ERROR;
+    }
+
+    return PAL_SUCCESS;
+}
+
+void pal_native_unmap_alias(uint64_t va, uint64_t size)
+{
+    munmap((void *)va, size);
+}
+
+/**
+ *   @brief    Restart the executable, the emulation of a system reset.
+ *             Progress survives in the file backed NVM.
+ *   @param    void
+ *   @return   Does not return
+**/
+void pal_native_reset(void)
+{
+    fflush(stdout);
+    setenv(PAL_NATIVE_RESET_ENV, "1", 1);
+    execv("/proc/self/exe", native_argv);
+    perror("execv");
+    exit(EXIT_FAILURE);
+}
+
+/**
+ *   @brief    Look up the emulated cpu of an MPIDR
+ *   @param    mpidr   - Target MPIDR
+ *   @return   Logical cpu index, PLATFORM_CPU_COUNT if not found
+**/
+static uint32_t pal_native_cpu_index(uint64_t mpidr)
+{
+    uint64_t *mpidr_list = pal_get_phy_mpidr_list_base();
+    uint32_t i;
+
+    for (i = 0; i < PLATFORM_CPU_COUNT; i++)
+    {
+        if (mpidr_list[i] == (mpidr & PAL_MPIDR_AFFINITY_MASK))
+            break;
+    }
+
+    return i;
+}
+
+static void *pal_native_cpu_thread(void *arg)
+{
+    pal_native_cpu_t *self = (pal_native_cpu_t *)arg;
+    uint32_t index = (uint32_t)(self - cpu);
+
+    pal_native_set_mpidr(pal_get_phy_mpidr_list_base()[index]);
+    self->state = CPU_STATE_ON;
+
+    ((void (*)(uint64_t))self->entry)(self->context_id);
+
+    self->state = CPU_STATE_OFF;
+    return NULL;
+}
+
+static int64_t pal_native_cpu_on(uint64_t mpidr, uint64_t entry, uint64_t context_id)
+{
+    uint32_t index = pal_native_cpu_index(mpidr);
+    int64_t ret = PSCI_E_SUCCESS;
+
+    if (index == PLATFORM_CPU_COUNT || !entry)
+        return PSCI_E_INVALID_PARAMS;
+
+    pal_spin_lock(&cpu_lock);
+    if (cpu[index].state != CPU_STATE_OFF)
+    {
+        ret = PSCI_E_ALREADY_ON;
+        goto unlock;
+    }
+
+    cpu[index].entry = entry;
+    cpu[index].context_id = context_id;
+    cpu[index].state = CPU_STATE_ON_PENDING;
+    if (pthread_create(&cpu[index].thread, NULL, pal_native_cpu_thread, &cpu[index]) ||
+        pthread_detach(cpu[index].thread))
+    {
+        cpu[index].state = CPU_STATE_OFF;
+        ret = PSCI_E_INTERN_FAIL;
+    }
+
+unlock:
+    pal_spin_unlock(&cpu_lock);
+    return ret;
+}
+
+void pal_native_psci_call(uint64_t *regs)
+{
+    uint32_t index;
+    int64_t ret;
+
+    switch (PAL_SMC_FID_FUNC(regs[0]))
+    {
+        case PSCI_FUNC_VERSION:
+            ret = PSCI_VERSION_1_1;
+            break;
+        case PSCI_FUNC_CPU_ON:
+            ret = pal_native_cpu_on(regs[1], regs[2], regs[3]);
+            break;
+        case PSCI_FUNC_CPU_OFF:
+            index = pal_native_cpu_index(pal_native_get_mpidr());
+            cpu[index].state = CPU_STATE_OFF;
+            pthread_exit(NULL);
+            break;
+        case PSCI_FUNC_AFFINITY_INFO:
+            index = pal_native_cpu_index(regs[1]);
+            if (index == PLATFORM_CPU_COUNT || regs[2])
+                ret = PSCI_E_INVALID_PARAMS;
+            else
+                ret = cpu[index].state;
+            break;
+        case PSCI_FUNC_SYSTEM_OFF:
+            fflush(stdout);
+            exit(EXIT_SUCCESS);
+            break;
+        case PSCI_FUNC_SYSTEM_RESET:
+            pal_native_reset();
+            break;
+        case PSCI_FUNC_FEATURES:
+            switch (PAL_SMC_FID_FUNC(regs[1]))
+            {
+                case PSCI_FUNC_VERSION:
+                case PSCI_FUNC_CPU_OFF:
+                case PSCI_FUNC_CPU_ON:
+                case PSCI_FUNC_AFFINITY_INFO:
+                case PSCI_FUNC_SYSTEM_OFF:
+                case PSCI_FUNC_SYSTEM_RESET:
+                case PSCI_FUNC_FEATURES:
+                    ret = PSCI_E_SUCCESS;
+                    break;
+                default:
+                    ret = PSCI_E_NOT_SUPPORTED;
+            }
+            break;
+        default:
+            ret = PSCI_E_NOT_SUPPORTED;
+    }
+
+    regs[0] = (uint64_t)ret;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t i;
+
+    native_argv = argv;
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    /* acs_host.elf --replay <trace>: check a recorded RMI sequence */
+    if (argc == 3 && !strcmp(argv[1], "--replay"))
+    {
+        if (pal_native_map_memory() || pal_rmm_model_init())
+            return EXIT_FAILURE;
+        return pal_rmm_model_replay(argv[2]) ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    if (pal_native_map_memory() || pal_rmm_model_init() ||
+        pal_native_nvm_init(getenv(PAL_NATIVE_RESET_ENV) != NULL))
+        return EXIT_FAILURE;
+
+    pal_init_spinlock(&cpu_lock);
+    for (i = 0; i < PLATFORM_CPU_COUNT; i++)
+        cpu[i].state = CPU_STATE_OFF;
+
+    /* The main thread is the boot cpu */
+    cpu[0].state = CPU_STATE_ON;
+    pal_native_set_mpidr(PLATFORM_PHY_MPIDR_CPU0);
+    acs_host_entry();
+
+    return EXIT_SUCCESS;
+}
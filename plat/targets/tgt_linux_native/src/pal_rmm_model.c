@@ -0,0 +1,1727 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pal_native.h"
+#include "pal_rmm_model.h"
+
+/*
+ * Software model of the RMM, as seen through the RMI. It tracks the state of
+ * every granule of the memory pool, keeps realm and REC descriptors in their
+ * RD and REC granules and stage 2 tables in their RTT granules, exactly as an
+ * RMM owns delegated memory.
+ *
+ * The realm image is linked into the host executable and every REC runs it
+ * on a thread of its own, which REC enter resumes and a REC exit suspends.
+ * A realm accesses an IPA at the same address of the host: the first access
+ * faults and the model maps the granule its RTT entry points to there, or
+ * makes the access a data abort REC exit. The writable data of the image is
+ * saved and restored when a REC of another realm is entered, one realm runs
+ * at a time. The RSI is modelled up to the version, features, realm config,
+ * RIPAS and host call commands, PSCI calls exit to the host as they do on the
+ * RMM. Measurements and attestation are not modelled.
+ */
+
+/* RMI function numbers, the low bits of the FIDs */
+#define RMI_FN_VERSION             0x150
+#define RMI_FN_GRANULE_DELEGATE    0x151
+#define RMI_FN_GRANULE_UNDELEGATE  0x152
+#define RMI_FN_DATA_CREATE         0x153
+#define RMI_FN_DATA_CREATE_UNKNOWN 0x154
+#define RMI_FN_DATA_DESTROY        0x155
+#define RMI_FN_REALM_ACTIVATE      0x157
+#define RMI_FN_REALM_CREATE        0x158
+#define RMI_FN_REALM_DESTROY       0x159
+#define RMI_FN_REC_CREATE          0x15a
+#define RMI_FN_REC_DESTROY         0x15b
+#define RMI_FN_REC_ENTER           0x15c
+#define RMI_FN_RTT_CREATE          0x15d
+#define RMI_FN_RTT_DESTROY         0x15e
+#define RMI_FN_RTT_MAP_UNPROTECTED 0x15f
+#define RMI_FN_RTT_READ_ENTRY      0x161
+#define RMI_FN_RTT_UNMAP_UNPROTECTED 0x162
+#define RMI_FN_PSCI_COMPLETE       0x164
+#define RMI_FN_FEATURES            0x165
+#define RMI_FN_RTT_FOLD            0x166
+#define RMI_FN_REC_AUX_COUNT       0x167
+#define RMI_FN_RTT_INIT_RIPAS      0x168
+#define RMI_FN_RTT_SET_RIPAS       0x169
+
+/* RSI function numbers */
+#define RSI_FN_VERSION             0x190
+#define RSI_FN_FEATURES            0x191
+#define RSI_FN_REALM_CONFIG        0x196
+#define RSI_FN_IPA_STATE_SET       0x197
+#define RSI_FN_IPA_STATE_GET       0x198
+#define RSI_FN_HOST_CALL           0x199
+
+/* RSI status codes */
+#define RSI_SUCCESS                0
+#define RSI_ERROR_INPUT            1
+
+#define RSI_VERSION                ((1ULL << 16) | 0)
+
+/* RMI status codes */
+#define MODEL_SUCCESS              0
+#define MODEL_ERROR_INPUT          1
+#define MODEL_ERROR_REALM          2
+#define MODEL_ERROR_REC            3
+#define MODEL_ERROR_RTT            4
+#define MODEL_STATUS(status, index) (((uint64_t)(index) << 8) | (status))
+
+#define MODEL_VERSION              ((1ULL << 16) | 0)
+
+/* Feature register 0: 40 bit IPA, SHA-256 and SHA-512 */
+#define MODEL_S2SZ_MIN             32
+#define MODEL_S2SZ_MAX             40
+#define MODEL_FEATURE_REG0         (MODEL_S2SZ_MAX | (1ULL << 28) | (1ULL << 29))
+#define MODEL_HASH_ALGO_MAX        1
+
+#define MODEL_REC_AUX_COUNT        2
+#define MODEL_REC_AUX_MAX          16
+#define MODEL_RTT_NUM_START_MAX    16
+
+#define MODEL_GRANULE_SIZE         0x1000ULL
+#define MODEL_GRANULE_MASK         (MODEL_GRANULE_SIZE - 1)
+#define MODEL_RTT_ENTRIES          512
+#define MODEL_RTT_LEVEL_MAX        3
+#define MODEL_MIN_BLOCK_LEVEL      2
+
+#define MODEL_POOL_BASE            PLATFORM_MEMORY_POOL_BASE
+#define MODEL_POOL_GRANULES        (PLATFORM_MEMORY_POOL_SIZE / MODEL_GRANULE_SIZE)
+#define MODEL_NS_BASE              PLATFORM_NORMAL_WORLD_IMAGE_BASE
+#define MODEL_NS_TOP               (PLATFORM_MEMORY_POOL_BASE + PLATFORM_MEMORY_POOL_SIZE)
+
+/*
+ * RTT entries: bits[1:0] HIPAS, bits[3:2] RIPAS, bits[11:4] the attributes of
+ * an unprotected mapping and bits[47:12] the output address.
+ */
+#define RTTE_UNASSIGNED            0ULL
+#define RTTE_ASSIGNED              1ULL
+#define RTTE_TABLE                 2ULL
+#define RTTE_ASSIGNED_NS           3ULL
+#define RTTE_HIPAS(e)              ((e) & 0x3)
+#define RTTE_RIPAS(e)              (((e) >> 2) & 0x3)
+#define RTTE_ATTR(e)               (((e) >> 4) & 0xFF)
+#define RTTE_OA_MASK               0xFFFFFFFFF000ULL
+#define RTTE_OA(e)                 ((e) & RTTE_OA_MASK)
+#define RTTE(hipas, ripas, oa, attr) ((oa) | ((uint64_t)(attr) << 4) | \
+                                      ((uint64_t)(ripas) << 2) | (hipas))
+
+/* Host descriptor of an unprotected mapping: MemAttr, S2AP, SH and the OA */
+#define NS_DESC_ATTR(desc)         (((desc) >> 2) & 0xFF)
+#define NS_DESC_VALID_MASK         (RTTE_OA_MASK | (0xFFULL << 2))
+
+#define RIPAS_EMPTY                0
+#define RIPAS_RAM                  1
+#define RIPAS_DESTROYED            2
+
+#define REALM_FLAGS_SUPPORTED      0x0ULL
+
+/* REC run object: the host sets the entry part and reads the exit part */
+#define RUN_ENTER_FLAGS            0x0
+#define RUN_ENTER_GPRS             0x200
+#define RUN_ENTER_GICV3_LRS        0x308
+#define RUN_GICV3_LRS              16
+#define RUN_ENTER_EMUL_MMIO        (1ULL << 0)
+#define GICV3_LR_HW                (1ULL << 61)
+#define RUN_EXIT                   0x800
+#define RUN_EXIT_SIZE              0x800
+#define RUN_EXIT_REASON            0x800
+#define RUN_EXIT_ESR               0x900
+#define RUN_EXIT_FAR               0x908
+#define RUN_EXIT_HPFAR             0x910
+#define RUN_EXIT_GPRS              0xA00
+#define RUN_EXIT_RIPAS_BASE        0xD00
+#define RUN_EXIT_RIPAS_TOP         0xD08
+#define RUN_EXIT_RIPAS_VALUE       0xD10
+#define RUN_EXIT_IMM               0xE00
+#define RUN_GPRS                   31
+#define RUN_ENTER_RIPAS_RESPONSE   (1ULL << 4)
+
+#define EXIT_SYNC                  0
+#define EXIT_PSCI                  3
+#define EXIT_RIPAS_CHANGE          4
+#define EXIT_HOST_CALL             5
+
+/* ESR of a data abort from a lower EL, translation fault at level 3 */
+#define EXIT_ESR_DATA_ABORT        ((0x24ULL << 26) | (1ULL << 25) | 0x7)
+
+#define REC_CREATE_RUNNABLE        (1ULL << 0)
+
+/* RSI host call: the immediate, then x0-x30 */
+#define HOST_CALL_ALIGN            0x100
+#define HOST_CALL_GPRS             0x8
+
+/* Granules of a realm mapped at their IPA at one time */
+#define MODEL_ALIAS_MAX            1024
+
+typedef enum {
+    GRANULE_UNDELEGATED = 0,
+    GRANULE_DELEGATED,
+    GRANULE_RD,
+    GRANULE_REC,
+    GRANULE_REC_AUX,
+    GRANULE_DATA,
+    GRANULE_RTT
+} model_granule_state_te;
+
+typedef enum {
+    REALM_NEW = 0,
+    REALM_ACTIVE,
+    /* A REC called PSCI SYSTEM_OFF or SYSTEM_RESET */
+    REALM_SYSTEM_OFF
+} model_realm_state_te;
+
+typedef struct {
+    uint8_t state;
+    /* Live entries of an RTT, RECs of an RD */
+    uint32_t refcount;
+} model_granule_ts;
+
+/* Kept in the RD granule */
+typedef struct {
+    uint64_t state;
+    uint64_t s2sz;
+    uint64_t hash_algo;
+    uint64_t vmid;
+    uint64_t rtt_base;
+    uint64_t rtt_level_start;
+    uint64_t rtt_num_start;
+    uint64_t rec_index;
+    /* Image data of the realm while another realm runs */
+    void *image;
+} model_realm_ts;
+
+/* Kept in the REC granule */
+typedef struct {
+    uint64_t rd;
+    uint64_t mpidr;
+    uint64_t num_aux;
+    uint64_t aux[MODEL_REC_AUX_MAX];
+    bool runnable;
+    /* A host thread waits for the REC to exit */
+    bool running;
+    /* The REC thread exists, it runs or waits for the next REC enter */
+    bool started;
+    bool destroyed;
+    /* The realm stopped the REC, it cannot be entered again */
+    bool aborted;
+    uint64_t run;
+    /* PSCI request for the host to complete */
+    bool psci_pending;
+    uint64_t psci_fid;
+    uint64_t psci_target;
+    uint64_t psci_result;
+    /* Pending RIPAS change, ripas_top is 0 if none */
+    uint64_t ripas_addr;
+    uint64_t ripas_top;
+    uint64_t ripas_value;
+    /* Stack of the REC thread, realm memory that is not an IPA */
+    uint64_t stack_base;
+    uint64_t stack_top;
+    pthread_t thread;
+    sem_t enter_sem;
+    sem_t exit_sem;
+    /* Start of the REC thread, a REC turned off starts again from there */
+    sigjmp_buf start;
+} model_rec_ts;
+
+typedef struct {
+    uint64_t *rtte;
+    uint64_t rtt;
+    uint64_t level;
+} model_walk_ts;
+
+/* Writable data of the realm image, see native_realm.ld */
+extern char __REALM_DATA_START__[], __REALM_DATA_END__[];
+#define IMAGE_DATA_BASE            ((uint64_t)__REALM_DATA_START__)
+#define IMAGE_DATA_SIZE            ((size_t)(__REALM_DATA_END__ - __REALM_DATA_START__))
+
+static model_granule_ts granule[MODEL_POOL_GRANULES];
+static s_lock_t model_lock;
+
+/* REC of the calling thread, NULL on the threads of the host */
+static __thread model_rec_ts *model_current_rec;
+/* The REC thread handles an RSI or PSCI call */
+static __thread bool model_realm_call;
+
+/* Image data of a realm that never ran, the realm whose data is live and
+   the number of its RECs a host thread waits for */
+static void *image_reset;
+static uint64_t image_rd;
+static uint32_t image_running;
+
+/* Granules mapped at their IPA for the realm whose data is live */
+static uint64_t alias[MODEL_ALIAS_MAX];
+static uint32_t alias_count;
+
+static void model_realm_fault(int sig, siginfo_t *info, void *context);
+
+uint32_t pal_rmm_model_init(void)
+{
+    struct sigaction action;
+
+    pal_init_spinlock(&model_lock);
+    memset(granule, 0, sizeof(granule));
+
+    image_reset = malloc(IMAGE_DATA_SIZE);
+    if (!image_reset)
+        return PAL_ERROR;
+    memcpy(image_reset, __REALM_DATA_START__, IMAGE_DATA_SIZE);
+
+    /* Faults of the realm threads are stage 2 accesses */
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = model_realm_fault;
+    action.sa_flags = SA_SIGINFO | SA_NODEFER;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGSEGV, &action, NULL))
+        return PAL_ERROR;
+
+    return PAL_SUCCESS;
+}
+
+/* Remove every alias, the RTT entries they were made from changed */
+static void model_alias_drop(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < alias_count; i++)
+        pal_native_unmap_alias(alias[i], MODEL_GRANULE_SIZE);
+    alias_count = 0;
+}
+
+static uint64_t model_level_shift(uint64_t level)
+{
+    return 12 + 9 * (MODEL_RTT_LEVEL_MAX - level);
+}
+
+static uint64_t model_level_size(uint64_t level)
+{
+    return 1ULL << model_level_shift(level);
+}
+
+static bool model_aligned(uint64_t addr, uint64_t size)
+{
+    return (addr & (size - 1)) == 0;
+}
+
+/**
+ *   @brief    Granule of the memory pool at a PA
+ *   @param    pa      - Physical address
+ *   @return   Granule, NULL if the PA is unaligned or outside the pool
+**/
+static model_granule_ts *model_granule(uint64_t pa)
+{
+    if ((pa & MODEL_GRANULE_MASK) || pa < MODEL_POOL_BASE ||
+        pa >= MODEL_POOL_BASE + MODEL_POOL_GRANULES * MODEL_GRANULE_SIZE)
+        return NULL;
+
+    return &granule[(pa - MODEL_POOL_BASE) / MODEL_GRANULE_SIZE];
+}
+
+static model_granule_ts *model_granule_in(uint64_t pa, uint8_t state)
+{
+    model_granule_ts *g = model_granule(pa);
+
+    return (g && g->state == state) ? g : NULL;
+}
+
+static void model_granule_set(uint64_t pa, uint8_t state)
+{
+    model_granule_ts *g = model_granule(pa);
+
+    /* Memory returned to the delegated state is scrubbed */
+    if (state == GRANULE_DELEGATED || state == GRANULE_UNDELEGATED)
+        memset((void *)pa, 0, MODEL_GRANULE_SIZE);
+    g->state = state;
+    g->refcount = 0;
+}
+
+/**
+ *   @brief    Check that a PA can be accessed by the RMM on behalf of the host
+ *   @param    pa      - Physical address
+ *   @return   True if the granule is aligned, in NS memory and not delegated
+**/
+static bool model_ns_valid(uint64_t pa)
+{
+    model_granule_ts *g = model_granule(pa);
+
+    if ((pa & MODEL_GRANULE_MASK) || pa < MODEL_NS_BASE || pa >= MODEL_NS_TOP)
+        return false;
+
+    return g == NULL || g->state == GRANULE_UNDELEGATED;
+}
+
+static model_realm_ts *model_realm(uint64_t rd)
+{
+    return model_granule_in(rd, GRANULE_RD) ? (model_realm_ts *)rd : NULL;
+}
+
+static model_rec_ts *model_rec(uint64_t rec)
+{
+    return model_granule_in(rec, GRANULE_REC) ? (model_rec_ts *)rec : NULL;
+}
+
+static bool model_ipa_protected(model_realm_ts *realm, uint64_t ipa)
+{
+    return ipa < (1ULL << (realm->s2sz - 1));
+}
+
+static bool model_ipa_bound(model_realm_ts *realm, uint64_t ipa)
+{
+    return ipa < (1ULL << realm->s2sz);
+}
+
+/**
+ *   @brief    Walk the stage 2 tables of a realm
+ *   @param    realm   - Realm descriptor
+ *   @param    ipa     - IPA to walk, within the IPA width of the realm
+ *   @param    level   - Level at which the walk stops
+ *   @param    walk    - Entry reached, its RTT and its level
+ *   @return   void
+**/
+static void model_rtt_walk(model_realm_ts *realm, uint64_t ipa, uint64_t level,
+                           model_walk_ts *walk)
+{
+    uint64_t l = realm->rtt_level_start;
+    uint64_t index = ipa >> model_level_shift(l);
+    uint64_t rtt = realm->rtt_base + (index / MODEL_RTT_ENTRIES) * MODEL_GRANULE_SIZE;
+    uint64_t *rtte = (uint64_t *)rtt + index % MODEL_RTT_ENTRIES;
+
+    while (l < level && RTTE_HIPAS(*rtte) == RTTE_TABLE)
+    {
+        rtt = RTTE_OA(*rtte);
+        l++;
+        rtte = (uint64_t *)rtt + ((ipa >> model_level_shift(l)) % MODEL_RTT_ENTRIES);
+    }
+
+    walk->rtte = rtte;
+    walk->rtt = rtt;
+    walk->level = l;
+}
+
+/* Update an RTT entry, the RTT counts its live entries */
+static void model_rtte_set(uint64_t rtt, uint64_t *rtte, uint64_t value)
+{
+    model_granule_ts *g = model_granule(rtt);
+
+    if (RTTE_HIPAS(*rtte) != RTTE_UNASSIGNED)
+        g->refcount--;
+    if (RTTE_HIPAS(value) != RTTE_UNASSIGNED)
+        g->refcount++;
+
+    /* A realm may have accessed the mapping the entry held */
+    if ((RTTE_HIPAS(*rtte) == RTTE_ASSIGNED || RTTE_HIPAS(*rtte) == RTTE_ASSIGNED_NS) &&
+        *rtte != value)
+        model_alias_drop();
+    *rtte = value;
+}
+
+/**
+ *   @brief    Skip the non-live entries that follow the entry a walk stopped
+ *             at, up to the end of its RTT
+ *   @param    walk    - Result of the walk
+ *   @param    ipa     - IPA that was walked
+ *   @return   IPA of the next live entry or of the end of the RTT
+**/
+static uint64_t model_walk_top(model_walk_ts *walk, uint64_t ipa)
+{
+    uint64_t size = model_level_size(walk->level);
+    uint64_t index = (ipa >> model_level_shift(walk->level)) % MODEL_RTT_ENTRIES;
+    uint64_t i;
+
+    for (i = 1; index + i < MODEL_RTT_ENTRIES; i++)
+    {
+        if (RTTE_HIPAS(walk->rtte[i]) != RTTE_UNASSIGNED)
+            break;
+    }
+
+    return (ipa & ~(size - 1)) + i * size;
+}
+
+/* Number of starting level RTTs needed for an IPA width, 0 if not valid */
+static uint64_t model_rtt_num_start(uint64_t s2sz, uint64_t level_start)
+{
+    uint64_t shift;
+
+    if (level_start > MODEL_RTT_LEVEL_MAX)
+        return 0;
+
+    shift = model_level_shift(level_start);
+    if (s2sz <= shift || s2sz - shift > 9 + 4)
+        return 0;
+
+    return (s2sz - shift > 9) ? 1ULL << (s2sz - shift - 9) : 1;
+}
+
+static bool model_vmid_in_use(uint64_t vmid)
+{
+    uint64_t i;
+
+    for (i = 0; i < MODEL_POOL_GRANULES; i++)
+    {
+        if (granule[i].state == GRANULE_RD &&
+            ((model_realm_ts *)(MODEL_POOL_BASE + i * MODEL_GRANULE_SIZE))->vmid == vmid)
+            return true;
+    }
+
+    return false;
+}
+
+static uint64_t model_granule_delegate(const uint64_t *args)
+{
+    if (!model_granule_in(args[1], GRANULE_UNDELEGATED))
+        return MODEL_ERROR_INPUT;
+
+    model_granule_set(args[1], GRANULE_DELEGATED);
+    return MODEL_SUCCESS;
+}
+
+static uint64_t model_granule_undelegate(const uint64_t *args)
+{
+    if (!model_granule_in(args[1], GRANULE_DELEGATED))
+        return MODEL_ERROR_INPUT;
+
+    model_granule_set(args[1], GRANULE_UNDELEGATED);
+    return MODEL_SUCCESS;
+}
+
+static uint64_t model_realm_create(const uint64_t *args)
+{
+    uint64_t rd = args[1], params = args[2];
+    uint64_t flags, s2sz, hash_algo, vmid, rtt_base, level_start, num_start, i;
+    model_realm_ts *realm;
+
+    if (!model_granule_in(rd, GRANULE_DELEGATED) || !model_ns_valid(params))
+        return MODEL_ERROR_INPUT;
+
+    flags = *(uint64_t *)params;
+    s2sz = *(uint32_t *)(params + 0x8);
+    hash_algo = *(uint8_t *)(params + 0x30);
+    vmid = *(uint16_t *)(params + 0x800);
+    rtt_base = *(uint64_t *)(params + 0x808);
+    level_start = *(uint64_t *)(params + 0x810);
+    num_start = *(uint32_t *)(params + 0x818);
+
+    if ((flags & ~REALM_FLAGS_SUPPORTED) || s2sz < MODEL_S2SZ_MIN ||
+        s2sz > MODEL_S2SZ_MAX || hash_algo > MODEL_HASH_ALGO_MAX ||
+        num_start == 0 || num_start > MODEL_RTT_NUM_START_MAX ||
+        model_rtt_num_start(s2sz, level_start) != num_start)
+        return MODEL_ERROR_INPUT;
+
+    for (i = 0; i < num_start; i++)
+    {
+        if (rtt_base + i * MODEL_GRANULE_SIZE == rd ||
+            !model_granule_in(rtt_base + i * MODEL_GRANULE_SIZE, GRANULE_DELEGATED))
+            return MODEL_ERROR_INPUT;
+    }
+
+    if (model_vmid_in_use(vmid))
+        return MODEL_ERROR_INPUT;
+
+    model_granule_set(rd, GRANULE_RD);
+    for (i = 0; i < num_start; i++)
+        model_granule_set(rtt_base + i * MODEL_GRANULE_SIZE, GRANULE_RTT);
+
+    realm = (model_realm_ts *)rd;
+    realm->state = REALM_NEW;
+    realm->s2sz = s2sz;
+    realm->hash_algo = hash_algo;
+    realm->vmid = vmid;
+    realm->rtt_base = rtt_base;
+    realm->rtt_level_start = level_start;
+    realm->rtt_num_start = num_start;
+    realm->rec_index = 0;
+    realm->image = NULL;
+
+    return MODEL_SUCCESS;
+}
+
+static uint64_t model_realm_activate(const uint64_t *args)
+{
+    model_realm_ts *realm = model_realm(args[1]);
+
+    if (!realm)
+        return MODEL_ERROR_INPUT;
+    if (realm->state != REALM_NEW)
+        return MODEL_ERROR_REALM;
+
+    realm->state = REALM_ACTIVE;
+    return MODEL_SUCCESS;
+}
+
+static uint64_t model_realm_destroy(const uint64_t *args)
+{
+    model_realm_ts *realm = model_realm(args[1]);
+    uint64_t i, rtt_base, num_start;
+
+    if (!realm)
+        return MODEL_ERROR_INPUT;
+
+    /* The RECs and every RTT below the starting level must be gone */
+    if (model_granule(args[1])->refcount)
+        return MODEL_ERROR_REALM;
+    for (i = 0; i < realm->rtt_num_start; i++)
+    {
+        if (model_granule(realm->rtt_base + i * MODEL_GRANULE_SIZE)->refcount)
+            return MODEL_ERROR_REALM;
+    }
+
+    free(realm->image);
+    if (image_rd == args[1])
+    {
+        model_alias_drop();
+        image_rd = 0;
+    }
+
+    rtt_base = realm->rtt_base;
+    num_start = realm->rtt_num_start;
+    for (i = 0; i < num_start; i++)
+        model_granule_set(rtt_base + i * MODEL_GRANULE_SIZE, GRANULE_DELEGATED);
+    model_granule_set(args[1], GRANULE_DELEGATED);
+
+    return MODEL_SUCCESS;
+}
+
+static uint64_t model_rec_aux_count(const uint64_t *args, uint64_t *res)
+{
+    if (!model_realm(args[1]))
+        return MODEL_ERROR_INPUT;
+
+    res[1] = MODEL_REC_AUX_COUNT;
+    return MODEL_SUCCESS;
+}
+
+static uint64_t model_rec_create(const uint64_t *args)
+{
+    uint64_t rd = args[1], rec_pa = args[2], params = args[3];
+    uint64_t flags, mpidr, num_aux, index, i, j;
+    model_realm_ts *realm = model_realm(rd);
+    uint64_t *aux;
+    model_rec_ts *rec;
+
+    if (!model_granule_in(rec_pa, GRANULE_DELEGATED) || !realm || !model_ns_valid(params))
+        return MODEL_ERROR_INPUT;
+    if (realm->state != REALM_NEW)
+        return MODEL_ERROR_REALM;
+
+    flags = *(uint64_t *)params;
+    mpidr = *(uint64_t *)(params + 0x100);
+    num_aux = *(uint64_t *)(params + 0x800);
+    aux = (uint64_t *)(params + 0x808);
+
+    /* RECs are created in the order of their MPIDR */
+    index = (mpidr & 0xF) | ((mpidr >> 4) & 0xFF0) | ((mpidr >> 4) & 0xFF000) |
+            ((mpidr >> 12) & 0xFF00000);
+    if ((mpidr & 0xFFFFFF00000000F0ULL) || index != realm->rec_index ||
+        num_aux != MODEL_REC_AUX_COUNT)
+        return MODEL_ERROR_INPUT;
+
+    for (i = 0; i < num_aux; i++)
+    {
+        if (aux[i] == rec_pa || !model_granule_in(aux[i], GRANULE_DELEGATED))
+            return MODEL_ERROR_INPUT;
+        for (j = 0; j < i; j++)
+        {
+            if (aux[j] == aux[i])
+                return MODEL_ERROR_INPUT;
+        }
+    }
+
+    model_granule_set(rec_pa, GRANULE_REC);
+    for (i = 0; i < num_aux; i++)
+        model_granule_set(aux[i], GRANULE_REC_AUX);
+
+    rec = (model_rec_ts *)rec_pa;
+    rec->rd = rd;
+    rec->mpidr = mpidr;
+    rec->num_aux = num_aux;
+    memcpy(rec->aux, aux, num_aux * sizeof(uint64_t));
+    rec->runnable = (flags & REC_CREATE_RUNNABLE) != 0;
+    sem_init(&rec->enter_sem, 0, 0);
+    sem_init(&rec->exit_sem, 0, 0);
+
+    model_granule(rd)->refcount++;
+    realm->rec_index++;
+
+    return MODEL_SUCCESS;
+}
+
+static uint64_t model_rec_destroy(const uint64_t *args)
+{
+    model_rec_ts *rec = model_rec(args[1]);
+    uint64_t i;
+
+    if (!rec)
+        return MODEL_ERROR_INPUT;
+    if (rec->running)
+        return MODEL_ERROR_REC;
+
+    /* The thread waits for a REC enter, it ends instead */
+    if (rec->started)
+    {
+        rec->destroyed = true;
+        sem_post(&rec->enter_sem);
+        pthread_join(rec->thread, NULL);
+    }
+    sem_destroy(&rec->enter_sem);
+    sem_destroy(&rec->exit_sem);
+
+    model_granule(rec->rd)->refcount--;
+    for (i = 0; i < rec->num_aux; i++)
+        model_granule_set(rec->aux[i], GRANULE_DELEGATED);
+    model_granule_set(args[1], GRANULE_DELEGATED);
+
+    return MODEL_SUCCESS;
+}
+
+/**
+ *   @brief    Make the image data of a realm live, the data of the realm it
+ *             replaces is saved in a buffer of its own
+ *   @param    rd      - RD of the realm
+ *   @return   False if a REC of another realm still runs
+**/
+static bool model_image_switch(uint64_t rd)
+{
+    model_realm_ts *owner = model_realm(image_rd);
+    model_realm_ts *realm = (model_realm_ts *)rd;
+
+    if (image_rd == rd)
+        return true;
+    if (image_running)
+        return false;
+
+    if (owner)
+    {
+        if (!owner->image)
+            owner->image = malloc(IMAGE_DATA_SIZE);
+        if (!owner->image)
+            return false;
+        memcpy(owner->image, __REALM_DATA_START__, IMAGE_DATA_SIZE);
+    }
+
+    memcpy(__REALM_DATA_START__, realm->image ? realm->image : image_reset, IMAGE_DATA_SIZE);
+    model_alias_drop();
+    image_rd = rd;
+
+    return true;
+}
+
+static uint64_t *model_run(model_rec_ts *rec, uint64_t offset)
+{
+    return (uint64_t *)(rec->run + offset);
+}
+
+/**
+ *   @brief    Hand the REC back to the host, which the REC thread does with
+ *             the model lock held once it wrote the exit part of the run
+ *             object. The thread resumes on the next REC enter.
+ *   @param    rec     - REC of the calling thread
+ *   @return   void
+**/
+static void model_rec_exit(model_rec_ts *rec)
+{
+    pal_spin_unlock(&model_lock);
+    sem_post(&rec->exit_sem);
+    while (sem_wait(&rec->enter_sem) && errno == EINTR)
+        ;
+
+    /* REC destroy ends the thread, it holds the model lock */
+    if (rec->destroyed)
+        siglongjmp(rec->start, 1);
+
+    pal_spin_lock(&model_lock);
+}
+
+/* The REC cannot run further, its REC enter fails */
+static void model_rec_abort(model_rec_ts *rec)
+{
+    rec->aborted = true;
+    for (;;)
+        model_rec_exit(rec);
+}
+
+void pal_rmm_model_realm_stop(void)
+{
+    pal_spin_lock(&model_lock);
+    model_rec_abort(model_current_rec);
+}
+
+bool pal_rmm_model_realm_thread(void)
+{
+    return model_current_rec != NULL;
+}
+
+static void *model_rec_thread(void *arg)
+{
+    model_rec_ts *rec = arg;
+    pthread_attr_t attr;
+    size_t size;
+    void *stack;
+
+    pthread_getattr_np(pthread_self(), &attr);
+    pthread_attr_getstack(&attr, &stack, &size);
+    pthread_attr_destroy(&attr);
+    rec->stack_base = (uint64_t)stack;
+    rec->stack_top = (uint64_t)stack + size;
+
+    model_current_rec = rec;
+    pal_native_set_mpidr(rec->mpidr);
+    pal_native_sysreg_write("CurrentEl", MODE_EL1 << MODE_EL_SHIFT);
+
+    /* The realm has one entry point, the PC of the REC is not used */
+    for (;;)
+    {
+        model_realm_call = false;
+        if (sigsetjmp(rec->start, 1) == 0)
+        {
+            acs_realm_entry();
+            pal_rmm_model_realm_stop();
+        }
+        if (rec->destroyed)
+            break;
+    }
+
+    return NULL;
+}
+
+/**
+ *   @brief    Check the entry part of a run object. No REC exit is an
+ *             emulatable data abort and no virtual interrupt can be backed
+ *             by a physical one.
+ *   @param    run     - Run object
+ *   @return   True if the REC can be entered with it
+**/
+static bool model_run_valid(uint64_t run)
+{
+    uint64_t *lrs = (uint64_t *)(run + RUN_ENTER_GICV3_LRS);
+    uint32_t i;
+
+    if (*(uint64_t *)(run + RUN_ENTER_FLAGS) & RUN_ENTER_EMUL_MMIO)
+        return false;
+
+    for (i = 0; i < RUN_GICV3_LRS; i++)
+    {
+        if (lrs[i] & GICV3_LR_HW)
+            return false;
+    }
+
+    return true;
+}
+
+static uint64_t model_rec_enter(const uint64_t *args)
+{
+    model_rec_ts *rec = model_rec(args[1]);
+    uint64_t run = args[2];
+    model_realm_ts *realm;
+
+    if (!rec || !model_ns_valid(run))
+        return MODEL_ERROR_INPUT;
+
+    realm = (model_realm_ts *)rec->rd;
+    if (realm->state == REALM_NEW)
+        return MODEL_ERROR_REALM;
+    if (realm->state == REALM_SYSTEM_OFF)
+        return MODEL_STATUS(MODEL_ERROR_REALM, 1);
+    if (!rec->runnable || rec->running || rec->aborted || rec->psci_pending ||
+        !model_run_valid(run) || !model_image_switch(rec->rd))
+        return MODEL_ERROR_REC;
+
+    rec->run = run;
+    memset(model_run(rec, RUN_EXIT), 0, RUN_EXIT_SIZE);
+    rec->running = true;
+    image_running++;
+
+    if (!rec->started)
+    {
+        rec->started = true;
+        if (pthread_create(&rec->thread, NULL, model_rec_thread, rec))
+        {
+            rec->started = false;
+            rec->running = false;
+            image_running--;
+            return MODEL_ERROR_REC;
+        }
+    } else
+    {
+        sem_post(&rec->enter_sem);
+    }
+
+    /* The REC runs until it exits, RMI calls of other cpus go on */
+    pal_spin_unlock(&model_lock);
+    while (sem_wait(&rec->exit_sem) && errno == EINTR)
+        ;
+    pal_spin_lock(&model_lock);
+
+    rec->running = false;
+    image_running--;
+
+    return rec->aborted ? MODEL_ERROR_REC : MODEL_SUCCESS;
+}
+
+/**
+ *   @brief    Translate an IPA of a realm through its RTTs
+ *   @param    realm   - Realm descriptor
+ *   @param    ipa     - IPA accessed by the realm
+ *   @param    pa      - PA the IPA maps to
+ *   @return   True if the realm can access the IPA
+**/
+static bool model_ipa_translate(model_realm_ts *realm, uint64_t ipa, uint64_t *pa)
+{
+    model_walk_ts walk;
+    uint64_t entry;
+
+    if (!model_ipa_bound(realm, ipa))
+        return false;
+
+    model_rtt_walk(realm, ipa, MODEL_RTT_LEVEL_MAX, &walk);
+    entry = *walk.rtte;
+    *pa = RTTE_OA(entry) + (ipa & (model_level_size(walk.level) - 1));
+
+    if (model_ipa_protected(realm, ipa))
+        return RTTE_HIPAS(entry) == RTTE_ASSIGNED && RTTE_RIPAS(entry) == RIPAS_RAM;
+
+    return RTTE_HIPAS(entry) == RTTE_ASSIGNED_NS;
+}
+
+/**
+ *   @brief    Find the memory of an RSI input or output of the calling REC.
+ *             Its image data and its stack are used as they are, any other
+ *             address is a protected IPA.
+ *   @param    rec     - REC of the calling thread
+ *   @param    addr    - Address passed by the realm
+ *   @param    size    - Size of the object, within a granule
+ *   @return   Host address of the object, NULL if not accessible
+**/
+static void *model_realm_object(model_rec_ts *rec, uint64_t addr, uint64_t size)
+{
+    model_realm_ts *realm = (model_realm_ts *)rec->rd;
+    uint64_t pa;
+
+    if ((addr >= IMAGE_DATA_BASE && addr + size <= IMAGE_DATA_BASE + IMAGE_DATA_SIZE) ||
+        (addr >= rec->stack_base && addr + size <= rec->stack_top))
+        return (void *)addr;
+
+    if (!model_ipa_protected(realm, addr) ||
+        !model_ipa_translate(realm, addr & ~MODEL_GRANULE_MASK, &pa))
+        return NULL;
+
+    return (void *)(pa + (addr & MODEL_GRANULE_MASK));
+}
+
+/**
+ *   @brief    Stage 2 fault of a realm thread. An IPA the RTTs map is mapped
+ *             at the same address of the host and the access is made again,
+ *             any other IPA is a data abort REC exit.
+ *   @param    sig     - SIGSEGV
+ *   @param    info    - Faulting address
+ *   @param    context - Unused
+ *   @return   void
+**/
+static void model_realm_fault(int sig, siginfo_t *info, void *context)
+{
+    model_rec_ts *rec = model_current_rec;
+    uint64_t addr = (uint64_t)info->si_addr;
+    uint64_t ipa = addr & ~MODEL_GRANULE_MASK;
+    uint64_t pa;
+    uint32_t i;
+
+    (void)context;
+
+    /* A fault of the host, or of the model itself, is not a realm access */
+    if (!rec || sig != SIGSEGV || model_realm_call)
+    {
+        signal(SIGSEGV, SIG_DFL);
+        return;
+    }
+
+    pal_spin_lock(&model_lock);
+
+    for (i = 0; i < alias_count; i++)
+    {
+        if (alias[i] == ipa)
+        {
+            pal_spin_unlock(&model_lock);
+            return;
+        }
+    }
+
+    if (model_ipa_translate((model_realm_ts *)rec->rd, ipa, &pa))
+    {
+        if (pa < MODEL_NS_BASE || pa >= MODEL_NS_TOP)
+        {
+            pal_printf("\tREC access outside native memory, ipa=0x%lx pa=0x%lx\n", ipa, pa);
+            model_rec_abort(rec);
+        }
+
+        if (alias_count == MODEL_ALIAS_MAX)
+            model_alias_drop();
+        if (pal_native_map_alias(ipa, pa, MODEL_GRANULE_SIZE))
+        {
+            pal_printf("\tREC access to host memory, ipa=0x%lx\n", ipa, 0);
+            model_rec_abort(rec);
+        }
+        alias[alias_count++] = ipa;
+    } else
+    {
+        *model_run(rec, RUN_EXIT_REASON) = EXIT_SYNC;
+        *model_run(rec, RUN_EXIT_ESR) = EXIT_ESR_DATA_ABORT;
+        *model_run(rec, RUN_EXIT_HPFAR) = (ipa >> 12) << 4;
+        model_rec_exit(rec);
+    }
+
+    pal_spin_unlock(&model_lock);
+}
+
+static uint64_t model_rsi_version(const uint64_t *args, uint64_t *res)
+{
+    res[1] = RSI_VERSION;
+    res[2] = RSI_VERSION;
+    return args[1] == RSI_VERSION ? RSI_SUCCESS : RSI_ERROR_INPUT;
+}
+
+static uint64_t model_rsi_realm_config(model_rec_ts *rec, const uint64_t *args)
+{
+    model_realm_ts *realm = (model_realm_ts *)rec->rd;
+    uint64_t *config;
+
+    if (!model_aligned(args[1], MODEL_GRANULE_SIZE))
+        return RSI_ERROR_INPUT;
+
+    config = model_realm_object(rec, args[1], MODEL_GRANULE_SIZE);
+    if (!config)
+        return RSI_ERROR_INPUT;
+
+    memset(config, 0, MODEL_GRANULE_SIZE);
+    config[0] = realm->s2sz;
+    config[1] = realm->hash_algo;
+    return RSI_SUCCESS;
+}
+
+static uint64_t model_rsi_ipa_state_get(model_rec_ts *rec, const uint64_t *args,
+                                        uint64_t *res)
+{
+    model_realm_ts *realm = (model_realm_ts *)rec->rd;
+    model_walk_ts walk;
+
+    if (!model_aligned(args[1], MODEL_GRANULE_SIZE) || !model_ipa_protected(realm, args[1]))
+        return RSI_ERROR_INPUT;
+
+    model_rtt_walk(realm, args[1], MODEL_RTT_LEVEL_MAX, &walk);
+    res[1] = RTTE_RIPAS(*walk.rtte);
+    return RSI_SUCCESS;
+}
+
+static uint64_t model_rsi_ipa_state_set(model_rec_ts *rec, const uint64_t *args,
+                                        uint64_t *res)
+{
+    model_realm_ts *realm = (model_realm_ts *)rec->rd;
+    uint64_t base = args[1], top = args[2], ripas = args[3];
+
+    if (!model_aligned(base, MODEL_GRANULE_SIZE) || !model_aligned(top, MODEL_GRANULE_SIZE) ||
+        top <= base || !model_ipa_protected(realm, top - 1) ||
+        (ripas != RIPAS_EMPTY && ripas != RIPAS_RAM))
+        return RSI_ERROR_INPUT;
+
+    rec->ripas_addr = base;
+    rec->ripas_top = top;
+    rec->ripas_value = ripas;
+
+    *model_run(rec, RUN_EXIT_REASON) = EXIT_RIPAS_CHANGE;
+    *model_run(rec, RUN_EXIT_RIPAS_BASE) = base;
+    *model_run(rec, RUN_EXIT_RIPAS_TOP) = top;
+    *(uint8_t *)model_run(rec, RUN_EXIT_RIPAS_VALUE) = (uint8_t)ripas;
+    model_rec_exit(rec);
+
+    /* The host applied the change up to ripas_addr */
+    res[1] = rec->ripas_addr;
+    res[2] = (*model_run(rec, RUN_ENTER_FLAGS) & RUN_ENTER_RIPAS_RESPONSE) ? 1 : 0;
+    rec->ripas_top = 0;
+    return RSI_SUCCESS;
+}
+
+static uint64_t model_rsi_host_call(model_rec_ts *rec, const uint64_t *args)
+{
+    uint64_t *gprs;
+    uint8_t *call;
+    uint32_t i;
+
+    if (!model_aligned(args[1], HOST_CALL_ALIGN))
+        return RSI_ERROR_INPUT;
+
+    call = model_realm_object(rec, args[1], HOST_CALL_ALIGN);
+    if (!call)
+        return RSI_ERROR_INPUT;
+
+    gprs = (uint64_t *)(call + HOST_CALL_GPRS);
+    *model_run(rec, RUN_EXIT_REASON) = EXIT_HOST_CALL;
+    *(uint32_t *)model_run(rec, RUN_EXIT_IMM) = *(uint32_t *)call;
+    for (i = 0; i < RUN_GPRS; i++)
+        model_run(rec, RUN_EXIT_GPRS)[i] = gprs[i];
+    model_rec_exit(rec);
+
+    for (i = 0; i < RUN_GPRS; i++)
+        gprs[i] = model_run(rec, RUN_ENTER_GPRS)[i];
+    return RSI_SUCCESS;
+}
+
+/* Find the REC of a realm with an MPIDR */
+static model_rec_ts *model_rec_by_mpidr(uint64_t rd, uint64_t mpidr)
+{
+    model_rec_ts *rec;
+    uint64_t i;
+
+    for (i = 0; i < MODEL_POOL_GRANULES; i++)
+    {
+        if (granule[i].state != GRANULE_REC)
+            continue;
+        rec = (model_rec_ts *)(MODEL_POOL_BASE + i * MODEL_GRANULE_SIZE);
+        if (rec->rd == rd && rec->mpidr == mpidr)
+            return rec;
+    }
+
+    return NULL;
+}
+
+static uint64_t model_psci_exit(model_rec_ts *rec, const uint64_t *args)
+{
+    uint32_t i;
+
+    *model_run(rec, RUN_EXIT_REASON) = EXIT_PSCI;
+    for (i = 0; i < 4; i++)
+        model_run(rec, RUN_EXIT_GPRS)[i] = args[i];
+    model_rec_exit(rec);
+
+    return rec->psci_result;
+}
+
+static uint64_t model_realm_psci(model_rec_ts *rec, const uint64_t *args)
+{
+    model_realm_ts *realm = (model_realm_ts *)rec->rd;
+    uint64_t func = PAL_SMC_FID_FUNC(args[0]);
+
+    switch (func)
+    {
+        case PSCI_FUNC_VERSION:
+            return PSCI_VERSION_1_1;
+        case PSCI_FUNC_FEATURES:
+            func = PAL_SMC_FID_FUNC(args[1]);
+            return (func <= PSCI_FUNC_FEATURES && func != 0x5 && func != 0x6 && func != 0x7) ?
+                        PSCI_E_SUCCESS : (uint64_t)PSCI_E_NOT_SUPPORTED;
+        case PSCI_FUNC_CPU_SUSPEND:
+            rec->psci_result = PSCI_E_SUCCESS;
+            return model_psci_exit(rec, args);
+        case PSCI_FUNC_CPU_OFF:
+            rec->runnable = false;
+            model_psci_exit(rec, args);
+            /* Turned on again, the REC starts from the entry point */
+            pal_spin_unlock(&model_lock);
+            siglongjmp(rec->start, 1);
+        case PSCI_FUNC_CPU_ON:
+        case PSCI_FUNC_AFFINITY_INFO:
+            /* The entry point is an IPA, the lowest affinity level is 0 */
+            if (func == PSCI_FUNC_CPU_ON && !model_ipa_protected(realm, args[2]))
+                return (uint64_t)PSCI_E_INVALID_ADDRESS;
+            if ((func == PSCI_FUNC_AFFINITY_INFO && args[2]) ||
+                !model_rec_by_mpidr(rec->rd, args[1]))
+                return (uint64_t)PSCI_E_INVALID_PARAMS;
+            rec->psci_pending = true;
+            rec->psci_fid = args[0];
+            rec->psci_target = args[1];
+            return model_psci_exit(rec, args);
+        case PSCI_FUNC_SYSTEM_OFF:
+        case PSCI_FUNC_SYSTEM_RESET:
+            realm->state = REALM_SYSTEM_OFF;
+            model_psci_exit(rec, args);
+            model_rec_abort(rec);
+            return (uint64_t)PSCI_E_INTERN_FAIL;
+        default:
+            return (uint64_t)PSCI_E_NOT_SUPPORTED;
+    }
+}
+
+void pal_rmm_model_realm_call(uint64_t *regs, size_t count)
+{
+    model_rec_ts *rec = model_current_rec;
+    uint64_t args[PAL_RMM_MODEL_REALM_REGS] = {0}, func, ret;
+
+    if (count > PAL_RMM_MODEL_REALM_REGS)
+        count = PAL_RMM_MODEL_REALM_REGS;
+    memcpy(args, regs, count * sizeof(args[0]));
+    memset(&regs[1], 0, (count - 1) * sizeof(args[0]));
+
+    func = PAL_SMC_FID_FUNC(args[0]);
+    pal_spin_lock(&model_lock);
+    model_realm_call = true;
+    switch (func)
+    {
+        case RSI_FN_VERSION:
+            ret = model_rsi_version(args, regs);
+            break;
+        case RSI_FN_FEATURES:
+            ret = RSI_SUCCESS;
+            break;
+        case RSI_FN_REALM_CONFIG:
+            ret = model_rsi_realm_config(rec, args);
+            break;
+        case RSI_FN_IPA_STATE_GET:
+            ret = model_rsi_ipa_state_get(rec, args, regs);
+            break;
+        case RSI_FN_IPA_STATE_SET:
+            ret = model_rsi_ipa_state_set(rec, args, regs);
+            break;
+        case RSI_FN_HOST_CALL:
+            ret = model_rsi_host_call(rec, args);
+            break;
+        default:
+            ret = (func <= PAL_SMC_PSCI_FUNC_MAX) ? model_realm_psci(rec, args) :
+                                                    PAL_SMC_NOT_SUPPORTED;
+    }
+    model_realm_call = false;
+    pal_spin_unlock(&model_lock);
+
+    regs[0] = ret;
+}
+
+/* Common checks of the RTT commands that act on the parent of an RTT */
+static model_realm_ts *model_rtt_parent_args(uint64_t rd, uint64_t ipa, uint64_t level)
+{
+    model_realm_ts *realm = model_realm(rd);
+
+    if (!realm || level <= realm->rtt_level_start || level > MODEL_RTT_LEVEL_MAX ||
+        !model_aligned(ipa, model_level_size(level - 1)) || !model_ipa_bound(realm, ipa))
+        return NULL;
+
+    return realm;
+}
+
+static uint64_t model_rtt_create(const uint64_t *args)
+{
+    uint64_t rtt = args[2], ipa = args[3], level = args[4];
+    model_realm_ts *realm = model_rtt_parent_args(args[1], ipa, level);
+    uint64_t entry, child, *table, i;
+    model_walk_ts walk;
+
+    if (!realm || !model_granule_in(rtt, GRANULE_DELEGATED))
+        return MODEL_ERROR_INPUT;
+
+    model_rtt_walk(realm, ipa, level - 1, &walk);
+    if (walk.level < level - 1)
+        return MODEL_STATUS(MODEL_ERROR_RTT, walk.level);
+
+    entry = *walk.rtte;
+    if (RTTE_HIPAS(entry) == RTTE_TABLE)
+        return MODEL_STATUS(MODEL_ERROR_RTT, level - 1);
+
+    /* The new table inherits the parent entry, a block is unfolded */
+    model_granule_set(rtt, GRANULE_RTT);
+    table = (uint64_t *)rtt;
+    for (i = 0; i < MODEL_RTT_ENTRIES; i++)
+    {
+        child = entry;
+        if (RTTE_HIPAS(entry) != RTTE_UNASSIGNED)
+            child = entry + i * model_level_size(level);
+        model_rtte_set(rtt, &table[i], child);
+    }
+
+    model_rtte_set(walk.rtt, walk.rtte, RTTE(RTTE_TABLE, 0, rtt, 0));
+    return MODEL_SUCCESS;
+}
+
+static uint64_t model_rtt_destroy(const uint64_t *args, uint64_t *res)
+{
+    uint64_t ipa = args[2], level = args[3], rtt;
+    model_realm_ts *realm = model_rtt_parent_args(args[1], ipa, level);
+    model_walk_ts walk;
+
+    if (!realm)
+        return MODEL_ERROR_INPUT;
+
+    model_rtt_walk(realm, ipa, level - 1, &walk);
+    if (walk.level < level - 1 || RTTE_HIPAS(*walk.rtte) != RTTE_TABLE)
+    {
+        res[2] = model_walk_top(&walk, ipa);
+        return MODEL_STATUS(MODEL_ERROR_RTT, walk.level);
+    }
+
+    rtt = RTTE_OA(*walk.rtte);
+    if (model_granule(rtt)->refcount)
+    {
+        res[2] = model_walk_top(&walk, ipa);
+        return MODEL_STATUS(MODEL_ERROR_RTT, level);
+    }
+
+    model_rtte_set(walk.rtt, walk.rtte,
+                   RTTE(RTTE_UNASSIGNED,
+                        model_ipa_protected(realm, ipa) ? RIPAS_DESTROYED : RIPAS_EMPTY, 0, 0));
+    model_granule_set(rtt, GRANULE_DELEGATED);
+
+    res[1] = rtt;
+    res[2] = model_walk_top(&walk, ipa);
+    return MODEL_SUCCESS;
+}
+
+/**
+ *   @brief    Check that the entries of an RTT can be replaced by one entry
+ *             of its parent
+ *   @param    table   - RTT entries
+ *   @param    level   - Level of the RTT
+ *   @return   True if the entries are homogeneous
+**/
+static bool model_rtt_homogeneous(uint64_t *table, uint64_t level)
+{
+    uint64_t first = table[0], i;
+
+    switch (RTTE_HIPAS(first))
+    {
+        case RTTE_UNASSIGNED:
+            for (i = 1; i < MODEL_RTT_ENTRIES; i++)
+            {
+                if (table[i] != first)
+                    return false;
+            }
+            return true;
+        case RTTE_ASSIGNED:
+        case RTTE_ASSIGNED_NS:
+            if (level - 1 < MODEL_MIN_BLOCK_LEVEL ||
+                !model_aligned(RTTE_OA(first), model_level_size(level - 1)))
+                return false;
+            for (i = 1; i < MODEL_RTT_ENTRIES; i++)
+            {
+                if (table[i] != first + i * model_level_size(level))
+                    return false;
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+static uint64_t model_rtt_fold(const uint64_t *args, uint64_t *res)
+{
+    uint64_t ipa = args[2], level = args[3], rtt;
+    model_realm_ts *realm = model_rtt_parent_args(args[1], ipa, level);
+    model_walk_ts walk;
+
+    if (!realm)
+        return MODEL_ERROR_INPUT;
+
+    model_rtt_walk(realm, ipa, level - 1, &walk);
+    if (walk.level < level - 1 || RTTE_HIPAS(*walk.rtte) != RTTE_TABLE)
+        return MODEL_STATUS(MODEL_ERROR_RTT, walk.level);
+
+    rtt = RTTE_OA(*walk.rtte);
+    if (!model_rtt_homogeneous((uint64_t *)rtt, level))
+        return MODEL_STATUS(MODEL_ERROR_RTT, level);
+
+    model_rtte_set(walk.rtt, walk.rtte, *(uint64_t *)rtt);
+    model_granule_set(rtt, GRANULE_DELEGATED);
+
+    res[1] = rtt;
+    return MODEL_SUCCESS;
+}
+
+static uint64_t model_rtt_read_entry(const uint64_t *args, uint64_t *res)
+{
+    model_realm_ts *realm = model_realm(args[1]);
+    uint64_t ipa = args[2], level = args[3], entry;
+    model_walk_ts walk;
+
+    if (!realm || level < realm->rtt_level_start || level > MODEL_RTT_LEVEL_MAX ||
+        !model_aligned(ipa, model_level_size(level)) || !model_ipa_bound(realm, ipa))
+        return MODEL_ERROR_INPUT;
+
+    model_rtt_walk(realm, ipa, level, &walk);
+    entry = *walk.rtte;
+
+    res[1] = walk.level;
+    res[4] = RIPAS_EMPTY;
+    switch (RTTE_HIPAS(entry))
+    {
+        case RTTE_UNASSIGNED:
+            res[2] = RTTE_UNASSIGNED;
+            res[4] = RTTE_RIPAS(entry);
+            break;
+        case RTTE_ASSIGNED:
+            res[2] = RTTE_ASSIGNED;
+            res[3] = RTTE_OA(entry);
+            res[4] = RTTE_RIPAS(entry);
+            break;
+        case RTTE_TABLE:
+            res[2] = RTTE_TABLE;
+            res[3] = RTTE_OA(entry);
+            break;
+        default:
+            res[2] = RTTE_ASSIGNED;
+            res[3] = RTTE_OA(entry) | (RTTE_ATTR(entry) << 2);
+    }
+
+    return MODEL_SUCCESS;
+}
+
+static uint64_t model_rtt_init_ripas(const uint64_t *args, uint64_t *res)
+{
+    model_realm_ts *realm = model_realm(args[1]);
+    uint64_t base = args[2], top = args[3], addr, size, *rtte;
+    model_walk_ts walk;
+
+    if (!realm)
+        return MODEL_ERROR_INPUT;
+    if (realm->state != REALM_NEW)
+        return MODEL_ERROR_REALM;
+    if (!model_aligned(base, MODEL_GRANULE_SIZE) || !model_aligned(top, MODEL_GRANULE_SIZE) ||
+        top <= base || !model_ipa_protected(realm, top - 1))
+        return MODEL_ERROR_INPUT;
+
+    model_rtt_walk(realm, base, MODEL_RTT_LEVEL_MAX, &walk);
+    size = model_level_size(walk.level);
+    if (!model_aligned(base, size) || !model_aligned(top, size))
+        return MODEL_STATUS(MODEL_ERROR_RTT, walk.level);
+
+    /* Entries of the RTT reached by the walk, up to the first assigned one */
+    rtte = walk.rtte;
+    for (addr = base; addr + size <= top && RTTE_HIPAS(*rtte) == RTTE_UNASSIGNED;
+         addr += size, rtte++)
+    {
+        *rtte = RTTE(RTTE_UNASSIGNED, RIPAS_RAM, 0, 0);
+        if (((addr + size) >> model_level_shift(walk.level)) % MODEL_RTT_ENTRIES == 0)
+        {
+            addr += size;
+            break;
+        }
+    }
+
+    if (addr == base)
+        return MODEL_STATUS(MODEL_ERROR_RTT, walk.level);
+
+    res[1] = addr;
+    return MODEL_SUCCESS;
+}
+
+static uint64_t model_rtt_set_ripas(const uint64_t *args, uint64_t *res)
+{
+    model_realm_ts *realm = model_realm(args[1]);
+    model_rec_ts *rec = model_rec(args[2]);
+    uint64_t base = args[3], top = args[4], addr, size, *rtte;
+    model_walk_ts walk;
+
+    if (!realm || !rec)
+        return MODEL_ERROR_INPUT;
+    if (rec->rd != args[1])
+        return MODEL_ERROR_REC;
+
+    /* The range is the next part of the change the REC requested */
+    if (top <= base || !rec->ripas_top || base != rec->ripas_addr ||
+        top > rec->ripas_top || !model_aligned(top, MODEL_GRANULE_SIZE))
+        return MODEL_ERROR_INPUT;
+
+    model_rtt_walk(realm, base, MODEL_RTT_LEVEL_MAX, &walk);
+    size = model_level_size(walk.level);
+    if (!model_aligned(base, size) || !model_aligned(top, size))
+        return MODEL_STATUS(MODEL_ERROR_RTT, walk.level);
+
+    /* Entries of the RTT reached by the walk that the range covers */
+    rtte = walk.rtte;
+    for (addr = base; addr + size <= top && RTTE_HIPAS(*rtte) != RTTE_TABLE;
+         addr += size, rtte++)
+    {
+        model_rtte_set(walk.rtt, rtte, (*rtte & ~(0x3ULL << 2)) | (rec->ripas_value << 2));
+        if (((addr + size) >> model_level_shift(walk.level)) % MODEL_RTT_ENTRIES == 0)
+        {
+            addr += size;
+            break;
+        }
+    }
+
+    if (addr == base)
+        return MODEL_STATUS(MODEL_ERROR_RTT, walk.level);
+
+    rec->ripas_addr = addr;
+    res[1] = addr;
+    return MODEL_SUCCESS;
+}
+
+static uint64_t model_data_create(const uint64_t *args, bool unknown)
+{
+    uint64_t rd = args[1], data = args[2], ipa = args[3], src = args[4];
+    model_realm_ts *realm;
+    model_walk_ts walk;
+    uint64_t ripas;
+
+    if ((!unknown && !model_ns_valid(src)) || !model_granule_in(data, GRANULE_DELEGATED))
+        return MODEL_ERROR_INPUT;
+
+    realm = model_realm(rd);
+    if (!realm || !model_aligned(ipa, MODEL_GRANULE_SIZE) || !model_ipa_protected(realm, ipa))
+        return MODEL_ERROR_INPUT;
+    if (!unknown && realm->state != REALM_NEW)
+        return MODEL_ERROR_REALM;
+
+    model_rtt_walk(realm, ipa, MODEL_RTT_LEVEL_MAX, &walk);
+    if (walk.level < MODEL_RTT_LEVEL_MAX)
+        return MODEL_STATUS(MODEL_ERROR_RTT, walk.level);
+    if (RTTE_HIPAS(*walk.rtte) != RTTE_UNASSIGNED)
+        return MODEL_STATUS(MODEL_ERROR_RTT, MODEL_RTT_LEVEL_MAX);
+
+    model_granule_set(data, GRANULE_DATA);
+    if (unknown)
+    {
+        ripas = RTTE_RIPAS(*walk.rtte);
+    } else
+    {
+        memcpy((void *)data, (void *)src, MODEL_GRANULE_SIZE);
+        ripas = RIPAS_RAM;
+    }
+    model_rtte_set(walk.rtt, walk.rtte, RTTE(RTTE_ASSIGNED, ripas, data, 0));
+
+    return MODEL_SUCCESS;
+}
+
+static uint64_t model_data_destroy(const uint64_t *args, uint64_t *res)
+{
+    model_realm_ts *realm = model_realm(args[1]);
+    uint64_t ipa = args[2], data, ripas;
+    model_walk_ts walk;
+
+    if (!realm || !model_aligned(ipa, MODEL_GRANULE_SIZE) || !model_ipa_protected(realm, ipa))
+        return MODEL_ERROR_INPUT;
+
+    model_rtt_walk(realm, ipa, MODEL_RTT_LEVEL_MAX, &walk);
+    if (walk.level < MODEL_RTT_LEVEL_MAX)
+    {
+        res[2] = model_walk_top(&walk, ipa);
+        return MODEL_STATUS(MODEL_ERROR_RTT, walk.level);
+    }
+    if (RTTE_HIPAS(*walk.rtte) != RTTE_ASSIGNED)
+    {
+        res[2] = model_walk_top(&walk, ipa);
+        return MODEL_STATUS(MODEL_ERROR_RTT, MODEL_RTT_LEVEL_MAX);
+    }
+
+    data = RTTE_OA(*walk.rtte);
+    ripas = RTTE_RIPAS(*walk.rtte) == RIPAS_RAM ? RIPAS_DESTROYED : RTTE_RIPAS(*walk.rtte);
+    model_rtte_set(walk.rtt, walk.rtte, RTTE(RTTE_UNASSIGNED, ripas, 0, 0));
+    model_granule_set(data, GRANULE_DELEGATED);
+
+    res[1] = data;
+    res[2] = model_walk_top(&walk, ipa);
+    return MODEL_SUCCESS;
+}
+
+/* Common checks of the unprotected mapping commands */
+static model_realm_ts *model_unprotected_args(uint64_t rd, uint64_t ipa, uint64_t level)
+{
+    model_realm_ts *realm = model_realm(rd);
+
+    if (!realm || level < MODEL_MIN_BLOCK_LEVEL || level > MODEL_RTT_LEVEL_MAX ||
+        !model_aligned(ipa, model_level_size(level)) || model_ipa_protected(realm, ipa) ||
+        !model_ipa_bound(realm, ipa))
+        return NULL;
+
+    return realm;
+}
+
+static uint64_t model_rtt_map_unprotected(const uint64_t *args)
+{
+    uint64_t ipa = args[2], level = args[3], desc = args[4];
+    model_realm_ts *realm = model_unprotected_args(args[1], ipa, level);
+    model_walk_ts walk;
+
+    if (!realm || (desc & ~NS_DESC_VALID_MASK) ||
+        !model_aligned(RTTE_OA(desc), model_level_size(level)))
+        return MODEL_ERROR_INPUT;
+
+    model_rtt_walk(realm, ipa, level, &walk);
+    if (walk.level < level)
+        return MODEL_STATUS(MODEL_ERROR_RTT, walk.level);
+    if (RTTE_HIPAS(*walk.rtte) != RTTE_UNASSIGNED)
+        return MODEL_STATUS(MODEL_ERROR_RTT, level);
+
+    model_rtte_set(walk.rtt, walk.rtte,
+                   RTTE(RTTE_ASSIGNED_NS, 0, RTTE_OA(desc), NS_DESC_ATTR(desc)));
+    return MODEL_SUCCESS;
+}
+
+static uint64_t model_rtt_unmap_unprotected(const uint64_t *args, uint64_t *res)
+{
+    uint64_t ipa = args[2], level = args[3];
+    model_realm_ts *realm = model_unprotected_args(args[1], ipa, level);
+    model_walk_ts walk;
+
+    if (!realm)
+        return MODEL_ERROR_INPUT;
+
+    model_rtt_walk(realm, ipa, level, &walk);
+    if (walk.level < level)
+    {
+        res[1] = model_walk_top(&walk, ipa);
+        return MODEL_STATUS(MODEL_ERROR_RTT, walk.level);
+    }
+    if (RTTE_HIPAS(*walk.rtte) != RTTE_ASSIGNED_NS)
+    {
+        res[1] = model_walk_top(&walk, ipa);
+        return MODEL_STATUS(MODEL_ERROR_RTT, level);
+    }
+
+    model_rtte_set(walk.rtt, walk.rtte, RTTE_UNASSIGNED);
+    res[1] = model_walk_top(&walk, ipa);
+    return MODEL_SUCCESS;
+}
+
+static uint64_t model_psci_complete(const uint64_t *args)
+{
+    model_rec_ts *calling = model_rec(args[1]);
+    model_rec_ts *target = model_rec(args[2]);
+
+    uint64_t status = args[3];
+    uint64_t func;
+
+    if (!calling || !target || calling->rd != target->rd || !calling->psci_pending ||
+        calling->psci_target != target->mpidr)
+        return MODEL_ERROR_INPUT;
+
+    func = PAL_SMC_FID_FUNC(calling->psci_fid);
+    if (status != PSCI_E_SUCCESS &&
+        (func != PSCI_FUNC_CPU_ON || status != (uint64_t)PSCI_E_DENIED))
+        return MODEL_ERROR_INPUT;
+
+    if (func == PSCI_FUNC_CPU_ON)
+    {
+        if (status != PSCI_E_SUCCESS)
+            calling->psci_result = status;
+        else if (target->runnable)
+            calling->psci_result = (uint64_t)PSCI_E_ALREADY_ON;
+        else
+        {
+            target->runnable = true;
+            calling->psci_result = PSCI_E_SUCCESS;
+        }
+    } else
+    {
+        /* AFFINITY_INFO: ON or OFF */
+        calling->psci_result = target->runnable ? 0 : 1;
+    }
+
+    calling->psci_pending = false;
+    return MODEL_SUCCESS;
+}
+
+static uint64_t model_version(const uint64_t *args, uint64_t *res)
+{
+    uint64_t req = args[1];
+
+    res[1] = MODEL_VERSION;
+    res[2] = MODEL_VERSION;
+    return req == MODEL_VERSION ? MODEL_SUCCESS : MODEL_ERROR_INPUT;
+}
+
+static uint64_t model_features(const uint64_t *args, uint64_t *res)
+{
+    res[1] = args[1] == 0 ? MODEL_FEATURE_REG0 : 0;
+    return MODEL_SUCCESS;
+}
+
+void pal_rmm_model_call(uint64_t *regs)
+{
+    uint64_t args[PAL_RMM_MODEL_REGS], ret;
+
+    /*
+     * Commands read their inputs from args and set only the outputs they
+     * return. The others read as zero, as they do from the RMM, including
+     * the outputs of a command that fails.
+     */
+    memcpy(args, regs, sizeof(args));
+    memset(&regs[1], 0, sizeof(args) - sizeof(args[0]));
+
+    pal_spin_lock(&model_lock);
+    switch (PAL_SMC_FID_FUNC(args[0]))
+    {
+        case RMI_FN_VERSION:
+            ret = model_version(args, regs);
+            break;
+        case RMI_FN_FEATURES:
+            ret = model_features(args, regs);
+            break;
+        case RMI_FN_GRANULE_DELEGATE:
+            ret = model_granule_delegate(args);
+            break;
+        case RMI_FN_GRANULE_UNDELEGATE:
+            ret = model_granule_undelegate(args);
+            break;
+        case RMI_FN_REALM_CREATE:
+            ret = model_realm_create(args);
+            break;
+        case RMI_FN_REALM_ACTIVATE:
+            ret = model_realm_activate(args);
+            break;
+        case RMI_FN_REALM_DESTROY:
+            ret = model_realm_destroy(args);
+            break;
+        case RMI_FN_REC_AUX_COUNT:
+            ret = model_rec_aux_count(args, regs);
+            break;
+        case RMI_FN_REC_CREATE:
+            ret = model_rec_create(args);
+            break;
+        case RMI_FN_REC_DESTROY:
+            ret = model_rec_destroy(args);
+            break;
+        case RMI_FN_REC_ENTER:
+            ret = model_rec_enter(args);
+            break;
+        case RMI_FN_RTT_CREATE:
+            ret = model_rtt_create(args);
+            break;
+        case RMI_FN_RTT_DESTROY:
+            ret = model_rtt_destroy(args, regs);
+            break;
+        case RMI_FN_RTT_FOLD:
+            ret = model_rtt_fold(args, regs);
+            break;
+        case RMI_FN_RTT_READ_ENTRY:
+            ret = model_rtt_read_entry(args, regs);
+            break;
+        case RMI_FN_RTT_INIT_RIPAS:
+            ret = model_rtt_init_ripas(args, regs);
+            break;
+        case RMI_FN_RTT_SET_RIPAS:
+            ret = model_rtt_set_ripas(args, regs);
+            break;
+        case RMI_FN_DATA_CREATE:
+            ret = model_data_create(args, false);
+            break;
+        case RMI_FN_DATA_CREATE_UNKNOWN:
+            ret = model_data_create(args, true);
+            break;
+        case RMI_FN_DATA_DESTROY:
+            ret = model_data_destroy(args, regs);
+            break;
+        case RMI_FN_RTT_MAP_UNPROTECTED:
+            ret = model_rtt_map_unprotected(args);
+            break;
+        case RMI_FN_RTT_UNMAP_UNPROTECTED:
+            ret = model_rtt_unmap_unprotected(args, regs);
+            break;
+        case RMI_FN_PSCI_COMPLETE:
+            ret = model_psci_complete(args);
+            break;
+        default:
+            ret = PAL_SMC_NOT_SUPPORTED;
+    }
+    pal_spin_unlock(&model_lock);
+
+    regs[0] = ret;
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "pal_native.h"
+#include "pal_rmm_model.h"
+
+/*
+ * Replay of a recorded RMI sequence against the RMM model. Only host RMI
+ * calls are replayed, realm code is not replayed so RSI calls, PSCI calls and
+ * REC enter are skipped. The NS parameter granules captured with the create
+ * commands are written back before the call, every other NS input reads
+ * zeroed memory.
+ */
+
+#define REPLAY_SECURITY_STATE_HOST 1
+#define REPLAY_FN_REALM_CREATE     0x158
+#define REPLAY_FN_REC_CREATE       0x15a
+#define REPLAY_FN_REC_ENTER        0x15c
+
+typedef struct {
+    uint16_t func;
+    const char *name;
+    /* Output registers after x0 */
+    uint8_t outputs;
+    /* Outputs are defined when the command fails */
+    bool on_error;
+} replay_cmd_t;
+
+static const replay_cmd_t replay_cmd[] = {
+    {0x150, "RMI_VERSION",               2, true},
+    {0x151, "RMI_GRANULE_DELEGATE",      0, false},
+    {0x152, "RMI_GRANULE_UNDELEGATE",    0, false},
+    {0x153, "RMI_DATA_CREATE",           0, false},
+    {0x154, "RMI_DATA_CREATE_UNKNOWN",   0, false},
+    {0x155, "RMI_DATA_DESTROY",          2, true},
+    {0x157, "RMI_REALM_ACTIVATE",        0, false},
+    {0x158, "RMI_REALM_CREATE",          0, false},
+    {0x159, "RMI_REALM_DESTROY",         0, false},
+    {0x15a, "RMI_REC_CREATE",            0, false},
+    {0x15b, "RMI_REC_DESTROY",           0, false},
+    {0x15c, "RMI_REC_ENTER",             0, false},
+    {0x15d, "RMI_RTT_CREATE",            0, false},
+    {0x15e, "RMI_RTT_DESTROY",           2, true},
+    {0x15f, "RMI_RTT_MAP_UNPROTECTED",   0, false},
+    {0x161, "RMI_RTT_READ_ENTRY",        4, false},
+    {0x162, "RMI_RTT_UNMAP_UNPROTECTED", 1, true},
+    {0x164, "RMI_PSCI_COMPLETE",         0, false},
+    {0x165, "RMI_FEATURES",              1, false},
+    {0x166, "RMI_RTT_FOLD",              1, false},
+    {0x167, "RMI_REC_AUX_COUNT",         1, false},
+    {0x168, "RMI_RTT_INIT_RIPAS",        1, false},
+    {0x169, "RMI_RTT_SET_RIPAS",         1, false},
+};
+
+static const replay_cmd_t *replay_cmd_lookup(uint64_t fid)
+{
+    uint32_t i;
+
+    if (PAL_SMC_FID_OWNER(fid) != PAL_SMC_OWNER_STD)
+        return NULL;
+
+    for (i = 0; i < sizeof(replay_cmd) / sizeof(replay_cmd[0]); i++)
+    {
+        if (replay_cmd[i].func == PAL_SMC_FID_FUNC(fid))
+            return &replay_cmd[i];
+    }
+
+    return NULL;
+}
+
+/**
+ *   @brief    Write a captured parameter granule back to NS memory
+ *   @param    rec     - Record of the create command
+ *   @param    page    - Captured granule
+ *   @return   void
+**/
+static void replay_restore_page(pal_rmm_trace_rec_t *rec, uint8_t *page)
+{
+    uint64_t params;
+
+    if (PAL_SMC_FID_FUNC(rec->fid) == REPLAY_FN_REALM_CREATE)
+        params = rec->in[1];
+    else if (PAL_SMC_FID_FUNC(rec->fid) == REPLAY_FN_REC_CREATE)
+        params = rec->in[2];
+    else
+        return;
+
+    if (params >= PLATFORM_NORMAL_WORLD_IMAGE_BASE &&
+        params + PAL_RMM_TRACE_PAGE_SIZE <= PLATFORM_MEMORY_POOL_BASE + PLATFORM_MEMORY_POOL_SIZE)
+        memcpy((void *)params, page, PAL_RMM_TRACE_PAGE_SIZE);
+}
+
+/**
+ *   @brief    Compare the model response with the recorded one
+ *   @param    index   - Position of the record in the trace
+ *   @param    cmd     - Command of the record
+ *   @param    rec     - Record
+ *   @param    regs    - Model response
+ *   @return   true if they match
+**/
+static bool replay_compare(uint64_t index, const replay_cmd_t *cmd,
+                           pal_rmm_trace_rec_t *rec, uint64_t *regs)
+{
+    uint32_t i, count = 0;
+    bool match = true;
+
+    if (regs[0] == rec->out[0] && (regs[0] == 0 || cmd->on_error))
+        count = cmd->outputs;
+
+    for (i = 0; i <= count; i++)
+    {
+        if (regs[i] == rec->out[i])
+            continue;
+
+        printf("%" PRIu64 ": %s x%u expected 0x%" PRIx64 " got 0x%" PRIx64 "\n",
+               index, cmd->name, i, rec->out[i], regs[i]);
+        match = false;
+        if (i == 0)
+            break;
+    }
+
+    return match;
+}
+
+uint32_t pal_rmm_model_replay(const char *path)
+{
+    uint8_t page[PAL_RMM_TRACE_PAGE_SIZE];
+    uint64_t regs[PAL_RMM_MODEL_REGS];
+    uint64_t index = 0, replayed = 0, skipped = 0, mismatch = 0;
+    const replay_cmd_t *cmd;
+    pal_rmm_trace_hdr_t hdr;
+    pal_rmm_trace_rec_t rec;
+    FILE *trace;
+    uint32_t i;
+
+    trace = fopen(path, "rb");
+    if (trace == NULL)
+    {
+        perror(path);
+        return PAL_ERROR;
+    }
+
+    if (fread(&hdr, sizeof(hdr), 1, trace) != 1 ||
+        memcmp(hdr.magic, PAL_RMM_TRACE_MAGIC, sizeof(hdr.magic)) ||
+        hdr.version != PAL_RMM_TRACE_VERSION || hdr.rec_size != sizeof(rec))
+    {
+        printf("%s: not a version %d trace\n", path, PAL_RMM_TRACE_VERSION);
+        fclose(trace);
+        return PAL_ERROR;
+    }
+
+    for (; fread(&rec, sizeof(rec), 1, trace) == 1; index++)
+    {
+        if ((rec.flags & PAL_RMM_TRACE_FLAG_PAGE) &&
+            fread(page, sizeof(page), 1, trace) != 1)
+            break;
+
+        cmd = replay_cmd_lookup(rec.fid);
+        if (rec.security_state != REPLAY_SECURITY_STATE_HOST || cmd == NULL ||
+            cmd->func == REPLAY_FN_REC_ENTER)
+        {
+            skipped++;
+            continue;
+        }
+
+        if (rec.flags & PAL_RMM_TRACE_FLAG_PAGE)
+            replay_restore_page(&rec, page);
+
+        regs[0] = rec.fid;
+        for (i = 1; i < PAL_RMM_MODEL_REGS; i++)
+            regs[i] = rec.in[i - 1];
+
+        pal_rmm_model_call(regs);
+        replayed++;
+
+        if (!replay_compare(index, cmd, &rec, regs))
+            mismatch++;
+    }
+
+    fclose(trace);
+
+    printf("Replayed %" PRIu64 " calls, %" PRIu64 " mismatched, %" PRIu64 " skipped\n",
+           replayed, mismatch, skipped);
+
+    return mismatch ? PAL_ERROR : PAL_SUCCESS;
+}
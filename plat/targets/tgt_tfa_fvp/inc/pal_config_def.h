@@ -149,6 +149,11 @@
  */
 #define PLATFORM_GPF_SUPPORT_NS_EL2 0x0
 
+/* Set to 0 if the RMM of the platform cannot run realm code, the host then
+ * reports the tests that need a realm as skipped.
+ */
+#define PLATFORM_REALM_EXECUTION 0x1
+
 /*******************************************************************************
  * GIC-400 & interrupt handling related constants
  ******************************************************************************/
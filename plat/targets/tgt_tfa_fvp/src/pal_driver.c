@@ -10,14 +10,37 @@
 #include "pal_sp805_watchdog.h"
 #include "pal_nvm.h"
 
-#define pal_uart_putc(x) pal_driver_uart_pl011_putc(x)
+/* Characters formatted before they are written to the uart in one burst */
+#define PAL_PRINTF_LINE_LEN 128
+
+typedef struct {
+    uint8_t buffer[PAL_PRINTF_LINE_LEN];
+    size_t length;
+} pal_printf_line_t;
+
+static void pal_printf_flush(pal_printf_line_t *line)
+{
+    pal_driver_uart_pl011_write(line->buffer, line->length);
+    line->length = 0;
+}
+
+static void pal_printf_putc(pal_printf_line_t *line, uint8_t c)
+{
+    if (line->length == PAL_PRINTF_LINE_LEN)
+        pal_printf_flush(line);
+
+    line->buffer[line->length++] = c;
+}
 
 uint32_t pal_printf(const char *msg, uint64_t data1, uint64_t data2)
 {
+    pal_printf_line_t line;
     uint8_t buffer[16];
     uint64_t j, i = 0;
     uint64_t data = data1;
 
+    line.length = 0;
+
     for (; *msg != '\0'; ++msg)
     {
         if (*msg == '%')
@@ -51,22 +74,30 @@ uint32_t pal_printf(const char *msg, uint64_t data1, uint64_t data2)
             {
                 while (i > 0)
                 {
-                    pal_uart_putc(buffer[--i]);
+                    pal_printf_putc(&line, buffer[--i]);
                 }
             } else
             {
-                pal_uart_putc(48);
+                pal_printf_putc(&line, 48);
             }
         } else
         {
-            pal_uart_putc(*msg);
+            pal_printf_putc(&line, (uint8_t)*msg);
 
             if (*msg == '\n')
             {
-                pal_uart_putc('\r');
+                pal_printf_putc(&line, '\r');
             }
         }
     }
+
+    pal_printf_flush(&line);
+    return PAL_SUCCESS;
+}
+
+uint32_t pal_uart_write(const uint8_t *buffer, size_t size)
+{
+    pal_driver_uart_pl011_write(buffer, size);
     return PAL_SUCCESS;
 }
 
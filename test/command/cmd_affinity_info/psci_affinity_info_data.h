@@ -19,7 +19,7 @@ struct stimulus {
     uint64_t status;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "target_bound",
     .abi = PSCI_AFFINITY_INFO_AARCH64,
     .label = INVALID_LOWEST_AFFINITY_LEVEL,
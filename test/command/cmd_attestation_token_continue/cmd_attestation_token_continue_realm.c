@@ -85,7 +85,7 @@ static uint64_t size_bound_prep_sequence(uint64_t size)
     return size + 1;
 }
 
-static uint64_t intent_to_seq(struct stimulus *test_data, struct arguments *args)
+static uint64_t intent_to_seq(const struct stimulus *test_data, struct arguments *args)
 {
     enum test_intent label = test_data->label;
 
@@ -22,7 +22,7 @@ struct stimulus {
     uint64_t status;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "addr_align",
     .abi = RSI_ATTESTATION_TOKEN_CONTINUE,
     .label = ADDR_ALIGN,
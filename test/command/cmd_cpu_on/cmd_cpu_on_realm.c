@@ -52,7 +52,7 @@ static void valid_argument_prep_sequence(void)
     c_args.context_id_valid = CONTEXT_ID;
 }
 
-static uint64_t intent_to_seq(struct stimulus *test_data, struct arguments *args)
+static uint64_t intent_to_seq(const struct stimulus *test_data, struct arguments *args)
 {
     enum test_intent label = test_data->label;
 
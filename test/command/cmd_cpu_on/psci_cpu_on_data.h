@@ -20,7 +20,7 @@ struct stimulus {
     uint64_t status;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "entry",
     .abi = PSCI_CPU_ON_AARCH64,
     .label = ENTRY_ADDR_UNPROTECTED,
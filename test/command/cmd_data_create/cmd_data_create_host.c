@@ -225,7 +225,7 @@ static uint64_t valid_input_args_prep_sequence(void)
     return VAL_SUCCESS;
 }
 
-static uint64_t intent_to_seq(struct stimulus *test_data, struct arguments *args)
+static uint64_t intent_to_seq(const struct stimulus *test_data, struct arguments *args)
 {
     enum test_intent label = test_data->label;
 
@@ -41,7 +41,7 @@ struct stimulus {
     uint64_t index;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "data_align",
     .abi = RMI_DATA_CREATE_UNKNOWN,
     .label = DATA_UNALIGNED,
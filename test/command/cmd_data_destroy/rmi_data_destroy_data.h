@@ -33,7 +33,7 @@ struct stimulus {
     uint64_t index;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "rd_align",
     .abi = RMI_DATA_DESTROY,
     .label = RD_UNALIGNED,
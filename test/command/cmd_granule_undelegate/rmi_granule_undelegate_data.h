@@ -26,7 +26,7 @@ struct stimulus {
     uint64_t index;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "gran_align",
     .abi = RMI_GRANULE_UNDELEGATE,
     .label = ADDR_UNALIGNED,
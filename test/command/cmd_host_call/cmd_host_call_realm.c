@@ -38,7 +38,7 @@ static uint64_t address_unprotected_prep_sequence(void)
     return 1ULL << (ipa_width - 1);
 }
 
-static uint64_t intent_to_seq(struct stimulus *test_data, struct arguments *args)
+static uint64_t intent_to_seq(const struct stimulus *test_data, struct arguments *args)
 {
     enum test_intent label = test_data->label;
 
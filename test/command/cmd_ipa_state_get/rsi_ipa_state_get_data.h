@@ -19,7 +19,7 @@ struct stimulus {
     uint64_t status;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "addr_align",
     .abi = RSI_IPA_STATE_GET,
     .label = ADDR_UNALIGNED,
@@ -23,7 +23,7 @@ struct stimulus {
     uint64_t index;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "base_align",
     .abi = RSI_IPA_STATE_SET,
     .label = BASE_UNALIGNED,
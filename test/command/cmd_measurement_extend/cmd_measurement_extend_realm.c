@@ -44,7 +44,7 @@ static uint64_t size_bound_prep_sequence(void)
     return 65;
 }
 
-static uint64_t intent_to_seq(struct stimulus *test_data, struct arguments *args)
+static uint64_t intent_to_seq(const struct stimulus *test_data, struct arguments *args)
 {
     enum test_intent label = test_data->label;
 
@@ -29,7 +29,7 @@ static uint64_t index_bound_prep_sequence(void)
     return 5;
 }
 
-static uint64_t intent_to_seq(struct stimulus *test_data, struct arguments *args)
+static uint64_t intent_to_seq(const struct stimulus *test_data, struct arguments *args)
 {
     enum test_intent label = test_data->label;
 
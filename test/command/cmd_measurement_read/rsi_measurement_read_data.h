@@ -18,7 +18,7 @@ struct stimulus {
     uint64_t status;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "index_bound",
     .abi = RSI_MEASUREMENT_READ,
     .label = INDEX_BOUND,
@@ -39,7 +39,7 @@ struct stimulus {
     uint64_t index;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "alias",
     .abi = RMI_PSCI_COMPLETE,
     .label = ALIAS,
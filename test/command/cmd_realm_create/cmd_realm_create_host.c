@@ -74,7 +74,7 @@ static uint64_t g_params_prep_sequence(params_prep_seq_type type)
     params->s2sz = IPA_WIDTH;
     params->rtt_level_start = 1;
     params->rtt_num_start = 0;
-    params->vmid = 0;
+    params->vmid = val_host_realm_vmid(0);
     params->rtt_base = rtt_base;
 
     switch (type) {
@@ -226,7 +226,7 @@ static uint64_t g_params_prep_sequence(params_prep_seq_type type)
 
     /* Select a already used VMID to create a realm */
     case PARAMS_VMID_USED:
-        params->vmid = 1;
+        params->vmid = val_host_realm_vmid(1);
         break;
 
     default:
@@ -252,7 +252,7 @@ static uint64_t params_valid_prep_sequence(void)
     params->s2sz = IPA_WIDTH;
     params->rtt_num_start = 1;
     params->rtt_level_start = 0;
-    params->vmid = REALM_VALID;
+    params->vmid = val_host_realm_vmid(REALM_VALID);
     params->rtt_base = rtt0;
 
     return (uint64_t)params;
@@ -312,7 +312,7 @@ static uint64_t valid_input_args_prep_sequence(void)
     return VAL_SUCCESS;
 }
 
-static uint64_t intent_to_seq(struct stimulus *test_data, struct arguments *args)
+static uint64_t intent_to_seq(const struct stimulus *test_data, struct arguments *args)
 {
     enum test_intent label = test_data->label;
 
@@ -158,7 +158,7 @@ static uint64_t valid_input_args_prep_sequence(void)
     return VAL_SUCCESS;
 }
 
-static uint64_t intent_to_seq(struct stimulus *test_data, struct arguments *args)
+static uint64_t intent_to_seq(const struct stimulus *test_data, struct arguments *args)
 {
     enum test_intent label = test_data->label;
 
@@ -275,7 +275,7 @@ void cmd_realm_destroy_host(void)
     params->s2sz = realm[VALID_REALM].s2sz;
     params->rtt_level_start = realm[VALID_REALM].s2_starting_level;
     params->rtt_num_start = realm[VALID_REALM].num_s2_sl_rtts;
-    params->vmid = realm[VALID_REALM].vmid;
+    params->vmid = val_host_realm_vmid(realm[VALID_REALM].vmid);
 
     if (val_host_rmi_realm_create(c_args.rd_valid, (uint64_t)params))
     {
@@ -60,6 +60,8 @@ static uint64_t g_rec_ready_prep_sequence(void)
 {
     val_host_rec_params_ts rec_params;
 
+    realm_test[REALM_VALID].rec_count = 1;
+
     rec_params.pc = 0;
     rec_params.flags = RMI_RUNNABLE;
     rec_params.mpidr = 0;
@@ -82,7 +84,7 @@ static uint64_t valid_input_args_prep_sequence(void)
     return VAL_SUCCESS;
 }
 
-static uint64_t intent_to_seq(struct stimulus *test_data, struct arguments *args)
+static uint64_t intent_to_seq(const struct stimulus *test_data, struct arguments *args)
 {
     enum test_intent label = test_data->label;
 
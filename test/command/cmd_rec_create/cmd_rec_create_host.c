@@ -264,7 +264,7 @@ static uint64_t valid_input_args_prep_sequence(void)
 }
 
 
-static uint64_t intent_to_seq(struct stimulus *test_data, struct arguments *args)
+static uint64_t intent_to_seq(const struct stimulus *test_data, struct arguments *args)
 {
     enum test_intent label = test_data->label;
 
@@ -549,7 +549,8 @@ void cmd_rec_create_host(void)
                                   c_args.params_valid);
 
     /* Keep track of the REC for destruction */
-    realm_test[REALM_VALID].rec[0] = c_args.rec_valid;
+    if (!val_host_realm_reserve_recs(&realm_test[REALM_VALID], 1))
+        realm_test[REALM_VALID].rec[0] = c_args.rec_valid;
     /* Valid call should give success if footprints have not changed */
     if (ret != 0)
     {
@@ -50,7 +50,7 @@ struct stimulus {
     uint64_t index;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "params_align",
     .abi = RMI_REC_CREATE,
     .label = PARAMS_UNALIGNED,
@@ -31,6 +31,9 @@ struct arguments {
 
 static uint64_t g_rec_aux_prep_sequence(void)
 {
+    if (val_host_realm_reserve_recs(&realm[VALID_REALM], 2))
+        return VAL_TEST_PREP_SEQ_FAILED;
+
     /* Delegate granule for the REC */
     uint64_t rec = g_delegated_prep_sequence();
     if (rec == VAL_TEST_PREP_SEQ_FAILED)
@@ -115,7 +118,7 @@ static uint64_t valid_input_args_prep_sequence(void)
     return VAL_SUCCESS;
 }
 
-static uint64_t intent_to_seq(struct stimulus *test_data, struct arguments *args)
+static uint64_t intent_to_seq(const struct stimulus *test_data, struct arguments *args)
 {
     enum test_intent label = test_data->label;
 
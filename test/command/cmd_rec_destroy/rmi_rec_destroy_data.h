@@ -26,7 +26,7 @@ struct stimulus {
     uint64_t index;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "rec_align",
     .abi = RMI_REC_DESTROY,
     .label = REC_UNALIGNED,
@@ -67,6 +67,9 @@ static uint64_t g_rd_new_prep_sequence(uint16_t vmid)
 
 static uint64_t add_rec(uint64_t entry, uint64_t flags, uint64_t mpidr, uint64_t vmid)
 {
+    if (val_host_realm_reserve_recs(&realm_test[vmid], mpidr + 1))
+        return VAL_TEST_PREP_SEQ_FAILED;
+
     /* Delegate granule for the REC */
     uint64_t rec = g_delegated_prep_sequence();
     if (rec == VAL_TEST_PREP_SEQ_FAILED)
@@ -215,6 +218,9 @@ static uint64_t gicv3_invalid_prep_sequence(void)
 
 static uint64_t g_rec_aux_prep_sequence(void)
 {
+    if (val_host_realm_reserve_recs(&realm_test[NEW_REALM], 2))
+        return VAL_TEST_PREP_SEQ_FAILED;
+
     /* Delegate granule for the REC */
     uint64_t rec = g_delegated_prep_sequence();
     if (rec == VAL_TEST_PREP_SEQ_FAILED)
@@ -326,7 +332,7 @@ static uint64_t valid_input_args_prep_sequence(void)
     return VAL_SUCCESS;
 }
 
-static uint64_t intent_to_seq(struct stimulus *test_data, struct arguments *args)
+static uint64_t intent_to_seq(const struct stimulus *test_data, struct arguments *args)
 {
     enum test_intent label = test_data->label;
 
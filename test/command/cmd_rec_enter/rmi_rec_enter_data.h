@@ -47,7 +47,7 @@ struct stimulus {
     uint64_t index;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "run_align",
     .abi = RMI_REC_ENTER,
     .label = RUN_PTR_UNALIGNED,
@@ -40,7 +40,7 @@ struct stimulus {
     uint64_t index;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "rd_align",
     .abi = RMI_RTT_CREATE,
     .label = RD_UNALIGNED,
@@ -61,7 +61,7 @@ static uint64_t ipa_folded_rtt_prep_sequence(void)
     }
 
     data_create.size = L2_SIZE;
-    phys = (uint64_t)val_host_mem_alloc(L2_SIZE, L2_SIZE);
+    phys = (uint64_t)val_host_mem_alloc(L2_SIZE, 2 * L2_SIZE);
     if (!phys)
     {
         LOG(ERROR, "\tval_host_mem_alloc failed\n", 0, 0);
@@ -185,7 +185,7 @@ static uint64_t valid_input_args_prep_sequence(void)
     return VAL_SUCCESS;
 }
 
-static uint64_t intent_to_seq(struct stimulus *test_data, struct arguments *args)
+static uint64_t intent_to_seq(const struct stimulus *test_data, struct arguments *args)
 {
     enum test_intent label = test_data->label;
 
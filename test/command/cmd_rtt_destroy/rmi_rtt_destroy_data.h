@@ -34,7 +34,7 @@ struct stimulus {
     uint64_t index;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "rd_align",
     .abi = RMI_RTT_DESTROY,
     .label = RD_UNALIGNED,
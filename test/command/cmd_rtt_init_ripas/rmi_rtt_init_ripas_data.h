@@ -36,7 +36,7 @@ struct stimulus {
     uint64_t index;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "rd_align",
     .abi = RMI_RTT_INIT_RIPAS,
     .label = RD_UNALIGNED,
@@ -36,7 +36,7 @@ struct stimulus {
     uint64_t index;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "attr_valid",
     .abi = RMI_RTT_MAP_UNPROTECTED,
     .label = MEM_ATTR_INVALID,
@@ -9,6 +9,7 @@
 #include "val_host_rmi.h"
 #include "rmi_rtt_read_entry_data.h"
 #include "command_common_host.h"
+#include "val_host_shadow.h"
 
 #define IPA_WIDTH 40
 #define START_RTT_LEVEL 0
@@ -109,6 +110,7 @@ static uint64_t g_rec_ready_prep_sequence(uint64_t rd)
     val_host_realm_ts realm;
     val_host_rec_params_ts rec_params;
 
+    realm.rec_count = 1;
     realm.rd = rd;
     rec_params.pc = 0;
     rec_params.flags = RMI_RUNNABLE;
@@ -137,7 +139,7 @@ static uint64_t valid_input_args_prep_sequence(void)
     return VAL_SUCCESS;
 }
 
-static uint64_t intent_to_seq(struct stimulus *test_data, struct arguments *args)
+static uint64_t intent_to_seq(const struct stimulus *test_data, struct arguments *args)
 {
     enum test_intent label = test_data->label;
 
@@ -375,6 +377,23 @@ void cmd_rtt_read_entry_host(void)
         goto exit;
     }
 
+    LOG(TEST, "\n\tShadow Observability \n", 0, 0);
+
+    /* The host shadow of the entries read above matches RMM at every level */
+    uint64_t shadow_ipa[] = {c_args.ipa_valid, IPA_ADDR_DATA, IPA_ADDR_UNPROTECTED};
+
+    realm_test[VALID_REALM].s2sz = IPA_WIDTH;
+    realm_test[VALID_REALM].s2_starting_level = START_RTT_LEVEL;
+    for (i = 0; i < (sizeof(shadow_ipa) / sizeof(shadow_ipa[0])); i++) {
+        for (uint64_t level = START_RTT_LEVEL; level <= VAL_RTT_MAX_LEVEL; level++) {
+            if (val_host_shadow_check_entry(&realm_test[VALID_REALM], ADDR_ALIGN_DOWN(
+                      shadow_ipa[i], 1UL << VAL_RTT_LEVEL_SHIFT(level)), level)) {
+                val_set_status(RESULT_FAIL(VAL_ERROR_POINT(17)));
+                goto exit;
+            }
+        }
+    }
+
     val_set_status(RESULT_PASS(VAL_SUCCESS));
 
 exit:
@@ -29,7 +29,7 @@ struct stimulus {
     uint64_t index;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "rd_align",
     .abi = RMI_RTT_READ_ENTRY,
     .label = RD_UNALIGNED,
@@ -37,7 +37,7 @@ struct stimulus {
     uint64_t index;
 };
 
-static struct stimulus test_data[] = {
+static const struct stimulus test_data[] = {
     {.msg = "rd_align",
     .abi = RMI_RTT_UNMAP_UNPROTECTED,
     .label = RD_UNALIGNED,
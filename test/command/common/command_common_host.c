@@ -28,6 +28,8 @@ uint32_t val_host_realm_create_common(val_host_realm_ts *realm)
     val_host_realm_params_ts *params;
     uint64_t ret;
 
+    val_host_realm_clear(realm);
+
     /* Allocate and delegate RD */
     realm->rd = (uint64_t)val_host_mem_alloc(PAGE_SIZE, PAGE_SIZE);
     if (!realm->rd)
@@ -74,7 +76,7 @@ uint32_t val_host_realm_create_common(val_host_realm_ts *realm)
     params->s2sz = realm->s2sz;
     params->rtt_level_start = realm->s2_starting_level;
     params->rtt_num_start = realm->num_s2_sl_rtts;
-    params->vmid = realm->vmid;
+    params->vmid = val_host_realm_vmid(realm->vmid);
 
     /* Create realm */
     if (val_host_rmi_realm_create(realm->rd, (uint64_t)params))
@@ -119,11 +121,8 @@ uint32_t val_host_rec_create_common(val_host_realm_ts *realm, val_host_rec_param
 
     uint64_t ret, i, mpidr = 0x0, aux_count, j;
 
-    if (realm->rec_count > VAL_MAX_REC_COUNT)
-    {
-        LOG(ERROR, "\tmax supported recs are VAL_MAX_REC_COUNT\n", 0, 0);
+    if (val_host_realm_reserve_recs(realm, realm->rec_count))
         return VAL_ERROR;
-    }
 
     /* Get aux granules count */
     ret = val_host_rmi_rec_aux_count(realm->rd, &aux_count);
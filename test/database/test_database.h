@@ -23,26 +23,64 @@ typedef struct {
     test_fptr_t         host_fn; /* Host Test function */
     test_fptr_t         realm_fn; /* Realm Test function */
     test_fptr_t         secure_fn; /* Secure Test function */
+    uint32_t            id; /* TEST_ID_<testname>, 0 for a dummy entry */
+    uint32_t            tags; /* TEST_MP_UNSAFE, ..., TEST_TAG_SUITE(suite) */
 } test_db_t;
 
+/* The test runs alone, never in parallel with other tests on other PEs */
+#define TEST_MP_UNSAFE      (1U << 0)
+/* The test enters a realm */
+#define TEST_NEEDS_REALM    (1U << 1)
+/* The test calls the secure payload */
+#define TEST_NEEDS_SECURE   (1U << 2)
+
+/* Suite of a test, one tag bit per test/<suite> directory */
+enum {
+    TEST_SUITE_attestation_measurement,
+    TEST_SUITE_command,
+    TEST_SUITE_exception,
+    TEST_SUITE_gic,
+    TEST_SUITE_memory_management,
+    TEST_SUITE_perf,
+    TEST_SUITE_pmu_debug,
+};
+
+#define TEST_SUITE_SHIFT    8
+#define TEST_TAG_SUITE(suitename)   (1U << (TEST_SUITE_SHIFT + TEST_SUITE_##suitename))
+
+/* Registry ID of each test, its position in the declarations of test_list.h.
+   The IDs are the same in the host, realm and secure images of a build. */
+enum { TEST_ID_BASE = __COUNTER__ };
+
 #define DECLARE_TEST_FN(testname) \
     extern  void testname##_host(void);\
     extern  void testname##_realm(void);\
-    extern  void testname##_secure(void);
+    extern  void testname##_secure(void);\
+    enum { TEST_ID_##testname = __COUNTER__ - TEST_ID_BASE }
 
-#define HOST_TEST_ONLY(suitename, testname) \
-    {"Suite="#suitename" : ", #testname, testname##_host, NULL, NULL}
+#define HOST_TEST_ONLY(suitename, testname, tags) \
+    {"Suite="#suitename" : ", #testname, testname##_host, NULL, NULL, \
+     TEST_ID_##testname, TEST_TAG_SUITE(suitename) | (tags)}
 
 #define REALM_TEST_ONLY(suitename, testname) \
-    {" "#suitename, #testname, NULL, testname##_realm, NULL}
+    {" "#suitename, #testname, NULL, testname##_realm, NULL, \
+     TEST_ID_##testname, TEST_TAG_SUITE(suitename) | TEST_NEEDS_REALM}
 
 #define SECURE_TEST_ONLY(suitename, testname) \
-    {" "#suitename, #testname, NULL, NULL, testname##_secure}
+    {" "#suitename, #testname, NULL, NULL, testname##_secure, \
+     TEST_ID_##testname, TEST_TAG_SUITE(suitename) | TEST_NEEDS_SECURE}
 
 #define DUMMY_TEST(suitename, testname) \
-    {" ", " ", NULL, NULL, NULL}
+    {" ", " ", NULL, NULL, NULL, 0, 0}
 
 #define TEST_FUNC_DECLARATION
 #include "test_list.h"
 
+/* One past the highest registry ID */
+enum { TEST_ID_END = __COUNTER__ - TEST_ID_BASE };
+
+void val_test_registry_init(void);
+uint32_t val_test_index_by_id(uint32_t id);
+uint32_t val_test_index_by_name(const char *name);
+
 #endif /* _TEST_DATABASE_H_ */
@@ -8,16 +8,20 @@
 #include "test_database.h"
 
 #define TEST_FUNC_DATABASE
-#define HOST_TEST(x, y)              HOST_TEST_ONLY(x, y)
-#define HOST_REALM_TEST(x, y)        HOST_TEST_ONLY(x, y)
-#define HOST_SECURE_TEST(x, y)       HOST_TEST_ONLY(x, y)
-#define HOST_REALM_SECURE_TEST(x, y) HOST_TEST_ONLY(x, y)
+/* Realm and secure payloads find their test through the single test number
+   of the shared region, so only host only tests run in parallel */
+#define HOST_TEST(x, y)              HOST_TEST_ONLY(x, y, 0)
+#define HOST_TEST_MP_UNSAFE(x, y)    HOST_TEST_ONLY(x, y, TEST_MP_UNSAFE)
+#define HOST_REALM_TEST(x, y)        HOST_TEST_ONLY(x, y, TEST_MP_UNSAFE | TEST_NEEDS_REALM)
+#define HOST_SECURE_TEST(x, y)       HOST_TEST_ONLY(x, y, TEST_MP_UNSAFE | TEST_NEEDS_SECURE)
+#define HOST_REALM_SECURE_TEST(x, y) HOST_TEST_ONLY(x, y, \
+                                        TEST_MP_UNSAFE | TEST_NEEDS_REALM | TEST_NEEDS_SECURE)
 
 const test_db_t test_list[] = {
-    {"", "", NULL, NULL, NULL},
+    {"", "", NULL, NULL, NULL, 0, 0},
 
 #include "test_list.h"
-    {"", "", NULL, NULL, NULL},
+    {"", "", NULL, NULL, NULL, 0, 0},
 
 };
 
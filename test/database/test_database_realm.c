@@ -9,15 +9,16 @@
 
 #define TEST_FUNC_DATABASE
 #define HOST_TEST(x, y)              DUMMY_TEST(x, y)
+#define HOST_TEST_MP_UNSAFE(x, y)    DUMMY_TEST(x, y)
 #define HOST_REALM_TEST(x, y)        REALM_TEST_ONLY(x, y)
 #define HOST_SECURE_TEST(x, y)       DUMMY_TEST(x, y)
 #define HOST_REALM_SECURE_TEST(x, y) REALM_TEST_ONLY(x, y)
 
 const test_db_t test_list[] = {
-    {"", "", NULL, NULL, NULL},
+    {"", "", NULL, NULL, NULL, 0, 0},
 
 #include "test_list.h"
-    {"", "", NULL, NULL, NULL},
+    {"", "", NULL, NULL, NULL, 0, 0},
 
 };
 
@@ -9,6 +9,7 @@
 
 #define TEST_FUNC_DATABASE
 #define HOST_TEST(x, y)              DUMMY_TEST(x, y)
+#define HOST_TEST_MP_UNSAFE(x, y)    DUMMY_TEST(x, y)
 #define HOST_REALM_TEST(x, y)        DUMMY_TEST(x, y)
 #define HOST_SECURE_TEST(x, y)       SECURE_TEST_ONLY(x, y)
 #define HOST_REALM_SECURE_TEST(x, y) SECURE_TEST_ONLY(x, y)
@@ -19,10 +20,10 @@
 #endif
 
 const test_db_t test_list[] = {
-    {"", "", NULL, NULL, NULL},
+    {"", "", NULL, NULL, NULL, 0, 0},
 
 #include "test_list.h"
-    {"", "", NULL, NULL, NULL},
+    {"", "", NULL, NULL, NULL, 0, 0},
 
 };
 
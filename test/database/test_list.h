@@ -62,7 +62,7 @@ DECLARE_TEST_FN(cmd_secure_test);
 DECLARE_TEST_FN(measurement_immutable_rim);
 DECLARE_TEST_FN(measurement_initial_rem_is_zero);
 DECLARE_TEST_FN(measurement_rim_order);
-DECLARE_TEST_FN(attestation_token_verify)
+DECLARE_TEST_FN(attestation_token_verify);
 DECLARE_TEST_FN(attestation_rpv_value);
 DECLARE_TEST_FN(attestation_challenge_data_verification);
 DECLARE_TEST_FN(attestation_token_init);
@@ -97,6 +97,7 @@ DECLARE_TEST_FN(mm_feat_s2fwb_check_2);
 DECLARE_TEST_FN(mm_feat_s2fwb_check_3);
 DECLARE_TEST_FN(mm_ha_hd_access);
 DECLARE_TEST_FN(mm_realm_access_outside_ipa);
+DECLARE_TEST_FN(mm_map_range_large);
 /*memory management testcase declaration ends here*/
 
 /*Exception model declaration starts here*/
@@ -131,6 +132,16 @@ DECLARE_TEST_FN(gic_ctrl_hcr);
 DECLARE_TEST_FN(pmu_overflow);
 /*PMU and DEBUG testcase declaration ends here*/
 
+/*Performance benchmark declaration starts here*/
+DECLARE_TEST_FN(perf_granule_delegate);
+DECLARE_TEST_FN(perf_data_create);
+DECLARE_TEST_FN(perf_rtt_create);
+DECLARE_TEST_FN(perf_rec_create);
+DECLARE_TEST_FN(perf_rec_round_trip);
+DECLARE_TEST_FN(perf_ipa_state_set);
+DECLARE_TEST_FN(perf_libc);
+/*Performance benchmark declaration ends here*/
+
 #else /* TEST_FUNC_DATABASE */
 /* Add test funcs to the respective host/realm/secure test_list array */
 #if (defined(d_all) || defined(d_command))
@@ -404,7 +415,7 @@ DECLARE_TEST_FN(pmu_overflow);
     HOST_REALM_TEST(memory_management, mm_hipas_unassigned_ns_da_ia),
     #endif
     #if (defined(TEST_COMBINE) || defined(d_mm_gpf_exception))
-    HOST_TEST(memory_management, mm_gpf_exception),
+    HOST_TEST_MP_UNSAFE(memory_management, mm_gpf_exception),
     #endif
     #if (defined(TEST_COMBINE) || defined(d_mm_unprotected_ipa_boundary))
     HOST_REALM_TEST(memory_management, mm_unprotected_ipa_boundary),
@@ -451,7 +462,36 @@ DECLARE_TEST_FN(pmu_overflow);
     #if (defined(TEST_COMBINE) || defined(d_mm_rtt_fold_assigned_ns))
     HOST_REALM_TEST(memory_management, mm_rtt_fold_assigned_ns),
     #endif
+    #if (defined(TEST_COMBINE) || defined(d_mm_map_range_large))
+    HOST_TEST(memory_management, mm_map_range_large),
+    #endif
 
 #endif /* #if (defined(d_all) || defined(d_memory_management)) */
 
+/* Benchmarks are not compliance tests, they only run with -DSUITE=perf */
+#if defined(d_perf)
+    #if (defined(TEST_COMBINE) || defined(d_perf_granule_delegate))
+    HOST_TEST_MP_UNSAFE(perf, perf_granule_delegate),
+    #endif
+    #if (defined(TEST_COMBINE) || defined(d_perf_data_create))
+    HOST_TEST_MP_UNSAFE(perf, perf_data_create),
+    #endif
+    #if (defined(TEST_COMBINE) || defined(d_perf_rtt_create))
+    HOST_TEST_MP_UNSAFE(perf, perf_rtt_create),
+    #endif
+    #if (defined(TEST_COMBINE) || defined(d_perf_rec_create))
+    HOST_TEST_MP_UNSAFE(perf, perf_rec_create),
+    #endif
+    #if (defined(TEST_COMBINE) || defined(d_perf_rec_round_trip))
+    HOST_REALM_TEST(perf, perf_rec_round_trip),
+    #endif
+    #if (defined(TEST_COMBINE) || defined(d_perf_ipa_state_set))
+    HOST_REALM_TEST(perf, perf_ipa_state_set),
+    #endif
+    #if (defined(TEST_COMBINE) || defined(d_perf_libc))
+    HOST_TEST_MP_UNSAFE(perf, perf_libc),
+    #endif
+
+#endif /* #if defined(d_perf) */
+
 #endif /* TEST_FUNC_DATABASE */
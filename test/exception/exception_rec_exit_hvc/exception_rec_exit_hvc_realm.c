@@ -19,7 +19,13 @@ void exception_rec_exit_hvc_realm(void)
     g_sea_params.abort_type = EXCEPTION_ABORT_TYPE_HVC;
 
     /* HVC instruction execution in AArch64 state - Unkonwn exception taken to Realm */
+#ifdef LINUX_NATIVE_BUILD
+    /* The HVC instruction cannot be built for the native target */
+    val_set_status(RESULT_SKIP(VAL_SKIP_CHECK));
+    goto test_exit;
+#else
     __asm__("hvc #0");
+#endif
 
     if (g_sea_params.handler_abort) {
         LOG(TEST, "\tREALM handled the SEA(For HVC) successfully \n", 0, 0);
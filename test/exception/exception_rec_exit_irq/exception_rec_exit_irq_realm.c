@@ -6,15 +6,15 @@
  */
 #include "test_database.h"
 #include "val_realm_framework.h"
+#include "val_timer.h"
 
 void exception_rec_exit_irq_realm(void)
 {
-    uint64_t timeout = 0x1000000;
-
     /* Below code is executed for REC[0] only */
     LOG(DBG, "\tIn realm_create_realm REC[0], mpdir=%x\n", val_read_mpidr(), 0);
 
-    while (timeout--);
+    /* The interrupt exits to the host before the deadline */
+    val_wait_until(false, VAL_WAIT_EXIT_NS);
 
     val_realm_return_to_host();
 }
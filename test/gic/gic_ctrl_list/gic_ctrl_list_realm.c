@@ -7,8 +7,7 @@
 #include "test_database.h"
 #include "val_realm_framework.h"
 #include "val_irq.h"
-
-#define INTR_TIMEOUT 0x100000
+#include "val_timer.h"
 
 static volatile int handler_flag;
 
@@ -21,9 +20,7 @@ static int rmi_irq_handler(void)
 
 static int gic_eoir(uint32_t irq)
 {
-    uint64_t timeout = INTR_TIMEOUT;
-
-    while (--timeout && !handler_flag);
+    val_wait_until(handler_flag, VAL_WAIT_INTR_NS);
     if (handler_flag == 1)
     {
         handler_flag = 0;
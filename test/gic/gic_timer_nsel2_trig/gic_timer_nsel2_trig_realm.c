@@ -7,15 +7,15 @@
 #include "test_database.h"
 #include "val_realm_framework.h"
 #include "val_realm_rsi.h"
+#include "val_timer.h"
 
 void gic_timer_nsel2_trig_realm(void)
 {
-    uint64_t timeout = 0x100000000000000;
-
     /* Below code is executed for REC[0] only */
     LOG(DBG, "\tIn realm_create_realm REC[0], mpdir=%x\n", val_read_mpidr(), 0);
 
-    while (timeout--);
+    /* The interrupt exits to the host before the deadline */
+    val_wait_until(false, VAL_WAIT_EXIT_NS);
 
     val_realm_return_to_host();
 }
@@ -11,13 +11,12 @@
 
 void gic_timer_rel1_trig_realm(void)
 {
-    uint64_t timeout = 0x100000000000000;
-
     /* Below code is executed for REC[0] only */
     LOG(DBG, "\tIn realm_create_realm REC[0], mpdir=%x\n", val_read_mpidr(), 0);
     val_timer_set_phy_el1(1, false);
 
-    while (timeout--);
+    /* The interrupt exits to the host before the deadline */
+    val_wait_until(false, VAL_WAIT_EXIT_NS);
 
     val_realm_return_to_host();
 }
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "test_database.h"
+#include "val_host_rmi.h"
+#include "val_host_shadow.h"
+#include "mm_common_host.h"
+
+/* L1 aligned protected IPA, clear of the realm image */
+#define DATA_IPA    0x40000000
+
+static uint32_t check_entry(val_host_realm_ts *realm, uint64_t ipa, uint64_t level,
+                                                     uint64_t walk_level, uint64_t pa)
+{
+    val_host_rtt_entry_ts rtte;
+    uint64_t ret;
+
+    ret = val_host_rmi_rtt_read_entry(realm->rd, ipa, level, &rtte);
+    if (ret)
+    {
+        LOG(ERROR, "\trtt_read_entry failed, ipa=0x%x, ret=0x%x\n", ipa, ret);
+        return VAL_ERROR;
+    }
+
+    if (rtte.walk_level != walk_level || rtte.state != RMI_ASSIGNED ||
+        OA(rtte.desc) != OA(pa))
+    {
+        LOG(ERROR, "\tUnexpected entry, ipa=0x%x, walk_level=%d\n", ipa, rtte.walk_level);
+        return VAL_ERROR;
+    }
+
+    return val_host_shadow_check_entry(realm, ipa, level);
+}
+
+void mm_map_range_large_host(void)
+{
+    val_host_realm_ts realm;
+    val_host_rtt_entry_ts rtte;
+    val_host_map_range_ts ns_range = {
+        .kind = VAL_HOST_MAP_UNPROTECTED,
+        .flags = ATTR_NORMAL_WB | ATTR_STAGE2_MASK | ATTR_INNER_SHARED,
+        .rtt_alignment = PAGE_SIZE,
+    };
+    val_host_map_range_ts data_range = {
+        .kind = VAL_HOST_MAP_DATA,
+        .base = DATA_IPA,
+        .top = DATA_IPA + VAL_RTT_L2_BLOCK_SIZE + PAGE_SIZE,
+        .flags = RMI_NO_MEASURE_CONTENT,
+        .rtt_alignment = PAGE_SIZE,
+        .fold = true,
+    };
+    uint64_t l1_ipa, l1_pa, l1_level, ret;
+
+    val_memset(&realm, 0, sizeof(realm));
+
+    val_host_realm_params(&realm);
+
+    if (val_host_realm_setup(&realm, false))
+    {
+        LOG(ERROR, "\tRealm setup failed\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(1)));
+        goto destroy_realm;
+    }
+
+    /* Unprotected range of a page, an L2 block and a full L1 block. The PA
+       is not accessed, it only needs the same alignment as the IPA */
+    l1_ipa = (1ULL << (realm.s2sz - 1)) + VAL_RTT_L1_BLOCK_SIZE;
+    l1_pa = ADDR_ALIGN_DOWN(val_get_shared_region_base_pa(), VAL_RTT_L1_BLOCK_SIZE) +
+                                                             VAL_RTT_L1_BLOCK_SIZE;
+    ns_range.base = l1_ipa - VAL_RTT_L2_BLOCK_SIZE - PAGE_SIZE;
+    ns_range.top = l1_ipa + VAL_RTT_L1_BLOCK_SIZE;
+    ns_range.pa = l1_pa - VAL_RTT_L2_BLOCK_SIZE - PAGE_SIZE;
+
+    if (val_host_map_range(&realm, &ns_range))
+    {
+        LOG(ERROR, "\tUnprotected range mapping failed\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(2)));
+        goto destroy_realm;
+    }
+
+    /* The 1GB chunk is an L1 block, or L2 blocks where RMM rejects L1 blocks */
+    l1_level = val_host_rtt_l1_block_supported() ? VAL_RTT_BLOCK_LEVEL - 1 :
+                                                   VAL_RTT_BLOCK_LEVEL;
+    LOG(TEST, "\tUnprotected 1GB chunk mapped at level %d\n", l1_level, 0);
+
+    if (check_entry(&realm, ns_range.base, VAL_RTT_MAX_LEVEL, VAL_RTT_MAX_LEVEL,
+                                                                ns_range.pa) ||
+        check_entry(&realm, ns_range.base + PAGE_SIZE, VAL_RTT_BLOCK_LEVEL,
+                             VAL_RTT_BLOCK_LEVEL, ns_range.pa + PAGE_SIZE) ||
+        check_entry(&realm, l1_ipa, l1_level, l1_level, l1_pa))
+    {
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(3)));
+        goto destroy_realm;
+    }
+
+    /* The walk to the last page of the range ends at the block entry */
+    ret = val_host_rmi_rtt_read_entry(realm.rd, ns_range.top - PAGE_SIZE,
+                                                      VAL_RTT_MAX_LEVEL, &rtte);
+    if (ret || rtte.walk_level != l1_level || rtte.state != RMI_ASSIGNED)
+    {
+        LOG(ERROR, "\tRange top not block mapped, ret=0x%x, walk_level=%d\n",
+                                                          ret, rtte.walk_level);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(4)));
+        goto destroy_realm;
+    }
+
+    /* Protected data of a full L3 table and a page, the table is folded */
+    data_range.pa = (uint64_t)val_host_mem_alloc(VAL_RTT_L2_BLOCK_SIZE,
+                                                 VAL_RTT_L2_BLOCK_SIZE + PAGE_SIZE);
+    data_range.src_pa = (uint64_t)val_host_mem_alloc(PAGE_SIZE,
+                                                     VAL_RTT_L2_BLOCK_SIZE + PAGE_SIZE);
+    if (!data_range.pa || !data_range.src_pa)
+    {
+        LOG(ERROR, "\tval_host_mem_alloc failed\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(5)));
+        goto destroy_realm;
+    }
+
+    if (val_host_ripas_init(&realm, data_range.base, data_range.top,
+                                            VAL_RTT_MAX_LEVEL, PAGE_SIZE))
+    {
+        LOG(ERROR, "\tval_host_ripas_init failed\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(6)));
+        goto destroy_realm;
+    }
+
+    if (val_host_map_range(&realm, &data_range))
+    {
+        LOG(ERROR, "\tData range mapping failed\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(7)));
+        goto destroy_realm;
+    }
+
+    if (check_entry(&realm, data_range.base, VAL_RTT_BLOCK_LEVEL, VAL_RTT_BLOCK_LEVEL,
+                                                                   data_range.pa) ||
+        check_entry(&realm, data_range.base + VAL_RTT_L2_BLOCK_SIZE, VAL_RTT_MAX_LEVEL,
+                    VAL_RTT_MAX_LEVEL, data_range.pa + VAL_RTT_L2_BLOCK_SIZE))
+    {
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(8)));
+        goto destroy_realm;
+    }
+
+    /* Unmapping walks the ranges with the levels they were mapped at */
+    if (val_host_unmap_range(&realm, &ns_range, ns_range.top) ||
+        val_host_unmap_range(&realm, &data_range, data_range.top))
+    {
+        LOG(ERROR, "\tRange unmapping failed\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(9)));
+        goto destroy_realm;
+    }
+
+    ret = val_host_rmi_rtt_read_entry(realm.rd, l1_ipa, l1_level, &rtte);
+    if (ret || rtte.state != RMI_UNASSIGNED)
+    {
+        LOG(ERROR, "\tUnprotected range still mapped, ret=0x%x, state=%d\n",
+                                                             ret, rtte.state);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(10)));
+        goto destroy_realm;
+    }
+
+    ret = val_host_rmi_rtt_read_entry(realm.rd, data_range.base, VAL_RTT_MAX_LEVEL, &rtte);
+    if (ret || rtte.state != RMI_UNASSIGNED)
+    {
+        LOG(ERROR, "\tData range still mapped, ret=0x%x, state=%d\n", ret, rtte.state);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(11)));
+        goto destroy_realm;
+    }
+
+    val_set_status(RESULT_PASS(VAL_SUCCESS));
+
+    /* Free test resources */
+destroy_realm:
+    return;
+}
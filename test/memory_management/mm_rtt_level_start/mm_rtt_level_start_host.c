@@ -41,11 +41,11 @@ static uint32_t create_realm(val_host_realm_ts *realm)
                 val_set_status(RESULT_FAIL(VAL_ERROR_POINT(2)));
                 return VAL_ERROR;
             }
-            realm->granules[realm->granules_mapped_count].ipa = ipa;
-            realm->granules[realm->granules_mapped_count].size = PAGE_SIZE;
-            realm->granules[realm->granules_mapped_count].level = VAL_RTT_MAX_LEVEL;
-            realm->granules[realm->granules_mapped_count].pa = pa;
-            realm->granules_mapped_count++;
+            if (val_host_realm_add_granules(realm, ipa, PAGE_SIZE, VAL_RTT_MAX_LEVEL, pa))
+            {
+                val_set_status(RESULT_FAIL(VAL_ERROR_POINT(2)));
+                return VAL_ERROR;
+            }
         } else {
             pa = (uint64_t)val_host_mem_alloc(PAGE_SIZE, PAGE_SIZE);
             ipa = rtt_sl_start[i][1];
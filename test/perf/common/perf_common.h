@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _PERF_COMMON_H_
+#define _PERF_COMMON_H_
+
+#include "val.h"
+
+/* Samples taken for every parameter of a benchmark */
+#define PERF_ITERATIONS 32
+
+/* Host call immediates of the realm side of the benchmarks */
+#define PERF_REALM_PING   0x100
+#define PERF_REALM_RESULT 0x101
+
+/* gprs of a PERF_REALM_RESULT host call */
+#define PERF_RESULT_PARAM 0
+#define PERF_RESULT_COUNT 1
+#define PERF_RESULT_TOTAL 2
+#define PERF_RESULT_MIN   3
+#define PERF_RESULT_MAX   4
+
+/* Largest RIPAS change of perf_ipa_state_set, in granules */
+#define PERF_IPA_STATE_SET_MAX_GRANULES 16
+
+/* Timed calls of one benchmark parameter, in CNTPCT ticks */
+typedef struct {
+    uint64_t count;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+} perf_sample_ts;
+
+static inline void perf_sample_reset(perf_sample_ts *sample)
+{
+    sample->count = 0;
+    sample->total = 0;
+    sample->min = 0;
+    sample->max = 0;
+}
+
+static inline void perf_sample_add(perf_sample_ts *sample, uint64_t ticks)
+{
+    if (sample->count == 0 || ticks < sample->min)
+        sample->min = ticks;
+    if (ticks > sample->max)
+        sample->max = ticks;
+    sample->count++;
+    sample->total += ticks;
+}
+
+#endif /* _PERF_COMMON_H_ */
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "perf_common_host.h"
+
+/* Time one RMI call. The val_host_rmi_* wrappers are not used as they also
+ * update the granule tracking, the benchmarks restore the state they change. */
+val_smc_param_ts perf_smc_call(perf_sample_ts *sample, uint64_t fid,
+                               uint64_t x1, uint64_t x2, uint64_t x3, uint64_t x4, uint64_t x5)
+{
+    val_smc_param_ts args;
+    uint64_t start;
+
+    start = syscounter_read();
+    args = val_smc_call(fid, x1, x2, x3, x4, x5, 0, 0, 0, 0, 0);
+    perf_sample_add(sample, syscounter_read() - start);
+
+    return args;
+}
+
+void perf_report(const char *bench, const char *op, uint64_t param, perf_sample_ts *sample)
+{
+    LOG(ALWAYS, "PERF ", 0, 0);
+    LOG(ALWAYS, bench, 0, 0);
+    LOG(ALWAYS, " ", 0, 0);
+    LOG(ALWAYS, op, 0, 0);
+    LOG(ALWAYS, " %d %d", param, sample->count);
+    LOG(ALWAYS, " %d %d", sample->total, sample->min);
+    LOG(ALWAYS, " %d %d\n", sample->max, read_cntfrq_el0());
+}
+
+/* Print the sample of a PERF_REALM_RESULT host call, the realm times with CNTPCT too */
+uint32_t perf_report_realm(const char *bench, const char *op, val_host_rec_run_ts *run)
+{
+    perf_sample_ts sample;
+
+    if (run->exit.exit_reason != RMI_EXIT_HOST_CALL || run->exit.imm != PERF_REALM_RESULT)
+        return VAL_ERROR;
+
+    sample.count = run->exit.gprs[PERF_RESULT_COUNT];
+    sample.total = run->exit.gprs[PERF_RESULT_TOTAL];
+    sample.min = run->exit.gprs[PERF_RESULT_MIN];
+    sample.max = run->exit.gprs[PERF_RESULT_MAX];
+    perf_report(bench, op, run->exit.gprs[PERF_RESULT_PARAM], &sample);
+
+    return VAL_SUCCESS;
+}
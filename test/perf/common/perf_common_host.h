@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _PERF_COMMON_HOST_H_
+#define _PERF_COMMON_HOST_H_
+
+#include "test_database.h"
+#include "val_host_rmi.h"
+#include "val_host_granule_pool.h"
+#include "perf_common.h"
+
+/* Protected IPA used by the host benchmarks, 1GB aligned and clear of the realm image */
+#define PERF_IPA_BASE 0x40000000UL
+
+/*
+ * Each result is printed on one line:
+ *   PERF <benchmark> <operation> <param> <count> <total> <min> <max> <cntfrq>
+ * count is the number of timed calls, total/min/max are CNTPCT ticks and
+ * cntfrq is the counter frequency in Hz.
+ */
+val_smc_param_ts perf_smc_call(perf_sample_ts *sample, uint64_t fid,
+                               uint64_t x1, uint64_t x2, uint64_t x3, uint64_t x4, uint64_t x5);
+void perf_report(const char *bench, const char *op, uint64_t param, perf_sample_ts *sample);
+uint32_t perf_report_realm(const char *bench, const char *op, val_host_rec_run_ts *run);
+#endif /* _PERF_COMMON_HOST_H_ */
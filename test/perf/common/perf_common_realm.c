@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "perf_common_realm.h"
+
+__attribute__((aligned(PAGE_SIZE))) static val_realm_rsi_host_call_t perf_host_call;
+
+/* Hand a sample over to the host, which prints it */
+uint64_t perf_realm_report(uint64_t param, perf_sample_ts *sample)
+{
+    val_memset(&perf_host_call, 0, sizeof(perf_host_call));
+    perf_host_call.imm = PERF_REALM_RESULT;
+    perf_host_call.gprs[PERF_RESULT_PARAM] = param;
+    perf_host_call.gprs[PERF_RESULT_COUNT] = sample->count;
+    perf_host_call.gprs[PERF_RESULT_TOTAL] = sample->total;
+    perf_host_call.gprs[PERF_RESULT_MIN] = sample->min;
+    perf_host_call.gprs[PERF_RESULT_MAX] = sample->max;
+
+    return val_realm_rsi_host_call_struct((uint64_t)&perf_host_call);
+}
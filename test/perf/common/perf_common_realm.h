@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _PERF_COMMON_REALM_H_
+#define _PERF_COMMON_REALM_H_
+
+#include "test_database.h"
+#include "val_realm_framework.h"
+#include "val_realm_rsi.h"
+#include "perf_common.h"
+
+uint64_t perf_realm_report(uint64_t param, perf_sample_ts *sample);
+#endif /* _PERF_COMMON_REALM_H_ */
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "perf_common_host.h"
+
+#define MAX_GRANULES 16
+
+/* Number of granules created and destroyed per round */
+static const uint64_t batch_granules[] = {1, MAX_GRANULES};
+
+static uint64_t data[MAX_GRANULES];
+
+static uint32_t perf_data_create_batch(uint64_t rd, uint64_t src, uint64_t granules,
+                                       uint64_t flags)
+{
+    perf_sample_ts create, destroy;
+    uint64_t i, j, ret = 0;
+
+    perf_sample_reset(&create);
+    perf_sample_reset(&destroy);
+
+    for (i = 0; i < PERF_ITERATIONS; i++)
+    {
+        for (j = 0; j < granules; j++)
+        {
+            ret = perf_smc_call(&create, RMI_DATA_CREATE, rd, data[j],
+                                PERF_IPA_BASE + j * PAGE_SIZE, src, flags).x0;
+            if (ret)
+            {
+                LOG(ERROR, "\tData create failed, ret=%x\n", ret, 0);
+                break;
+            }
+        }
+
+        /* Destroy the granules of the round, even after a failure */
+        while (j-- > 0)
+        {
+            if (perf_smc_call(&destroy, RMI_DATA_DESTROY, rd,
+                              PERF_IPA_BASE + j * PAGE_SIZE, 0, 0, 0).x0)
+            {
+                LOG(ERROR, "\tData destroy failed, ipa=%x\n", PERF_IPA_BASE + j * PAGE_SIZE, 0);
+                return VAL_ERROR;
+            }
+        }
+
+        if (ret)
+            return VAL_ERROR;
+    }
+
+    if (flags == RMI_MEASURE_CONTENT)
+    {
+        perf_report("data_create", "create_measure", granules, &create);
+        perf_report("data_create", "destroy_measure", granules, &destroy);
+    } else {
+        perf_report("data_create", "create", granules, &create);
+        perf_report("data_create", "destroy", granules, &destroy);
+    }
+
+    return VAL_SUCCESS;
+}
+
+void perf_data_create_host(void)
+{
+    val_host_realm_ts realm;
+    uint64_t i, src;
+    uint32_t ret = VAL_SUCCESS;
+
+    val_memset(&realm, 0, sizeof(realm));
+    val_memset(data, 0, sizeof(data));
+
+    val_host_realm_params(&realm);
+
+    if (val_host_realm_create(&realm))
+    {
+        LOG(ERROR, "\tRealm create failed\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(1)));
+        return;
+    }
+
+    if (val_host_ripas_init(&realm, PERF_IPA_BASE, PERF_IPA_BASE + MAX_GRANULES * PAGE_SIZE,
+                            VAL_RTT_MAX_LEVEL, PAGE_SIZE))
+    {
+        LOG(ERROR, "\tRIPAS init failed\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(2)));
+        return;
+    }
+
+    src = (uint64_t)val_host_mem_alloc(PAGE_SIZE, PAGE_SIZE);
+    if (!src)
+    {
+        LOG(ERROR, "\tFailed to allocate memory for src\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(3)));
+        return;
+    }
+    val_memset((void *)src, 0xA5, PAGE_SIZE);
+
+    for (i = 0; i < MAX_GRANULES; i++)
+    {
+        data[i] = val_host_granule_pool_get();
+        if (!data[i])
+        {
+            LOG(ERROR, "\tFailed to get delegated granule for data\n", 0, 0);
+            val_set_status(RESULT_FAIL(VAL_ERROR_POINT(4)));
+            goto release_data;
+        }
+    }
+
+    for (i = 0; i < sizeof(batch_granules) / sizeof(batch_granules[0]) && !ret; i++)
+    {
+        ret = perf_data_create_batch(realm.rd, src, batch_granules[i], RMI_NO_MEASURE_CONTENT);
+        if (!ret)
+            ret = perf_data_create_batch(realm.rd, src, batch_granules[i], RMI_MEASURE_CONTENT);
+    }
+
+    /* Granules that may still be mapped are not returned to the pool */
+    if (ret)
+    {
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(5)));
+        return;
+    }
+
+    val_set_status(RESULT_PASS(VAL_SUCCESS));
+
+release_data:
+    for (i = 0; i < MAX_GRANULES && data[i]; i++)
+        val_host_granule_pool_release(data[i]);
+
+    val_host_mem_free((void *)src);
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "perf_common_host.h"
+
+/* Number of contiguous granules delegated and undelegated per round */
+static const uint64_t batch_granules[] = {1, 16, 64};
+
+static uint32_t perf_delegate_batch(uint64_t base, uint64_t granules)
+{
+    perf_sample_ts delegate, undelegate;
+    uint64_t i, j, ret = 0;
+
+    perf_sample_reset(&delegate);
+    perf_sample_reset(&undelegate);
+
+    for (i = 0; i < PERF_ITERATIONS; i++)
+    {
+        for (j = 0; j < granules; j++)
+        {
+            ret = perf_smc_call(&delegate, RMI_GRANULE_DELEGATE,
+                                base + j * PAGE_SIZE, 0, 0, 0, 0).x0;
+            if (ret)
+            {
+                LOG(ERROR, "\tGranule delegate failed, ret=%x\n", ret, 0);
+                break;
+            }
+        }
+
+        /* Undelegate the granules of the round, even after a failure */
+        while (j-- > 0)
+        {
+            if (perf_smc_call(&undelegate, RMI_GRANULE_UNDELEGATE,
+                              base + j * PAGE_SIZE, 0, 0, 0, 0).x0)
+            {
+                LOG(ERROR, "\tGranule undelegate failed, pa=%x\n", base + j * PAGE_SIZE, 0);
+                return VAL_ERROR;
+            }
+        }
+
+        if (ret)
+            return VAL_ERROR;
+    }
+
+    perf_report("granule_delegate", "delegate", granules, &delegate);
+    perf_report("granule_delegate", "undelegate", granules, &undelegate);
+    return VAL_SUCCESS;
+}
+
+void perf_granule_delegate_host(void)
+{
+    uint64_t i, base;
+
+    for (i = 0; i < sizeof(batch_granules) / sizeof(batch_granules[0]); i++)
+    {
+        base = (uint64_t)val_host_mem_alloc(PAGE_SIZE, batch_granules[i] * PAGE_SIZE);
+        if (!base)
+        {
+            LOG(ERROR, "\tFailed to allocate %d granules\n", batch_granules[i], 0);
+            val_set_status(RESULT_FAIL(VAL_ERROR_POINT(1)));
+            return;
+        }
+
+        /* Granules left delegated after a failure are not returned to the heap */
+        if (perf_delegate_batch(base, batch_granules[i]))
+        {
+            val_set_status(RESULT_FAIL(VAL_ERROR_POINT(2)));
+            return;
+        }
+
+        val_host_mem_free((void *)base);
+    }
+
+    val_set_status(RESULT_PASS(VAL_SUCCESS));
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "perf_common_host.h"
+
+/* The realm reports its RIPAS changes to EMPTY, then to RAM, for every size */
+static const char *const realm_ops[] = {"to_empty", "to_ram"};
+
+static uint32_t perf_ripas_change(val_host_realm_ts *realm, val_host_rec_run_ts *run,
+                                  perf_sample_ts *set_ripas)
+{
+    val_host_rec_enter_flags_ts rec_enter_flags;
+    val_smc_param_ts args;
+    uint64_t base = run->exit.ripas_base;
+
+    while (base < run->exit.ripas_top)
+    {
+        args = perf_smc_call(set_ripas, RMI_RTT_SET_RIPAS, realm->rd, realm->rec[0],
+                             base, run->exit.ripas_top, 0);
+        if (args.x0)
+        {
+            LOG(ERROR, "\tRTT set RIPAS failed, ret=%x\n", args.x0, 0);
+            return VAL_ERROR;
+        }
+        base = args.x1;
+    }
+
+    val_memset(&rec_enter_flags, 0, sizeof(rec_enter_flags));
+    rec_enter_flags.ripas_response = RMI_ACCEPT;
+    val_memcpy(&run->enter.flags, &rec_enter_flags, sizeof(rec_enter_flags));
+
+    return VAL_SUCCESS;
+}
+
+void perf_ipa_state_set_host(void)
+{
+    val_host_realm_ts realm;
+    val_host_rec_run_ts *run;
+    perf_sample_ts set_ripas;
+    uint64_t ret, results = 0;
+
+    val_memset(&realm, 0, sizeof(realm));
+
+    val_host_realm_params(&realm);
+
+    if (val_host_realm_setup(&realm, 1))
+    {
+        LOG(ERROR, "\tRealm setup failed\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(1)));
+        return;
+    }
+
+    run = (val_host_rec_run_ts *)realm.run[0];
+    perf_sample_reset(&set_ripas);
+
+    while (1)
+    {
+        ret = val_host_rmi_rec_enter(realm.rec[0], realm.run[0]);
+        if (ret)
+        {
+            LOG(ERROR, "\tRec enter failed, ret=%x\n", ret, 0);
+            val_set_status(RESULT_FAIL(VAL_ERROR_POINT(2)));
+            return;
+        }
+
+        if (!val_host_check_realm_exit_ripas_change(run))
+        {
+            if (perf_ripas_change(&realm, run, &set_ripas))
+            {
+                val_set_status(RESULT_FAIL(VAL_ERROR_POINT(3)));
+                return;
+            }
+            continue;
+        }
+
+        if (!perf_report_realm("ipa_state_set", realm_ops[results % 2], run))
+        {
+            /* Both directions of a size are done, print the host side */
+            if (results++ % 2)
+            {
+                perf_report("ipa_state_set", "rtt_set_ripas",
+                            run->exit.gprs[PERF_RESULT_PARAM], &set_ripas);
+                perf_sample_reset(&set_ripas);
+            }
+            continue;
+        }
+
+        if (!val_host_check_realm_exit_host_call(run))
+            break;
+
+        LOG(ERROR, "\tUnexpected REC exit, exit_reason %lx imm %lx\n",
+                            run->exit.exit_reason, run->exit.imm);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(4)));
+        return;
+    }
+
+    val_set_status(RESULT_PASS(VAL_SUCCESS));
+}
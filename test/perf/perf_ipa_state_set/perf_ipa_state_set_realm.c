@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "perf_common_realm.h"
+
+#define MAX_GRANULES PERF_IPA_STATE_SET_MAX_GRANULES
+
+/* Protected RAM of the realm image whose RIPAS is changed, it is never accessed */
+__attribute__((aligned (PAGE_SIZE))) static uint8_t perf_gran[MAX_GRANULES * PAGE_SIZE];
+
+/* Number of granules per RIPAS change */
+static const uint64_t change_granules[] = {1, 4, MAX_GRANULES};
+
+static uint32_t perf_ipa_state_set(uint64_t base, uint64_t top, uint8_t ripas)
+{
+    val_smc_param_ts args;
+
+    /* The host may complete part of the range per REC exit */
+    while (base < top)
+    {
+        args = val_realm_rsi_ipa_state_set(base, top, ripas, RSI_NO_CHANGE_DESTROYED);
+        if (args.x0 || args.x2 != RSI_ACCEPT)
+        {
+            LOG(ERROR, "\tRSI_IPA_STATE_SET failed, ret=%x response=%x\n", args.x0, args.x2);
+            return VAL_ERROR;
+        }
+        base = args.x1;
+    }
+
+    return VAL_SUCCESS;
+}
+
+void perf_ipa_state_set_realm(void)
+{
+    perf_sample_ts to_empty, to_ram;
+    uint64_t i, j, start, base, top;
+
+    base = (uint64_t)perf_gran;
+
+    for (i = 0; i < sizeof(change_granules) / sizeof(change_granules[0]); i++)
+    {
+        top = base + change_granules[i] * PAGE_SIZE;
+        perf_sample_reset(&to_empty);
+        perf_sample_reset(&to_ram);
+
+        for (j = 0; j < PERF_ITERATIONS; j++)
+        {
+            start = syscounter_read();
+            if (perf_ipa_state_set(base, top, RSI_EMPTY))
+                goto exit;
+            perf_sample_add(&to_empty, syscounter_read() - start);
+
+            start = syscounter_read();
+            if (perf_ipa_state_set(base, top, RSI_RAM))
+                goto exit;
+            perf_sample_add(&to_ram, syscounter_read() - start);
+        }
+
+        perf_realm_report(top - base, &to_empty);
+        perf_realm_report(top - base, &to_ram);
+    }
+
+    val_realm_return_to_host();
+    return;
+
+exit:
+    val_set_status(RESULT_FAIL(VAL_ERROR_POINT(1)));
+    val_realm_return_to_host();
+}
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "perf_common_host.h"
+
+/* Not exported through VAL, the xlat tables library calls it directly */
+void *memmove(void *dst, const void *src, size_t len);
+
+/* Buffer sizes of the benchmarks, in bytes */
+static const uint64_t libc_sizes[] = {64, 512, PAGE_SIZE};
+
+/* Lengths and buffer offsets covered by the correctness checks */
+#define LIBC_CHECK_LEN      80
+#define LIBC_CHECK_OFFSETS  8
+#define LIBC_CHECK_AREA     (LIBC_CHECK_LEN + 2 * LIBC_CHECK_OFFSETS)
+
+#define LIBC_GUARD          0xEE
+#define LIBC_FILL           0x5A
+
+/* Each buffer is two pages, a page sized operation can start at any offset */
+#define LIBC_BUF_SIZE       (2 * PAGE_SIZE)
+
+static uint8_t libc_pattern(uint64_t i)
+{
+    return (uint8_t)(i * 7 + 1);
+}
+
+static void libc_fill(uint8_t *buf, uint64_t len, uint8_t (*value)(uint64_t))
+{
+    uint64_t i;
+
+    for (i = 0; i < len; i++)
+        buf[i] = value ? value(i) : LIBC_GUARD;
+}
+
+/* Check that buf holds expect at [start, start + len) and the guard elsewhere */
+static uint32_t libc_check_area(const uint8_t *buf, uint64_t start, uint64_t len,
+                                const uint8_t *expect, int fill)
+{
+    uint64_t i;
+    uint8_t value;
+
+    for (i = 0; i < LIBC_CHECK_AREA; i++)
+    {
+        if (i < start || i >= start + len)
+            value = LIBC_GUARD;
+        else
+            value = expect ? expect[i - start] : (uint8_t)fill;
+
+        if (buf[i] != value)
+            return VAL_ERROR;
+    }
+
+    return VAL_SUCCESS;
+}
+
+static uint32_t libc_check_copy_set(uint8_t *src, uint8_t *dst)
+{
+    uint64_t soff, doff, len;
+
+    libc_fill(src, LIBC_CHECK_AREA, libc_pattern);
+
+    for (doff = 0; doff < LIBC_CHECK_OFFSETS; doff++)
+    {
+        for (len = 0; len <= LIBC_CHECK_LEN; len++)
+        {
+            for (soff = 0; soff < LIBC_CHECK_OFFSETS; soff++)
+            {
+                libc_fill(dst, LIBC_CHECK_AREA, NULL);
+                val_memcpy(dst + doff, src + soff, len);
+                if (libc_check_area(dst, doff, len, src + soff, 0))
+                {
+                    LOG(ERROR, "\tmemcpy mismatch, len=%d offsets=%x\n",
+                                                    len, (soff << 4) | doff);
+                    return VAL_ERROR;
+                }
+            }
+
+            libc_fill(dst, LIBC_CHECK_AREA, NULL);
+            val_memset(dst + doff, 0, len);
+            if (libc_check_area(dst, doff, len, NULL, 0))
+            {
+                LOG(ERROR, "\tmemset 0 mismatch, len=%d offset=%d\n", len, doff);
+                return VAL_ERROR;
+            }
+
+            libc_fill(dst, LIBC_CHECK_AREA, NULL);
+            val_memset(dst + doff, LIBC_FILL, len);
+            if (libc_check_area(dst, doff, len, NULL, LIBC_FILL))
+            {
+                LOG(ERROR, "\tmemset mismatch, len=%d offset=%d\n", len, doff);
+                return VAL_ERROR;
+            }
+        }
+    }
+
+    return VAL_SUCCESS;
+}
+
+static uint32_t libc_check_compare(uint8_t *src, uint8_t *dst)
+{
+    uint64_t soff, doff, len, pos;
+    int ret;
+
+    libc_fill(src, LIBC_CHECK_AREA, libc_pattern);
+
+    for (soff = 0; soff < LIBC_CHECK_OFFSETS; soff++)
+    {
+        for (doff = 0; doff < LIBC_CHECK_OFFSETS; doff++)
+        {
+            for (len = 1; len <= LIBC_CHECK_LEN; len++)
+            {
+                val_memcpy(dst + doff, src + soff, len);
+                if (val_memcmp(src + soff, dst + doff, len))
+                {
+                    LOG(ERROR, "\tmemcmp of equal buffers, len=%d offsets=%x\n",
+                                                    len, (soff << 4) | doff);
+                    return VAL_ERROR;
+                }
+
+                /* The sign comes from the first differing byte */
+                for (pos = 0; pos < len; pos += (len / 3) + 1)
+                {
+                    dst[doff + pos]++;
+                    if (pos + 1 < len)
+                        dst[doff + pos + 1] = (uint8_t)(src[soff + pos + 1] - 1);
+
+                    ret = val_memcmp(src + soff, dst + doff, len);
+                    if (ret >= 0 || val_memcmp(dst + doff, src + soff, len) <= 0)
+                    {
+                        LOG(ERROR, "\tmemcmp sign, len=%d pos=%d\n", len, pos);
+                        return VAL_ERROR;
+                    }
+
+                    val_memcpy(dst + doff, src + soff, len);
+                }
+            }
+        }
+    }
+
+    return VAL_SUCCESS;
+}
+
+static uint32_t libc_check_move(uint8_t *buf)
+{
+    uint8_t expect[LIBC_CHECK_LEN];
+    uint64_t src, dst, len;
+
+    for (len = 0; len <= LIBC_CHECK_LEN; len++)
+    {
+        for (src = 0; src < 2 * LIBC_CHECK_OFFSETS; src++)
+        {
+            for (dst = 0; dst < 2 * LIBC_CHECK_OFFSETS; dst++)
+            {
+                libc_fill(buf, LIBC_CHECK_AREA, libc_pattern);
+                val_memcpy(expect, buf + src, len);
+
+                memmove(buf + dst, buf + src, len);
+                if (val_memcmp(buf + dst, expect, len))
+                {
+                    LOG(ERROR, "\tmemmove mismatch, len=%d offsets=%x\n",
+                                                    len, (src << 8) | dst);
+                    return VAL_ERROR;
+                }
+            }
+        }
+    }
+
+    return VAL_SUCCESS;
+}
+
+/* A page sized zeroing, the only one large enough for DC ZVA, at every word offset */
+static uint32_t libc_check_page_zero(uint8_t *buf)
+{
+    uint64_t off, i;
+
+    for (off = 0; off < LIBC_CHECK_OFFSETS; off++)
+    {
+        libc_fill(buf, LIBC_BUF_SIZE, NULL);
+        val_memset(buf + off, 0, PAGE_SIZE);
+
+        for (i = 0; i < LIBC_BUF_SIZE; i++)
+        {
+            if (buf[i] != ((i >= off && i < off + PAGE_SIZE) ? 0 : LIBC_GUARD))
+            {
+                LOG(ERROR, "\tPage memset mismatch, offset=%d byte=%x\n", off, i);
+                return VAL_ERROR;
+            }
+        }
+    }
+
+    return VAL_SUCCESS;
+}
+
+static void libc_bench(uint8_t *src, uint8_t *dst, uint64_t size)
+{
+    perf_sample_ts copy, copy_unaligned, zero, set, compare, move;
+    uint64_t i, start;
+
+    perf_sample_reset(&copy);
+    perf_sample_reset(&copy_unaligned);
+    perf_sample_reset(&zero);
+    perf_sample_reset(&set);
+    perf_sample_reset(&compare);
+    perf_sample_reset(&move);
+
+    for (i = 0; i < PERF_ITERATIONS; i++)
+    {
+        start = syscounter_read();
+        val_memcpy(dst, src, size);
+        perf_sample_add(&copy, syscounter_read() - start);
+
+        start = syscounter_read();
+        val_memcpy(dst, src + 1, size);
+        perf_sample_add(&copy_unaligned, syscounter_read() - start);
+
+        start = syscounter_read();
+        val_memset(dst, 0, size);
+        perf_sample_add(&zero, syscounter_read() - start);
+
+        start = syscounter_read();
+        val_memset(dst, LIBC_FILL, size);
+        perf_sample_add(&set, syscounter_read() - start);
+
+        val_memcpy(dst, src, size);
+        start = syscounter_read();
+        (void)val_memcmp(src, dst, size);
+        perf_sample_add(&compare, syscounter_read() - start);
+
+        /* Overlapping and moving up, the backward copy */
+        start = syscounter_read();
+        memmove(dst + 8, dst, size);
+        perf_sample_add(&move, syscounter_read() - start);
+    }
+
+    perf_report("libc", "memcpy", size, &copy);
+    perf_report("libc", "memcpy_unaligned", size, &copy_unaligned);
+    perf_report("libc", "memset_zero", size, &zero);
+    perf_report("libc", "memset", size, &set);
+    perf_report("libc", "memcmp", size, &compare);
+    perf_report("libc", "memmove", size, &move);
+}
+
+void perf_libc_host(void)
+{
+    uint8_t *src, *dst;
+    uint64_t i;
+
+    src = val_host_mem_alloc(PAGE_SIZE, LIBC_BUF_SIZE);
+    dst = val_host_mem_alloc(PAGE_SIZE, LIBC_BUF_SIZE);
+    if (!src || !dst)
+    {
+        LOG(ERROR, "\tFailed to allocate the buffers\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(1)));
+        return;
+    }
+
+    if (libc_check_copy_set(src, dst) || libc_check_compare(src, dst) ||
+        libc_check_move(dst) || libc_check_page_zero(dst))
+    {
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(2)));
+        goto free_buf;
+    }
+
+    libc_fill(src, LIBC_BUF_SIZE, libc_pattern);
+
+    for (i = 0; i < sizeof(libc_sizes) / sizeof(libc_sizes[0]); i++)
+        libc_bench(src, dst, libc_sizes[i]);
+
+    val_set_status(RESULT_PASS(VAL_SUCCESS));
+
+free_buf:
+    val_host_mem_free(src);
+    val_host_mem_free(dst);
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "perf_common_host.h"
+
+/* MPIDR of the REC with the given index, 16 RECs per Aff1 value */
+#define REC_MPIDR(index) (((index) & 0xFUL) | ((((index) >> 4) & 0xFFUL) << 8))
+
+static uint64_t rec_aux[VAL_MAX_REC_AUX_GRANULES];
+
+static uint32_t perf_rec_create_config(val_host_realm_ts *realm, val_host_rec_params_ts *params)
+{
+    perf_sample_ts create, destroy;
+    uint64_t i, ret, rec, aux_count;
+    uint32_t status = VAL_ERROR;
+
+    if (val_host_realm_create(realm))
+    {
+        LOG(ERROR, "\tRealm create failed\n", 0, 0);
+        return VAL_ERROR;
+    }
+
+    ret = val_host_rmi_rec_aux_count(realm->rd, &aux_count);
+    if (ret || aux_count > VAL_MAX_REC_AUX_GRANULES)
+    {
+        LOG(ERROR, "\tREC AUX count failed, ret=%x count=%d\n", ret, aux_count);
+        return VAL_ERROR;
+    }
+
+    val_memset(rec_aux, 0, sizeof(rec_aux));
+    rec = val_host_granule_pool_get();
+    for (i = 0; i < aux_count; i++)
+    {
+        rec_aux[i] = val_host_granule_pool_get();
+        if (!rec_aux[i])
+            break;
+    }
+
+    if (!rec || i < aux_count)
+    {
+        LOG(ERROR, "\tFailed to get delegated granules for REC\n", 0, 0);
+        goto release;
+    }
+
+    val_memset(params, 0, PAGE_SIZE);
+    params->flags = RMI_RUNNABLE;
+    params->pc = VAL_REALM_IMAGE_BASE_IPA;
+    params->num_aux = aux_count;
+    val_memcpy(params->aux, rec_aux, sizeof(rec_aux));
+
+    perf_sample_reset(&create);
+    perf_sample_reset(&destroy);
+
+    /* RMI_REC_CREATE expects the MPIDR of the next REC index of the realm */
+    for (i = 0; i < PERF_ITERATIONS; i++)
+    {
+        params->mpidr = REC_MPIDR(i);
+
+        ret = perf_smc_call(&create, RMI_REC_CREATE, realm->rd, rec, (uint64_t)params, 0, 0).x0;
+        if (ret)
+        {
+            LOG(ERROR, "\tREC create failed, ret=%x\n", ret, 0);
+            goto release;
+        }
+
+        ret = perf_smc_call(&destroy, RMI_REC_DESTROY, rec, 0, 0, 0, 0).x0;
+        if (ret)
+        {
+            /* The granules are in use, they are not returned to the pool */
+            LOG(ERROR, "\tREC destroy failed, ret=%x\n", ret, 0);
+            return VAL_ERROR;
+        }
+    }
+
+    perf_report("rec_create", "create", aux_count, &create);
+    perf_report("rec_create", "destroy", aux_count, &destroy);
+    status = VAL_SUCCESS;
+
+release:
+    if (rec)
+        val_host_granule_pool_release(rec);
+    for (i = 0; i < aux_count && rec_aux[i]; i++)
+        val_host_granule_pool_release(rec_aux[i]);
+
+    return status;
+}
+
+void perf_rec_create_host(void)
+{
+    val_host_realm_ts realm;
+    val_host_rec_params_ts *params;
+    uint64_t feature_reg;
+
+    params = val_host_mem_alloc(PAGE_SIZE, PAGE_SIZE);
+    if (params == NULL)
+    {
+        LOG(ERROR, "\tFailed to allocate memory for rec_params\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(1)));
+        return;
+    }
+
+    val_memset(&realm, 0, sizeof(realm));
+    val_host_realm_params(&realm);
+
+    if (perf_rec_create_config(&realm, params))
+    {
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(2)));
+        goto free_params;
+    }
+
+    /* The REC of a realm with PMU enabled holds the PMU state */
+    val_host_rmi_features(0, &feature_reg);
+    if (VAL_EXTRACT_BITS(feature_reg, 22, 22))
+    {
+        val_memset(&realm, 0, sizeof(realm));
+        val_host_realm_params(&realm);
+        realm.vmid = 1;
+        realm.flags = REALM_FLAG_PMU_ENABLE;
+        realm.pmu_num_ctrs = (uint8_t)VAL_EXTRACT_BITS(feature_reg, 23, 27);
+
+        if (perf_rec_create_config(&realm, params))
+        {
+            val_set_status(RESULT_FAIL(VAL_ERROR_POINT(3)));
+            goto free_params;
+        }
+    }
+
+    val_set_status(RESULT_PASS(VAL_SUCCESS));
+
+free_params:
+    val_host_mem_free(params);
+}
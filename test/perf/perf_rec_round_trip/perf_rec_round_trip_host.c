@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "perf_common_host.h"
+#include "val_host_helpers.h"
+#include "val_irq.h"
+#include "val_timer.h"
+
+/* Exit causes in the order the realm triggers them */
+typedef enum {
+    ROUND_TRIP_HOST_CALL,
+    ROUND_TRIP_EMUL_MMIO,
+    ROUND_TRIP_WFI,
+    ROUND_TRIP_WFE,
+    ROUND_TRIP_IRQ,
+} perf_round_trip_te;
+
+static const char *round_trip_op[] = {"host_call", "emul_mmio", "wfi", "wfe", "irq"};
+
+static int timer_handler(void)
+{
+    val_disable_phy_timer_el2();
+
+    return 0;
+}
+
+static uint32_t perf_round_trip_check(val_host_rec_run_ts *run, perf_round_trip_te cause,
+                                      uint64_t seq)
+{
+    uint64_t ec = run->exit.esr & ESR_EL2_EC_MASK;
+
+    switch (cause)
+    {
+        case ROUND_TRIP_HOST_CALL:
+            if (run->exit.exit_reason == RMI_EXIT_HOST_CALL &&
+                run->exit.imm == PERF_REALM_PING && run->exit.gprs[0] == seq)
+                return VAL_SUCCESS;
+            break;
+        case ROUND_TRIP_EMUL_MMIO:
+            if (run->exit.exit_reason == RMI_EXIT_SYNC && ec == ESR_EL2_EC_DATA_ABORT)
+                return VAL_SUCCESS;
+            break;
+        case ROUND_TRIP_WFI:
+        case ROUND_TRIP_WFE:
+            if (run->exit.exit_reason == RMI_EXIT_SYNC && ec == ESR_EL2_EC_WFX)
+                return VAL_SUCCESS;
+            break;
+        case ROUND_TRIP_IRQ:
+            if (run->exit.exit_reason == RMI_EXIT_IRQ)
+                return VAL_SUCCESS;
+            break;
+    }
+
+    LOG(ERROR, "\tUnexpected REC exit, exit_reason %lx esr %lx\n",
+                        run->exit.exit_reason, run->exit.esr);
+    return VAL_ERROR;
+}
+
+/* Entry flags that resume the REC from its last exit and keep the cause trapped */
+static void perf_round_trip_flags(val_host_rec_run_ts *run, perf_round_trip_te cause)
+{
+    val_host_rec_enter_flags_ts flags;
+
+    val_memset(&flags, 0, sizeof(flags));
+
+    /* The read of the MMIO loop completes with the value of gprs[0] */
+    if (run->exit.exit_reason == RMI_EXIT_SYNC &&
+        (run->exit.esr & ESR_EL2_EC_MASK) == ESR_EL2_EC_DATA_ABORT)
+        flags.emul_mmio = 1;
+
+    flags.trap_wfi = (cause == ROUND_TRIP_WFI);
+    flags.trap_wfe = (cause == ROUND_TRIP_WFE);
+
+    val_memcpy(&run->enter.flags, &flags, sizeof(flags));
+}
+
+/*
+ * The realm exits PERF_ITERATIONS + 1 times for each cause. The first entry
+ * resumes the REC from the previous cause and is not timed, every other one
+ * is a full round trip from an exit to the next exit of the same cause.
+ */
+static uint32_t perf_round_trip(val_host_realm_ts *realm, perf_round_trip_te cause)
+{
+    val_host_rec_run_ts *run = (val_host_rec_run_ts *)realm->run[0];
+    perf_sample_ts round_trip, first;
+    uint64_t i, ret;
+
+    perf_sample_reset(&round_trip);
+    perf_sample_reset(&first);
+
+    for (i = 0; i <= PERF_ITERATIONS; i++)
+    {
+        perf_round_trip_flags(run, cause);
+
+        /* The pending timer interrupt makes the REC exit as soon as it is entered */
+        if (cause == ROUND_TRIP_IRQ)
+            val_timer_set_phy_el2(0);
+
+        /* The realm prints its start up messages on the first entry */
+        if (cause == ROUND_TRIP_HOST_CALL && i == 0)
+            ret = val_host_rmi_rec_enter(realm->rec[0], realm->run[0]);
+        else
+            ret = perf_smc_call(i ? &round_trip : &first, RMI_REC_ENTER,
+                                realm->rec[0], realm->run[0], 0, 0, 0).x0;
+
+        if (cause == ROUND_TRIP_IRQ)
+            val_disable_phy_timer_el2();
+
+        if (ret || perf_round_trip_check(run, cause, i))
+        {
+            LOG(ERROR, "\tRec enter failed, ret=%x iteration=%d\n", ret, i);
+            return VAL_ERROR;
+        }
+    }
+
+    perf_report("rec_round_trip", round_trip_op[cause], 0, &round_trip);
+    return VAL_SUCCESS;
+}
+
+void perf_rec_round_trip_host(void)
+{
+    uint64_t *irq_done = (val_get_shared_region_base() + TEST_USE_OFFSET1);
+    val_host_realm_ts realm;
+    val_host_rec_run_ts *run;
+    uint64_t ret, mem_attr, top;
+    uint32_t index, status = VAL_SUCCESS;
+
+    val_memset(&realm, 0, sizeof(realm));
+    *irq_done = 0;
+
+    val_host_realm_params(&realm);
+
+    if (val_host_realm_setup(&realm, 1))
+    {
+        LOG(ERROR, "\tRealm setup failed\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(1)));
+        return;
+    }
+
+    run = (val_host_rec_run_ts *)realm.run[0];
+
+    /* An unassigned unprotected IPA makes every access an emulatable data abort */
+    mem_attr = ATTR_NORMAL_WB | ATTR_STAGE2_MASK | ATTR_INNER_SHARED;
+    index = val_host_map_ns_shared_region(&realm, PAGE_SIZE, mem_attr);
+    if (!index)
+    {
+        LOG(ERROR, "\tval_host_map_ns_shared_region failed\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(2)));
+        return;
+    }
+
+    ret = val_host_rmi_rtt_unmap_unprotected(realm.rd, realm.granules[index].ipa,
+                                            realm.granules[index].level, &top);
+    if (ret)
+    {
+        LOG(ERROR, "\tval_rmi_rtt_unmap_unprotected failed, ipa=0x%x, ret=0x%x\n",
+                                                             realm.granules[index].ipa, ret);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(3)));
+        return;
+    }
+
+    run->enter.gprs[1] = realm.granules[index].ipa;
+
+    if (val_irq_register_handler(IRQ_PHY_TIMER_EL2, timer_handler))
+    {
+        LOG(ERROR, "\tIRQ_PHY_TIMER_EL2 interrupt register failed\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(4)));
+        return;
+    }
+
+    val_irq_enable(IRQ_PHY_TIMER_EL2, 0);
+
+    if (perf_round_trip(&realm, ROUND_TRIP_HOST_CALL) ||
+        perf_round_trip(&realm, ROUND_TRIP_EMUL_MMIO))
+    {
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(5)));
+        goto free_irq;
+    }
+
+#ifdef TEST_WFI_TRAP
+    if (perf_round_trip(&realm, ROUND_TRIP_WFI))
+    {
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(6)));
+        goto free_irq;
+    }
+#endif
+
+#ifdef TEST_WFE_TRAP
+    if (perf_round_trip(&realm, ROUND_TRIP_WFE))
+    {
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(7)));
+        goto free_irq;
+    }
+#endif
+
+    /* Masked so that the host does not take the armed timer interrupt before the REC */
+    disable_irq();
+    status = perf_round_trip(&realm, ROUND_TRIP_IRQ);
+    enable_irq();
+
+    if (status)
+    {
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(8)));
+        goto free_irq;
+    }
+
+    /* The realm ends its wait and returns */
+    *irq_done = 1;
+    perf_round_trip_flags(run, ROUND_TRIP_IRQ);
+    ret = val_host_rmi_rec_enter(realm.rec[0], realm.run[0]);
+    if (ret || val_host_check_realm_exit_host_call(run))
+    {
+        LOG(ERROR, "\tRealm did not return, ret=%x\n", ret, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(9)));
+        goto free_irq;
+    }
+
+    val_set_status(RESULT_PASS(VAL_SUCCESS));
+
+free_irq:
+    val_irq_disable(IRQ_PHY_TIMER_EL2);
+
+    if (val_irq_unregister_handler(IRQ_PHY_TIMER_EL2))
+    {
+        LOG(ERROR, "\tIRQ_PHY_TIMER_EL2 interrupt unregister failed\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(10)));
+    }
+}
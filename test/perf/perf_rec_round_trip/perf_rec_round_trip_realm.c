@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "perf_common_realm.h"
+#include "val_realm_memory.h"
+#include "val_timer.h"
+
+__attribute__((aligned(PAGE_SIZE))) static val_realm_rsi_host_call_t perf_ping;
+
+/* Host call carrying its sequence number, the host checks that none is lost */
+static void perf_round_trip_ping(uint64_t seq)
+{
+    perf_ping.imm = PERF_REALM_PING;
+    perf_ping.gprs[0] = seq;
+    val_realm_rsi_host_call_struct((uint64_t)&perf_ping);
+}
+
+/*
+ * Every exit cause is repeated PERF_ITERATIONS + 1 times, in the order the host
+ * expects them: host call, emulated MMIO, WFI, WFE and IRQ.
+ */
+void perf_rec_round_trip_realm(void)
+{
+    volatile uint64_t *irq_done = (val_get_shared_region_base() + TEST_USE_OFFSET1);
+    val_memory_region_descriptor_ts mem_desc;
+    uint64_t i, mmio_ipa;
+
+    for (i = 0; i <= PERF_ITERATIONS; i++)
+        perf_round_trip_ping(i);
+
+    /* The host passes the unassigned unprotected IPA with every host call */
+    mmio_ipa = perf_ping.gprs[1];
+
+    mem_desc.virtual_address = mmio_ipa;
+    mem_desc.physical_address = mmio_ipa;
+    mem_desc.length = PAGE_SIZE;
+    mem_desc.attributes = MT_RW_DATA | MT_REALM;
+    if (val_realm_pgt_create(&mem_desc))
+    {
+        LOG(ERROR, "\tVA to PA mapping failed\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(1)));
+        goto exit;
+    }
+
+    for (i = 0; i <= PERF_ITERATIONS; i++)
+        (void)*(volatile uint32_t *)mmio_ipa;
+
+#ifdef TEST_WFI_TRAP
+    for (i = 0; i <= PERF_ITERATIONS; i++)
+        wfi();
+#endif
+
+#ifdef TEST_WFE_TRAP
+    for (i = 0; i <= PERF_ITERATIONS; i++)
+        wfe();
+#endif
+
+    /* The host interrupts the wait, and sets the flag once the IRQ exits are timed */
+    if (!val_wait_until(*irq_done, VAL_WAIT_EXIT_NS))
+    {
+        LOG(ERROR, "\tIRQ round trips did not complete\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(2)));
+    }
+
+exit:
+    val_realm_return_to_host();
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "perf_common_host.h"
+
+/* An IPA width that starts the walk at level 0 with one table */
+#define IPA_WIDTH   40
+#define START_LEVEL 0
+
+static uint32_t perf_rtt_create_level(uint64_t rd, uint64_t rtt, uint64_t level)
+{
+    perf_sample_ts create, destroy;
+    uint64_t i, ret, ipa;
+
+    perf_sample_reset(&create);
+    perf_sample_reset(&destroy);
+
+    /* The RTT describes the IPA range of one entry of its parent */
+    ipa = ADDR_ALIGN_DOWN(PERF_IPA_BASE, 1UL << VAL_RTT_LEVEL_SHIFT(level - 1));
+
+    for (i = 0; i < PERF_ITERATIONS; i++)
+    {
+        ret = perf_smc_call(&create, RMI_RTT_CREATE, rd, rtt, ipa, level, 0).x0;
+        if (ret)
+        {
+            LOG(ERROR, "\tRTT create failed, level=%d ret=%x\n", level, ret);
+            return VAL_ERROR;
+        }
+
+        ret = perf_smc_call(&destroy, RMI_RTT_DESTROY, rd, ipa, level, 0, 0).x0;
+        if (ret)
+        {
+            LOG(ERROR, "\tRTT destroy failed, level=%d ret=%x\n", level, ret);
+            return VAL_ERROR;
+        }
+    }
+
+    perf_report("rtt_create", "create", level, &create);
+    perf_report("rtt_create", "destroy", level, &destroy);
+    return VAL_SUCCESS;
+}
+
+void perf_rtt_create_host(void)
+{
+    val_host_realm_ts realm;
+    uint64_t level, rtt;
+
+    val_memset(&realm, 0, sizeof(realm));
+
+    val_host_realm_params(&realm);
+    realm.s2sz = IPA_WIDTH;
+    realm.s2_starting_level = START_LEVEL;
+
+    if (val_host_realm_create(&realm))
+    {
+        LOG(ERROR, "\tRealm create failed\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(1)));
+        return;
+    }
+
+    rtt = val_host_granule_pool_get();
+    if (!rtt)
+    {
+        LOG(ERROR, "\tFailed to get delegated granule for rtt\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR_POINT(2)));
+        return;
+    }
+
+    for (level = START_LEVEL + 1; level <= VAL_RTT_MAX_LEVEL; level++)
+    {
+        /* Granule left in use after a failure is not returned to the pool */
+        if (perf_rtt_create_level(realm.rd, rtt, level))
+        {
+            val_set_status(RESULT_FAIL(VAL_ERROR_POINT(3)));
+            return;
+        }
+
+        /* Keep a table at this level to benchmark the next one */
+        if (level < VAL_RTT_MAX_LEVEL &&
+            val_host_create_rtt_levels(&realm, PERF_IPA_BASE, level - 1, level, PAGE_SIZE))
+        {
+            LOG(ERROR, "\tRTT levels creation failed, level=%d\n", level, 0);
+            val_set_status(RESULT_FAIL(VAL_ERROR_POINT(4)));
+            return;
+        }
+    }
+
+    val_host_granule_pool_release(rtt);
+    val_set_status(RESULT_PASS(VAL_SUCCESS));
+}
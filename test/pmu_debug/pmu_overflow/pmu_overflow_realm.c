@@ -9,6 +9,7 @@
 #include "val_realm_rsi.h"
 #include "val_pmu.h"
 #include "val_irq.h"
+#include "val_timer.h"
 
 static volatile int handler_flag;
 
@@ -27,7 +28,6 @@ static int rmi_pmu_handler(void)
 
 void pmu_overflow_realm(void)
 {
-    uint64_t timeout = 0x10000000000;
     uint64_t dfr0;
 
     /* Below code is executed for REC[0] only */
@@ -58,12 +58,9 @@ void pmu_overflow_realm(void)
     write_pmintenset_el1((1UL << 0));
 
     enable_counting();
-    while ((read_pmintenset_el1() != 0UL) && --timeout)
-    {
-    }
+    val_wait_until(read_pmintenset_el1() == 0UL, VAL_WAIT_INTR_NS);
 
-    timeout = 0x1000000;
-    while (--timeout && !handler_flag);
+    val_wait_until(handler_flag, VAL_WAIT_INTR_NS);
     if (handler_flag == 1)
     {
         handler_flag = 0;
@@ -16,7 +16,12 @@ set(CMAKE_SHARED_LIBRARY_SUFFIX "")
 set(CMAKE_EXECUTABLE_SUFFIX ".elf")
 
 
-if(NOT DEFINED CROSS_COMPILE)
+if(${TARGET} STREQUAL "tgt_linux_native")
+    # Native target builds the host image as a Linux executable
+    set(CMAKE_C_COMPILER  "${CROSS_COMPILE}gcc")
+    set(CMAKE_C_COMPILER_ID "native" CACHE INTERNAL "Native compiler ID" FORCE)
+    set(COMPILER_FILE "${ROOT_DIR}/tools/cmake/toolchain/native.cmake")
+elseif(NOT DEFINED CROSS_COMPILE)
     message(FATAL_ERROR "CROSS_COMPILE is undefined.")
 else()
     set(CMAKE_C_COMPILER  "${CROSS_COMPILE}gcc")
@@ -39,7 +44,11 @@ if(DEFINED CC)
 endif()
 
 ## Always use ld for linking
-set(LINKER_FILE "${ROOT_DIR}/tools/cmake/toolchain/linker.cmake")
+if(${TARGET} STREQUAL "tgt_linux_native")
+    set(LINKER_FILE "${ROOT_DIR}/tools/cmake/toolchain/native.cmake")
+else()
+    set(LINKER_FILE "${ROOT_DIR}/tools/cmake/toolchain/linker.cmake")
+endif()
 
 set(CROSS_COMPILE ${CROSS_COMPILE} CACHE INTERNAL "CROSS_COMPILE is set to ${CROSS_COMPILE}" FORCE)
 set(CMAKE_C_COMPILER ${CMAKE_C_COMPILER} CACHE INTERNAL "CMAKE_C_COMPILER is set to ${CMAKE_C_COMPILER}" FORCE)
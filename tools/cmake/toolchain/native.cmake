@@ -0,0 +1,84 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+# Toolchain and link rules for the tgt_linux_native target. The host image is
+# built with the build machine compiler and linked as a Linux executable, the
+# realm image is linked into it.
+
+if(_TOOLCHAIN_CMAKE_LOADED)
+  return()
+endif()
+set(_TOOLCHAIN_CMAKE_LOADED TRUE)
+
+set(CMAKE_ASM_COMPILER "${CMAKE_C_COMPILER}" CACHE FILEPATH "The native asm" FORCE)
+set(CMAKE_AR "${CROSS_COMPILE}ar" CACHE FILEPATH "The native archiver" FORCE)
+set(CMAKE_OBJCOPY "${CROSS_COMPILE}objcopy" CACHE FILEPATH "The native objcopy" FORCE)
+
+if(${CMAKE_BUILD_TYPE} STREQUAL "Debug")
+    set(C_COMPILE_DEBUG_OPTIONS "-g")
+else()
+    set(C_COMPILE_DEBUG_OPTIONS "")
+endif()
+
+# The VAL still builds AArch64 translation tables and register layouts
+add_definitions(-DLINUX_NATIVE_BUILD -D__aarch64__)
+
+set(CMAKE_C_FLAGS          "${C_COMPILE_DEBUG_OPTIONS} -fno-pie -mcmodel=large -ffunction-sections -fdata-sections -O2 -ffreestanding -pthread -Wall -Werror -std=gnu99 -Wmissing-prototypes -Wmissing-declarations -Wstrict-prototypes -Wextra -Wconversion -Wsign-conversion -Wcast-align -Wstrict-overflow -Wno-packed-bitfield-compat -include ${ROOT_DIR}/plat/targets/${TARGET}/inc/pal_native_cdefs.h")
+set(CMAKE_ASM_FLAGS        "${C_COMPILE_DEBUG_OPTIONS} -c -x assembler-with-cpp -Wall -Werror")
+
+# The image has no fixed load address on Linux. The linker symbols describing
+# the host image layout point at the placeholder window reserved for the host
+# image by pal_config_def.h so that the translation table setup stays valid.
+file(WRITE ${CMAKE_BINARY_DIR}/native_image_base.c
+    "#include \"pal_config_def.h\"\nPLATFORM_HOST_IMAGE_BASE\n")
+execute_process(
+    COMMAND ${CMAKE_C_COMPILER} -E -P -I${ROOT_DIR}/plat/targets/${TARGET}/inc/
+            ${CMAKE_BINARY_DIR}/native_image_base.c
+    OUTPUT_VARIABLE NATIVE_IMAGE_BASE
+    OUTPUT_STRIP_TRAILING_WHITESPACE
+)
+math(EXPR NATIVE_IMAGE_BASE "${NATIVE_IMAGE_BASE}" OUTPUT_FORMAT HEXADECIMAL)
+
+set(NATIVE_IMAGE_SYMBOLS "")
+set(_offset 0)
+foreach(_section TEXT RODATA DATA BSS)
+    math(EXPR _start "${NATIVE_IMAGE_BASE} + ${_offset}" OUTPUT_FORMAT HEXADECIMAL)
+    math(EXPR _offset "${_offset} + 0x1000")
+    math(EXPR _end "${NATIVE_IMAGE_BASE} + ${_offset}" OUTPUT_FORMAT HEXADECIMAL)
+    list(APPEND NATIVE_IMAGE_SYMBOLS
+        "-Wl,--defsym=__${_section}_START__=${_start}"
+        "-Wl,--defsym=__${_section}_END__=${_end}")
+endforeach()
+
+function (create_executable EXE_NAME OUTPUT_DIR TEST)
+    if(${EXE_NAME} STREQUAL "acs_realm")
+        # The realm image is a relocatable object linked into the host
+        # executable. Its symbols are made local, so that they do not clash
+        # with the host VAL, except the entry point and the data bounds used
+        # by the RMM model. PAL calls resolve to the host PAL.
+        add_custom_command(OUTPUT ${EXE_NAME}${TEST}.o
+                        COMMAND ${CMAKE_C_COMPILER} -r -nostdlib -o ${OUTPUT_DIR}/${EXE_NAME}.o
+                                -Wl,-T,${ROOT_DIR}/tools/cmake/toolchain/native_realm.ld
+                                -Wl,--whole-archive ${VAL_LIB}.a ${TEST_LIB}.a -Wl,--no-whole-archive
+                        COMMAND ${CMAKE_OBJCOPY} --keep-global-symbol=acs_realm_entry
+                                --keep-global-symbol=__REALM_DATA_START__
+                                --keep-global-symbol=__REALM_DATA_END__
+                                ${OUTPUT_DIR}/${EXE_NAME}.o
+                        DEPENDS ${VAL_LIB} ${TEST_LIB})
+        add_custom_target(${EXE_NAME}${TEST}_elf ALL DEPENDS ${EXE_NAME}${TEST}.o)
+        return()
+    endif()
+
+    # Link the objects, with the realm image built in the same output directory
+    add_custom_command(OUTPUT ${EXE_NAME}${TEST}.elf
+                    COMMAND ${CMAKE_C_COMPILER} -no-pie -pthread -o ${OUTPUT_DIR}/${EXE_NAME}.elf
+                            -Wl,--start-group ${VAL_LIB}.a ${PAL_LIB}.a ${TEST_LIB}.a -Wl,--end-group
+                            ${OUTPUT_DIR}/acs_realm.o
+                            ${NATIVE_IMAGE_SYMBOLS} -Wl,-T,${ROOT_DIR}/tools/cmake/toolchain/native_log_fmt.ld -lrt
+                    DEPENDS ${VAL_LIB} ${PAL_LIB} ${TEST_LIB} acs_realm${TEST}_elf)
+    add_custom_target(${EXE_NAME}${TEST}_elf ALL DEPENDS ${EXE_NAME}${TEST}.elf)
+endfunction()
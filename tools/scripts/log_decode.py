@@ -0,0 +1,171 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+#------------------------------------------------------------------------------
+# Turn the UART log of a -DLOG_TOKENS=ON build back into text. A token record
+# is a byte 0xF0 ORed with the security state of the image that logged it,
+# then the format ID, data1 and data2 as ULEB128 values. The format ID is the
+# offset of the format string from __LOG_FMT_START__ in that image. A value
+# record has bit 3 of the first byte set and carries the number of values and
+# the values instead of data1 and data2.
+# Usage:
+#   python3 log_decode.py <uart_log> --host <acs_host.elf>
+#                         [--realm <acs_realm.elf>] [--secure <acs_secure.elf>]
+#------------------------------------------------------------------------------
+
+import struct
+import sys
+
+TOKEN_MARK = 0xF0
+TOKEN_VALUES = 0x08
+TOKEN_STATE_MASK = 0x07
+FMT_START = b"__LOG_FMT_START__"
+
+SECURITY_STATE = {"--host": 1, "--realm": 2, "--secure": 3}
+
+SHT_SYMTAB = 2
+SHT_NOBITS = 8
+
+
+class Image:
+    """Format strings of one ELF64 little endian image."""
+
+    def __init__(self, path):
+        with open(path, "rb") as elf:
+            self.data = elf.read()
+
+        if self.data[:4] != b"\x7fELF" or self.data[4] != 2 or self.data[5] != 1:
+            sys.exit("%s: not an ELF64 little endian file" % path)
+
+        shoff, = struct.unpack_from("<Q", self.data, 0x28)
+        shentsize, shnum = struct.unpack_from("<HH", self.data, 0x3A)
+        self.sections = [struct.unpack_from("<IIQQQQIIQQ", self.data, shoff + i * shentsize)
+                         for i in range(shnum)]
+
+        self.start = self.symbol(FMT_START)
+        if self.start is None:
+            sys.exit("%s: %s not found, not a -DLOG_TOKENS=ON image" %
+                     (path, FMT_START.decode()))
+
+    def symbol(self, name):
+        for section in self.sections:
+            if section[1] != SHT_SYMTAB:
+                continue
+            strtab = self.sections[section[6]]
+            for offset in range(section[4], section[4] + section[5], section[9]):
+                st_name, _, _, _, st_value, _ = struct.unpack_from("<IBBHQQ", self.data, offset)
+                end = self.data.index(b"\0", strtab[4] + st_name)
+                if self.data[strtab[4] + st_name:end] == name:
+                    return st_value
+        return None
+
+    def string(self, fmt_id):
+        address = self.start + fmt_id
+        for section in self.sections:
+            _, sh_type, _, sh_addr, sh_offset, sh_size = section[:6]
+            if sh_type != SHT_NOBITS and sh_addr <= address < sh_addr + sh_size:
+                offset = sh_offset + address - sh_addr
+                return self.data[offset:self.data.index(b"\0", offset)].decode(errors="replace")
+        return None
+
+
+def format_msg(msg, values):
+    """Print a format string the way pal_printf does."""
+    out = []
+    data = list(values)
+    i = 0
+
+    while i < len(msg):
+        if msg[i] != "%":
+            out.append(msg[i])
+            i += 1
+            continue
+
+        i += 1
+        if i < len(msg) and msg[i] in "lL":
+            i += 1
+
+        # Any other conversion prints 0 and does not use a value
+        spec = msg[i] if i < len(msg) else ""
+        if spec == "d":
+            out.append("%d" % data.pop(0))
+        elif spec in ("x", "X"):
+            out.append("%X" % data.pop(0))
+        else:
+            out.append("0")
+        data.append(0)
+        i += 1
+
+    return "".join(out)
+
+
+def read_uleb(log, pos):
+    value = shift = 0
+    while True:
+        if pos >= len(log):
+            return None, pos
+        byte = log[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def decode(log, images, out):
+    pos = 0
+    while pos < len(log):
+        byte = log[pos]
+        if byte & 0xF0 != TOKEN_MARK:
+            out.write(chr(byte) if byte < 0x80 else "?")
+            pos += 1
+            continue
+
+        state = byte & TOKEN_STATE_MASK
+        pos += 1
+        fmt_id, pos = read_uleb(log, pos)
+        count, pos = read_uleb(log, pos)
+        if count is not None and byte & TOKEN_VALUES:
+            values = []
+            for _ in range(count):
+                value, pos = read_uleb(log, pos)
+                values.append(value)
+        else:
+            data2, pos = read_uleb(log, pos)
+            values = [count, data2]
+        if None in [fmt_id] + values:
+            out.write("<truncated token>\n")
+            break
+
+        image = images.get(state)
+        msg = image.string(fmt_id) if image else None
+        if msg is None:
+            out.write("<token state %d id 0x%x %s>\n" %
+                      (state, fmt_id, " ".join("0x%x" % value for value in values)))
+        else:
+            out.write(format_msg(msg, values))
+
+
+def main(argv):
+    images = {}
+    args = argv[2:]
+
+    if len(argv) < 2 or len(args) % 2:
+        sys.exit("usage: %s <uart_log> --host <acs_host.elf> [--realm <acs_realm.elf>] "
+                 "[--secure <acs_secure.elf>]" % argv[0])
+
+    for option, path in zip(args[::2], args[1::2]):
+        if option not in SECURITY_STATE:
+            sys.exit("unknown option %s" % option)
+        images[SECURITY_STATE[option]] = Image(path)
+
+    with open(argv[1], "rb") as log:
+        decode(log.read(), images, sys.stdout)
+
+
+if __name__ == "__main__":
+    main(sys.argv)
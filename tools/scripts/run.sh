@@ -19,12 +19,25 @@
 # Set defaults
 #------------------------------------------------------------------------------
 ACS_NS_PRELOAD_ADDR_DFLT=0x88000000
+# NVM base + 0x40 of the FVP, see val_run_config_ts
+ACS_RUN_CONFIG_ADDR_DFLT=0x82800040
+RUN_CONFIG_TOOL="$(dirname "$0")/run_config.py"
+TEST_RECORDS_TOOL="$(dirname "$0")/test_records.py"
 arg_dryrun=
 arg_model=
 arg_bl1=
 arg_fip=
 arg_acs_build_dir=
 arg_acs_ns_preload_addr=${ACS_NS_PRELOAD_ADDR_DFLT}
+arg_acs_run_config_addr=${ACS_RUN_CONFIG_ADDR_DFLT}
+# Shard to run (1 based) and number of shards, every shard when arg_shard is 0
+arg_shard=0
+arg_shard_count=1
+# Test selection options of run_config.py, all tests when empty
+arg_run_config=
+# Result records of a previous run to compare with, and options of test_records.py
+arg_baseline=
+arg_baseline_options=
 # Run the test with a timeout so they can't loop forever.
 arg_test_timeout=30
 suite_timeout_multiplier=3
@@ -80,6 +93,47 @@ fvp_cmd=" -C bp.refcounter.non_arch_start_at_default=1 \
 -C bp.pl011_uart1.uart_enable=1 \
 -C bp.pl011_uart2.uart_enable=1 "
 
+#------------------------------------------------------------------------------
+# Functions
+#------------------------------------------------------------------------------
+function print_help()
+{
+    echo "run.sh [options] [-- [model_options]]"
+    echo ""
+    echo "Model Configuration:"
+    echo "  --model PATH           <path_to_model_bin>"
+    echo ""
+    echo "Images:"
+    echo "  --bl1                  <path_to_bl1.bin>"
+    echo "  --fip                  <path_to_fip.bin>"
+    echo "  --acs_build_dir        <path_to_acs_build_directory>"
+    echo "  --acs_ns_preload_addr  <Address where acs_non_secure.bin to be preloaded>"
+    echo "                       (default: ${ACS_NS_PRELOAD_ADDR_DFLT})"
+    echo "  --acs_run_config_addr  <Address where the run configuration is preloaded>"
+    echo "                       (default: ${ACS_RUN_CONFIG_ADDR_DFLT})"
+    echo "Test selection, without a rebuild of a -DTEST_COMBINE=ON image:"
+    echo "  --tests NAME[,NAME]     Run the named tests, at most 8"
+    echo "  --tags TAG[,TAG]        Run the tests with any of the tags, which are"
+    echo "                          mp_unsafe, realm, secure and the suite names"
+    echo "  --skip_tags TAG[,TAG]   Skip the tests with any of the tags"
+    echo "  --range FIRST:LAST      Run the test numbers FIRST to LAST"
+    echo "  --shard i/N             Run shard i (1 to N) of N, every N-th test from test i"
+    echo "  --shards N              Run the N shards on N models in parallel and merge"
+    echo "                          their reports into regression_report.log"
+    echo "Performance regression gate:"
+    echo "  --baseline FILE         Compare the result records with FILE, written by"
+    echo "                          test_records.py extract, and fail on a regression"
+    echo "  --rmi_threshold PCT     Allowed growth of the RMI calls of a test (default: 0)"
+    echo "  --cycle_threshold PCT   Allowed growth of the cycles of a test (default: 10)"
+    echo "Other options:"
+    echo "  --test_timeout          Run each test with specified timeout in seconds"
+    echo "                          (default: ${arg_test_timeout}s)"
+    echo "  --help                  Print this message"
+    echo "  -n / --dry-run          Print command but don't execute anything"
+    echo ""
+    echo "Options passed after an empty '--' are passed straight to the model"
+}
+
 #------------------------------------------------------------------------------
 # Main
 #------------------------------------------------------------------------------
@@ -109,6 +163,36 @@ case "$1" in
         arg_acs_ns_preload_addr="$2"
         shift 2
         ;;
+    --acs_run_config_addr)
+        arg_acs_run_config_addr="$2"
+        shift 2
+        ;;
+
+    # Test selection
+    --tests | --tags | --skip_tags | --range)
+        arg_run_config="${arg_run_config} $1 $2"
+        shift 2
+        ;;
+    --shard)
+        arg_shard="${2%/*}"
+        arg_shard_count="${2#*/}"
+        shift 2
+        ;;
+    --shards)
+        arg_shard=0
+        arg_shard_count="$2"
+        shift 2
+        ;;
+
+    # Performance regression gate
+    --baseline)
+        arg_baseline="$2"
+        shift 2
+        ;;
+    --rmi_threshold | --cycle_threshold)
+        arg_baseline_options="${arg_baseline_options} $1 $2"
+        shift 2
+        ;;
 
     # Other options
     --arg_test_timeout)
@@ -155,6 +239,15 @@ elif [[ ${arg_acs_build_dir} = "" ]] || [[ ! -d ${arg_acs_build_dir} ]]
 then
     echo "Error! --acs_build_dir parameter not set properly"
     exit 1
+elif [[ -n ${arg_baseline} ]] && [[ ! -f ${arg_baseline} ]]
+then
+    echo "Error! --baseline parameter not set properly"
+    exit 1
+elif ! [[ ${arg_shard} =~ ^[0-9]+$ && ${arg_shard_count} =~ ^[1-9][0-9]*$ ]] ||
+     (( arg_shard > arg_shard_count ))
+then
+    echo "Error! --shard/--shards parameter not set properly"
+    exit 1
 fi
 
 fvp_cmd="${arg_model} ${fvp_cmd} \
@@ -171,21 +264,76 @@ then
     tfa_rmm_logfile=${arg_acs_build_dir}/output/tfa_rmm.log
 
     fvp_cmd="${fvp_cmd} \
- --data cluster0.cpu0=${arg_acs_build_dir}/output/acs_non_secure.bin@${arg_acs_ns_preload_addr}\
- -C bp.pl011_uart2.out_file=${regression_report_logfile}"
+ --data cluster0.cpu0=${arg_acs_build_dir}/output/acs_non_secure.bin@${arg_acs_ns_preload_addr}"
 
     arg_test_timeout=$(($arg_test_timeout * $suite_timeout_multiplier))
 
-    echo "Running model command: timeout $arg_test_timeout $fvp_cmd | tee ${tfa_rmm_logfile}"
-    if [[ ${arg_dryrun} != "yes" ]]
+    if (( arg_shard_count > 1 ))
     then
-        # delete any older logfile
-        rm -f $regression_report_logfile $tfa_rmm_logfile
-        # Execute the command
-        timeout $arg_test_timeout $fvp_cmd | tee ${tfa_rmm_logfile}
-        #Generate regression summary
+        # One model per shard, each with its own run configuration and logs
+        shard_logs=
+        if (( arg_shard ))
+        then
+            shards=$((arg_shard - 1))
+        else
+            shards=$(seq 0 $((arg_shard_count - 1)))
+        fi
+
+        for shard in ${shards}; do
+            shard_name=shard$((shard + 1))
+            run_config_file=${arg_acs_build_dir}/output/run_config_${shard_name}.bin
+            shard_report_logfile=${arg_acs_build_dir}/output/regression_report_${shard_name}.log
+            shard_tfa_rmm_logfile=${arg_acs_build_dir}/output/tfa_rmm_${shard_name}.log
+            shard_logs="${shard_logs} ${shard_report_logfile}"
+
+            fvp_cmd_shard="${fvp_cmd} \
+ --data cluster0.cpu0=${run_config_file}@${arg_acs_run_config_addr} \
+ -C bp.pl011_uart2.out_file=${shard_report_logfile}"
+
+            echo "Running model command for ${shard_name} of ${arg_shard_count}: timeout \
+$arg_test_timeout $fvp_cmd_shard > ${shard_tfa_rmm_logfile}"
+            if [[ ${arg_dryrun} != "yes" ]]
+            then
+                rm -f $shard_report_logfile $shard_tfa_rmm_logfile
+                python3 $RUN_CONFIG_TOOL $run_config_file \
+                    --shard $((shard + 1))/$arg_shard_count ${arg_run_config} || exit 1
+                timeout $arg_test_timeout $fvp_cmd_shard > ${shard_tfa_rmm_logfile} &
+            fi
+        done
+
+        wait
+        echo "Model commands completed"
+
+        if (( arg_shard ))
+        then
+            regression_report_logfile=${shard_logs# }
+        elif [[ ${arg_dryrun} != "yes" ]]
+        then
+            python3 "$(dirname "$0")/shard_merge.py" ${shard_logs} > $regression_report_logfile
+            sed -n '/SHARD REPORT/,$p' $regression_report_logfile
+        fi
+    else
+        if [[ -n ${arg_run_config} ]]
+        then
+            run_config_file=${arg_acs_build_dir}/output/run_config.bin
+            python3 $RUN_CONFIG_TOOL $run_config_file ${arg_run_config} || exit 1
+            fvp_cmd="${fvp_cmd} \
+ --data cluster0.cpu0=${run_config_file}@${arg_acs_run_config_addr}"
+        fi
+
+        fvp_cmd="${fvp_cmd} -C bp.pl011_uart2.out_file=${regression_report_logfile}"
+
+        echo "Running model command: timeout $arg_test_timeout $fvp_cmd | tee ${tfa_rmm_logfile}"
+        if [[ ${arg_dryrun} != "yes" ]]
+        then
+            # delete any older logfile
+            rm -f $regression_report_logfile $tfa_rmm_logfile
+            # Execute the command
+            timeout $arg_test_timeout $fvp_cmd | tee ${tfa_rmm_logfile}
+            #Generate regression summary
+        fi
+        echo "Model command completed"
     fi
-    echo "Model command completed"
 else
     cd ${arg_acs_build_dir}/output/
     for suite in */;do
@@ -235,30 +383,10 @@ Total Pass  :$total_pass
 Total Skip  :$total_skip
 Total Fail  :$total_fail
 ***************************"
-exit 0
-
-#------------------------------------------------------------------------------
-# Functions
-#------------------------------------------------------------------------------
-function print_help()
-{
-    echo "run.sh [options] [-- [model_options]]"
-    echo ""
-    echo "Model Configuration:"
-    echo "  --model PATH           <path_to_model_bin>"
-    echo ""
-    echo "Images:"
-    echo "  --bl1                  <path_to_bl1.bin>"
-    echo "  --fip                  <path_to_fip.bin>"
-    echo "  --acs_build_dir        <path_to_acs_build_directory>"
-    echo "  --acs_ns_preload_addr  <Address where acs_non_secure.bin to be preloaded>"
-    echo "                       (default: ${ACS_NS_PRELOAD_ADDR_DFLT})"
-    echo "Other options:"
-    echo "  --test_timeout          Run each test with specified timeout in seconds"
-    echo "                          (default: ${arg_test_timeout}s)"
-    echo "  --help                  Print this message"
-    echo "  -n / --dry-run          Print command but don't execute anything"
-    echo ""
-    echo "Options passed after an empty '--' are passed straight to the model"
-}
 
+if [[ -n ${arg_baseline} ]] && [[ ${arg_dryrun} != "yes" ]]
+then
+    python3 $TEST_RECORDS_TOOL compare ${arg_baseline} $regression_report_logfile \
+        ${arg_baseline_options} || exit 1
+fi
+exit 0
@@ -0,0 +1,104 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+#------------------------------------------------------------------------------
+# Write the run configuration (val_run_config_ts) that selects the tests a
+# TEST_COMBINE image runs. The file is preloaded at NVM base + 0x40 of the
+# model, or with --nvm written at offset 0x40 of the NVM file of the native
+# target, which keeps its other content.
+# Usage:
+#   python3 run_config.py <file> [--nvm] [--shard i/N] [--tests name,...]
+#                         [--tags tag,...] [--skip_tags tag,...] [--range first:last]
+# Tags are mp_unsafe, realm, secure and the suite names.
+#------------------------------------------------------------------------------
+
+import argparse
+import struct
+import sys
+
+RUN_CONFIG_MAGIC = 0x44524853
+RUN_CONFIG_OFFSET = 0x40
+RUN_CONFIG_NAMES = 8
+RUN_CONFIG_NAME_LEN = 48
+
+# test_db_t.tags of test/database/test_database.h
+TAGS = {"mp_unsafe": 1 << 0, "realm": 1 << 1, "secure": 1 << 2}
+SUITE_SHIFT = 8
+SUITES = ["attestation_measurement", "command", "exception", "gic",
+          "memory_management", "perf", "pmu_debug"]
+TAGS.update((suite, 1 << (SUITE_SHIFT + i)) for i, suite in enumerate(SUITES))
+
+
+def tag_mask(names):
+    mask = 0
+    for name in filter(None, names.split(",")):
+        if name not in TAGS:
+            sys.exit("unknown tag %s, tags are %s" % (name, ", ".join(TAGS)))
+        mask |= TAGS[name]
+    return mask
+
+
+def build(args):
+    index, count = 1, 1
+    if args.shard:
+        index, count = (int(x) for x in args.shard.split("/"))
+        if not 1 <= index <= count:
+            sys.exit("--shard i/N needs 1 <= i <= N")
+
+    names = [name for name in args.tests.split(",") if name] if args.tests else []
+    if len(names) > RUN_CONFIG_NAMES:
+        sys.exit("at most %d tests can be named" % RUN_CONFIG_NAMES)
+    for name in names:
+        if len(name) >= RUN_CONFIG_NAME_LEN:
+            sys.exit("test name %s longer than %d characters" % (name, RUN_CONFIG_NAME_LEN - 1))
+
+    first, last = 0, 0
+    if args.range:
+        first, _, last = args.range.partition(":")
+        first, last = int(first or 0), int(last or 0)
+
+    block = struct.pack("<8I", RUN_CONFIG_MAGIC, index - 1, count, len(names),
+                        tag_mask(args.tags), tag_mask(args.skip_tags), first, last)
+    for i in range(RUN_CONFIG_NAMES):
+        name = names[i].encode() if i < len(names) else b""
+        block += name.ljust(RUN_CONFIG_NAME_LEN, b"\0")
+    return block
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Write the ACS run configuration")
+    parser.add_argument("file")
+    parser.add_argument("--nvm", action="store_true",
+                        help="write at offset 0x%x of a native NVM file" % RUN_CONFIG_OFFSET)
+    parser.add_argument("--shard", help="run shard i (1 to N) of N")
+    parser.add_argument("--tests", help="run the named tests")
+    parser.add_argument("--tags", default="", help="run the tests with any of the tags")
+    parser.add_argument("--skip_tags", default="", help="skip the tests with any of the tags")
+    parser.add_argument("--range", help="run the test numbers first:last")
+    args = parser.parse_args(argv[1:])
+
+    block = build(args)
+
+    if not args.nvm:
+        with open(args.file, "wb") as out:
+            out.write(block)
+        return
+
+    try:
+        with open(args.file, "rb") as nvm:
+            data = bytearray(nvm.read())
+    except FileNotFoundError:
+        data = bytearray()
+
+    data.extend(b"\0" * max(0, RUN_CONFIG_OFFSET + len(block) - len(data)))
+    data[RUN_CONFIG_OFFSET:RUN_CONFIG_OFFSET + len(block)] = block
+    with open(args.file, "wb") as nvm:
+        nvm.write(data)
+
+
+if __name__ == "__main__":
+    main(sys.argv)
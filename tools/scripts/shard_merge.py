@@ -0,0 +1,117 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+#------------------------------------------------------------------------------
+# Merge the regression reports of the shards of a run into one report. Shard k
+# of N runs the tests whose (test number - 1) % N is k. The test outputs are
+# printed in the order of the full run, by the test number of their Duration
+# line, or else taking the j-th test in the log of shard k as test k + j * N.
+# A summary of the shards and the duration of each test follow.
+# Usage:
+#   python3 shard_merge.py <shard_1_log> ... <shard_N_log>
+#------------------------------------------------------------------------------
+
+import re
+import sys
+
+SUITE = "Suite="
+REPORT = "REGRESSION REPORT"
+
+RESULT = re.compile(r"Result => (\w+)")
+DURATION = re.compile(r"Duration => (\d+) us(?: \(test (\d+)\))?")
+
+# Result word of the ACS and the total it is counted in
+TOTALS = [("Passed", "TOTAL PASSED"), ("Failed", "TOTAL FAILED"),
+          ("Skipped", "TOTAL SKIPPED"), ("Error", "TOTAL SIM ERROR")]
+
+
+class Test:
+    """Output of one test in a shard log."""
+
+    def __init__(self, name):
+        self.name = name
+        self.lines = []
+        self.result = None
+        self.duration = None
+        self.number = None
+
+    def add(self, line):
+        self.lines.append(line)
+        match = RESULT.search(line)
+        if match:
+            self.result = match.group(1)
+        match = DURATION.search(line)
+        if match:
+            self.duration = int(match.group(1))
+            if match.group(2):
+                self.number = int(match.group(2))
+
+
+def parse(path):
+    """Return the tests of a shard log in the order they ran."""
+    tests = []
+    test = None
+
+    try:
+        with open(path, "r", errors="replace") as log:
+            lines = log.readlines()
+    except OSError as err:
+        sys.stderr.write("%s: %s, shard counted as empty\n" % (path, err.strerror))
+        return tests
+
+    for line in lines:
+        if SUITE in line:
+            test = Test(line[line.index(SUITE) + len(SUITE):].strip())
+            tests.append(test)
+        elif REPORT in line:
+            test = None
+        if test is not None:
+            test.add(line)
+
+    return tests
+
+
+def main(argv):
+    if len(argv) < 2:
+        sys.exit("usage: %s <shard_1_log> ... <shard_N_log>" % argv[0])
+
+    shards = [parse(path) for path in argv[1:]]
+    count = len(shards)
+    ordered = {}
+
+    for k, tests in enumerate(shards):
+        for j, test in enumerate(tests):
+            index = k + j * count + 1
+            ordered[(test.number or index, index)] = test
+
+    tests = [ordered[index] for index in sorted(ordered)]
+    out = sys.stdout
+
+    for test in tests:
+        out.write("".join(test.lines))
+
+    out.write("\n\nSHARD REPORT: \n")
+    out.write("==================\n")
+    out.write("   SHARDS          : %d\n" % count)
+    out.write("   TOTAL TESTS     : %d\n" % len(tests))
+    for word, total in TOTALS:
+        out.write("   %-15s : %d\n" % (total, sum(1 for t in tests if t.result == word)))
+    out.write("   NO RESULT       : %d\n\n" % sum(1 for t in tests if t.result is None))
+
+    for k, shard in enumerate(shards):
+        out.write("   SHARD %-9d : %d tests, %d us\n" %
+                  (k + 1, len(shard), sum(t.duration or 0 for t in shard)))
+
+    out.write("\nTEST DURATIONS (us): \n")
+    out.write("==================\n")
+    for test in tests:
+        duration = "-" if test.duration is None else "%d" % test.duration
+        out.write("   %10s  %-8s %s\n" % (duration, test.result or "-", test.name))
+
+
+if __name__ == "__main__":
+    main(sys.argv)
@@ -0,0 +1,201 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+#------------------------------------------------------------------------------
+# Convert the SMC trace printed by a -DSMC_TRACE=ON build into a binary trace
+# and print it in a readable form.
+# Usage:
+#   python3 smc_trace.py extract <uart_log> <trace.bin>
+#   python3 smc_trace.py show <uart_log|trace.bin>
+#
+# Replay a binary trace against the RMM model of the native target:
+#   <native_build>/output/acs_host.elf --replay <trace.bin>
+#------------------------------------------------------------------------------
+
+import struct
+import sys
+
+TRACE_MAGIC = b"RMMSMCTR"
+TRACE_VERSION = 1
+IN_REGS = 10
+OUT_REGS = 11
+FLAG_PAGE = 1
+PAGE_SIZE = 0x1000
+
+# Layout of val_smc_trace_rec_ts
+REC_FORMAT = "<Q%dQ%dQQHBBI" % (IN_REGS, OUT_REGS)
+REC_SIZE = struct.calcsize(REC_FORMAT)
+HDR_FORMAT = "<8sII"
+
+SECURITY_STATE = {1: "HOST", 2: "REALM", 3: "SECURE"}
+
+FID_NAME = {
+    0xC4000150: "RMI_VERSION",
+    0xC4000151: "RMI_GRANULE_DELEGATE",
+    0xC4000152: "RMI_GRANULE_UNDELEGATE",
+    0xC4000153: "RMI_DATA_CREATE",
+    0xC4000154: "RMI_DATA_CREATE_UNKNOWN",
+    0xC4000155: "RMI_DATA_DESTROY",
+    0xC4000157: "RMI_REALM_ACTIVATE",
+    0xC4000158: "RMI_REALM_CREATE",
+    0xC4000159: "RMI_REALM_DESTROY",
+    0xC400015A: "RMI_REC_CREATE",
+    0xC400015B: "RMI_REC_DESTROY",
+    0xC400015C: "RMI_REC_ENTER",
+    0xC400015D: "RMI_RTT_CREATE",
+    0xC400015E: "RMI_RTT_DESTROY",
+    0xC400015F: "RMI_RTT_MAP_UNPROTECTED",
+    0xC4000161: "RMI_RTT_READ_ENTRY",
+    0xC4000162: "RMI_RTT_UNMAP_UNPROTECTED",
+    0xC4000164: "RMI_PSCI_COMPLETE",
+    0xC4000165: "RMI_FEATURES",
+    0xC4000166: "RMI_RTT_FOLD",
+    0xC4000167: "RMI_REC_AUX_COUNT",
+    0xC4000168: "RMI_RTT_INIT_RIPAS",
+    0xC4000169: "RMI_RTT_SET_RIPAS",
+    0xC4000190: "RSI_VERSION",
+    0xC4000191: "RSI_FEATURES",
+    0xC4000192: "RSI_MEASUREMENT_READ",
+    0xC4000193: "RSI_MEASUREMENT_EXTEND",
+    0xC4000194: "RSI_ATTESTATION_TOKEN_INIT",
+    0xC4000195: "RSI_ATTESTATION_TOKEN_CONTINUE",
+    0xC4000196: "RSI_REALM_CONFIG",
+    0xC4000197: "RSI_IPA_STATE_SET",
+    0xC4000198: "RSI_IPA_STATE_GET",
+    0xC4000199: "RSI_HOST_CALL",
+    0x84000000: "PSCI_VERSION",
+    0xC4000001: "PSCI_CPU_SUSPEND",
+    0x84000002: "PSCI_CPU_OFF",
+    0xC4000003: "PSCI_CPU_ON",
+    0xC4000004: "PSCI_AFFINITY_INFO",
+    0x84000008: "PSCI_SYSTEM_OFF",
+    0x84000009: "PSCI_SYSTEM_RESET",
+    0x8400000A: "PSCI_FEATURES",
+}
+
+
+class Record:
+    def __init__(self, fid, regs_in, regs_out, timestamp, cpu, security_state):
+        self.fid = fid
+        self.regs_in = regs_in
+        self.regs_out = regs_out
+        self.timestamp = timestamp
+        self.cpu = cpu
+        self.security_state = security_state
+        self.page = None
+
+    def pack(self):
+        flags = FLAG_PAGE if self.page is not None else 0
+        data = struct.pack(REC_FORMAT, self.fid, *self.regs_in, *self.regs_out,
+                           self.timestamp, self.cpu, self.security_state, flags, 0)
+        if self.page is not None:
+            data += self.page
+        return data
+
+
+def parse_log(path):
+    """Rebuild the records from the SMCT/SMCP/SMCL lines of a UART log."""
+    records = []
+    host = {}
+    lost = 0
+
+    with open(path, errors="replace") as log:
+        for line in log:
+            fields = line.strip().split()
+            if not fields:
+                continue
+
+            if fields[0] == "SMCT" and len(fields) == 6 + IN_REGS + OUT_REGS:
+                values = [int(f, 16) for f in fields[1:]]
+                seq, security_state, cpu, timestamp, fid = values[:5]
+                rec = Record(fid, values[5:5 + IN_REGS], values[5 + IN_REGS:],
+                             timestamp, cpu, security_state)
+                records.append(rec)
+                if security_state == 1:
+                    host[seq] = rec
+            elif fields[0] == "SMCP" and len(fields) == 4:
+                seq, offset, value = (int(f, 16) for f in fields[1:])
+                rec = host.get(seq)
+                if rec is None:
+                    continue
+                if rec.page is None:
+                    rec.page = bytearray(PAGE_SIZE)
+                struct.pack_into("<Q", rec.page, offset, value)
+            elif fields[0] == "SMCL" and len(fields) == 3:
+                lost += int(fields[2], 16)
+
+    if lost:
+        print("warning: %d records were overwritten before the dump" % lost,
+              file=sys.stderr)
+
+    for rec in records:
+        if rec.page is not None:
+            rec.page = bytes(rec.page)
+
+    return records
+
+
+def read_trace(path):
+    records = []
+
+    with open(path, "rb") as trace:
+        magic, version, rec_size = struct.unpack(HDR_FORMAT,
+                                                 trace.read(struct.calcsize(HDR_FORMAT)))
+        if magic != TRACE_MAGIC or version != TRACE_VERSION or rec_size != REC_SIZE:
+            sys.exit("%s: not a version %d trace" % (path, TRACE_VERSION))
+
+        while True:
+            data = trace.read(REC_SIZE)
+            if len(data) < REC_SIZE:
+                break
+            values = struct.unpack(REC_FORMAT, data)
+            rec = Record(values[0], list(values[1:1 + IN_REGS]),
+                         list(values[1 + IN_REGS:1 + IN_REGS + OUT_REGS]),
+                         values[-5], values[-4], values[-3])
+            if values[-2] & FLAG_PAGE:
+                rec.page = trace.read(PAGE_SIZE)
+            records.append(rec)
+
+    return records
+
+
+def load(path):
+    with open(path, "rb") as f:
+        magic = f.read(len(TRACE_MAGIC))
+    return read_trace(path) if magic == TRACE_MAGIC else parse_log(path)
+
+
+def extract(log_path, trace_path):
+    records = parse_log(log_path)
+    with open(trace_path, "wb") as trace:
+        trace.write(struct.pack(HDR_FORMAT, TRACE_MAGIC, TRACE_VERSION, REC_SIZE))
+        for rec in records:
+            trace.write(rec.pack())
+    print("%d records written to %s" % (len(records), trace_path))
+
+
+def show(path):
+    for index, rec in enumerate(load(path)):
+        name = FID_NAME.get(rec.fid, "0x%x" % rec.fid)
+        print("%6d %16x %-6s cpu%d %-30s in: %s" %
+              (index, rec.timestamp, SECURITY_STATE.get(rec.security_state, "?"),
+               rec.cpu, name, " ".join("%x" % r for r in rec.regs_in[:7])))
+        print("%62s out: %s%s" % ("", " ".join("%x" % r for r in rec.regs_out[:5]),
+                                  " (params captured)" if rec.page else ""))
+
+
+def main(argv):
+    if len(argv) == 4 and argv[1] == "extract":
+        extract(argv[2], argv[3])
+    elif len(argv) == 3 and argv[1] == "show":
+        show(argv[2])
+    else:
+        sys.exit("usage: %s extract <uart_log> <trace.bin> | show <uart_log|trace.bin>" % argv[0])
+
+
+if __name__ == "__main__":
+    main(sys.argv)
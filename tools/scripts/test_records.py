@@ -0,0 +1,158 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+#------------------------------------------------------------------------------
+# Read the ACS_RECORD lines that the host prints after the result of each test
+# and compare them with a baseline, typically the run of the previous RMM
+# drop. A test regresses when its RMI call count or its cycle count grows by
+# more than the threshold, or when it no longer passes. The cycle count is the
+# PMU cycles of -DTEST_PROFILE=ON runs on a PE with a PMU, else CNTPCT ticks.
+# Usage:
+#   python3 test_records.py extract <uart_log> <baseline.json>
+#   python3 test_records.py compare <baseline> <uart_log or json>
+#                           [--rmi_threshold pct] [--cycle_threshold pct]
+#                           [--min_cycles count]
+# Exits with 1 when a test regressed.
+#------------------------------------------------------------------------------
+
+import argparse
+import json
+import re
+import sys
+
+MARKER = "ACS_RECORD:"
+FIELD = re.compile(r"(\w+)=(\S+)")
+
+# Test states of val.h, bits [15:8] of the status
+TEST_STATE_SHIFT = 8
+STATES = {1: "start", 2: "pass", 3: "fail", 4: "skip", 5: "error"}
+
+
+def parse_log(path):
+    """Return the records of a UART log, by test name."""
+    records = {}
+
+    with open(path, "r", errors="replace") as log:
+        for line in log:
+            if MARKER not in line:
+                continue
+
+            record = {}
+            for key, value in FIELD.findall(line[line.index(MARKER) + len(MARKER):]):
+                try:
+                    record[key] = int(value, 0)
+                except ValueError:
+                    record[key] = value
+
+            if "test" in record:
+                records[record["test"]] = record
+
+    return records
+
+
+def load(path):
+    """Return the records of a JSON file written by extract or of a UART log."""
+    with open(path, "r", errors="replace") as data:
+        head = data.read(1)
+
+    if head in "{[":
+        with open(path, "r") as data:
+            return json.load(data)
+
+    return parse_log(path)
+
+
+def state(record):
+    return STATES.get((record.get("status", 0) >> TEST_STATE_SHIFT) & 0xff, "unknown")
+
+
+def cycles(record, other):
+    """Cycle count of a record, PMU cycles when both records have them."""
+    if "cycles" in record and "cycles" in other:
+        return record["cycles"], "cycles"
+    return record.get("ticks"), "ticks"
+
+
+def grew(base, curr, threshold):
+    return base is not None and curr is not None and curr > base * (1 + threshold / 100.0)
+
+
+def extract(args):
+    records = parse_log(args.log)
+    if not records:
+        sys.exit("%s: no %s lines" % (args.log, MARKER))
+
+    with open(args.out, "w") as out:
+        json.dump(records, out, indent=1, sort_keys=True)
+    print("%d records written to %s" % (len(records), args.out))
+
+
+def compare(args):
+    baseline = load(args.baseline)
+    current = load(args.current)
+    regressions = 0
+
+    print("%-40s %-10s %12s %12s %8s" % ("TEST", "CHECK", "BASELINE", "CURRENT", "CHANGE"))
+    for name in sorted(set(baseline) & set(current)):
+        base, curr = baseline[name], current[name]
+        checks = []
+
+        if state(base) == "pass" and state(curr) != "pass":
+            checks.append(("status", state(base), state(curr)))
+
+        if grew(base.get("rmi"), curr.get("rmi"), args.rmi_threshold):
+            checks.append(("rmi", base["rmi"], curr["rmi"]))
+
+        base_cycles, unit = cycles(base, curr)
+        curr_cycles, _ = cycles(curr, base)
+        if (base_cycles is not None and base_cycles >= args.min_cycles and
+                grew(base_cycles, curr_cycles, args.cycle_threshold)):
+            checks.append((unit, base_cycles, curr_cycles))
+
+        for check, old, new in checks:
+            change = "-"
+            if isinstance(old, int) and old:
+                change = "%+.1f%%" % ((new - old) * 100.0 / old)
+            print("%-40s %-10s %12s %12s %8s" % (name, check, old, new, change))
+            regressions += 1
+
+    missing = sorted(set(baseline) - set(current))
+    for name in missing:
+        print("%-40s %-10s" % (name, "not run"))
+
+    print("\n%d tests compared, %d regressions, %d baseline tests not run" %
+          (len(set(baseline) & set(current)), regressions, len(missing)))
+    return 1 if regressions else 0
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Compare ACS result records with a baseline")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    parser_extract = sub.add_parser("extract", help="write the records of a UART log as JSON")
+    parser_extract.add_argument("log")
+    parser_extract.add_argument("out")
+
+    parser_compare = sub.add_parser("compare", help="flag the tests that regressed")
+    parser_compare.add_argument("baseline", help="JSON written by extract, or a UART log")
+    parser_compare.add_argument("current", help="UART log, or JSON written by extract")
+    parser_compare.add_argument("--rmi_threshold", type=float, default=0,
+                                help="allowed growth of the RMI calls in percent (default 0)")
+    parser_compare.add_argument("--cycle_threshold", type=float, default=10,
+                                help="allowed growth of the cycles in percent (default 10)")
+    parser_compare.add_argument("--min_cycles", type=int, default=0,
+                                help="ignore the cycles of tests shorter than this in the baseline")
+    args = parser.parse_args(argv[1:])
+
+    if args.command == "extract":
+        extract(args)
+        return 0
+    return compare(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -61,12 +61,16 @@ extern uint64_t security_state;
 /* Shared region layout
  * 0x0  - 0x7    TEST_NUM
  * 0x8  - 0xF    TEST_STATUS
- * 0x10 - 0x63   REALM_PRINTF_MSG - 90 Chars
+ * 0x10 - 0x63   REALM_PRINTF_MSG - 90 Chars, RECs without a log ring
  * 0x68 - 0x6F   REALM_PRINTF_DATA1
  * 0x70 - 0x77   REALM_PRINTF_DATA2
- * 0x78 - 0x9F   TEST_NAME_STRING - 40 Chars
- * 0xA0 - 0xFFF  VAL_RESERVED
- * 0x1000 - SHARED_END - Test usecase
+ * 0x78 - 0x7F   TEST_ID - Registry ID of the current test
+ * 0x80 - 0x9F   VAL_RESERVED
+ * 0xA0 - 0xDF   TEST_STATUS of each PE, VAL_PARALLEL_DISPATCH builds
+ * 0xE0 - 0xFFF  VAL_RESERVED
+ * 0x1000 - 0x5FFFF  Test usecase
+ * 0x60000 - 0x7FFFF  Realm log rings
+ * 0x80000 - SHARED_END - SMC trace, VAL_SMC_TRACE builds
  * */
 
 typedef enum {
@@ -75,7 +79,8 @@ typedef enum {
     VAL_PRINTF_MSG        = 2,
     VAL_PRINTF_DATA1      = 13,
     VAL_PRINTF_DATA2      = 14,
-    VAL_CURR_TEST_NAME    = 15,
+    VAL_CURR_TEST_ID      = 15,
+    VAL_CPU_TEST_STATUS   = 20,
     VAL_TEST_USE1         = 512,
     VAL_TEST_USE2         = 520,
     VAL_TEST_USE3         = 528,
@@ -90,7 +95,8 @@ typedef enum {
 #define REALM_PRINTF_MSG_OFFSET OFFSET(VAL_PRINTF_MSG)
 #define REALM_PRINTF_DATA1_OFFSET OFFSET(VAL_PRINTF_DATA1)
 #define REALM_PRINTF_DATA2_OFFSET OFFSET(VAL_PRINTF_DATA2)
-#define TEST_NAME_OFFSET OFFSET(VAL_CURR_TEST_NAME)
+#define TEST_ID_OFFSET OFFSET(VAL_CURR_TEST_ID)
+#define CPU_TEST_STATUS_OFFSET(cpu) OFFSET(VAL_CPU_TEST_STATUS + (cpu))
 #define TEST_USE_OFFSET1 OFFSET(VAL_TEST_USE1)
 #define TEST_USE_OFFSET2 OFFSET(VAL_TEST_USE2)
 #define TEST_USE_OFFSET3 OFFSET(VAL_TEST_USE3)
@@ -129,16 +135,41 @@ typedef struct {
     uint32_t test_progress;
 } val_test_info_ts;
 
+/* Regression state kept in NVM across resets, written as one record */
+typedef struct {
+    val_test_info_ts test_info;
+    val_regre_report_ts regre_report;
+} val_regression_state_ts;
+
+#define VAL_RUN_CONFIG_NAMES       8
+#define VAL_RUN_CONFIG_NAME_LEN    48
+
+/* Run configuration preloaded into NVM by the launcher, never written by the ACS.
+   A test is run if it passes every selection, zeroed fields select all tests. */
+typedef struct {
+    uint32_t magic;
+    /* Tests whose (test number - 1) % shard_count is shard_index are run */
+    uint32_t shard_index;
+    uint32_t shard_count;
+    /* Tests named in names[0 .. name_count - 1] */
+    uint32_t name_count;
+    /* Tests with any of tags_any and none of tags_none, see test_db_t.tags */
+    uint32_t tags_any;
+    uint32_t tags_none;
+    /* Test numbers test_first to test_last, test_last 0 for no upper bound */
+    uint32_t test_first;
+    uint32_t test_last;
+    char     names[VAL_RUN_CONFIG_NAMES][VAL_RUN_CONFIG_NAME_LEN];
+} val_run_config_ts;
+
+#define VAL_RUN_CONFIG_MAGIC       0x44524853 /* "SHRD" */
+
 typedef enum {
     NVM_PLATFORM_RESERVE_INDEX         = 0x0,
-    NVM_CUR_SUITE_NUM_INDEX            = 0x1,
-    NVM_CUR_TEST_NUM_INDEX             = 0x2,
-    NVM_END_TEST_NUM_INDEX             = 0x3,
-    NVM_TEST_PROGRESS_INDEX            = 0x4,
-    NVM_TOTAL_PASS_INDEX               = 0x5,
-    NVM_TOTAL_FAIL_INDEX               = 0x6,
-    NVM_TOTAL_SKIP_INDEX               = 0x7,
-    NVM_TOTAL_ERROR_INDEX              = 0x8,
+    /* val_regression_state_ts, 64-bit aligned for the word wide NVM accesses */
+    NVM_REGRESSION_STATE_INDEX         = 0x2,
+    /* val_run_config_ts, at NVM base + 0x40 */
+    NVM_RUN_CONFIG_INDEX               = 0x10,
 } val_nvm_map_index_te;
 
 /* Test state macros */
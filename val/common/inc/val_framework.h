@@ -32,8 +32,9 @@ uint32_t val_get_curr_test_num(void);
 void val_set_curr_test_num(uint32_t test_num);
 void val_set_status(uint32_t status);
 uint32_t val_get_status(void);
-uint32_t val_is_current_test(char *testname);
-void val_set_curr_test_name(char *testname);
+void val_set_status_per_cpu(uint32_t enable);
+uint32_t val_get_curr_test_id(void);
+void val_set_curr_test_id(uint32_t test_id);
 uint32_t val_nvm_write(uint32_t offset, void *buffer, size_t size);
 uint32_t val_nvm_read(uint32_t offset, void *buffer, size_t size);
 uint32_t val_watchdog_enable(void);
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _VAL_LOG_CAPTURE_H_
+#define _VAL_LOG_CAPTURE_H_
+
+#include "val.h"
+
+/* Characters kept of a message, including the terminating NUL */
+#define VAL_LOG_CAPTURE_MSG_LEN     128
+
+/* Messages held before the buffer is printed early */
+#define VAL_LOG_CAPTURE_ENTRIES     32
+
+typedef struct {
+    char msg[VAL_LOG_CAPTURE_MSG_LEN];
+    uint64_t data1;
+    uint64_t data2;
+} val_log_capture_entry_ts;
+
+typedef struct {
+    uint32_t count;
+    val_log_capture_entry_ts entry[VAL_LOG_CAPTURE_ENTRIES];
+} val_log_capture_ts;
+
+void val_log_capture_start(val_log_capture_ts *buf);
+void val_log_capture_stop(void);
+void val_log_capture_flush(void);
+bool val_log_capture_write(const char *msg, uint64_t data1, uint64_t data2);
+bool val_log_capture_write_token(uint32_t id, uint64_t data1, uint64_t data2);
+#endif /* _VAL_LOG_CAPTURE_H_ */
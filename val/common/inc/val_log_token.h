@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _VAL_LOG_TOKEN_H_
+#define _VAL_LOG_TOKEN_H_
+
+#include "val.h"
+
+/*
+ * A token record is the mark byte ORed with the security state of the image
+ * that logged it, then the format ID, data1 and data2 as ULEB128 values. The
+ * format ID is the offset of the format string in the read-only data of the
+ * image, text is never printed with a byte at or above 0x80.
+ */
+#define VAL_LOG_TOKEN_MARK          0xF0
+#define VAL_LOG_TOKEN_STATE_MASK    0x07
+
+/*
+ * A value record has VAL_LOG_TOKEN_VALUES set in the mark byte and carries
+ * the number of values and the values instead of data1 and data2, for
+ * formats with more than two specifiers.
+ */
+#define VAL_LOG_TOKEN_VALUES        0x08
+#define VAL_LOG_TOKEN_MAX_VALUES    32
+
+/* Mark and the three ULEB128 values of 10 bytes at most */
+#define VAL_LOG_TOKEN_MAX_LEN       31
+
+bool val_log_token_id(const char *msg, uint32_t *id);
+void val_log_token_emit(uint64_t state, uint32_t id, uint64_t data1, uint64_t data2);
+void val_log_token_emit_values(uint64_t state, uint32_t id, const uint64_t *values,
+                               uint32_t count);
+#endif /* _VAL_LOG_TOKEN_H_ */
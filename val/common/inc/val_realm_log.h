@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _VAL_REALM_LOG_H_
+#define _VAL_REALM_LOG_H_
+
+#include "val.h"
+
+/* Log area, below the SMC trace in the shared region */
+#define VAL_REALM_LOG_OFFSET        0x60000
+#define VAL_REALM_LOG_SIZE          0x20000
+
+#define VAL_REALM_LOG_MAGIC         0x474F4C4D4C414552ULL
+
+/* Characters kept of a message, including the terminating NUL */
+#define VAL_REALM_LOG_MSG_LEN       112
+
+/* Header page, then one ring per REC index */
+#define VAL_REALM_LOG_RING_BASE     PAGE_SIZE
+#define VAL_REALM_LOG_ENTRIES       ((VAL_REALM_LOG_SIZE - VAL_REALM_LOG_RING_BASE) / \
+                                        PLATFORM_CPU_COUNT / sizeof(val_realm_log_entry_ts))
+
+typedef struct {
+    char msg[VAL_REALM_LOG_MSG_LEN];
+    uint64_t data1;
+    uint64_t data2;
+} val_realm_log_entry_ts;
+
+typedef struct {
+    /* Entries written, only the REC of the ring writes it */
+    volatile uint64_t head;
+    /* First entry not printed yet, only the host writes it */
+    volatile uint64_t tail;
+} val_realm_log_ring_ts;
+
+typedef struct {
+    uint64_t magic;
+    /* Serialises the host PEs that drain the rings */
+    s_lock_t lock;
+    val_realm_log_ring_ts ring[PLATFORM_CPU_COUNT];
+} val_realm_log_hdr_ts;
+
+void val_realm_log_init(void);
+void val_realm_log_write(const char *msg, uint64_t data1, uint64_t data2);
+void val_realm_log_write_token(uint32_t id, uint64_t data1, uint64_t data2);
+void val_realm_log_drain(void);
+#endif /* _VAL_REALM_LOG_H_ */
@@ -32,6 +32,7 @@ val_smc_param_ts val_smc_call(uint64_t x0, uint64_t x1, uint64_t x2,
                          uint64_t x6, uint64_t x7, uint64_t x8,
                          uint64_t x9, uint64_t x10);
 void val_smc_call_asm(val_smc_param_ts *args);
+uint64_t val_smc_rmi_calls(bool all_pes);
 void val_return_to_host_hvc_asm(void);
 void val_realm_printf_msg_hvc_asm(void);
 #endif /* _VAL_SMC_H_ */
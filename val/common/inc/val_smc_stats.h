@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _VAL_SMC_STATS_H_
+#define _VAL_SMC_STATS_H_
+
+#include "val.h"
+#include "val_rmm.h"
+
+/* RMI function IDs tracked, RMI_VERSION onwards */
+#define VAL_SMC_STATS_FID_BASE      RMI_VERSION
+#define VAL_SMC_STATS_FIDS          0x20
+
+/* Bucket n counts the calls that took [2^(n-1), 2^n) CNTPCT ticks */
+#define VAL_SMC_STATS_BUCKETS       32
+
+typedef struct {
+    uint64_t count;
+    uint64_t min;
+    uint64_t max;
+    uint64_t total;
+    uint32_t hist[VAL_SMC_STATS_BUCKETS];
+} val_smc_stats_ts;
+
+void val_smc_stats_update(uint64_t fid, uint64_t ticks);
+void val_smc_stats_print(void);
+#endif /* _VAL_SMC_STATS_H_ */
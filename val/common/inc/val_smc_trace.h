@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _VAL_SMC_TRACE_H_
+#define _VAL_SMC_TRACE_H_
+
+#include "val.h"
+#include "val_smc.h"
+
+/* Trace area, the upper half of the shared region */
+#define VAL_SMC_TRACE_OFFSET        0x80000
+#define VAL_SMC_TRACE_SIZE          (PLATFORM_SHARED_REGION_SIZE - VAL_SMC_TRACE_OFFSET)
+
+#define VAL_SMC_TRACE_MAGIC         0x454341525443534DULL
+
+/* Registers captured besides the FID, x1-x10 on entry and x0-x10 on return */
+#define VAL_SMC_TRACE_IN_REGS       10
+#define VAL_SMC_TRACE_OUT_REGS      11
+
+/* NS parameter granules captured with RMI_REALM_CREATE and RMI_REC_CREATE */
+#define VAL_SMC_TRACE_PAGES         16
+#define VAL_SMC_TRACE_PAGE_NONE     0xFFFFFFFF
+
+/* Record flags */
+#define VAL_SMC_TRACE_FLAG_PAGE     (1U << 0)
+
+/* The host ring is shared by every PE, each realm vCPU owns a ring */
+#define VAL_SMC_TRACE_HOST_RING     0
+#define VAL_SMC_TRACE_RINGS         (1 + PLATFORM_CPU_COUNT)
+
+typedef struct {
+    uint64_t fid;
+    uint64_t in[VAL_SMC_TRACE_IN_REGS];
+    uint64_t out[VAL_SMC_TRACE_OUT_REGS];
+    /* CNTVCT_EL0 before the call */
+    uint64_t timestamp;
+    uint16_t cpu;
+    uint8_t  security_state;
+    uint8_t  flags;
+    uint32_t page;
+} val_smc_trace_rec_ts;
+
+typedef struct {
+    /* Records written, the writer never waits for the dump */
+    volatile uint64_t head;
+    /* First record not dumped yet */
+    uint64_t tail;
+    uint64_t base;
+    uint64_t capacity;
+} val_smc_trace_ring_ts;
+
+typedef struct {
+    uint64_t magic;
+    s_lock_t lock;
+    /* Page slots used by host records not dumped yet */
+    uint32_t page_used;
+    val_smc_trace_ring_ts ring[VAL_SMC_TRACE_RINGS];
+} val_smc_trace_hdr_ts;
+
+void val_smc_trace_init(void);
+void val_smc_trace_record(val_smc_param_ts *in, val_smc_param_ts *out, uint64_t timestamp);
+void val_smc_trace_dump(void);
+#endif /* _VAL_SMC_TRACE_H_ */
@@ -15,11 +15,39 @@
 #define ARM_ARCH_TIMER_IMASK            (1ULL << 1)
 #define ARM_ARCH_TIMER_ISTATUS          (1ULL << 2)
 
+/* Counter bit whose transitions send the events that wake val_wait_until,
+   one event every 2^(VAL_WAIT_EVNTI + 1) ticks */
+#define VAL_WAIT_EVNTI                  9
+
+/* Deadline of a wait for an interrupt taken by the waiting PE */
+#define VAL_WAIT_INTR_NS                (10ULL * 1000 * 1000)
+/* Deadline of a realm that waits for an interrupt to exit to the host */
+#define VAL_WAIT_EXIT_NS                (1000ULL * 1000 * 1000)
+
+/*
+ * Wait until cond, an expression evaluated again after every event, is true
+ * or ns nanoseconds of the generic counter have passed. The PE sleeps in WFE
+ * between the events of the counter event stream and wakes early on an
+ * interrupt. Returns the last value of cond.
+ */
+#define val_wait_until(cond, ns)                                        \
+    ({                                                                  \
+        uint64_t _deadline = val_wait_deadline(ns);                     \
+        bool _done;                                                     \
+                                                                        \
+        while (!(_done = (cond)) && !val_wait_expired(_deadline))       \
+            val_wait_event();                                           \
+        _done;                                                          \
+    })
+
 void val_disable_phy_timer_el1(void);
 void val_timer_set_phy_el1(uint64_t timeout, bool irq_mask);
 void val_disable_virt_timer_el1(void);
 void val_timer_set_virt_el1(uint64_t timeout);
 void val_disable_phy_timer_el2(void);
 void val_timer_set_phy_el2(uint64_t timeout);
+uint64_t val_wait_deadline(uint64_t ns);
+bool val_wait_expired(uint64_t deadline);
+void val_wait_event(void);
 
 #endif /* _VAL_TIMER_H_ */
@@ -9,11 +9,26 @@
 #include "val_libc.h"
 #include "val_rmm.h"
 #include "val_smc.h"
+#include "val_realm_log.h"
+#include "val_log_token.h"
+#include "val_log_capture.h"
+#include "val_mp_supp.h"
+#include "val_sysreg.h"
+
+#if defined(VAL_PARALLEL_DISPATCH) && (PLATFORM_CPU_COUNT > 8)
+#error "The shared region holds the test status of 8 PEs"
+#endif
 
 uint64_t security_state;
 static uint64_t realm_thread;
 uint64_t realm_ipa_width;
 uint64_t skip_for_val_logs = 0;
+/* Keeps the text lines of the PEs of an image apart on the uart */
+static s_lock_t printf_lock;
+#ifdef VAL_PARALLEL_DISPATCH
+/* Set while the host runs tests in parallel, each PE records its own status */
+static volatile uint32_t status_per_cpu;
+#endif
 
 /**
  *   @brief    set the security state
@@ -96,6 +111,27 @@ uint32_t val_printf(const char *msg, uint64_t data1, uint64_t data2)
   return pal_printf(msg, data1, data2);
 }
 
+#ifdef VAL_LOG_TOKENS
+/**
+ *   @brief    Send a token record, realm records go through the realm log ring
+ *   @param    id       - Format ID
+ *   @param    data1    - Value for first format specifier
+ *   @param    data2    - Value for second format specifier
+ *   @return   Void
+**/
+static void val_log_token_write(uint32_t id, uint64_t data1, uint64_t data2)
+{
+    if (security_state == 2)
+        val_realm_log_write_token(id, data1, data2);
+#ifdef VAL_PARALLEL_DISPATCH
+    else if (security_state == 1 && val_log_capture_write_token(id, data1, data2))
+        return;
+#endif
+    else
+        val_log_token_emit(security_state, id, data1, data2);
+}
+#endif
+
 /**
  *   @brief    This function checks the security state and take action based on it.
  *   @param    str      - Input String
@@ -107,7 +143,12 @@ void val_common_printf(const char *msg, uint64_t data1, uint64_t data2)
 {
     size_t length = 0, msg_security_state_length = 0;
     char msg_security_state[1000] = {0,};
+    const char *prefix = NULL;
+#ifdef VAL_LOG_TOKENS
+    uint32_t id, prefix_id = 0;
+#endif
     uint64_t prev_log_state = (*(uint64_t *)(val_get_shared_region_base() + PRINT_OFFSET));
+    bool lock;
 
     if (msg == NULL) {
         LOG(WARN, "\tInvalid Message pointer \n", 0, 0);
@@ -131,7 +172,7 @@ void val_common_printf(const char *msg, uint64_t data1, uint64_t data2)
             *(uint64_t *)(val_get_shared_region_base() + PRINT_OFFSET) = security_state;
             if (skip_for_val_logs == 1)
             {
-                val_memcpy(msg_security_state, "HOST : \n", 8);
+                prefix = "HOST : \n";
             }
         }
     }
@@ -140,7 +181,7 @@ void val_common_printf(const char *msg, uint64_t data1, uint64_t data2)
         if (prev_log_state != security_state)
         {
             *(uint64_t *)(val_get_shared_region_base() + PRINT_OFFSET) = security_state;
-            val_memcpy(msg_security_state, "REALM : \n", 9);
+            prefix = "REALM : \n";
         }
     }
     else if (security_state == 3)
@@ -148,36 +189,54 @@ void val_common_printf(const char *msg, uint64_t data1, uint64_t data2)
         if (prev_log_state != security_state)
         {
             *(uint64_t *)(val_get_shared_region_base() + PRINT_OFFSET) = security_state;
-            val_memcpy(msg_security_state, "SECURE : \n", 10);
+            prefix = "SECURE : \n";
         }
     }
     else
     {
-        val_memcpy(msg_security_state, "UNKNOWN : \n", 11);
+        prefix = "UNKNOWN : \n";
+    }
+
+#ifdef VAL_LOG_TOKENS
+    /* Format strings of the image are sent as tokens, the prefix as well */
+    if (val_log_token_id(msg, &id) && (!prefix || val_log_token_id(prefix, &prefix_id)))
+    {
+        if (prefix)
+            val_log_token_write(prefix_id, 0, 0);
+        val_log_token_write(id, data1, data2);
+        return;
     }
+#endif
+
+    if (prefix)
+        val_memcpy(msg_security_state, prefix, val_strlen((char *)prefix));
 
     msg_security_state_length = val_strlen(msg_security_state);
 
     val_memcpy(&msg_security_state[msg_security_state_length], msg, length);
 
+    /* Realm messages are printed by the host on the next REC exit */
     if (security_state == 2)
     {
-        __attribute__((aligned (PAGE_SIZE))) val_print_rsi_host_call_t realm_print;
-            /* Write realm message to shared printf location */
-        val_memcpy((char *)(val_get_shared_region_base() + REALM_PRINTF_MSG_OFFSET),
-                    (char *)msg_security_state,
-                    length+msg_security_state_length+1);
-        *(uint64_t *)(val_get_shared_region_base() + REALM_PRINTF_DATA1_OFFSET) = (uint64_t)data1;
-        *(uint64_t *)(val_get_shared_region_base() + REALM_PRINTF_DATA2_OFFSET) = (uint64_t)data2;
-
-        /* Print from realm through RSI_HOST_CALL */
-
-        realm_print.imm = VAL_REALM_PRINT_MSG;
-        val_smc_call(RSI_HOST_CALL, (uint64_t)&realm_print, 0, 0, 0, 0, 0, 0, 0, 0, 0);
-
+        val_realm_log_write(msg_security_state, data1, data2);
+    }
+#ifdef VAL_PARALLEL_DISPATCH
+    /* A host PE running a test in parallel prints it when the test ends */
+    else if (security_state == 1 && val_log_capture_write(msg_security_state, data1, data2))
+    {
+        return;
     }
+#endif
     else {
+        /* Only the primary PE runs before the MMU is on */
+        lock = (val_sctlr_read(security_state == 1 ? 2 : 1) & SCTLR_M_BIT) != 0;
+        if (lock)
+            val_spin_lock(&printf_lock);
+
         val_printf(msg_security_state, data1, data2);
+
+        if (lock)
+            val_spin_unlock(&printf_lock);
     }
 }
 
@@ -202,47 +261,56 @@ void val_set_curr_test_num(uint32_t test_num)
 }
 
 /**
- *   @brief    Compare the given string with current
- *             test name stored into the shared memory by host
- *   @param    testname   - Test name
- *   @return   SUCCESS(0)/FAILURE
+ *   @brief    Returns the registry ID of the current test from shared region
+ *   @param    Void
+ *   @return   Current test ID, TEST_ID_<testname>
 **/
-uint32_t val_is_current_test(char *testname)
+uint32_t val_get_curr_test_id(void)
 {
-    size_t length = 0;
-    char   *shared_test_name = (void *)(val_get_shared_region_base() + TEST_NAME_OFFSET);
-
-    while (shared_test_name[length] != '\0')
-    {
-      ++length;
-    }
-
-    if (val_memcmp((void *)testname, (void *)shared_test_name, length))
-        return VAL_ERROR;
-
-    return VAL_SUCCESS;
+    return (*(uint32_t *)((val_get_shared_region_base() + TEST_ID_OFFSET)));
 }
 
 /**
- *   @brief    Sets the current test name into shared region
- *   @param    testname   - Current test name string
+ *   @brief    Sets the registry ID of the current test into shared region
+ *   @param    test_id   - Current test ID
  *   @return   Void
 **/
-void val_set_curr_test_name(char *testname)
+void val_set_curr_test_id(uint32_t test_id)
+{
+    *(uint32_t *)(val_get_shared_region_base() + TEST_ID_OFFSET) = test_id;
+}
+
+/**
+ *   @brief    Return the status slot of the calling PE
+ *   @param    Void
+ *   @return   Test status slot in the shared region
+**/
+static val_test_status_buffer_ts *val_status_buffer(void)
 {
-   size_t length = 0;
+#ifdef VAL_PARALLEL_DISPATCH
+    uint32_t cpu;
 
-    while (testname[length] != '\0')
+    if (status_per_cpu)
     {
-      ++length;
+        cpu = val_get_cpuid(val_read_mpidr());
+        if (cpu < PLATFORM_CPU_COUNT)
+            return val_get_shared_region_base() + CPU_TEST_STATUS_OFFSET(cpu);
     }
+#endif
+    return val_get_shared_region_base() + TEST_STATUS_OFFSET;
+}
 
-    /* Write test name to shared printf location */
-    val_memcpy((char *)(val_get_shared_region_base() + TEST_NAME_OFFSET),
-                (char *)testname,
-                length+1);
-
+#ifdef VAL_PARALLEL_DISPATCH
+/**
+ *   @brief    Select the status slots used by val_set_status and val_get_status
+ *   @param    enable   - 1 for a slot per PE, 0 for the single slot of the test
+ *   @return   Void
+**/
+void val_set_status_per_cpu(uint32_t enable)
+{
+    status_per_cpu = enable;
 }
+#endif
 
 /**
  *   @brief    Records the state and status of test
@@ -252,8 +320,7 @@ void val_set_curr_test_name(char *testname)
 void val_set_status(uint32_t status)
 {
     uint8_t state = ((status >> TEST_STATE_SHIFT) & TEST_STATE_MASK);
-    val_test_status_buffer_ts *curr_test_status = (val_get_shared_region_base()
-                                                  + TEST_STATUS_OFFSET);
+    val_test_status_buffer_ts *curr_test_status = val_status_buffer();
 
     /* Update the test_status only when previously set status isn't fail or
      * it is required to set as part of test init */
@@ -273,8 +340,7 @@ void val_set_status(uint32_t status)
 **/
 uint32_t val_get_status(void)
 {
-    val_test_status_buffer_ts *curr_test_status = (val_get_shared_region_base()
-                                                   + TEST_STATUS_OFFSET);
+    val_test_status_buffer_ts *curr_test_status = val_status_buffer();
     return (uint32_t)(((curr_test_status->state) << TEST_STATE_SHIFT) |
             (curr_test_status->status_code));
 }
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Log capture of the -DPARALLEL_DISPATCH=ON builds. A PE that runs a test in
+ * parallel with other PEs keeps its messages in its own buffer and prints
+ * them in one go when the test ends, so that the output of a test is never
+ * interleaved with the output of another one.
+ */
+#ifdef VAL_PARALLEL_DISPATCH
+
+#include "val_log_capture.h"
+#include "val_log_token.h"
+#include "val_framework.h"
+#include "val_mp_supp.h"
+#include "val_libc.h"
+
+/* First byte of a message that holds a token, then the format ID */
+#define VAL_LOG_CAPTURE_TOKEN       (VAL_LOG_TOKEN_MARK | 1)
+
+/* Buffer of each PE, NULL when the PE prints its messages at once */
+static val_log_capture_ts *capture[PLATFORM_CPU_COUNT];
+
+/* Serialises the PEs that print their buffers */
+static s_lock_t capture_lock;
+
+static val_log_capture_ts **val_log_capture_slot(void)
+{
+    uint32_t cpu = val_get_cpuid(val_read_mpidr());
+
+    return (cpu < PLATFORM_CPU_COUNT) ? &capture[cpu] : NULL;
+}
+
+/**
+ *   @brief    Keep the messages of the calling PE in buf until the next flush
+ *   @param    buf      - Buffer of the calling PE
+ *   @return   void
+**/
+void val_log_capture_start(val_log_capture_ts *buf)
+{
+    val_log_capture_ts **slot = val_log_capture_slot();
+
+    if (slot == NULL)
+        return;
+
+    buf->count = 0;
+    *slot = buf;
+}
+
+/**
+ *   @brief    Print the captured messages of the calling PE and print the
+ *             following ones at once
+ *   @param    void
+ *   @return   void
+**/
+void val_log_capture_stop(void)
+{
+    val_log_capture_ts **slot = val_log_capture_slot();
+
+    if (slot == NULL || *slot == NULL)
+        return;
+
+    val_log_capture_flush();
+    *slot = NULL;
+}
+
+/**
+ *   @brief    Print the messages captured by the calling PE since the last flush
+ *   @param    void
+ *   @return   void
+**/
+void val_log_capture_flush(void)
+{
+    val_log_capture_ts **slot = val_log_capture_slot();
+    val_log_capture_ts *buf;
+    val_log_capture_entry_ts *entry;
+    uint32_t i;
+#ifdef VAL_LOG_TOKENS
+    uint32_t id;
+#endif
+
+    if (slot == NULL || *slot == NULL)
+        return;
+
+    buf = *slot;
+
+    val_spin_lock(&capture_lock);
+    for (i = 0; i < buf->count; i++)
+    {
+        entry = &buf->entry[i];
+#ifdef VAL_LOG_TOKENS
+        if ((uint8_t)entry->msg[0] == VAL_LOG_CAPTURE_TOKEN)
+        {
+            val_memcpy(&id, &entry->msg[1], sizeof(id));
+            val_log_token_emit(1, id, entry->data1, entry->data2);
+            continue;
+        }
+#endif
+        val_printf(entry->msg, entry->data1, entry->data2);
+    }
+    val_spin_unlock(&capture_lock);
+
+    buf->count = 0;
+}
+
+static bool val_log_capture_put(const char *msg, size_t length, uint64_t data1, uint64_t data2)
+{
+    val_log_capture_ts **slot = val_log_capture_slot();
+    val_log_capture_entry_ts *entry;
+
+    if (slot == NULL || *slot == NULL)
+        return false;
+
+    if ((*slot)->count == VAL_LOG_CAPTURE_ENTRIES)
+        val_log_capture_flush();
+
+    entry = &(*slot)->entry[(*slot)->count++];
+    val_memcpy(entry->msg, msg, length);
+    entry->msg[length] = '\0';
+    entry->data1 = data1;
+    entry->data2 = data2;
+
+    return true;
+}
+
+/**
+ *   @brief    Capture a text message of the calling PE
+ *   @param    msg      - Message, truncated to VAL_LOG_CAPTURE_MSG_LEN - 1 characters
+ *   @param    data1    - Value for first format specifier
+ *   @param    data2    - Value for second format specifier
+ *   @return   false if the PE does not capture its messages
+**/
+bool val_log_capture_write(const char *msg, uint64_t data1, uint64_t data2)
+{
+    size_t length = val_strlen((char *)msg);
+
+    if (length >= VAL_LOG_CAPTURE_MSG_LEN)
+        length = VAL_LOG_CAPTURE_MSG_LEN - 1;
+
+    return val_log_capture_put(msg, length, data1, data2);
+}
+
+#ifdef VAL_LOG_TOKENS
+/**
+ *   @brief    Capture a token of the calling PE
+ *   @param    id       - Format ID in the host image
+ *   @param    data1    - Value for first format specifier
+ *   @param    data2    - Value for second format specifier
+ *   @return   false if the PE does not capture its messages
+**/
+bool val_log_capture_write_token(uint32_t id, uint64_t data1, uint64_t data2)
+{
+    char msg[1 + sizeof(uint32_t)];
+
+    msg[0] = (char)VAL_LOG_CAPTURE_TOKEN;
+    val_memcpy(&msg[1], &id, sizeof(id));
+    return val_log_capture_put(msg, sizeof(msg), data1, data2);
+}
+#endif
+#endif /* VAL_PARALLEL_DISPATCH */
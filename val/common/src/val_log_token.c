@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Tokenised logging of the -DLOG_TOKENS=ON builds. A message whose format
+ * string is part of the image is sent as a short binary record instead of
+ * text, tools/scripts/log_decode.py turns the UART log back into text with
+ * the ELF files of the images.
+ */
+#ifdef VAL_LOG_TOKENS
+
+#include "val_log_token.h"
+#include "val_framework.h"
+#include "val_mp_supp.h"
+#include "val_sysreg.h"
+#include "pal_interfaces.h"
+
+/* Read-only data of the image, the format IDs are offsets into it */
+extern char __LOG_FMT_START__[], __LOG_FMT_END__[];
+
+/* Keeps the records of the PEs of an image apart */
+static s_lock_t log_token_lock;
+
+/**
+ *   @brief    Return the format ID of a message
+ *   @param    msg     - Format string
+ *   @param    id      - Format ID, set when the message can be tokenised
+ *   @return   true if msg is a format string of the image
+**/
+bool val_log_token_id(const char *msg, uint32_t *id)
+{
+    if (msg < __LOG_FMT_START__ || msg >= __LOG_FMT_END__)
+        return false;
+
+    *id = (uint32_t)(msg - __LOG_FMT_START__);
+    return true;
+}
+
+static uint32_t val_log_token_uleb(uint8_t *buf, uint64_t value)
+{
+    uint32_t len = 0;
+
+    do {
+        buf[len] = (uint8_t)(value & 0x7F);
+        value >>= 7;
+        if (value)
+            buf[len] |= 0x80;
+        len++;
+    } while (value);
+
+    return len;
+}
+
+static void val_log_token_put(uint8_t *record, uint32_t len)
+{
+    bool lock;
+
+    /* Only the primary PE runs before the MMU is on */
+    lock = (val_sctlr_read(security_state == 1 ? 2 : 1) & SCTLR_M_BIT) != 0;
+    if (lock)
+        val_spin_lock(&log_token_lock);
+
+    pal_uart_write(record, len);
+
+    if (lock)
+        val_spin_unlock(&log_token_lock);
+}
+
+/**
+ *   @brief    Write a token record onto the uart
+ *   @param    state   - Security state of the image that owns the format string
+ *   @param    id      - Format ID
+ *   @param    data1   - Value for first format specifier
+ *   @param    data2   - Value for second format specifier
+ *   @return   void
+**/
+void val_log_token_emit(uint64_t state, uint32_t id, uint64_t data1, uint64_t data2)
+{
+    uint8_t record[VAL_LOG_TOKEN_MAX_LEN];
+    uint32_t len = 0;
+
+    record[len++] = (uint8_t)(VAL_LOG_TOKEN_MARK | (state & VAL_LOG_TOKEN_STATE_MASK));
+    len += val_log_token_uleb(&record[len], id);
+    len += val_log_token_uleb(&record[len], data1);
+    len += val_log_token_uleb(&record[len], data2);
+
+    val_log_token_put(record, len);
+}
+
+/**
+ *   @brief    Write a value record onto the uart, the values beyond
+ *             VAL_LOG_TOKEN_MAX_VALUES are dropped
+ *   @param    state   - Security state of the image that owns the format string
+ *   @param    id      - Format ID
+ *   @param    values  - Values for the format specifiers
+ *   @param    count   - Number of values
+ *   @return   void
+**/
+void val_log_token_emit_values(uint64_t state, uint32_t id, const uint64_t *values,
+                               uint32_t count)
+{
+    uint8_t record[VAL_LOG_TOKEN_MAX_LEN + VAL_LOG_TOKEN_MAX_VALUES * 10];
+    uint32_t len = 0, i;
+
+    if (count > VAL_LOG_TOKEN_MAX_VALUES)
+        count = VAL_LOG_TOKEN_MAX_VALUES;
+
+    record[len++] = (uint8_t)(VAL_LOG_TOKEN_MARK | VAL_LOG_TOKEN_VALUES |
+                              (state & VAL_LOG_TOKEN_STATE_MASK));
+    len += val_log_token_uleb(&record[len], id);
+    len += val_log_token_uleb(&record[len], count);
+    for (i = 0; i < count; i++)
+        len += val_log_token_uleb(&record[len], values[i]);
+
+    val_log_token_put(record, len);
+}
+
+#endif /* VAL_LOG_TOKENS */
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * C replacements of the VAL assembly sources for native builds. System
+ * register and conduit accesses go to the emulation in the native PAL.
+ */
+#ifdef LINUX_NATIVE_BUILD
+
+#include "val_smc.h"
+#include "val_mp_supp.h"
+#include "val_sysreg.h"
+#include "xlat_mmu_helpers.h"
+
+/**
+ *   @brief    Issue an SMC through the native conduit
+ *   @param    args    - Arguments in x0-x10, updated with the return values
+ *   @return   void
+**/
+void val_smc_call_asm(val_smc_param_ts *args)
+{
+    pal_native_smc_call(&args->x0, sizeof(*args) / sizeof(args->x0));
+}
+
+/**
+ *   @brief    Switch from realm to host. Native realms exit with RSI host calls,
+ *             the RMM model does not trap HVC
+ *   @param    void
+ *   @return   void
+**/
+void val_return_to_host_hvc_asm(void)
+{
+    pal_native_sysop("hvc", VAL_SWITCH_TO_HOST);
+}
+
+/**
+ *   @brief    Request the host to print a realm message
+ *   @param    void
+ *   @return   void
+**/
+void val_realm_printf_msg_hvc_asm(void)
+{
+    pal_native_sysop("hvc", VAL_REALM_PRINT_MSG);
+}
+
+void val_mair_write(uint64_t value, uint64_t el_num)
+{
+    if (el_num == 1)
+        write_mair_el1(value);
+    else
+        write_mair_el2(value);
+}
+
+void val_tcr_write(uint64_t value, uint64_t el_num)
+{
+    if (el_num == 1)
+        write_tcr_el1(value);
+    else
+        write_tcr_el2(value);
+}
+
+void val_ttbr0_write(uint64_t value, uint64_t el_num)
+{
+    if (el_num == 1)
+        write_ttbr0_el1(value);
+    else
+        write_ttbr0_el2(value);
+}
+
+uint64_t val_ttbr0_read(uint64_t el_num)
+{
+    return (el_num == 1) ? read_ttbr0_el1() : read_ttbr0_el2();
+}
+
+uint64_t val_sctlr_read(uint64_t el_num)
+{
+    return (el_num == 1) ? read_sctlr_el1() : read_sctlr_el2();
+}
+
+void val_sctlr_write(uint64_t value, uint64_t el_num)
+{
+    if (el_num == 1)
+        write_sctlr_el1(value);
+    else
+        write_sctlr_el2(value);
+}
+
+uint64_t val_esr_el1_read(void)
+{
+    return read_esr_el1();
+}
+
+uint64_t val_elr_el1_read(void)
+{
+    return read_elr_el1();
+}
+
+void val_elr_el1_write(uint64_t value)
+{
+    write_elr_el1(value);
+}
+
+uint64_t val_far_el1_read(void)
+{
+    return read_far_el1();
+}
+
+uint64_t val_hpfar_el2_read(void)
+{
+    return pal_native_sysreg_read("hpfar_el2");
+}
+
+uint64_t val_id_aa64mmfr0_el1_read(void)
+{
+    return read_id_aa64mmfr0_el1();
+}
+
+uint64_t val_id_aa64mmfr1_el1_read(void)
+{
+    return read_id_aa64mmfr1_el1();
+}
+
+uint64_t val_id_aa64mmfr2_el1_read(void)
+{
+    return read_id_aa64mmfr2_el1();
+}
+
+uint64_t val_id_aa64pfr0_el1_read(void)
+{
+    return read_id_aa64pfr0_el1();
+}
+
+uint64_t val_id_aa64isar0_el1_read(void)
+{
+    return pal_native_sysreg_read("id_aa64isar0_el1");
+}
+
+uint64_t val_id_aa64dfr0_el1_read(void)
+{
+    return read_id_aa64dfr0_el1();
+}
+
+uint64_t val_esr_el2_read(void)
+{
+    return read_esr_el2();
+}
+
+uint64_t val_elr_el2_read(void)
+{
+    return read_elr_el2();
+}
+
+uint64_t val_far_el2_read(void)
+{
+    return read_far_el2();
+}
+
+uint64_t val_read_mpidr(void)
+{
+    return read_mpidr_el1();
+}
+
+uint64_t val_read_current_el(void)
+{
+    return read_CurrentEl();
+}
+
+/* Host memory is always coherent, cache maintenance only orders accesses */
+void val_dataCacheCleanInvalidateVA(uint64_t va)
+{
+    dccivac(va);
+}
+
+void val_dataCacheCleanVA(uint64_t va)
+{
+    dccvac(va);
+}
+
+void val_dataCacheInvalidateVA(uint64_t va)
+{
+    dcivac(va);
+}
+
+void flush_dcache_range(uintptr_t addr, size_t size)
+{
+    (void)addr;
+    (void)size;
+    dsbsy();
+}
+
+void clean_dcache_range(uintptr_t addr, size_t size)
+{
+    (void)addr;
+    (void)size;
+    dsbsy();
+}
+
+void inv_dcache_range(uintptr_t addr, size_t size)
+{
+    (void)addr;
+    (void)size;
+    dsbsy();
+}
+
+/**
+ *   @brief    Enable the emulated stage 1 MMU. Translation is flat natively,
+ *             only the control register is updated.
+ *   @param    flags   - Unused
+ *   @return   void
+**/
+void enable_mmu_direct_el1(unsigned int flags)
+{
+    (void)flags;
+    write_sctlr_el1(read_sctlr_el1() | SCTLR_M_BIT | SCTLR_C_BIT);
+}
+
+void enable_mmu_direct_el2(unsigned int flags)
+{
+    (void)flags;
+    write_sctlr_el2(read_sctlr_el2() | SCTLR_M_BIT | SCTLR_C_BIT);
+}
+
+void enable_mmu_direct_el3(unsigned int flags)
+{
+    (void)flags;
+    write_sctlr_el3(read_sctlr_el3() | SCTLR_M_BIT | SCTLR_C_BIT);
+}
+
+#endif /* LINUX_NATIVE_BUILD */
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Realm log messages are appended to the ring of the REC that logs them and
+ * printed by the host on the next REC exit, so that a LOG does not cost a
+ * REC exit. The realm only exits to have its ring drained when it is full.
+ */
+
+#include "val_realm_log.h"
+#include "val_log_token.h"
+#include "val_framework.h"
+#include "val_mp_supp.h"
+#include "val_libc.h"
+#include "val_rmm.h"
+#include "val_smc.h"
+
+/* First byte of a message that holds a realm token, then the format ID */
+#define VAL_REALM_LOG_TOKEN         (VAL_LOG_TOKEN_MARK | 2)
+#define VAL_REALM_LOG_TOKEN_LEN     (1 + sizeof(uint32_t))
+
+static uint8_t *val_realm_log_base(void)
+{
+    return (uint8_t *)val_get_shared_region_base() + VAL_REALM_LOG_OFFSET;
+}
+
+static val_realm_log_hdr_ts *val_realm_log_hdr(void)
+{
+    return (val_realm_log_hdr_ts *)val_realm_log_base();
+}
+
+static val_realm_log_entry_ts *val_realm_log_entry(uint32_t cpu, uint64_t seq)
+{
+    return (val_realm_log_entry_ts *)(val_realm_log_base() + VAL_REALM_LOG_RING_BASE) +
+                (cpu * VAL_REALM_LOG_ENTRIES) + (seq % VAL_REALM_LOG_ENTRIES);
+}
+
+/**
+ *   @brief    Exit to the host with VAL_REALM_PRINT_MSG, the host prints the
+ *             pending messages and enters the REC again
+ *   @param    void
+ *   @return   void
+**/
+static void val_realm_log_host_call(void)
+{
+    __attribute__((aligned (PAGE_SIZE))) val_print_rsi_host_call_t realm_print;
+
+    realm_print.imm = VAL_REALM_PRINT_MSG;
+    val_smc_call(RSI_HOST_CALL, (uint64_t)&realm_print, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+}
+
+/**
+ *   @brief    Reset the rings, called by the host once its MMU is on
+ *   @param    void
+ *   @return   void
+**/
+void val_realm_log_init(void)
+{
+    val_realm_log_hdr_ts *hdr = val_realm_log_hdr();
+
+    val_memset(hdr, 0, sizeof(*hdr));
+    val_init_spinlock(&hdr->lock);
+    *(char *)(val_get_shared_region_base() + REALM_PRINTF_MSG_OFFSET) = '\0';
+    hdr->magic = VAL_REALM_LOG_MAGIC;
+}
+
+/**
+ *   @brief    Queue a realm message for the host. A REC without a ring hands
+ *             the message over in the printf slot and exits at once.
+ *   @param    msg      - Message
+ *   @param    length   - Length of msg, at most VAL_REALM_LOG_MSG_LEN - 1
+ *   @param    data1    - Value for first format specifier
+ *   @param    data2    - Value for second format specifier
+ *   @return   void
+**/
+static void val_realm_log_put(const char *msg, size_t length, uint64_t data1, uint64_t data2)
+{
+    val_realm_log_hdr_ts *hdr = val_realm_log_hdr();
+    char *slot = (char *)(val_get_shared_region_base() + REALM_PRINTF_MSG_OFFSET);
+    val_realm_log_ring_ts *ring;
+    val_realm_log_entry_ts *entry;
+    uint32_t cpu;
+    uint64_t seq;
+
+    cpu = val_get_cpuid(val_read_mpidr());
+    if (hdr->magic != VAL_REALM_LOG_MAGIC || cpu >= PLATFORM_CPU_COUNT)
+    {
+        if (length >= REALM_PRINTF_DATA1_OFFSET - REALM_PRINTF_MSG_OFFSET)
+            length = REALM_PRINTF_DATA1_OFFSET - REALM_PRINTF_MSG_OFFSET - 1;
+        val_memcpy(slot, msg, length);
+        slot[length] = '\0';
+        *(uint64_t *)(val_get_shared_region_base() + REALM_PRINTF_DATA1_OFFSET) = data1;
+        *(uint64_t *)(val_get_shared_region_base() + REALM_PRINTF_DATA2_OFFSET) = data2;
+        val_realm_log_host_call();
+        return;
+    }
+
+    ring = &hdr->ring[cpu];
+    seq = ring->head;
+
+    /* The host drains every ring before it enters the REC again */
+    if (seq - ring->tail == VAL_REALM_LOG_ENTRIES)
+        val_realm_log_host_call();
+
+    entry = val_realm_log_entry(cpu, seq);
+    val_memcpy(entry->msg, msg, length);
+    entry->msg[length] = '\0';
+    entry->data1 = data1;
+    entry->data2 = data2;
+
+    dmbsy();
+    ring->head = seq + 1;
+}
+
+/**
+ *   @brief    Queue a realm text message for the host
+ *   @param    msg      - Message, truncated to VAL_REALM_LOG_MSG_LEN - 1 characters
+ *   @param    data1    - Value for first format specifier
+ *   @param    data2    - Value for second format specifier
+ *   @return   void
+**/
+void val_realm_log_write(const char *msg, uint64_t data1, uint64_t data2)
+{
+    size_t length = val_strlen((char *)msg);
+
+    if (length >= VAL_REALM_LOG_MSG_LEN)
+        length = VAL_REALM_LOG_MSG_LEN - 1;
+
+    val_realm_log_put(msg, length, data1, data2);
+}
+
+#ifdef VAL_LOG_TOKENS
+/**
+ *   @brief    Queue a realm token for the host, which sends the token record
+ *   @param    id       - Format ID in the realm image
+ *   @param    data1    - Value for first format specifier
+ *   @param    data2    - Value for second format specifier
+ *   @return   void
+**/
+void val_realm_log_write_token(uint32_t id, uint64_t data1, uint64_t data2)
+{
+    char msg[VAL_REALM_LOG_TOKEN_LEN];
+
+    msg[0] = (char)VAL_REALM_LOG_TOKEN;
+    val_memcpy(&msg[1], &id, sizeof(id));
+    val_realm_log_put(msg, sizeof(msg), data1, data2);
+}
+#endif
+
+static void val_realm_log_print(const char *msg, uint64_t data1, uint64_t data2)
+{
+#ifdef VAL_LOG_TOKENS
+    uint32_t id;
+
+    if ((uint8_t)msg[0] == VAL_REALM_LOG_TOKEN)
+    {
+        val_memcpy(&id, &msg[1], sizeof(id));
+        val_log_token_emit(2, id, data1, data2);
+        return;
+    }
+#endif
+    val_printf(msg, data1, data2);
+}
+
+/**
+ *   @brief    Print the realm messages queued since the last drain, called by
+ *             the host on REC exit
+ *   @param    void
+ *   @return   void
+**/
+void val_realm_log_drain(void)
+{
+    val_realm_log_hdr_ts *hdr = val_realm_log_hdr();
+    char *slot = (char *)(val_get_shared_region_base() + REALM_PRINTF_MSG_OFFSET);
+    val_realm_log_ring_ts *ring;
+    val_realm_log_entry_ts *entry;
+    uint64_t seq, head;
+    uint32_t cpu;
+
+    if (hdr->magic != VAL_REALM_LOG_MAGIC)
+        return;
+
+    val_spin_lock(&hdr->lock);
+
+    for (cpu = 0; cpu < PLATFORM_CPU_COUNT; cpu++)
+    {
+        ring = &hdr->ring[cpu];
+        head = ring->head;
+        dmbsy();
+
+        for (seq = ring->tail; seq < head; seq++)
+        {
+            entry = val_realm_log_entry(cpu, seq);
+            val_realm_log_print(entry->msg, entry->data1, entry->data2);
+        }
+
+        ring->tail = head;
+    }
+
+    /* Message of a REC without a ring, it exited as soon as it wrote it */
+    if (*slot)
+    {
+        val_realm_log_print(slot,
+                    *(uint64_t *)(val_get_shared_region_base() + REALM_PRINTF_DATA1_OFFSET),
+                    *(uint64_t *)(val_get_shared_region_base() + REALM_PRINTF_DATA2_OFFSET));
+        *slot = '\0';
+    }
+
+    val_spin_unlock(&hdr->lock);
+}
@@ -7,6 +7,36 @@
 
 
 #include "val_smc.h"
+#include "val_smc_trace.h"
+#include "val_smc_stats.h"
+#include "val_mp_supp.h"
+
+/* RMI calls made by each PE, the RMI function IDs follow RMI_VERSION */
+#define VAL_SMC_RMI_FIDS    0x40
+
+static uint64_t rmi_calls[PLATFORM_CPU_COUNT];
+
+/**
+ *   @brief    Return the number of RMI calls made through val_smc_call
+ *   @param    all_pes  - Sum of every PE, else the calling PE only
+ *   @return   Number of calls since boot
+**/
+uint64_t val_smc_rmi_calls(bool all_pes)
+{
+    uint64_t count = 0;
+    uint32_t cpu;
+
+    if (!all_pes)
+    {
+        cpu = val_get_cpuid(val_read_mpidr());
+        return (cpu < PLATFORM_CPU_COUNT) ? rmi_calls[cpu] : 0;
+    }
+
+    for (cpu = 0; cpu < PLATFORM_CPU_COUNT; cpu++)
+        count += rmi_calls[cpu];
+
+    return count;
+}
 
 /* SMC call */
 val_smc_param_ts val_smc_call(uint64_t x0, uint64_t x1, uint64_t x2,
@@ -15,6 +45,21 @@ val_smc_param_ts val_smc_call(uint64_t x0, uint64_t x1, uint64_t x2,
                                 uint64_t x9, uint64_t x10)
 {
     val_smc_param_ts args;
+#ifdef VAL_SMC_TRACE
+    val_smc_param_ts in;
+    uint64_t timestamp;
+#endif
+#ifdef VAL_SMC_STATS
+    uint64_t start;
+#endif
+    uint32_t cpu;
+
+    if (x0 >= RMI_VERSION && x0 < RMI_VERSION + VAL_SMC_RMI_FIDS)
+    {
+        cpu = val_get_cpuid(val_read_mpidr());
+        if (cpu < PLATFORM_CPU_COUNT)
+            rmi_calls[cpu]++;
+    }
 
     args.x0 = x0;
     args.x1 = x1;
@@ -27,6 +72,19 @@ val_smc_param_ts val_smc_call(uint64_t x0, uint64_t x1, uint64_t x2,
     args.x8 = x8;
     args.x9 = x9;
     args.x10 = x10;
+#ifdef VAL_SMC_TRACE
+    in = args;
+    timestamp = virtualcounter_read();
+#endif
+#ifdef VAL_SMC_STATS
+    start = syscounter_read();
+#endif
     val_smc_call_asm(&args);
+#ifdef VAL_SMC_STATS
+    val_smc_stats_update(x0, syscounter_read() - start);
+#endif
+#ifdef VAL_SMC_TRACE
+    val_smc_trace_record(&in, &args, timestamp);
+#endif
     return args;
 }
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Opt-in latency statistics of the RMI calls made by the host through
+ * val_smc_call. Every PE updates its own table, the tables are merged when
+ * printed after the regression report.
+ */
+#ifdef VAL_SMC_STATS
+
+#include "val_smc_stats.h"
+#include "val_mp_supp.h"
+#include "val_libc.h"
+
+static val_smc_stats_ts smc_stats[PLATFORM_CPU_COUNT][VAL_SMC_STATS_FIDS];
+
+static const char *const smc_stats_name[VAL_SMC_STATS_FIDS] = {
+    [RMI_VERSION - VAL_SMC_STATS_FID_BASE]               = "RMI_VERSION",
+    [RMI_GRANULE_DELEGATE - VAL_SMC_STATS_FID_BASE]      = "RMI_GRANULE_DELEGATE",
+    [RMI_GRANULE_UNDELEGATE - VAL_SMC_STATS_FID_BASE]    = "RMI_GRANULE_UNDELEGATE",
+    [RMI_DATA_CREATE - VAL_SMC_STATS_FID_BASE]           = "RMI_DATA_CREATE",
+    [RMI_DATA_CREATE_UNKNOWN - VAL_SMC_STATS_FID_BASE]   = "RMI_DATA_CREATE_UNKNOWN",
+    [RMI_DATA_DESTROY - VAL_SMC_STATS_FID_BASE]          = "RMI_DATA_DESTROY",
+    [RMI_REALM_ACTIVATE - VAL_SMC_STATS_FID_BASE]        = "RMI_REALM_ACTIVATE",
+    [RMI_REALM_CREATE - VAL_SMC_STATS_FID_BASE]          = "RMI_REALM_CREATE",
+    [RMI_REALM_DESTROY - VAL_SMC_STATS_FID_BASE]         = "RMI_REALM_DESTROY",
+    [RMI_REC_CREATE - VAL_SMC_STATS_FID_BASE]            = "RMI_REC_CREATE",
+    [RMI_REC_DESTROY - VAL_SMC_STATS_FID_BASE]           = "RMI_REC_DESTROY",
+    [RMI_REC_ENTER - VAL_SMC_STATS_FID_BASE]             = "RMI_REC_ENTER",
+    [RMI_RTT_CREATE - VAL_SMC_STATS_FID_BASE]            = "RMI_RTT_CREATE",
+    [RMI_RTT_DESTROY - VAL_SMC_STATS_FID_BASE]           = "RMI_RTT_DESTROY",
+    [RMI_RTT_MAP_UNPROTECTED - VAL_SMC_STATS_FID_BASE]   = "RMI_RTT_MAP_UNPROTECTED",
+    [RMI_RTT_MAP_PROTECTED - VAL_SMC_STATS_FID_BASE]     = "RMI_RTT_MAP_PROTECTED",
+    [RMI_RTT_READ_ENTRY - VAL_SMC_STATS_FID_BASE]        = "RMI_RTT_READ_ENTRY",
+    [RMI_RTT_UNMAP_UNPROTECTED - VAL_SMC_STATS_FID_BASE] = "RMI_RTT_UNMAP_UNPROTECTED",
+    [RMI_PSCI_COMPLETE - VAL_SMC_STATS_FID_BASE]         = "RMI_PSCI_COMPLETE",
+    [RMI_FEATURES - VAL_SMC_STATS_FID_BASE]              = "RMI_FEATURES",
+    [RMI_RTT_FOLD - VAL_SMC_STATS_FID_BASE]              = "RMI_RTT_FOLD",
+    [RMI_REC_AUX_COUNT - VAL_SMC_STATS_FID_BASE]         = "RMI_REC_AUX_COUNT",
+    [RMI_RTT_INIT_RIPAS - VAL_SMC_STATS_FID_BASE]        = "RMI_RTT_INIT_RIPAS",
+    [RMI_RTT_SET_RIPAS - VAL_SMC_STATS_FID_BASE]         = "RMI_RTT_SET_RIPAS",
+};
+
+static uint32_t val_smc_stats_bucket(uint64_t ticks)
+{
+    uint32_t bucket = 0;
+
+    while (ticks && bucket < VAL_SMC_STATS_BUCKETS - 1)
+    {
+        ticks >>= 1;
+        bucket++;
+    }
+
+    return bucket;
+}
+
+/**
+ *   @brief    Account one call, only host RMI calls are tracked
+ *   @param    fid     - Function ID of the call
+ *   @param    ticks   - CNTPCT_EL0 ticks spent in the call
+ *   @return   void
+**/
+void val_smc_stats_update(uint64_t fid, uint64_t ticks)
+{
+    val_smc_stats_ts *stats;
+    uint32_t cpu;
+
+    if (security_state != 1 || fid < VAL_SMC_STATS_FID_BASE ||
+        fid >= VAL_SMC_STATS_FID_BASE + VAL_SMC_STATS_FIDS)
+        return;
+
+    cpu = val_get_cpuid(val_read_mpidr());
+    if (cpu >= PLATFORM_CPU_COUNT)
+        return;
+
+    stats = &smc_stats[cpu][fid - VAL_SMC_STATS_FID_BASE];
+    if (stats->count == 0 || ticks < stats->min)
+        stats->min = ticks;
+    if (ticks > stats->max)
+        stats->max = ticks;
+    stats->count++;
+    stats->total += ticks;
+    stats->hist[val_smc_stats_bucket(ticks)]++;
+}
+
+/**
+ *   @brief    Merge the tables of every PE for one function ID
+ *   @param    index   - Function ID less VAL_SMC_STATS_FID_BASE
+ *   @param    stats   - Merged statistics
+ *   @return   void
+**/
+static void val_smc_stats_merge(uint32_t index, val_smc_stats_ts *stats)
+{
+    val_smc_stats_ts *cpu_stats;
+    uint32_t cpu, i;
+
+    val_memset(stats, 0, sizeof(*stats));
+
+    for (cpu = 0; cpu < PLATFORM_CPU_COUNT; cpu++)
+    {
+        cpu_stats = &smc_stats[cpu][index];
+        if (cpu_stats->count == 0)
+            continue;
+
+        if (stats->count == 0 || cpu_stats->min < stats->min)
+            stats->min = cpu_stats->min;
+        if (cpu_stats->max > stats->max)
+            stats->max = cpu_stats->max;
+        stats->count += cpu_stats->count;
+        stats->total += cpu_stats->total;
+        for (i = 0; i < VAL_SMC_STATS_BUCKETS; i++)
+            stats->hist[i] += cpu_stats->hist[i];
+    }
+}
+
+/**
+ *   @brief    Print the statistics of every RMI command that was called
+ *   @param    void
+ *   @return   void
+**/
+void val_smc_stats_print(void)
+{
+    val_smc_stats_ts stats;
+    uint32_t index, i;
+
+    LOG(ALWAYS, "RMI LATENCY REPORT (CNTPCT ticks, CNTFRQ %d Hz): \n",
+        read_cntfrq_el0(), 0);
+    LOG(ALWAYS, "==================\n", 0, 0);
+
+    for (index = 0; index < VAL_SMC_STATS_FIDS; index++)
+    {
+        val_smc_stats_merge(index, &stats);
+        if (stats.count == 0)
+            continue;
+
+        if (smc_stats_name[index] != NULL)
+        {
+            LOG(ALWAYS, smc_stats_name[index], 0, 0);
+        } else
+        {
+            LOG(ALWAYS, "FID 0x%x", VAL_SMC_STATS_FID_BASE + index, 0);
+        }
+        LOG(ALWAYS, "\n   COUNT : %d    MEAN : %d\n", stats.count, stats.total / stats.count);
+        LOG(ALWAYS, "   MIN   : %d    MAX  : %d\n", stats.min, stats.max);
+
+        for (i = 0; i < VAL_SMC_STATS_BUCKETS; i++)
+        {
+            if (stats.hist[i] == 0)
+                continue;
+
+            LOG(ALWAYS, "   < 2^%d : %d\n", i, stats.hist[i]);
+        }
+    }
+    LOG(ALWAYS, "\n", 0, 0);
+}
+
+#endif /* VAL_SMC_STATS */
@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Opt-in trace of the calls made through val_smc_call. Records are kept in
+ * rings in the upper half of the shared region and printed by the host, one
+ * line per record, when a test exits. tools/scripts/smc_trace.py turns the
+ * printed lines back into a binary trace, after tools/scripts/log_decode.py
+ * for the logs of -DLOG_TOKENS=ON builds.
+ */
+#ifdef VAL_SMC_TRACE
+
+#include "val_smc_trace.h"
+#include "val_log_token.h"
+#include "val_mp_supp.h"
+#include "val_libc.h"
+
+/* Header, then the page slots, then the records */
+#define VAL_SMC_TRACE_PAGE_BASE     PAGE_SIZE
+#define VAL_SMC_TRACE_REC_BASE      (VAL_SMC_TRACE_PAGE_BASE + \
+                                        (VAL_SMC_TRACE_PAGES * PAGE_SIZE))
+#define VAL_SMC_TRACE_REC_SIZE      sizeof(val_smc_trace_rec_ts)
+#define VAL_SMC_TRACE_REALM_RECS    64
+#define VAL_SMC_TRACE_HOST_RECS     ((VAL_SMC_TRACE_SIZE - VAL_SMC_TRACE_REC_BASE) / \
+                                        VAL_SMC_TRACE_REC_SIZE - \
+                                        (PLATFORM_CPU_COUNT * VAL_SMC_TRACE_REALM_RECS))
+
+/* Hex digits of a 64 bit value plus a separator */
+#define VAL_SMC_TRACE_FIELD_LEN     17
+#define VAL_SMC_TRACE_LINE_LEN      (8 + (VAL_SMC_TRACE_IN_REGS + VAL_SMC_TRACE_OUT_REGS + 6) * \
+                                        VAL_SMC_TRACE_FIELD_LEN)
+
+/*
+ * Formats of the lines, a tag and one field per specifier. -DLOG_TOKENS=ON
+ * builds send a line as one value record of this format, text builds only
+ * use the tag.
+ */
+#define VAL_SMC_TRACE_TAG_LEN       5
+#define VAL_SMC_TRACE_X5            "%x %x %x %x %x "
+#define VAL_SMC_TRACE_REC_FMT       "SMCT " VAL_SMC_TRACE_X5 VAL_SMC_TRACE_X5 VAL_SMC_TRACE_X5 \
+                                        VAL_SMC_TRACE_X5 VAL_SMC_TRACE_X5 "%x\n"
+#define VAL_SMC_TRACE_REC_FIELDS    (5 + VAL_SMC_TRACE_IN_REGS + VAL_SMC_TRACE_OUT_REGS)
+#define VAL_SMC_TRACE_PAGE_FMT      "SMCP %x %x %x\n"
+#define VAL_SMC_TRACE_LOST_FMT      "SMCL %x %x\n"
+
+CASSERT(VAL_SMC_TRACE_REC_FIELDS == 26, assert_smc_trace_rec_fmt);
+
+static uint8_t *val_smc_trace_base(void)
+{
+    return (uint8_t *)val_get_shared_region_base() + VAL_SMC_TRACE_OFFSET;
+}
+
+static val_smc_trace_hdr_ts *val_smc_trace_hdr(void)
+{
+    return (val_smc_trace_hdr_ts *)val_smc_trace_base();
+}
+
+static val_smc_trace_rec_ts *val_smc_trace_rec(val_smc_trace_ring_ts *ring, uint64_t seq)
+{
+    return (val_smc_trace_rec_ts *)(val_smc_trace_base() + ring->base +
+                                    (seq % ring->capacity) * VAL_SMC_TRACE_REC_SIZE);
+}
+
+static uint8_t *val_smc_trace_page(uint32_t slot)
+{
+    return val_smc_trace_base() + VAL_SMC_TRACE_PAGE_BASE + slot * PAGE_SIZE;
+}
+
+/**
+ *   @brief    Check that the caller can write to the trace area. Secure
+ *             endpoints do not map it and the realm maps it with its MMU.
+ *   @param    void
+ *   @return   true if records can be written
+**/
+static bool val_smc_trace_active(void)
+{
+    if (security_state == 1)
+        return (val_sctlr_read(2) & SCTLR_M_BIT) &&
+                val_smc_trace_hdr()->magic == VAL_SMC_TRACE_MAGIC;
+
+    if (security_state == 2)
+        return (val_sctlr_read(1) & SCTLR_M_BIT) &&
+                val_smc_trace_hdr()->magic == VAL_SMC_TRACE_MAGIC;
+
+    return false;
+}
+
+/**
+ *   @brief    Reset the trace area, called by the host once its MMU is on.
+ *             Records of a run interrupted by a reset are kept.
+ *   @param    void
+ *   @return   void
+**/
+void val_smc_trace_init(void)
+{
+    val_smc_trace_hdr_ts *hdr = val_smc_trace_hdr();
+    uint64_t base = VAL_SMC_TRACE_REC_BASE;
+    uint32_t i;
+
+    if (hdr->magic == VAL_SMC_TRACE_MAGIC)
+        return;
+
+    val_memset(hdr, 0, sizeof(*hdr));
+    val_init_spinlock(&hdr->lock);
+
+    for (i = 0; i < VAL_SMC_TRACE_RINGS; i++)
+    {
+        hdr->ring[i].base = base;
+        hdr->ring[i].capacity = (i == VAL_SMC_TRACE_HOST_RING) ?
+                                    VAL_SMC_TRACE_HOST_RECS : VAL_SMC_TRACE_REALM_RECS;
+        base += hdr->ring[i].capacity * VAL_SMC_TRACE_REC_SIZE;
+    }
+
+    hdr->magic = VAL_SMC_TRACE_MAGIC;
+}
+
+/**
+ *   @brief    Return the NS parameter granule read by a create command
+ *   @param    in      - Registers on entry
+ *   @return   Address of the granule, 0 if there is none to capture
+**/
+static uint64_t val_smc_trace_params(val_smc_param_ts *in)
+{
+    uint64_t params;
+
+    if (in->x0 == RMI_REALM_CREATE)
+        params = in->x2;
+    else if (in->x0 == RMI_REC_CREATE)
+        params = in->x3;
+    else
+        return 0;
+
+    if (params < PLATFORM_NORMAL_WORLD_IMAGE_BASE ||
+        params >= PLATFORM_MEMORY_POOL_BASE + PLATFORM_MEMORY_POOL_SIZE ||
+        (params & (PAGE_SIZE - 1)))
+        return 0;
+
+    return params;
+}
+
+static uint32_t val_smc_trace_hex(char *buf, uint64_t value)
+{
+    uint32_t len = 0, i;
+    char digits[16];
+
+    do {
+        digits[len++] = "0123456789abcdef"[value & 0xF];
+        value >>= 4;
+    } while (value);
+
+    for (i = 0; i < len; i++)
+        buf[i] = digits[len - 1 - i];
+    buf[len] = ' ';
+
+    return len + 1;
+}
+
+/**
+ *   @brief    Print a line of the trace
+ *   @param    fmt     - Format of the line
+ *   @param    field   - Field values
+ *   @param    count   - Number of fields
+ *   @return   void
+**/
+static void val_smc_trace_print(const char *fmt, const uint64_t *field, uint32_t count)
+{
+    char line[VAL_SMC_TRACE_LINE_LEN];
+    uint32_t len = VAL_SMC_TRACE_TAG_LEN, i;
+#ifdef VAL_LOG_TOKENS
+    uint32_t id;
+
+    /* The trace is dumped by the host with no log capture active */
+    if (val_log_token_id(fmt, &id))
+    {
+        val_log_token_emit_values(security_state, id, field, count);
+        return;
+    }
+#endif
+
+    val_memcpy(line, fmt, VAL_SMC_TRACE_TAG_LEN);
+    for (i = 0; i < count; i++)
+        len += val_smc_trace_hex(&line[len], field[i]);
+
+    line[len - 1] = '\n';
+    line[len] = '\0';
+    LOG(ALWAYS, line, 0, 0);
+}
+
+/**
+ *   @brief    Print the non-zero words of a captured page
+ *   @param    seq     - Sequence number of the owning record
+ *   @param    page    - Captured page
+ *   @return   void
+**/
+static void val_smc_trace_print_page(uint64_t seq, uint64_t *page)
+{
+    uint64_t field[3];
+    uint32_t i;
+
+    for (i = 0; i < PAGE_SIZE / sizeof(uint64_t); i++)
+    {
+        if (!page[i])
+            continue;
+
+        field[0] = seq;
+        field[1] = i * sizeof(uint64_t);
+        field[2] = page[i];
+        val_smc_trace_print(VAL_SMC_TRACE_PAGE_FMT, field, 3);
+    }
+}
+
+/**
+ *   @brief    Print the records of a ring that were not dumped yet
+ *   @param    hdr     - Trace header
+ *   @param    ring    - Ring to drain
+ *   @return   void
+**/
+static void val_smc_trace_drain(val_smc_trace_hdr_ts *hdr, val_smc_trace_ring_ts *ring)
+{
+    uint64_t field[VAL_SMC_TRACE_REC_FIELDS];
+    val_smc_trace_rec_ts *rec;
+    uint64_t seq, head = ring->head;
+
+    if (head - ring->tail > ring->capacity)
+    {
+        field[0] = (uint64_t)(ring - hdr->ring);
+        field[1] = head - ring->tail - ring->capacity;
+        val_smc_trace_print(VAL_SMC_TRACE_LOST_FMT, field, 2);
+        ring->tail = head - ring->capacity;
+    }
+
+    for (seq = ring->tail; seq < head; seq++)
+    {
+        rec = val_smc_trace_rec(ring, seq);
+
+        field[0] = seq;
+        field[1] = rec->security_state;
+        field[2] = rec->cpu;
+        field[3] = rec->timestamp;
+        field[4] = rec->fid;
+        val_memcpy(&field[5], rec->in, sizeof(rec->in));
+        val_memcpy(&field[5 + VAL_SMC_TRACE_IN_REGS], rec->out, sizeof(rec->out));
+        val_smc_trace_print(VAL_SMC_TRACE_REC_FMT, field, VAL_SMC_TRACE_REC_FIELDS);
+
+        if (rec->flags & VAL_SMC_TRACE_FLAG_PAGE)
+            val_smc_trace_print_page(seq, (uint64_t *)val_smc_trace_page(rec->page));
+    }
+
+    ring->tail = head;
+    if (ring == &hdr->ring[VAL_SMC_TRACE_HOST_RING])
+        hdr->page_used = 0;
+}
+
+/**
+ *   @brief    Append a call to the ring of the caller
+ *   @param    in          - Registers on entry
+ *   @param    out         - Registers on return
+ *   @param    timestamp   - CNTVCT_EL0 before the call
+ *   @return   void
+**/
+void val_smc_trace_record(val_smc_param_ts *in, val_smc_param_ts *out, uint64_t timestamp)
+{
+    val_smc_trace_hdr_ts *hdr = val_smc_trace_hdr();
+    val_smc_trace_ring_ts *ring;
+    val_smc_trace_rec_ts *rec;
+    uint64_t seq, params = 0;
+    uint32_t cpu;
+
+    if (!val_smc_trace_active())
+        return;
+
+    cpu = val_get_cpuid(val_read_mpidr());
+    if (cpu >= PLATFORM_CPU_COUNT)
+        return;
+
+    /*
+     * A REC can exit in the middle of a record, realm rings are not locked
+     * and wrap. The host prints its ring rather than dropping records, so
+     * that a trace replays from a known state.
+     */
+    if (security_state == 1)
+    {
+        ring = &hdr->ring[VAL_SMC_TRACE_HOST_RING];
+        params = val_smc_trace_params(in);
+        val_spin_lock(&hdr->lock);
+        if (ring->head - ring->tail == ring->capacity ||
+            (params && hdr->page_used == VAL_SMC_TRACE_PAGES))
+            val_smc_trace_drain(hdr, ring);
+    } else
+        ring = &hdr->ring[VAL_SMC_TRACE_HOST_RING + 1 + cpu];
+
+    seq = ring->head;
+    rec = val_smc_trace_rec(ring, seq);
+    rec->fid = in->x0;
+    val_memcpy(rec->in, &in->x1, sizeof(rec->in));
+    val_memcpy(rec->out, &out->x0, sizeof(rec->out));
+    rec->timestamp = timestamp;
+    rec->cpu = (uint16_t)cpu;
+    rec->security_state = (uint8_t)security_state;
+    rec->flags = 0;
+    rec->page = VAL_SMC_TRACE_PAGE_NONE;
+
+    if (params)
+    {
+        rec->page = hdr->page_used++;
+        rec->flags |= VAL_SMC_TRACE_FLAG_PAGE;
+        val_memcpy(val_smc_trace_page(rec->page), (void *)params, PAGE_SIZE);
+    }
+
+    dmbsy();
+    ring->head = seq + 1;
+
+    if (security_state == 1)
+        val_spin_unlock(&hdr->lock);
+}
+
+/**
+ *   @brief    Print and drop the records of every ring. Called by the host
+ *             when no realm is running.
+ *   @param    void
+ *   @return   void
+**/
+void val_smc_trace_dump(void)
+{
+    val_smc_trace_hdr_ts *hdr = val_smc_trace_hdr();
+    uint32_t i;
+
+    if (!val_smc_trace_active())
+        return;
+
+    val_spin_lock(&hdr->lock);
+    for (i = 0; i < VAL_SMC_TRACE_RINGS; i++)
+        val_smc_trace_drain(hdr, &hdr->ring[i]);
+    val_spin_unlock(&hdr->lock);
+}
+
+#endif /* VAL_SMC_TRACE */
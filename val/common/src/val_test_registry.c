@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Lookup of the test_list[] entries of an image by registry ID and by name.
+ * The name lookup is a perfect hash built once at boot: a first hash puts the
+ * names into buckets, and each bucket gets the displacement of a second hash
+ * that sends all of its names to free slots. A lookup is then one string
+ * compare, with the names that are not in the image rejected by it.
+ */
+
+#include "test_database.h"
+
+extern const uint32_t  total_tests;
+extern const test_db_t test_list[];
+
+/* Power of 2 of at least twice the number of tests */
+#define VAL_TEST_HASH_SLOTS     512
+#define VAL_TEST_HASH_BUCKETS   128
+#define VAL_TEST_HASH_DISP_MAX  255
+
+/* test_list[] indices are kept in 16 bits */
+CASSERT((TEST_ID_END + 1) * 2 <= VAL_TEST_HASH_SLOTS, assert_test_hash_slots);
+CASSERT(VAL_TEST_HASH_SLOTS <= 0x10000, assert_test_index_size);
+
+/* test_list[] index of each registry ID, 0 if the test is not in the image */
+static uint16_t test_index[TEST_ID_END];
+
+/* Displacement of each bucket, 0 for a bucket without names */
+static uint8_t hash_disp[VAL_TEST_HASH_BUCKETS];
+
+/* test_list[] index of the name hashed to each slot, 0 for a free slot */
+static uint16_t hash_slot[VAL_TEST_HASH_SLOTS];
+
+/* Set once the perfect hash is built, else names are looked up one by one */
+static bool hash_ready;
+
+static uint32_t val_test_name_hash(const char *name)
+{
+    uint32_t hash = 2166136261U;
+
+    /* FNV-1a */
+    while (*name)
+    {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+static uint32_t val_test_hash_mix(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+static uint32_t val_test_hash_bucket(uint32_t hash)
+{
+    return val_test_hash_mix(hash) % VAL_TEST_HASH_BUCKETS;
+}
+
+static uint32_t val_test_hash_slot(uint32_t hash, uint32_t disp)
+{
+    return val_test_hash_mix(hash ^ (disp * 0x9e3779b9U)) & (VAL_TEST_HASH_SLOTS - 1);
+}
+
+static bool val_test_is_entry(uint32_t index)
+{
+    return test_list[index].id != 0 && test_list[index].id < TEST_ID_END;
+}
+
+/**
+ *   @brief    Find a displacement that sends every name of a bucket to a free
+ *             slot and take the slots
+ *   @param    bucket      - Bucket
+ *   @return   SUCCESS/FAILURE
+**/
+static uint32_t val_test_hash_place(uint32_t bucket)
+{
+    uint32_t disp, i, j, hash, slot;
+
+    for (disp = 1; disp <= VAL_TEST_HASH_DISP_MAX; disp++)
+    {
+        for (i = 1; i < total_tests; i++)
+        {
+            hash = val_test_name_hash(test_list[i].test_name);
+            if (!val_test_is_entry(i) || val_test_hash_bucket(hash) != bucket)
+                continue;
+
+            slot = val_test_hash_slot(hash, disp);
+            if (hash_slot[slot])
+                break;
+
+            hash_slot[slot] = (uint16_t)i;
+        }
+
+        if (i == total_tests)
+        {
+            hash_disp[bucket] = (uint8_t)disp;
+            return VAL_SUCCESS;
+        }
+
+        /* Free the slots taken with this displacement */
+        for (j = 1; j < i; j++)
+        {
+            hash = val_test_name_hash(test_list[j].test_name);
+            if (val_test_is_entry(j) && val_test_hash_bucket(hash) == bucket)
+                hash_slot[val_test_hash_slot(hash, disp)] = 0;
+        }
+    }
+
+    return VAL_ERROR;
+}
+
+/**
+ *   @brief    Build the ID and name lookups of test_list[], called once at boot
+ *             by the primary PE of each image
+ *   @param    void
+ *   @return   void
+**/
+void val_test_registry_init(void)
+{
+    uint8_t bucket_size[VAL_TEST_HASH_BUCKETS] = {0};
+    uint32_t i, bucket, size, max_size = 0;
+
+    val_memset(test_index, 0, sizeof(test_index));
+    val_memset(hash_disp, 0, sizeof(hash_disp));
+    val_memset(hash_slot, 0, sizeof(hash_slot));
+    hash_ready = false;
+
+    for (i = 1; i < total_tests; i++)
+    {
+        if (!val_test_is_entry(i))
+            continue;
+
+        test_index[test_list[i].id] = (uint16_t)i;
+
+        bucket = val_test_hash_bucket(val_test_name_hash(test_list[i].test_name));
+        if (++bucket_size[bucket] > max_size)
+            max_size = bucket_size[bucket];
+    }
+
+    /* Largest buckets first, while most slots are free */
+    for (size = max_size; size > 0; size--)
+    {
+        for (bucket = 0; bucket < VAL_TEST_HASH_BUCKETS; bucket++)
+        {
+            if (bucket_size[bucket] == size && val_test_hash_place(bucket))
+            {
+                LOG(WARN, "\tNo perfect hash of the test names, bucket %d\n", bucket, 0);
+                return;
+            }
+        }
+    }
+
+    hash_ready = true;
+}
+
+/**
+ *   @brief    Return the test_list[] index of a test
+ *   @param    id          - Registry ID, TEST_ID_<testname>
+ *   @return   Index, 0 if the test is not in this image
+**/
+uint32_t val_test_index_by_id(uint32_t id)
+{
+    return (id < TEST_ID_END) ? test_index[id] : 0;
+}
+
+/**
+ *   @brief    Return the test_list[] index of a test
+ *   @param    name        - Test name
+ *   @return   Index, 0 if the test is not in this image
+**/
+uint32_t val_test_index_by_name(const char *name)
+{
+    uint32_t hash, i;
+
+    if (hash_ready)
+    {
+        hash = val_test_name_hash(name);
+        i = hash_disp[val_test_hash_bucket(hash)];
+        if (i)
+        {
+            i = hash_slot[val_test_hash_slot(hash, i)];
+            if (i && !val_strcmp((char *)test_list[i].test_name, (char *)name))
+                return i;
+        }
+        return 0;
+    }
+
+    for (i = 1; i < total_tests; i++)
+    {
+        if (val_test_is_entry(i) && !val_strcmp((char *)test_list[i].test_name, (char *)name))
+            return i;
+    }
+
+    return 0;
+}
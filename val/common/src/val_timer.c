@@ -144,3 +144,53 @@ void val_timer_set_phy_el2(uint64_t timeout)
     write_cnthp_ctl_el2(timer_ctrl_reg);
 }
 
+/**
+ *   @brief   Return the counter value of a deadline
+ *   @param   ns        - Nanoseconds from now
+ *   @return  CNTPCT_EL0 value of the deadline
+**/
+uint64_t val_wait_deadline(uint64_t ns)
+{
+    uint64_t freq = read_cntfrq_el0();
+
+    return syscounter_read() + (ns / 1000000000) * freq +
+           ((ns % 1000000000) * freq) / 1000000000;
+}
+
+/**
+ *   @brief   Check whether a deadline has passed
+ *   @param   deadline  - CNTPCT_EL0 value of the deadline
+ *   @return  true once the counter reaches the deadline
+**/
+bool val_wait_expired(uint64_t deadline)
+{
+    return syscounter_read() >= deadline;
+}
+
+/**
+ *   @brief   Sleep until the next event of the counter event stream, an
+ *            interrupt or any other WFE wake-up event
+ *   @param   void
+ *   @return  void
+**/
+void val_wait_event(void)
+{
+    uint64_t ctl, evnt;
+
+    evnt = EVNTEN_BIT | ((uint64_t)VAL_WAIT_EVNTI << EVNTI_SHIFT);
+
+    /* The event stream bits of CNTHCTL_EL2 and CNTKCTL_EL1 match */
+    ctl = (get_current_el() == 2) ? read_cnthctl_el2() : read_cntkctl_el1();
+    if ((ctl & (EVNTEN_BIT | EVNTDIR_BIT | (EVNTI_MASK << EVNTI_SHIFT))) != evnt)
+    {
+        ctl &= ~(uint64_t)(EVNTDIR_BIT | (EVNTI_MASK << EVNTI_SHIFT));
+        ctl |= evnt;
+        if (get_current_el() == 2)
+            write_cnthctl_el2(ctl);
+        else
+            write_cntkctl_el1(ctl);
+        isb();
+    }
+
+    wfe();
+}
@@ -14,10 +14,21 @@
 #define __ADDR_ALIGN_MASK(a, mask)    (((a) + (mask)) & ~(mask))
 #define ADDR_ALIGN(a, b)              __ADDR_ALIGN_MASK(a, (typeof(a))(b) - 1)
 
+/* Largest buddy block is PAGE_SIZE << VAL_HOST_BUDDY_MAX_ORDER */
+#define VAL_HOST_BUDDY_MAX_ORDER      11
+
+struct val_host_granule_ts;
+
 void val_host_mem_alloc_init(void);
 void *val_host_mem_alloc(size_t alignment, size_t size);
 void val_host_mem_free(void *ptr);
 void *mem_alloc(size_t alignment, size_t size);
+struct val_host_granule_ts *val_host_granule_node_alloc(void);
+void val_host_granule_node_free(struct val_host_granule_ts *node);
+void val_host_mem_pin(uint64_t addr);
+void val_host_mem_unpin(uint64_t addr);
+uint64_t val_host_mem_peak(void);
+uint32_t val_host_get_arena_index(void);
 uint16_t val_host_get_vmid(void);
 
 #endif /* _VAL_HOST_ALLOC_H_ */
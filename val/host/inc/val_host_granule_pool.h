@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _VAL_HOST_GRANULE_POOL_H_
+#define _VAL_HOST_GRANULE_POOL_H_
+
+#include "val_host_realm.h"
+
+/* Maximum number of delegated granules held by the pool */
+#define VAL_HOST_GRANULE_POOL_SIZE    64
+/* Number of granules delegated per refill */
+#define VAL_HOST_GRANULE_POOL_BATCH   16
+/* Pool level that starts a refill on the secondary cpu */
+#define VAL_HOST_GRANULE_POOL_LOW     4
+
+void val_host_granule_pool_init(uint32_t refill_cpuid);
+uint32_t val_host_granule_pool_refill(uint32_t count);
+uint32_t val_host_granule_pool_refill_async(uint32_t target_cpuid, uint32_t count);
+uint64_t val_host_granule_pool_get(void);
+uint64_t val_host_granule_pool_release(uint64_t pa);
+void val_host_granule_pool_drain(void);
+
+#endif /* _VAL_HOST_GRANULE_POOL_H_ */
@@ -11,6 +11,15 @@
 #include "val_mp_supp.h"
 #include "val_host_framework.h"
 
+typedef void (*val_host_cpu_job_fn)(void *arg);
+
+typedef struct {
+    val_host_cpu_job_fn fn;
+    void *arg;
+} val_host_cpu_job_ts;
+
 uint64_t val_host_power_on_cpu(uint32_t target_cpuid);
 uint64_t val_host_power_off_cpu(void);
+uint64_t val_host_run_on_cpu(uint32_t target_cpuid, val_host_cpu_job_fn fn, void *arg);
+void val_host_run_secondary_job(void);
 #endif /* _VAL_HOST_MP_H_ */
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _VAL_HOST_PROFILE_H_
+#define _VAL_HOST_PROFILE_H_
+
+#include "val.h"
+
+/* Rows of the slowest tests table */
+#define VAL_HOST_PROFILE_SLOWEST    10
+
+/* Part of a test the counters are accounted to */
+typedef enum {
+    VAL_HOST_PROFILE_SETUP,         /* val_host_realm_setup */
+    VAL_HOST_PROFILE_BODY,
+    VAL_HOST_PROFILE_POSTAMBLE,
+    VAL_HOST_PROFILE_PHASES
+} val_host_profile_phase_te;
+
+typedef struct {
+    uint64_t ticks;                 /* CNTPCT_EL0 */
+    uint64_t cycles;                /* PMCCNTR_EL0 */
+    uint64_t instructions;          /* INST_RETIRED event counter */
+} val_host_profile_count_ts;
+
+typedef struct {
+    val_host_profile_count_ts phase[VAL_HOST_PROFILE_PHASES];
+    bool pmu;                       /* Cycles and instructions were counted */
+} val_host_profile_ts;
+
+void val_host_profile_start(uint32_t test_num);
+val_host_profile_phase_te val_host_profile_phase(val_host_profile_phase_te phase);
+void val_host_profile_stop(void);
+const val_host_profile_ts *val_host_profile_get(uint32_t test_num);
+void val_host_profile_print(void);
+#endif /* _VAL_HOST_PROFILE_H_ */
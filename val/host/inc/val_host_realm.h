@@ -11,8 +11,6 @@
 #include "val_host_rmi.h"
 #include "val_libc.h"
 
-#define VAL_MAX_REC_COUNT 8
-
 #define VAL_RTT_BLOCK_LEVEL    2
 #define VAL_RTT_MAX_LEVEL    3
 
@@ -22,6 +20,7 @@
 #define VAL_PAGE_SHIFT        12
 #define VAL_RTT_LEVEL_SHIFT(level)    ((VAL_PAGE_SHIFT - 3) * (4 - (level)) + 3)
 #define VAL_RTT_L2_BLOCK_SIZE    (1UL << VAL_RTT_LEVEL_SHIFT(2))
+#define VAL_RTT_L1_BLOCK_SIZE    (1UL << VAL_RTT_LEVEL_SHIFT(1))
 
 #define VAL_REC_NUM_GPRS                      8
 #define VAL_REC_HVC_NUM_GPRS                 31
@@ -32,14 +31,27 @@
 #define REC_CREATE_NR_GPRS                  8
 
 #define VAL_MAX_REC_AUX_GRANULES 16
-#define VAL_MAX_RTT_GRANULES 25
-#define VAL_MAX_GRANULES_MAP 25
 
-#define VAL_HOST_MAX_REALMS 10
+/* Initial number of entries of the growable realm tables, they double when full */
+#define VAL_HOST_REALM_TABLE_MIN 8
+
+/* mem_track slots are allocated in chunks, the first chunk is static */
+#define VAL_HOST_REALM_CHUNK_SLOTS 32
+#define VAL_HOST_MAX_REALMS 1024
+/* Number of buckets in the RD keyed realm slot index, must be power of 2 */
+#define VAL_HOST_REALM_INDEX_SIZE 256
+
+/* Number of buckets in the PA keyed NS granule index, must be power of 2 */
+#define VAL_HOST_GRANULE_INDEX_SIZE 4096
+/* Number of locks striped over the NS granule index buckets, must be power of 2 */
+#define VAL_HOST_GRANULE_INDEX_LOCKS 64
 #define SET_MEMBER_RMI	SET_MEMBER
 
 #define REALM_FLAG_PMU_ENABLE (1UL << 2)
 
+/* VMIDs from 0 that a test picks itself, see val_host_realm_vmid() */
+#define VAL_HOST_TEST_VMIDS 32
+
 typedef enum {
     REALM_STATE_NULL,
     REALM_STATE_NEW,
@@ -84,23 +96,31 @@ typedef struct {
     uint32_t num_s2_sl_rtts;
     uint64_t rec_count;
 
-    /* Test Input end */
+    /* Test Input end, the fields below are set by realm creation */
     uint64_t image_pa_base;
     uint64_t image_pa_size;
     uint64_t rd;
     uint64_t rtt_l0_addr;
+    /* The tables below are allocated on first use and grow on demand,
+       the capacity fields hold their number of entries */
     uint64_t rtt_l1_count;
-    val_host_rtt_db_ts rtt_l1[VAL_MAX_RTT_GRANULES];
+    uint64_t rtt_l1_capacity;
+    val_host_rtt_db_ts *rtt_l1;
     uint64_t rtt_l2_count;
-    val_host_rtt_db_ts rtt_l2[VAL_MAX_RTT_GRANULES];
+    uint64_t rtt_l2_capacity;
+    val_host_rtt_db_ts *rtt_l2;
     uint64_t rtt_l3_count;
-    val_host_rtt_db_ts rtt_l3[VAL_MAX_RTT_GRANULES];
+    uint64_t rtt_l3_capacity;
+    val_host_rtt_db_ts *rtt_l3;
     uint64_t granules_mapped_count;
-    val_host_granules_mapped_ts granules[VAL_MAX_GRANULES_MAP];
-    uint64_t rec[VAL_MAX_REC_COUNT];
-    uint64_t run[VAL_MAX_REC_COUNT];
+    uint64_t granules_capacity;
+    val_host_granules_mapped_ts *granules;
+    /* rec, run and rec_aux_granules have room for rec_capacity RECs */
+    uint64_t rec_capacity;
+    uint64_t *rec;
+    uint64_t *run;
     uint64_t aux_count;
-    uint64_t rec_aux_granules[VAL_MAX_REC_AUX_GRANULES * VAL_MAX_REC_COUNT];
+    uint64_t *rec_aux_granules;
     val_host_realm_state_te state;
 } val_host_realm_ts;
 
@@ -276,7 +296,22 @@ typedef struct val_host_granule_ts {
     uint64_t ipa;
     uint64_t level;
     uint8_t  is_granule_sliced;
+    /* Granule came from the delegated granule pool and returns to it on destroy */
+    uint8_t  is_granule_pooled;
+    /* Per-cpu NS list shard holding the node, valid only while on the NS list */
+    uint8_t  ns_shard;
+    /* RIPAS requested by the last RIPAS change exit of a REC */
+    uint8_t  ripas;
+    /* RTTE descriptor of an unprotected mapping */
+    uint64_t desc;
     struct val_host_granule_ts *next;
+    /* NS list back link and PA index chain, valid only while on NS mem_track[0] */
+    struct val_host_granule_ts *prev;
+    struct val_host_granule_ts *hash_next;
+    /* IPA ordered index links, valid only while on a realm data/RTT index */
+    struct val_host_granule_ts *left;
+    struct val_host_granule_ts *right;
+    int32_t height;
 } val_host_granule_ts;
 
 typedef struct {
@@ -287,6 +322,28 @@ typedef struct {
     uint64_t size;
 } val_data_create_ts;
 
+typedef enum {
+    VAL_HOST_MAP_DATA = 0,
+    VAL_HOST_MAP_DATA_UNKNOWN,
+    VAL_HOST_MAP_UNPROTECTED
+} val_host_map_kind_te;
+
+typedef struct {
+    val_host_map_kind_te kind;
+    /* IPA range [base, top) */
+    uint64_t base;
+    uint64_t top;
+    /* PA mapped at base */
+    uint64_t pa;
+    /* Source PA of base, VAL_HOST_MAP_DATA only */
+    uint64_t src_pa;
+    /* RMI data flags for VAL_HOST_MAP_DATA, descriptor attributes for VAL_HOST_MAP_UNPROTECTED */
+    uint64_t flags;
+    uint64_t rtt_alignment;
+    /* Fold full L3 tables of protected data into block entries */
+    bool fold;
+} val_host_map_range_ts;
+
 typedef val_host_granule_ts NS_LL;
 typedef val_host_granule_ts RD_LL;
 typedef val_host_granule_ts RTT_LL;
@@ -294,6 +351,10 @@ typedef val_host_granule_ts REC_LL;
 typedef val_host_granule_ts DATA_LL;
 typedef val_host_granule_ts VALID_NS_LL;
 
+/* rtt and data are roots of IPA ordered AVL trees, the others are linked lists.
+ * RTTs are ordered leaf level first, so an in-order walk is a valid teardown order.
+ * ns of mem_track[0] is the NS list shard of cpu 0, the shards of other cpus are
+ * merged into it by the postamble. */
 typedef struct {
     NS_LL *ns;
     RD_LL *rd;
@@ -303,13 +364,39 @@ typedef struct {
     VALID_NS_LL *valid_ns;
 } val_host_granule_type_ts;
 
+/* RIPAS given to an IPA range by an RMI command */
+typedef struct {
+    uint64_t base;
+    uint64_t top;
+    uint64_t ripas;
+} val_host_ripas_range_ts;
+
+/* Slot 0 tracks the NS granules, the other slots track one realm each */
 typedef struct mem_track {
     uint64_t rd;
     val_host_granule_type_ts gran_type;
+    /* Protects gran_type of the slot */
+    s_lock_t lock;
+    /* Next slot in the RD index chain, 0 ends the chain */
+    uint32_t rd_next;
+    /* Cpu that created the realm */
+    uint32_t owner;
+    /* RIPAS changes of the realm in the order they were made, protected by lock */
+    val_host_ripas_range_ts *ripas;
+    uint32_t ripas_count;
+    uint32_t ripas_capacity;
 } val_host_memory_track_ts;
 
+/* First chunk of mem_track slots, use val_host_mem_track() for the others */
 extern val_host_memory_track_ts mem_track[];
 
+val_host_memory_track_ts *val_host_mem_track(int realm_index);
+uint32_t val_host_realm_reserve_recs(val_host_realm_ts *realm, uint64_t count);
+uint16_t val_host_realm_vmid(uint16_t vmid);
+void val_host_realm_clear(val_host_realm_ts *realm);
+uint32_t val_host_realm_add_granules(val_host_realm_ts *realm, uint64_t ipa,
+                        uint64_t size, uint64_t level, uint64_t pa);
+
 uint32_t val_host_map_protected_data(val_host_realm_ts *realm,
                 uint64_t target_pa,
                 uint64_t ipa,
@@ -348,10 +435,16 @@ void val_host_update_granule_state(uint64_t rd,
                         uint64_t ipa,
                         uint64_t level);
 uint64_t val_host_postamble(void);
+uint64_t val_host_postamble_cpu(void);
 val_host_granule_ts *val_host_remove_granule(val_host_granule_ts **current, uint64_t PA);
 val_host_granule_ts *val_host_remove_data_granule(val_host_granule_ts **current, uint64_t ipa);
 val_host_granule_ts *val_host_remove_rtt_granule(val_host_granule_ts **gran_list_head,
                                                         uint64_t ipa, uint64_t level);
+val_host_granule_ts *val_host_find_rtt_granule(int realm_index, uint64_t ipa, uint64_t level);
+val_host_granule_ts *val_host_find_data_granule(int realm_index, uint64_t base, uint64_t top);
+val_host_granule_ts *val_host_find_unprotected_granule(int realm_index, uint64_t ipa,
+                                                                      uint64_t level);
+val_host_granule_ts *val_host_find_rec_granule(uint64_t rec);
 int val_host_get_curr_realm(uint64_t rd);
 void val_host_update_destroy_granule_state(uint64_t rd,
                         uint64_t PA,
@@ -371,6 +464,12 @@ uint32_t val_host_create_rtt_levels(val_host_realm_ts *realm,
 
 uint32_t val_host_map_protected_data_to_realm(val_host_realm_ts *realm,
                                             val_data_create_ts *data_create);
+uint32_t val_host_map_range(val_host_realm_ts *realm, val_host_map_range_ts *range);
+uint32_t val_host_unmap_range(val_host_realm_ts *realm, val_host_map_range_ts *range,
+                                                                   uint64_t top);
+uint32_t val_host_map_range_add_granules(val_host_realm_ts *realm,
+                                         val_host_map_range_ts *range);
+bool val_host_rtt_l1_block_supported(void);
 
 void val_host_realm_params(val_host_realm_ts *realm);
 void val_host_reset_mem_tack(void);
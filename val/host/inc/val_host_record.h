@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _VAL_HOST_RECORD_H_
+#define _VAL_HOST_RECORD_H_
+
+#include "val.h"
+
+/* Start of the result record lines, read by tools/scripts/test_records.py */
+#define VAL_HOST_RECORD_MARKER      "ACS_RECORD:"
+
+void val_host_record_start(bool all_pes);
+void val_host_record_print(uint32_t test_num);
+#endif /* _VAL_HOST_RECORD_H_ */
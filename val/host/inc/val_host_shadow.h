@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _VAL_HOST_SHADOW_H_
+#define _VAL_HOST_SHADOW_H_
+
+#include "val_host_rmi.h"
+
+uint32_t val_host_shadow_read_entry(val_host_realm_ts *realm, uint64_t ipa,
+                                    uint64_t level, val_host_rtt_entry_ts *rtte);
+uint32_t val_host_shadow_create_rtt_levels(val_host_realm_ts *realm, uint64_t base,
+                                    uint64_t top, uint64_t level, uint64_t rtt_alignment);
+uint32_t val_host_shadow_check_entry(val_host_realm_ts *realm, uint64_t ipa, uint64_t level);
+void val_host_shadow_set_ripas(uint64_t rd, uint64_t base, uint64_t top, uint64_t ripas);
+void val_host_shadow_data_destroy(uint64_t rd, uint64_t ipa);
+void val_host_shadow_request_ripas(uint64_t rec, uint64_t ripas);
+void val_host_shadow_complete_ripas(uint64_t rd, uint64_t rec, uint64_t base, uint64_t top);
+void val_host_shadow_map_unprotected(uint64_t rd, uint64_t ipa, uint64_t level, uint64_t desc);
+
+#endif /* _VAL_HOST_SHADOW_H_ */
@@ -7,23 +7,71 @@
 
 #include "val_host_alloc.h"
 #include "val_host_realm.h"
+#include "val_mp_supp.h"
 
-typedef struct {
-    uint64_t base;
-    uint64_t size;
-} val_host_alloc_region_ts;
+/* Number of granules in the heap region */
+#define VAL_HOST_HEAP_PAGES        (PLATFORM_HEAP_REGION_SIZE / PAGE_SIZE)
+
+/* page_info[] encoding, only the first page of a block carries information */
+#define PAGE_INFO_ORDER_MASK       0xFU
+#define PAGE_INFO_SLAB             (1U << 4)
+#define PAGE_INFO_FREE             (1U << 5)
+#define PAGE_INFO_USED             (1U << 6)
+#define PAGE_INFO_FREE_PENDING     (1U << 7)
+
+/* Single page blocks cached per cpu, moved from the heap in batches */
+#define VAL_HOST_ARENA_PAGES       32
+#define VAL_HOST_ARENA_BATCH       16
+
+/* Pattern of free heap memory in -DHEAP_DEBUG=ON builds */
+#define VAL_HOST_HEAP_POISON       0xA5A5A5A5A5A5A5A5ULL
 
-static int number_of_regions;
+/* Free blocks are linked through their own first bytes */
+typedef struct val_host_free_block_ts {
+    struct val_host_free_block_ts *next;
+    struct val_host_free_block_ts *prev;
+} val_host_free_block_ts;
+
+/* Free slab objects are linked through their own first bytes */
+typedef struct val_host_slab_obj_ts {
+    struct val_host_slab_obj_ts *next;
+} val_host_slab_obj_ts;
+
+/* Per cpu allocation arena. Single page blocks and granule tracking nodes are
+   served from the arena of the calling cpu without taking the heap lock. */
+typedef struct {
+    uint64_t page[VAL_HOST_ARENA_PAGES];
+    uint32_t count;
+    val_host_slab_obj_ts *node_free;
+} val_host_arena_ts;
 
 static uint64_t heap_base;
 static uint64_t heap_top;
 static uint16_t curr_vmid;
 
+static val_host_free_block_ts *free_list[VAL_HOST_BUDDY_MAX_ORDER + 1];
+static uint8_t page_info[VAL_HOST_HEAP_PAGES];
+/* Bit per block head, set when the next block belongs to the same allocation */
+static uint64_t page_run[(VAL_HOST_HEAP_PAGES + 63) / 64];
+/* Number of delegated granules per allocated block, indexed by block head */
+static uint16_t pin_count[VAL_HOST_HEAP_PAGES];
+static val_host_arena_ts arena[PLATFORM_CPU_COUNT];
+/* Protects free_list, page_info of free blocks and pin_count */
+static s_lock_t heap_lock;
+/* Bytes out of the free lists, arena caches included, and their maximum */
+static uint64_t heap_used;
+static uint64_t heap_peak;
+
 /* get vmid */
 uint16_t val_host_get_vmid(void)
 {
+    uint16_t vmid;
+
+    val_spin_lock(&heap_lock);
     curr_vmid = curr_vmid + 1;
-    return curr_vmid;
+    vmid = curr_vmid;
+    val_spin_unlock(&heap_lock);
+    return vmid;
 }
 
 static int val_is_power_of_2(uint32_t n)
@@ -31,8 +79,338 @@ static int val_is_power_of_2(uint32_t n)
     return n && !(n & (n - 1));
 }
 
+/**
+ * @brief  Fill free heap memory with the poison pattern, in -DHEAP_DEBUG=ON builds
+ * @param  addr - Start address, 8 bytes aligned
+ * @param  size - Size in bytes
+ * @return Void
+ **/
+static void val_host_heap_poison(uint64_t addr, uint64_t size)
+{
+#ifdef VAL_HEAP_DEBUG
+    uint64_t *word = (uint64_t *)addr, *end = (uint64_t *)(addr + size);
+
+    while (word < end)
+        *word++ = VAL_HOST_HEAP_POISON;
+#else
+    (void)addr;
+    (void)size;
+#endif
+}
+
+/**
+ * @brief  Check that a block leaving the free lists still holds the poison
+ *         pattern, which catches writes outside the block a test allocated,
+ *         in -DHEAP_DEBUG=ON builds
+ * @param  addr - Block head address
+ * @param  size - Block size in bytes
+ * @return Returns false if the block was written while free
+ **/
+static bool val_host_heap_check(uint64_t addr, uint64_t size)
+{
+#ifdef VAL_HEAP_DEBUG
+    uint64_t *word = (uint64_t *)addr, *end = (uint64_t *)(addr + size);
+
+    while (word < end && *word == VAL_HOST_HEAP_POISON)
+        word++;
+
+    if (word < end)
+    {
+        LOG(ERROR, "\tFree heap block 0x%x was written at 0x%x\n", addr, (uint64_t)word);
+        return false;
+    }
+#else
+    (void)addr;
+    (void)size;
+#endif
+    return true;
+}
+
+static uint64_t val_host_page_index(uint64_t addr)
+{
+    return (addr - heap_base) / PAGE_SIZE;
+}
+
+static uint64_t val_host_block_size(uint32_t order)
+{
+    return (uint64_t)PAGE_SIZE << order;
+}
+
+static bool val_host_run_test(uint64_t index)
+{
+    return (page_run[index / 64] >> (index % 64)) & 1;
+}
+
+static void val_host_run_set(uint64_t index, bool next)
+{
+    if (next)
+        page_run[index / 64] |= 1ULL << (index % 64);
+    else
+        page_run[index / 64] &= ~(1ULL << (index % 64));
+}
+
+static void val_host_heap_peak_update(void)
+{
+    if (heap_used > heap_peak)
+        heap_peak = heap_used;
+}
+
+/* Smallest order whose block holds the given number of bytes */
+static uint32_t val_host_size_to_order(uint64_t size)
+{
+    uint32_t order = 0;
+
+    while ((order <= VAL_HOST_BUDDY_MAX_ORDER) && (val_host_block_size(order) < size))
+        order++;
+
+    return order;
+}
+
+static void val_host_free_list_add(uint64_t addr, uint32_t order)
+{
+    val_host_free_block_ts *block = (val_host_free_block_ts *)addr;
+
+    block->prev = NULL;
+    block->next = free_list[order];
+    if (free_list[order] != NULL)
+        free_list[order]->prev = block;
+    free_list[order] = block;
+
+    page_info[val_host_page_index(addr)] = (uint8_t)(PAGE_INFO_FREE | order);
+}
+
+static void val_host_free_list_del(uint64_t addr, uint32_t order)
+{
+    val_host_free_block_ts *block = (val_host_free_block_ts *)addr;
+
+    if (block->prev != NULL)
+        block->prev->next = block->next;
+    else
+        free_list[order] = block->next;
+
+    if (block->next != NULL)
+        block->next->prev = block->prev;
+
+    val_host_heap_poison(addr, sizeof(*block));
+    page_info[val_host_page_index(addr)] = 0;
+}
+
+/**
+ * @brief  Return the head of the allocated block containing the given address
+ * @param  addr - Address within the heap region
+ * @return Returns the block head address, or 0 if addr is not in an allocated block
+ **/
+static uint64_t val_host_block_head(uint64_t addr)
+{
+    uint64_t head;
+    uint8_t info;
+    uint32_t order;
+
+    if (addr < heap_base || addr >= heap_top)
+        return 0;
+
+    /* Blocks are naturally aligned, so the head is addr aligned down to the block size */
+    for (order = 0; order <= VAL_HOST_BUDDY_MAX_ORDER; order++)
+    {
+        head = ADDR_ALIGN_DOWN(addr, val_host_block_size(order));
+        if (head < heap_base)
+            break;
+
+        info = page_info[val_host_page_index(head)];
+        if ((info & PAGE_INFO_USED) && ((info & PAGE_INFO_ORDER_MASK) >= order))
+            return head;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief  Return a block to the buddy free lists, merging with free buddies.
+ *         Caller holds heap_lock.
+ * @param  addr  - Block head address
+ * @param  order - Block order
+ * @return Void
+ **/
+static void val_host_buddy_free(uint64_t addr, uint32_t order)
+{
+    uint64_t buddy;
+    uint8_t info;
+
+    heap_used -= val_host_block_size(order);
+    val_host_heap_poison(addr, val_host_block_size(order));
+    val_host_run_set(val_host_page_index(addr), false);
+
+    while (order < VAL_HOST_BUDDY_MAX_ORDER)
+    {
+        buddy = addr ^ val_host_block_size(order);
+        if (buddy < heap_base || (buddy + val_host_block_size(order)) > heap_top)
+            break;
+
+        info = page_info[val_host_page_index(buddy)];
+        if (!(info & PAGE_INFO_FREE) || ((info & PAGE_INFO_ORDER_MASK) != order))
+            break;
+
+        val_host_free_list_del(buddy, order);
+        page_info[val_host_page_index(addr)] = 0;
+        addr = (addr < buddy) ? addr : buddy;
+        order++;
+    }
+
+    val_host_free_list_add(addr, order);
+}
+
+/**
+ * @brief  Allocate a naturally aligned block of the given order. Caller holds heap_lock.
+ *         A block written while free is left allocated, whoever wrote it may still use it.
+ * @param  order - Block order
+ * @return Returns block head address, or 0 if no block is available
+ **/
+static uint64_t val_host_buddy_alloc(uint32_t order)
+{
+    uint32_t curr;
+    uint64_t addr;
+    bool clean;
+
+    do {
+        curr = order;
+        while (curr <= VAL_HOST_BUDDY_MAX_ORDER && free_list[curr] == NULL)
+            curr++;
+
+        if (curr > VAL_HOST_BUDDY_MAX_ORDER)
+            return 0;
+
+        addr = (uint64_t)free_list[curr];
+        val_host_free_list_del(addr, curr);
+
+        /* Split down, returning the upper halves to the free lists */
+        while (curr > order)
+        {
+            curr--;
+            val_host_free_list_add(addr + val_host_block_size(curr), curr);
+        }
+
+        clean = val_host_heap_check(addr, val_host_block_size(order));
+        page_info[val_host_page_index(addr)] = (uint8_t)(PAGE_INFO_USED | order);
+        pin_count[val_host_page_index(addr)] = 0;
+
+        heap_used += val_host_block_size(order);
+    } while (!clean);
+
+    return addr;
+}
+
+/**
+ * @brief  Return the pages of an allocated block beyond the requested size to
+ *         the free lists. The block becomes a run of smaller blocks, each but
+ *         the last one marked in page_run. Caller holds heap_lock.
+ * @param  addr  - Block head address
+ * @param  order - Block order
+ * @param  size  - Requested size in bytes
+ * @return Void
+ **/
+static void val_host_buddy_trim(uint64_t addr, uint32_t order, uint64_t size)
+{
+    uint64_t end = addr + ADDR_ALIGN(size, PAGE_SIZE), half;
+
+    while ((order > 0) && (end < addr + val_host_block_size(order)))
+    {
+        order--;
+        half = val_host_block_size(order);
+        page_info[val_host_page_index(addr)] = (uint8_t)(PAGE_INFO_USED | order);
+
+        if (end <= addr + half)
+        {
+            val_host_buddy_free(addr + half, order);
+        } else
+        {
+            /* The lower half is used up, the run goes on in the upper half */
+            val_host_run_set(val_host_page_index(addr), true);
+            addr += half;
+            page_info[val_host_page_index(addr)] = (uint8_t)(PAGE_INFO_USED | order);
+            pin_count[val_host_page_index(addr)] = 0;
+        }
+    }
+}
+
+/**
+ * @brief  Return the arena index of the calling cpu
+ * @param  void
+ * @return Returns logical cpu index, 0 if the cpu is unknown
+ **/
+uint32_t val_host_get_arena_index(void)
+{
+    uint32_t cpuid = val_get_cpuid(val_read_mpidr());
+
+    return (cpuid < PLATFORM_CPU_COUNT) ? cpuid : 0;
+}
+
+/**
+ * @brief  Return the cached pages of an arena to the heap. Caller holds heap_lock.
+ * @param  curr - Arena of the calling cpu
+ * @return Void
+ **/
+static void val_host_arena_flush(val_host_arena_ts *curr)
+{
+    while (curr->count > 0)
+        val_host_buddy_free(curr->page[--curr->count], 0);
+}
+
+/**
+ * @brief  Allocate a single page block from the arena of the calling cpu.
+ *         Cached pages stay marked used and free pending in page_info, so they
+ *         are never merged by the buddy allocator and a double free is ignored.
+ * @param  void
+ * @return Returns page address, or 0 if the heap is exhausted
+ **/
+static uint64_t val_host_arena_get(void)
+{
+    val_host_arena_ts *curr = &arena[val_host_get_arena_index()];
+    uint64_t addr;
+
+    if (curr->count == 0)
+    {
+        val_spin_lock(&heap_lock);
+        while (curr->count < VAL_HOST_ARENA_BATCH)
+        {
+            addr = val_host_buddy_alloc(0);
+            if (!addr)
+                break;
+            page_info[val_host_page_index(addr)] |= PAGE_INFO_FREE_PENDING;
+            curr->page[curr->count++] = addr;
+        }
+        val_host_heap_peak_update();
+        val_spin_unlock(&heap_lock);
+
+        if (curr->count == 0)
+            return 0;
+    }
+
+    addr = curr->page[--curr->count];
+    page_info[val_host_page_index(addr)] = (uint8_t)PAGE_INFO_USED;
+
+    /* A page written while cached is left allocated, like in val_host_buddy_alloc */
+    if (!val_host_heap_check(addr, PAGE_SIZE))
+        return val_host_arena_get();
+
+    return addr;
+}
+
+/**
+ * @brief  Cache a freed single page block in the arena of the calling cpu
+ * @param  curr - Arena of the calling cpu, with room for one more page
+ * @param  addr - Page address, already marked free pending
+ * @return Void
+ **/
+static void val_host_arena_put(val_host_arena_ts *curr, uint64_t addr)
+{
+    val_host_heap_poison(addr, PAGE_SIZE);
+    curr->page[curr->count++] = addr;
+}
+
 /**
  * @brief Allocates contiguous memory of requested size(no_of_bytes) and alignment.
+ *        The memory is not tracked in mem_track. Sizes that are not a power of
+ *        two get a run of blocks, not the next larger block.
  * @param alignment - alignment for the address. It must be in power of 2.
  * @param Size - Size of the region. It must not be zero.
  * @return - Returns allocated memory base address if allocation is successful.
@@ -40,22 +418,179 @@ static int val_is_power_of_2(uint32_t n)
  **/
 void *mem_alloc(size_t alignment, size_t size)
 {
+    uint32_t order, align_order;
     uint64_t addr;
 
-    addr = ADDR_ALIGN(heap_base, alignment);
-    size += addr - heap_base;
+    /* Buddy blocks are naturally aligned to their size */
+    order = val_host_size_to_order(size);
+    align_order = val_host_size_to_order(alignment);
+    if (align_order > order)
+        order = align_order;
 
-    if ((heap_top - heap_base) < size)
+    if (order > VAL_HOST_BUDDY_MAX_ORDER)
     {
-       LOG(ERROR, "Not enough space available\n", 0, 0);
+       LOG(ERROR, "Allocation too large, size=0x%x, alignment=0x%x\n", size, alignment);
        return NULL;
     }
 
-    heap_base += size;
+    if (order == 0)
+        return (void *)val_host_arena_get();
+
+    val_spin_lock(&heap_lock);
+    addr = val_host_buddy_alloc(order);
+    if (!addr)
+    {
+        /* Pages cached by this cpu may be all that keeps the block from merging */
+        val_host_arena_flush(&arena[val_host_get_arena_index()]);
+        addr = val_host_buddy_alloc(order);
+    }
+    if (addr)
+    {
+        val_host_buddy_trim(addr, order, size);
+        val_host_heap_peak_update();
+    }
+    val_spin_unlock(&heap_lock);
+
+    if (!addr)
+    {
+       LOG(ERROR, "Not enough space available\n", 0, 0);
+       return NULL;
+    }
 
     return (void *)addr;
 }
 
+/**
+ * @brief  Allocate a granule tracking node from the node slab of the calling cpu
+ * @param  void
+ * @return Returns zeroed node, or NULL if heap is exhausted
+ **/
+val_host_granule_ts *val_host_granule_node_alloc(void)
+{
+    val_host_arena_ts *curr = &arena[val_host_get_arena_index()];
+    val_host_slab_obj_ts *obj;
+    uint64_t page, offset;
+
+    if (curr->node_free == NULL)
+    {
+        page = val_host_arena_get();
+        if (!page)
+        {
+            LOG(ERROR, "Not enough space available for granule node\n", 0, 0);
+            return NULL;
+        }
+
+        page_info[val_host_page_index(page)] |= PAGE_INFO_SLAB;
+        for (offset = 0; (offset + sizeof(val_host_granule_ts)) <= PAGE_SIZE;
+                                         offset += sizeof(val_host_granule_ts))
+        {
+            obj = (val_host_slab_obj_ts *)(page + offset);
+            obj->next = curr->node_free;
+            curr->node_free = obj;
+        }
+    }
+
+    obj = curr->node_free;
+    curr->node_free = obj->next;
+    val_memset(obj, 0, sizeof(val_host_granule_ts));
+
+    return (val_host_granule_ts *)obj;
+}
+
+/**
+ * @brief  Return a granule tracking node to the node slab of the calling cpu
+ * @param  node - node pointer
+ * @return Void
+ **/
+void val_host_granule_node_free(val_host_granule_ts *node)
+{
+    val_host_arena_ts *curr = &arena[val_host_get_arena_index()];
+    val_host_slab_obj_ts *obj = (val_host_slab_obj_ts *)node;
+
+    if (!node)
+        return;
+
+    obj->next = curr->node_free;
+    curr->node_free = obj;
+}
+
+/**
+ * @brief  Record that a granule within an allocated block has been delegated.
+ *         A block is not returned to the heap while any of its granules is delegated.
+ *         A heap granule outside any allocated block is reported, the buddy
+ *         allocator would hand it out again to the next caller.
+ * @param  addr - Granule address
+ * @return Void
+ **/
+void val_host_mem_pin(uint64_t addr)
+{
+    uint64_t head;
+
+    val_spin_lock(&heap_lock);
+    head = val_host_block_head(addr);
+    if (head)
+        pin_count[val_host_page_index(head)]++;
+    val_spin_unlock(&heap_lock);
+
+    if (!head && addr >= heap_base && addr < heap_top)
+        LOG(ERROR, "\tDelegated granule 0x%x is not in an allocated heap block\n", addr, 0);
+}
+
+/**
+ * @brief  Record that a granule within an allocated block has been undelegated,
+ *         completing a deferred free of the block if this was the last one.
+ * @param  addr - Granule address
+ * @return Void
+ **/
+void val_host_mem_unpin(uint64_t addr)
+{
+    uint64_t head, index;
+
+    val_spin_lock(&heap_lock);
+    head = val_host_block_head(addr);
+    if (head)
+    {
+        index = val_host_page_index(head);
+        if (pin_count[index] != 0)
+        {
+            pin_count[index]--;
+            if ((pin_count[index] == 0) && (page_info[index] & PAGE_INFO_FREE_PENDING))
+                val_host_buddy_free(head, page_info[index] & PAGE_INFO_ORDER_MASK);
+        }
+    }
+    val_spin_unlock(&heap_lock);
+}
+
+/**
+ * @brief  Free the blocks that follow the head block of a run, the blocks with
+ *         delegated granules are freed when their last granule is undelegated.
+ *         Caller holds heap_lock.
+ * @param  addr - Head address of the allocation
+ * @return Void
+ **/
+static void val_host_run_free(uint64_t addr)
+{
+    uint64_t block = addr, index;
+    uint32_t order;
+    bool next;
+
+    do {
+        index = val_host_page_index(block);
+        order = page_info[index] & PAGE_INFO_ORDER_MASK;
+        next = val_host_run_test(index);
+        val_host_run_set(index, false);
+
+        /* The next block is in use, freeing this one cannot merge with it */
+        if (block != addr)
+        {
+            page_info[index] |= PAGE_INFO_FREE_PENDING;
+            if (pin_count[index] == 0)
+                val_host_buddy_free(block, order);
+        }
+        block += val_host_block_size(order);
+    } while (next);
+}
+
 /**
  * @brief  Initialisation of allocation data structure
  * @param  void
@@ -63,10 +598,50 @@ void *mem_alloc(size_t alignment, size_t size)
  **/
 void val_host_mem_alloc_init(void)
 {
+    uint64_t addr;
+    uint32_t order;
+
     heap_base = PLATFORM_HEAP_REGION_BASE;
     heap_top = PLATFORM_HEAP_REGION_BASE + PLATFORM_HEAP_REGION_SIZE;
-    number_of_regions = 0;
     curr_vmid = 0;
+    heap_used = 0;
+    heap_peak = 0;
+
+    val_init_spinlock(&heap_lock);
+    val_memset(arena, 0, sizeof(arena));
+    val_memset(free_list, 0, sizeof(free_list));
+    val_memset(page_info, 0, sizeof(page_info));
+    val_memset(page_run, 0, sizeof(page_run));
+    val_memset(pin_count, 0, sizeof(pin_count));
+    val_host_heap_poison(heap_base, heap_top - heap_base);
+
+    /* Carve the heap into the largest naturally aligned blocks */
+    addr = heap_base;
+    while (addr + PAGE_SIZE <= heap_top)
+    {
+        order = VAL_HOST_BUDDY_MAX_ORDER;
+        while ((order > 0) && (!ADDR_IS_ALIGNED(addr, val_host_block_size(order)) ||
+                          ((addr + val_host_block_size(order)) > heap_top)))
+            order--;
+
+        val_host_free_list_add(addr, order);
+        addr += val_host_block_size(order);
+    }
+}
+
+/**
+ * @brief  Return the most heap in use since val_host_mem_alloc_init
+ * @param  void
+ * @return Returns bytes, pages cached in the arenas are counted as in use
+ **/
+uint64_t val_host_mem_peak(void)
+{
+    uint64_t peak;
+
+    val_spin_lock(&heap_lock);
+    peak = heap_peak;
+    val_spin_unlock(&heap_lock);
+    return peak;
 }
 
 /**
@@ -92,23 +667,76 @@ void *val_host_mem_alloc(size_t alignment, size_t size)
     return NULL;
   }
 
-  size += alignment - 1;
   addr = mem_alloc(alignment, size);
-  val_host_add_granule(GRANULE_UNDELEGATED, (uint64_t)addr, NULL);
+  if (addr != NULL)
+    val_host_add_granule(GRANULE_UNDELEGATED, (uint64_t)addr, NULL);
 
   return addr;
 }
 
 /**
- * Free the memory for given memory address
- * Currently acs code is initialisazing from base for every test,
- * the regions data structure is internal and below code only setting to zero
- * not actually freeing memory.
+ * Free the memory for given memory address.
+ * Granule tracking nodes go back to the node slab. Heap blocks go back to the
+ * buddy allocator, deferred until none of their granules is delegated. Single
+ * page blocks are cached in the arena of the calling cpu while it has room.
+ * Addresses that are not the start of an allocated block are ignored, which
+ * makes double free and free of a granule sliced out of a block harmless.
  **/
 void val_host_mem_free(void *ptr)
 {
-  if (!ptr)
+  uint64_t addr = (uint64_t)ptr, index;
+  uint32_t order;
+  val_host_granule_ts *node;
+  val_host_arena_ts *curr = &arena[val_host_get_arena_index()];
+
+  if (!ptr || addr < heap_base || addr >= heap_top)
+    return;
+
+  index = val_host_page_index(ADDR_ALIGN_DOWN(addr, PAGE_SIZE));
+  if ((page_info[index] & (PAGE_INFO_USED | PAGE_INFO_SLAB)) == (PAGE_INFO_USED | PAGE_INFO_SLAB))
+  {
+    val_host_granule_node_free(ptr);
+    return;
+  }
+
+  index = val_host_page_index(addr);
+  if (!ADDR_IS_ALIGNED(addr, PAGE_SIZE) || !(page_info[index] & PAGE_INFO_USED) ||
+       (page_info[index] & PAGE_INFO_FREE_PENDING))
+    return;
+
+  /* Drop the tracking node added by val_host_mem_alloc */
+  node = val_host_find_granule(addr);
+  if ((node != NULL) && (node->state == GRANULE_UNDELEGATED) && !node->is_granule_sliced)
+  {
+    val_host_remove_granule(&mem_track[0].gran_type.ns, addr);
+    val_host_granule_node_free(node);
+  }
+
+  val_spin_lock(&heap_lock);
+  /* Recheck under the lock, another cpu may have freed the block meanwhile */
+  if (page_info[index] & PAGE_INFO_FREE_PENDING)
+  {
+    val_spin_unlock(&heap_lock);
+    return;
+  }
+
+  val_host_run_free(addr);
+
+  page_info[index] |= PAGE_INFO_FREE_PENDING;
+  order = page_info[index] & PAGE_INFO_ORDER_MASK;
+  if (pin_count[index] != 0)
+  {
+    val_spin_unlock(&heap_lock);
     return;
+  }
+
+  if ((order == 0) && (curr->count < VAL_HOST_ARENA_PAGES))
+  {
+    val_spin_unlock(&heap_lock);
+    val_host_arena_put(curr, addr);
+    return;
+  }
 
-  return;
+  val_host_buddy_free(addr, order);
+  val_spin_unlock(&heap_lock);
 }
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* C replacement of val_host_boot_entry.S for native builds */
+#ifdef LINUX_NATIVE_BUILD
+
+#include "val_host_framework.h"
+#include "val_mp_supp.h"
+
+extern uint64_t val_primary_mpidr;
+
+/**
+ *   @brief    Host entry point for every cpu. Each cpu is a thread running on
+ *             its own stack, so only the primary cpu detection is left.
+ *   @param    void
+ *   @return   void
+**/
+void acs_host_entry(void)
+{
+    uint64_t mpidr = val_read_mpidr();
+    bool primary_cpu_boot = false;
+
+    write_sctlr_el2(read_sctlr_el2() | SCTLR_I_BIT);
+
+    if (val_primary_mpidr == INVALID_MPIDR || val_primary_mpidr == mpidr)
+    {
+        val_primary_mpidr = mpidr;
+        primary_cpu_boot = true;
+    }
+
+    val_host_main(primary_cpu_boot);
+}
+
+#endif /* LINUX_NATIVE_BUILD */
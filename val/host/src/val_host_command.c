@@ -8,6 +8,7 @@
 #include "val_host_rmi.h"
 #include "val_host_realm.h"
 #include "val_host_command.h"
+#include "val_host_granule_pool.h"
 
 #define L3_SIZE PAGE_SIZE
 #define L2_SIZE (512 * L3_SIZE)
@@ -91,23 +92,17 @@ uint64_t create_mapping(uint64_t ipa, bool ripas_init, uint64_t rd1)
 
 uint64_t val_host_delegate_granule(void)
 {
-    /* Allocate a src granule*/
-    uint64_t *gran = val_host_mem_alloc(PAGE_SIZE, PAGE_SIZE);
+    /* Get a delegated granule from the pool */
+    uint64_t gran = val_host_granule_pool_get();
 
-    if (gran != NULL) {
-        if (val_host_rmi_granule_delegate((uint64_t)gran)) {
-            LOG(ERROR, "\tError! granule couldn't be delegated!\n", 0, 0);
-            return VAL_ERROR;
-        } else {
-            LOG(DBG, "\tallocation: granule @ address: %x\n",
-                (uint64_t)gran, 0);
-        }
-    } else {
-        LOG(ERROR, "\tError! granule couldn't be allocated!\n", 0, 0);
+    if (!gran) {
+        LOG(ERROR, "\tError! granule couldn't be delegated!\n", 0, 0);
         return VAL_ERROR;
     }
 
-    return (uint64_t)gran;
+    LOG(DBG, "\tallocation: granule @ address: %x\n", gran, 0);
+
+    return gran;
 }
 
 uint64_t val_host_undelegate_granule(void)
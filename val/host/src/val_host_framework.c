@@ -12,21 +12,46 @@
 #include "pal_interfaces.h"
 #include "val.h"
 #include "val_host_memory.h"
+#include "val_host_granule_pool.h"
+#include "val_smc_trace.h"
+#include "val_smc_stats.h"
+#include "val_host_profile.h"
+#include "val_host_record.h"
+#include "val_realm_log.h"
+#include "val_log_capture.h"
 
 extern const uint32_t  total_tests;
 extern const test_db_t test_list[];
 extern uint64_t skip_for_val_logs;
+
+/* Regression state of the primary PE, the NVM copy is written once per test */
+static val_regression_state_ts regression_state;
+
+/* Tests run by this instance, all tests unless preloaded */
+static val_run_config_ts run_config = {.magic = VAL_RUN_CONFIG_MAGIC, .shard_count = 1};
+
+/* Registry IDs of the tests named in the run configuration */
+static bool test_named[TEST_ID_END];
+
 /**
- *   @brief    Read realm message from shared printf location and print them using uart
+ *   @brief    Write the regression state to NVM
+ *   @param    size    -   Bytes written, the test info is at the start of the record
+ *   @return   SUCCESS/FAILURE
+**/
+static uint32_t val_host_regression_state_save(size_t size)
+{
+    return val_nvm_write(VAL_NVM_OFFSET(NVM_REGRESSION_STATE_INDEX), &regression_state, size);
+}
+
+/**
+ *   @brief    Print the messages the realm queued in the shared region
  *   @param    void
  *   @return   SUCCESS(0)/FAILURE
 **/
 uint32_t val_host_realm_printf_msg_service(void)
 {
-    /* Read realm message from shared printf location and print them using uart */
-    return val_printf((char *)(val_get_shared_region_base() + REALM_PRINTF_MSG_OFFSET),
-                *(uint64_t *)(val_get_shared_region_base() + REALM_PRINTF_DATA1_OFFSET),
-                *(uint64_t *)(val_get_shared_region_base() + REALM_PRINTF_DATA2_OFFSET));
+    val_realm_log_drain();
+    return VAL_SUCCESS;
 }
 
 /**
@@ -58,7 +83,7 @@ uint64_t val_host_get_secondary_cpu_entry(void)
 static uint32_t val_host_report_status(uint32_t test_num)
 {
     uint32_t status, status_code, state;
-    char      test_result_print[PRINT_LIMIT] = "Result";
+    const char *test_result_print;
 
     (void)test_num;
     status = val_get_status();
@@ -69,25 +94,21 @@ static uint32_t val_host_report_status(uint32_t test_num)
     {
         case TEST_PASS:
             state = TEST_PASS;
-            val_strcat(test_result_print, " => Passed\n",
-                sizeof(test_result_print));
+            test_result_print = "Result => Passed\n";
             break;
 
         case TEST_SKIP:
             state = TEST_SKIP;
-            val_strcat(test_result_print, " => Skipped (Skip code=%d)\n",
-                sizeof(test_result_print));
+            test_result_print = "Result => Skipped (Skip code=%d)\n";
             break;
 
         case TEST_ERROR:
             state = TEST_ERROR;
-            val_strcat(test_result_print, " => Error (Error code=%d)\n",
-                sizeof(test_result_print));
+            test_result_print = "Result => Error (Error code=%d)\n";
             break;
         default:
             state = TEST_FAIL;
-            val_strcat(test_result_print, " => Failed (Error Code=%d)\n",
-                sizeof(test_result_print));
+            test_result_print = "Result => Failed (Error Code=%d)\n";
             break;
     }
 
@@ -97,6 +118,32 @@ static uint32_t val_host_report_status(uint32_t test_num)
     return state;
 }
 
+/**
+ *   @brief    Add a test result to the regression report
+ *   @param    test_result  -  Test state
+ *   @return   void
+**/
+static void val_host_count_result(uint32_t test_result)
+{
+    val_regre_report_ts *regre_report = &regression_state.regre_report;
+
+    switch (test_result)
+    {
+        case TEST_PASS:
+            regre_report->total_pass++;
+            break;
+        case TEST_FAIL:
+            regre_report->total_fail++;
+            break;
+        case TEST_SKIP:
+            regre_report->total_skip++;
+            break;
+        case TEST_ERROR:
+            regre_report->total_error++;
+            break;
+    }
+}
+
 /**
  *   @brief    This function notifies the framework about test
  *             intension of rebooting the platform. Test returns
@@ -106,11 +153,9 @@ static uint32_t val_host_report_status(uint32_t test_num)
 **/
 void val_host_set_reboot_flag(void)
 {
-   uint32_t test_progress  = TEST_REBOOTING;
-
    LOG(INFO, "\tSetting reboot flag\n", 0, 0);
-   if (val_nvm_write(VAL_NVM_OFFSET(NVM_TEST_PROGRESS_INDEX),
-                 &test_progress, sizeof(uint32_t)))
+   regression_state.test_info.test_progress = TEST_REBOOTING;
+   if (val_host_regression_state_save(sizeof(regression_state.test_info)))
    {
       VAL_PANIC("\tnvm write failed\n");
    }
@@ -125,19 +170,13 @@ uint32_t val_host_get_last_run_test_info(val_test_info_ts *test_info)
 {
     uint32_t        reboot_run = 0, i = 0;
     uint8_t         test_progress_pattern[] = {TEST_START, TEST_END, TEST_FAIL, TEST_REBOOTING};
-    val_regre_report_ts  regre_report = {0};
+    val_regre_report_ts  *regre_report = &regression_state.regre_report;
 
-    if (val_nvm_read(VAL_NVM_OFFSET(NVM_CUR_TEST_NUM_INDEX),
-            &test_info->test_num, sizeof(uint32_t)))
+    if (val_nvm_read(VAL_NVM_OFFSET(NVM_REGRESSION_STATE_INDEX),
+            &regression_state, sizeof(regression_state)))
         return VAL_ERROR;
 
-    if (val_nvm_read(VAL_NVM_OFFSET(NVM_END_TEST_NUM_INDEX),
-            &test_info->end_test_num, sizeof(uint32_t)))
-        return VAL_ERROR;
-
-    if (val_nvm_read(VAL_NVM_OFFSET(NVM_TEST_PROGRESS_INDEX),
-            &test_info->test_progress, sizeof(uint32_t)))
-        return VAL_ERROR;
+    val_memcpy(test_info, &regression_state.test_info, sizeof(*test_info));
 
     LOG(INFO, "\tIn val_host_get_last_run_test_info, test_num=%x\n", test_info->test_num, 0);
     LOG(INFO, "\ttest_progress=%x\n", test_info->test_progress, 0);
@@ -158,41 +197,152 @@ uint32_t val_host_get_last_run_test_info(val_test_info_ts *test_info)
      * */
     if (!reboot_run)
     {
-         test_info->test_num         = VAL_INVALID_TEST_NUM;
-         test_info->end_test_num     = total_tests;
-         test_info->test_progress     = 0;
+         val_memset(&regression_state, 0, sizeof(regression_state));
+         regression_state.test_info.test_num     = VAL_INVALID_TEST_NUM;
+         regression_state.test_info.end_test_num = total_tests;
 
-         if (val_nvm_write(VAL_NVM_OFFSET(NVM_CUR_TEST_NUM_INDEX),
-                 &test_info->test_num, sizeof(uint32_t)))
-             return VAL_ERROR;
-         if (val_nvm_write(VAL_NVM_OFFSET(NVM_END_TEST_NUM_INDEX),
-                 &test_info->end_test_num, sizeof(uint32_t)))
-             return VAL_ERROR;
-         if (val_nvm_write(VAL_NVM_OFFSET(NVM_TEST_PROGRESS_INDEX),
-                 &test_info->test_progress, sizeof(uint32_t)))
-             return VAL_ERROR;
-         if (val_nvm_write(VAL_NVM_OFFSET(NVM_TOTAL_PASS_INDEX),
-                 &regre_report.total_pass, sizeof(uint32_t)))
-             return VAL_ERROR;
-         if (val_nvm_write(VAL_NVM_OFFSET(NVM_TOTAL_FAIL_INDEX),
-                 &regre_report.total_fail, sizeof(uint32_t)))
-             return VAL_ERROR;
-         if (val_nvm_write(VAL_NVM_OFFSET(NVM_TOTAL_SKIP_INDEX),
-                 &regre_report.total_skip, sizeof(uint32_t)))
-             return VAL_ERROR;
-         if (val_nvm_write(VAL_NVM_OFFSET(NVM_TOTAL_ERROR_INDEX),
-                 &regre_report.total_error, sizeof(uint32_t)))
+         if (val_host_regression_state_save(sizeof(regression_state)))
              return VAL_ERROR;
+
+         val_memcpy(test_info, &regression_state.test_info, sizeof(*test_info));
     }
 
     LOG(INFO, "\tIn val_host_get_last_run_test_num, test_num=%x\n", test_info->test_num, 0);
-    LOG(INFO, "\tregre_report.total_pass=%x\n", regre_report.total_pass, 0);
-    LOG(INFO, "\tregre_report.total_fail=%x\n", regre_report.total_fail, 0);
-    LOG(INFO, "\tregre_report.total_skip=%x\n", regre_report.total_skip, 0);
-    LOG(INFO, "\tregre_report.total_error=%x\n", regre_report.total_error, 0);
+    LOG(INFO, "\tregre_report.total_pass=%x\n", regre_report->total_pass, 0);
+    LOG(INFO, "\tregre_report.total_fail=%x\n", regre_report->total_fail, 0);
+    LOG(INFO, "\tregre_report.total_skip=%x\n", regre_report->total_skip, 0);
+    LOG(INFO, "\tregre_report.total_error=%x\n", regre_report->total_error, 0);
     return VAL_SUCCESS;
 }
 
+/**
+ *   @brief    Read the run configuration the launcher preloaded into NVM. A
+ *             missing or invalid configuration runs every test.
+ *   @param    void
+ *   @return   void
+**/
+static void val_host_run_config_init(void)
+{
+    val_run_config_ts config;
+    char msg[PRINT_LIMIT];
+    uint32_t i, index;
+
+    if (val_nvm_read(VAL_NVM_OFFSET(NVM_RUN_CONFIG_INDEX), &config, sizeof(config)) ||
+        config.magic != VAL_RUN_CONFIG_MAGIC || config.shard_count == 0 ||
+        config.shard_index >= config.shard_count ||
+        config.name_count > VAL_RUN_CONFIG_NAMES)
+        return;
+
+    for (i = 0; i < config.name_count; i++)
+    {
+        config.names[i][VAL_RUN_CONFIG_NAME_LEN - 1] = '\0';
+        index = val_test_index_by_name(config.names[i]);
+        if (index)
+        {
+            test_named[test_list[index].id] = true;
+            continue;
+        }
+
+        msg[0] = '\0';
+        val_strcat(msg, "\tUnknown test in run configuration: ", sizeof(msg));
+        val_strcat(msg, config.names[i], sizeof(msg));
+        val_strcat(msg, "\n", sizeof(msg));
+        LOG(WARN, msg, 0, 0);
+    }
+
+    run_config = config;
+}
+
+/**
+ *   @brief    Check whether a test is selected by the run configuration
+ *   @param    test_num     -  Test number
+ *   @return   true if the test is run
+**/
+static bool val_host_test_selected(uint32_t test_num)
+{
+    const test_db_t *test = &test_list[test_num];
+
+    if (((test_num - 1) % run_config.shard_count) != run_config.shard_index)
+        return false;
+
+    if (test_num < run_config.test_first ||
+        (run_config.test_last && test_num > run_config.test_last))
+        return false;
+
+    if ((run_config.tags_any && !(test->tags & run_config.tags_any)) ||
+        (test->tags & run_config.tags_none))
+        return false;
+
+    return !run_config.name_count || test_named[test->id];
+}
+
+/**
+ *   @brief    Print the time a test took and its number, which orders the
+ *             merged shard reports of run.sh
+ *   @param    test_num     -  Test number
+ *   @param    start        -  Counter value when the test started
+ *   @return   void
+**/
+static void val_host_print_duration(uint32_t test_num, uint64_t start)
+{
+    uint64_t freq = read_cntfrq_el0();
+
+    if (freq)
+        LOG(ALWAYS, "Duration => %d us (test %d)\n",
+            ((syscounter_read() - start) * 1000000) / freq, test_num);
+}
+
+/**
+ * @brief  Print the suite and test name
+ * @param  test_num     -   Test number
+ * @return void
+**/
+static void val_host_print_test_name(uint32_t test_num)
+{
+   /* The names are printed as they are so -DLOG_TOKENS=ON builds send them as tokens */
+   LOG(ALWAYS, "\n", 0, 0);
+   LOG(ALWAYS, test_list[test_num].suite_name, 0, 0);
+   LOG(ALWAYS, test_list[test_num].test_name, 0, 0);
+   LOG(ALWAYS, "\n", 0, 0);
+}
+
+/**
+ * @brief  Check that the platform can run the realm part of a test, and
+ *         report the test as skipped if it cannot
+ * @param  test_num     -   Test number
+ * @return true if the test can run
+**/
+static bool val_host_test_supported(uint32_t test_num)
+{
+#if (PLATFORM_REALM_EXECUTION == 0)
+   if (test_list[test_num].tags & TEST_NEEDS_REALM)
+   {
+      LOG(TEST, "\tRealm code does not run on this platform\n", 0, 0);
+      val_set_status(RESULT_SKIP(VAL_SKIP_CHECK));
+      return false;
+   }
+#elif defined(PLATFORM_REALM_TESTS)
+   static const char *realm_tests[] = {PLATFORM_REALM_TESTS};
+   uint32_t i;
+
+   if (!(test_list[test_num].tags & TEST_NEEDS_REALM))
+      return true;
+
+   for (i = 0; i < sizeof(realm_tests) / sizeof(realm_tests[0]); i++)
+   {
+      if (!val_strcmp((char *)test_list[test_num].test_name, (char *)realm_tests[i]))
+         return true;
+   }
+
+   LOG(TEST, "\tThe realm part of the test does not run on this platform\n", 0, 0);
+   val_set_status(RESULT_SKIP(VAL_SKIP_CHECK));
+   return false;
+#else
+   (void)test_num;
+#endif
+   return true;
+}
+
 /**
  * @brief  This API prints the testname and sets the test
  *           state to invalid.
@@ -202,30 +352,21 @@ uint32_t val_host_get_last_run_test_info(val_test_info_ts *test_info)
 
 static void val_host_test_init(uint32_t test_num)
 {
-   char testname[PRINT_LIMIT] = "";
-   uint32_t test_progress = TEST_START;
+   uint32_t refill_cpuid;
 
    /* Clear test status */
    val_set_status(RESULT_START(VAL_STATUS_INVALID));
 
    /* Save current test num and testname */
    val_set_curr_test_num(test_num);
-   val_set_curr_test_name((char *)test_list[test_num].test_name);
+   val_set_curr_test_id(test_list[test_num].id);
    LOG(DBG, "test_num=%d\n", val_get_curr_test_num(), 0);
 
-   val_strcat(testname,
-                (char *)test_list[test_num].suite_name,
-                sizeof(testname));
-   val_strcat(testname,
-                (char *)test_list[test_num].test_name,
-                sizeof(testname));
-   val_strcat(testname, "\n", sizeof(testname));
+   val_host_print_test_name(test_num);
 
-   LOG(ALWAYS, "\n", 0, 0);
-   LOG(ALWAYS, testname, 0, 0);
-
-   if (val_nvm_write(VAL_NVM_OFFSET(NVM_TEST_PROGRESS_INDEX),
-           &test_progress, sizeof(uint32_t)))
+   regression_state.test_info.test_num = test_num;
+   regression_state.test_info.test_progress = TEST_START;
+   if (val_host_regression_state_save(sizeof(regression_state.test_info)))
    {
       VAL_PANIC("\tnvm write failed\n");
    }
@@ -240,6 +381,17 @@ static void val_host_test_init(uint32_t test_num)
 
    /* Reset mem alloc data structure */
    val_host_mem_alloc_init();
+
+   /* Reset delegated granule pool, host only tests leave the secondary cpus
+      idle for background refills */
+   refill_cpuid = PLATFORM_CPU_COUNT;
+   if (!(test_list[test_num].tags & TEST_MP_UNSAFE) && PLATFORM_CPU_COUNT > 1)
+       refill_cpuid = (val_get_cpuid(val_read_mpidr()) == 0) ? 1 : 0;
+   val_host_granule_pool_init(refill_cpuid);
+
+#ifdef VAL_TEST_PROFILE
+   val_host_profile_start(test_num);
+#endif
 }
 
 /**
@@ -249,7 +401,9 @@ static void val_host_test_init(uint32_t test_num)
 **/
 static void val_host_test_exit(void)
 {
-   uint32_t test_progress = TEST_END;
+#ifdef VAL_TEST_PROFILE
+   val_host_profile_phase(VAL_HOST_PROFILE_POSTAMBLE);
+#endif
 
 #if defined(TEST_COMBINE)
    if (val_host_postamble())
@@ -259,17 +413,18 @@ static void val_host_test_exit(void)
    }
 #endif
 
+#ifdef VAL_SMC_TRACE
+   val_smc_trace_dump();
+#endif
+
    if (val_watchdog_disable())
    {
       VAL_PANIC("\tWatchdog disable failed\n");
    }
 
-   if (val_nvm_write(VAL_NVM_OFFSET(NVM_TEST_PROGRESS_INDEX),
-           &test_progress, sizeof(uint32_t)))
-   {
-      VAL_PANIC("\tnvm write failed\n");
-   }
-
+#ifdef VAL_TEST_PROFILE
+   val_host_profile_stop();
+#endif
 }
 
 /**
@@ -286,6 +441,239 @@ static void val_host_print_acs_header(void)
    ACS_MINOR_VERSION);
 }
 
+#ifdef VAL_PARALLEL_DISPATCH
+/* Work queue of a batch of consecutive tests that run on every PE */
+typedef struct {
+    /* Next test to hand out and last test of the batch */
+    uint32_t next;
+    uint32_t last;
+    /* PEs still taking tests from the batch */
+    volatile uint32_t busy;
+    /* Protects the queue and the regression report */
+    s_lock_t lock;
+} val_host_batch_ts;
+
+static val_host_batch_ts batch;
+static val_log_capture_ts log_capture[PLATFORM_CPU_COUNT];
+
+/**
+ *   @brief    Return the last test of the batch that starts at test_num
+ *   @param    test_num      -  First test of the batch
+ *   @param    test_num_end  -  Last test of the regression
+ *   @return   Last test of the batch, test_num if the test runs alone
+**/
+static uint32_t val_host_batch_end(uint32_t test_num, uint32_t test_num_end)
+{
+    uint32_t i, last = test_num;
+
+    /* Tests of other shards neither join nor end the batch */
+    for (i = test_num; i <= test_num_end && test_list[i].host_fn != NULL; i++)
+    {
+        if (!val_host_test_selected(i))
+            continue;
+
+        if (test_list[i].tags & TEST_MP_UNSAFE)
+            break;
+
+        last = i;
+    }
+
+    return last;
+}
+
+/**
+ *   @brief    Take the next test of the batch
+ *   @param    void
+ *   @return   Test number, 0 once the batch is empty
+**/
+static uint32_t val_host_batch_take(void)
+{
+    uint32_t test_num = 0;
+
+    val_spin_lock(&batch.lock);
+    while (batch.next <= batch.last && !val_host_test_selected(batch.next))
+        batch.next++;
+    if (batch.next <= batch.last)
+        test_num = batch.next++;
+    val_spin_unlock(&batch.lock);
+
+    return test_num;
+}
+
+/**
+ *   @brief    Run a test of the batch on the calling PE. The output of the test
+ *             is printed in one go once its result is known.
+ *   @param    test_num     -  Test number
+ *   @return   void
+**/
+static void val_host_batch_run(uint32_t test_num)
+{
+    uint32_t test_result;
+    uint64_t start = syscounter_read();
+
+    val_set_status(RESULT_START(VAL_STATUS_INVALID));
+    val_host_print_test_name(test_num);
+    val_host_record_start(false);
+
+#ifdef VAL_TEST_PROFILE
+    val_host_profile_start(test_num);
+#endif
+    ((test_fptr_t)test_list[test_num].host_fn)();
+
+#ifdef VAL_TEST_PROFILE
+    val_host_profile_phase(VAL_HOST_PROFILE_POSTAMBLE);
+#endif
+    if (val_host_postamble_cpu())
+    {
+        LOG(ERROR, "\tval_host_postamble_cpu failed\n", 0, 0);
+        val_set_status(RESULT_FAIL(VAL_ERROR));
+    }
+#ifdef VAL_TEST_PROFILE
+    val_host_profile_stop();
+#endif
+
+    val_host_print_duration(test_num, start);
+    test_result = val_host_report_status(test_num);
+    val_host_record_print(test_num);
+    val_log_capture_flush();
+
+    val_spin_lock(&batch.lock);
+    val_host_count_result(test_result);
+
+    /* The batch has a watchdog period per test, not for all of its tests */
+    if (val_watchdog_enable())
+    {
+        VAL_PANIC("\tWatchdog enable failed\n");
+    }
+    val_spin_unlock(&batch.lock);
+}
+
+/**
+ *   @brief    Take tests from the batch until it is empty, runs on every PE
+ *   @param    arg     - Unused
+ *   @return   void
+**/
+static void val_host_batch_worker(void *arg)
+{
+    uint32_t test_num;
+
+    (void)arg;
+
+    val_log_capture_start(&log_capture[val_host_get_arena_index()]);
+
+    while ((test_num = val_host_batch_take()) != 0)
+        val_host_batch_run(test_num);
+
+    val_log_capture_stop();
+
+    val_spin_lock(&batch.lock);
+    batch.busy--;
+    val_spin_unlock(&batch.lock);
+}
+
+/**
+ *   @brief    Run a batch of tests on all PEs. The secondary PEs are powered on
+ *             to take tests from the batch and power off once it is empty.
+ *   @param    test_num   -  First test of the batch
+ *   @param    last       -  Last test of the batch
+ *   @return   SUCCESS/FAILURE
+**/
+static uint32_t val_host_batch_dispatch(uint32_t test_num, uint32_t last)
+{
+    uint32_t self = val_get_cpuid(val_read_mpidr());
+    uint32_t cpu, workers = 1;
+    uint64_t started = 0;
+
+    batch.next = test_num;
+    batch.last = last;
+    batch.busy = 1;
+    val_init_spinlock(&batch.lock);
+
+    /* A reset during the batch fails its first test and runs the others again */
+    regression_state.test_info.test_num = test_num;
+    regression_state.test_info.test_progress = TEST_START;
+    if (val_host_regression_state_save(sizeof(regression_state.test_info)))
+    {
+        VAL_PANIC("\tnvm write failed\n");
+    }
+
+    if (val_watchdog_enable())
+    {
+        VAL_PANIC("\tWatchdog enable failed\n");
+    }
+
+    /* Host memory is reset once, each PE tears down what its tests created */
+    val_host_reset_mem_tack();
+    val_host_mem_alloc_init();
+    val_host_granule_pool_init(PLATFORM_CPU_COUNT);
+
+    val_set_status_per_cpu(1);
+    *(uint64_t *)(val_get_shared_region_base() + PRINT_OFFSET) = 0xffffffffffffffff;
+    skip_for_val_logs = 1;
+
+    for (cpu = 0; cpu < val_get_cpu_count() && workers <= last - test_num; cpu++)
+    {
+        if (cpu == self)
+            continue;
+
+        val_spin_lock(&batch.lock);
+        batch.busy++;
+        val_spin_unlock(&batch.lock);
+
+        if (val_host_run_on_cpu(cpu, val_host_batch_worker, NULL))
+        {
+            val_spin_lock(&batch.lock);
+            batch.busy--;
+            val_spin_unlock(&batch.lock);
+            continue;
+        }
+
+        started |= 1ULL << cpu;
+        workers++;
+    }
+
+    val_host_batch_worker(NULL);
+
+    while (batch.busy)
+        ;
+
+    /* The PEs must be off before the next batch powers them on again */
+    for (cpu = 0; cpu < PLATFORM_CPU_COUNT; cpu++)
+    {
+        if (started & (1ULL << cpu))
+            while (val_psci_affinity_info(val_get_mpidr(cpu), 0) != PSCI_E_OFF)
+                ;
+    }
+
+    skip_for_val_logs = 0;
+    val_set_status_per_cpu(0);
+
+    /* Pooled granules are shared by the PEs and undelegated once all are done */
+    if (val_host_postamble())
+        LOG(ERROR, "\tval_host_postamble failed\n", 0, 0);
+
+#ifdef VAL_SMC_TRACE
+    val_smc_trace_dump();
+#endif
+
+    if (val_watchdog_disable())
+    {
+        VAL_PANIC("\tWatchdog disable failed\n");
+    }
+
+    /* Test number, progress and report of the whole batch in one write */
+    regression_state.test_info.test_num = last;
+    regression_state.test_info.test_progress = TEST_END;
+    if (val_host_regression_state_save(sizeof(regression_state)))
+    {
+        LOG(ERROR, "\tUnable to write regre_report\n", 0, 0);
+        return VAL_ERROR;
+    }
+
+    return VAL_SUCCESS;
+}
+#endif
+
 /**
  *   @brief    Query test database and execute test from each suite one by one
  *   @param    primary_cpu_boot   -    Boolean value for primary cpu boot
@@ -296,12 +684,18 @@ static void val_host_test_dispatch(bool primary_cpu_boot)
     uint32_t          test_result, i;
     uint32_t          reboot_run = 0;
     uint32_t          test_num_start = 0, test_num_end = 0;
+#ifdef VAL_PARALLEL_DISPATCH
+    uint32_t          batch_end;
+#endif
+    uint64_t          start;
     test_fptr_t       fn_ptr;
     val_test_info_ts       test_info = {0};
-    val_regre_report_ts    regre_report = {0};
+    val_regre_report_ts    *regre_report = &regression_state.regre_report;
 
     if (primary_cpu_boot == true)
     {
+        val_test_registry_init();
+        val_host_run_config_init();
 
         if (val_host_get_last_run_test_info(&test_info))
         {
@@ -322,28 +716,10 @@ static void val_host_test_dispatch(bool primary_cpu_boot)
         {
 
 #if defined(SUITE_TEST_RANGE)
-            uint32_t          test_num, j;
-            char *start_test_name = SUITE_TEST_RANGE_MIN;
-            char *end_test_name = SUITE_TEST_RANGE_MAX;
-
-            test_num = test_info.test_num;
-
-            for (; test_num < total_tests - 1; test_num++)
-            {
-                if (val_strcmp((char *)test_list[test_num].test_name, start_test_name) == 0)
-                {
-                    test_num_start = test_num;
-                }
-            }
+            uint32_t          j;
 
-            test_num = test_info.test_num;
-            for (; test_num < total_tests - 1; test_num++)
-            {
-                if (val_strcmp((char *)test_list[test_num].test_name, end_test_name) == 0)
-                {
-                    test_num_end = test_num;
-                }
-            }
+            test_num_start = val_test_index_by_name(SUITE_TEST_RANGE_MIN);
+            test_num_end = val_test_index_by_name(SUITE_TEST_RANGE_MAX);
 
             if (test_num_start > test_num_end)
             {
@@ -352,8 +728,8 @@ static void val_host_test_dispatch(bool primary_cpu_boot)
                 test_num_end = j;
             }
 
-            if ((val_nvm_write(VAL_NVM_OFFSET(NVM_END_TEST_NUM_INDEX),
-                                                    &test_num_end, sizeof(test_num_end))))
+            regression_state.test_info.end_test_num = test_num_end;
+            if (val_host_regression_state_save(sizeof(regression_state.test_info)))
             {
                         LOG(ERROR, "\tUnable to write nvm\n", 0, 0);
                         return;
@@ -362,8 +738,8 @@ static void val_host_test_dispatch(bool primary_cpu_boot)
             test_num_start = test_info.test_num;
             test_num_end = total_tests;
 
-            if ((val_nvm_write(VAL_NVM_OFFSET(NVM_END_TEST_NUM_INDEX),
-                                                    &test_num_end, sizeof(test_num_end))))
+            regression_state.test_info.end_test_num = test_num_end;
+            if (val_host_regression_state_save(sizeof(regression_state.test_info)))
             {
                         LOG(ERROR, "\tUnable to write nvm\n", 0, 0);
                         return;
@@ -385,6 +761,10 @@ static void val_host_test_dispatch(bool primary_cpu_boot)
             if (fn_ptr == NULL)
                 break;
 
+            /* The test that reset the platform is always in this shard */
+            if (!reboot_run && !val_host_test_selected(i))
+                continue;
+
             if (reboot_run)
             {
                 /* Reboot case, find out whether reboot expected or not? */
@@ -398,65 +778,40 @@ static void val_host_test_dispatch(bool primary_cpu_boot)
                     val_set_status(RESULT_ERROR(VAL_SIM_ERROR));
                 }
                 reboot_run = 0;
-            } else {
-                if ((val_nvm_write(VAL_NVM_OFFSET(NVM_CUR_TEST_NUM_INDEX),
-                                            &i, sizeof(i))))
-                {
-                    LOG(ERROR, "\tUnable to write nvm\n", 0, 0);
+            }
+#ifdef VAL_PARALLEL_DISPATCH
+            else if ((batch_end = val_host_batch_end(i, test_num_end)) != i)
+            {
+                if (val_host_batch_dispatch(i, batch_end))
                     return;
-                }
 
+                i = batch_end;
+                continue;
+            }
+#endif
+            else {
+                start = syscounter_read();
+                val_host_record_start(true);
                 val_host_test_init(i);
 
                 *(uint64_t *)(val_get_shared_region_base() + PRINT_OFFSET) = 0xffffffffffffffff;
 	            /* Execute host test */
                 skip_for_val_logs = 1;
-                fn_ptr();
+                if (val_host_test_supported(i))
+                    fn_ptr();
                 skip_for_val_logs = 0;
 
 	            val_host_test_exit();
+                val_host_print_duration(i, start);
             }
 
             test_result = val_host_report_status(i);
+            val_host_record_print(i);
+            val_host_count_result(test_result);
 
-            if (val_nvm_read(VAL_NVM_OFFSET(NVM_TOTAL_PASS_INDEX),
-                     &regre_report.total_pass, sizeof(uint32_t)) ||
-                val_nvm_read(VAL_NVM_OFFSET(NVM_TOTAL_FAIL_INDEX),
-                     &regre_report.total_fail, sizeof(uint32_t))  ||
-                val_nvm_read(VAL_NVM_OFFSET(NVM_TOTAL_SKIP_INDEX),
-                     &regre_report.total_skip, sizeof(uint32_t))  ||
-                val_nvm_read(VAL_NVM_OFFSET(NVM_TOTAL_ERROR_INDEX),
-                     &regre_report.total_error, sizeof(uint32_t)))
-
-            {
-                LOG(ERROR, "\tUnable to read regre_report\n", 0, 0);
-                return;
-            }
-
-            switch (test_result)
-            {
-                case TEST_PASS:
-                    regre_report.total_pass++;
-                    break;
-                case TEST_FAIL:
-                    regre_report.total_fail++;
-                    break;
-                case TEST_SKIP:
-                    regre_report.total_skip++;
-                    break;
-                case TEST_ERROR:
-                    regre_report.total_error++;
-                    break;
-            }
-
-            if (val_nvm_write(VAL_NVM_OFFSET(NVM_TOTAL_PASS_INDEX),
-                     &regre_report.total_pass, sizeof(uint32_t)) ||
-                val_nvm_write(VAL_NVM_OFFSET(NVM_TOTAL_FAIL_INDEX),
-                     &regre_report.total_fail, sizeof(uint32_t))  ||
-                val_nvm_write(VAL_NVM_OFFSET(NVM_TOTAL_SKIP_INDEX),
-                     &regre_report.total_skip, sizeof(uint32_t))  ||
-                val_nvm_write(VAL_NVM_OFFSET(NVM_TOTAL_ERROR_INDEX),
-                     &regre_report.total_error, sizeof(uint32_t)))
+            /* Test number, progress and report in one write */
+            regression_state.test_info.test_progress = TEST_END;
+            if (val_host_regression_state_save(sizeof(regression_state)))
             {
                 LOG(ERROR, "\tUnable to write regre_report\n", 0, 0);
                 return;
@@ -467,18 +822,30 @@ static void val_host_test_dispatch(bool primary_cpu_boot)
         LOG(ALWAYS, "\n\n", 0, 0);
         LOG(ALWAYS, "REGRESSION REPORT: \n", 0, 0);
         LOG(ALWAYS, "==================\n", 0, 0);
+        if (run_config.shard_count > 1)
+            LOG(ALWAYS, "   SHARD           : %d of %d\n",
+                run_config.shard_index + 1, run_config.shard_count);
         LOG(ALWAYS, "   TOTAL TESTS     : %d\n",
-            (uint64_t)(regre_report.total_pass
-            + regre_report.total_fail
-            + regre_report.total_skip
-            + regre_report.total_error),
+            (uint64_t)(regre_report->total_pass
+            + regre_report->total_fail
+            + regre_report->total_skip
+            + regre_report->total_error),
             0);
-        LOG(ALWAYS, "   TOTAL PASSED    : %d\n", regre_report.total_pass, 0);
-        LOG(ALWAYS, "   TOTAL FAILED    : %d\n", regre_report.total_fail, 0);
-        LOG(ALWAYS, "   TOTAL SKIPPED   : %d\n", regre_report.total_skip, 0);
-        LOG(ALWAYS, "   TOTAL SIM ERROR : %d\n\n", regre_report.total_error, 0);
+        LOG(ALWAYS, "   TOTAL PASSED    : %d\n", regre_report->total_pass, 0);
+        LOG(ALWAYS, "   TOTAL FAILED    : %d\n", regre_report->total_fail, 0);
+        LOG(ALWAYS, "   TOTAL SKIPPED   : %d\n", regre_report->total_skip, 0);
+        LOG(ALWAYS, "   TOTAL SIM ERROR : %d\n\n", regre_report->total_error, 0);
+#ifdef VAL_SMC_STATS
+        val_smc_stats_print();
+#endif
+#ifdef VAL_TEST_PROFILE
+        val_host_profile_print();
+#endif
         LOG(ALWAYS, "******* END OF ACS *******\n", 0, 0);
     } else {
+        /* Run queued job for secondary cpu, if any */
+        val_host_run_secondary_job();
+
         /* Resume the current test for secondary cpu */
         fn_ptr = (test_fptr_t)(test_list[val_get_curr_test_num()].host_fn);
         if (fn_ptr == NULL)
@@ -519,6 +886,14 @@ void val_host_main(bool primary_cpu_boot)
     /* Enable Stage-1 MMU */
     val_enable_mmu(host_xlat_ctx);
 
+    if (primary_cpu_boot == true)
+        val_realm_log_init();
+
+#ifdef VAL_SMC_TRACE
+    if (primary_cpu_boot == true)
+        val_smc_trace_init();
+#endif
+
     /* Ready to run test regression */
     val_host_test_dispatch(primary_cpu_boot);
 
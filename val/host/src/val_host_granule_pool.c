@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "val_host_granule_pool.h"
+#include "val_host_rmi.h"
+#include "val_host_mp.h"
+
+/* Batch of granules delegated by a secondary cpu */
+typedef struct {
+    uint64_t pa[VAL_HOST_GRANULE_POOL_BATCH];
+    uint64_t status[VAL_HOST_GRANULE_POOL_BATCH];
+    uint32_t count;
+    uint32_t busy;
+    uint32_t cpuid;
+    event_t done;
+} val_host_pool_batch_ts;
+
+static uint64_t pool[VAL_HOST_GRANULE_POOL_SIZE];
+static uint32_t pool_count;
+static val_host_pool_batch_ts pool_batch;
+/* Secondary cpu refilling the pool in the background, PLATFORM_CPU_COUNT if none */
+static uint32_t pool_cpuid = PLATFORM_CPU_COUNT;
+/* Protects pool[], pool_count and pool_batch.busy */
+static s_lock_t pool_lock;
+
+/**
+ *   @brief    Mark a tracked delegated granule as pooled and push it to the pool
+ *   @param    pa      - PA of delegated granule
+ *   @return   1 if the granule was pushed, 0 if the pool is full
+**/
+static uint32_t val_host_granule_pool_push(uint64_t pa)
+{
+    val_host_granule_ts *node = val_host_find_granule(pa);
+    uint32_t pushed = 0;
+
+    if (node != NULL)
+        node->is_granule_pooled = 1;
+
+    val_spin_lock(&pool_lock);
+    if (pool_count < VAL_HOST_GRANULE_POOL_SIZE)
+    {
+        pool[pool_count++] = pa;
+        pushed = 1;
+    }
+    val_spin_unlock(&pool_lock);
+
+    return pushed;
+}
+
+/**
+ *   @brief    Pop a granule from the pool
+ *   @param    void
+ *   @return   PA of a delegated granule, 0 if the pool is empty
+**/
+static uint64_t val_host_granule_pool_pop(void)
+{
+    uint64_t pa = 0;
+
+    val_spin_lock(&pool_lock);
+    if (pool_count > 0)
+        pa = pool[--pool_count];
+    val_spin_unlock(&pool_lock);
+
+    return pa;
+}
+
+/**
+ *   @brief    Delegate the granules of the pending batch, runs on a secondary cpu.
+ *             Only RMI calls are made here, mem_track is updated by the primary
+ *             cpu when the batch is collected.
+ *   @param    arg     - Batch descriptor
+ *   @return   void
+**/
+static void val_host_granule_pool_worker(void *arg)
+{
+    val_host_pool_batch_ts *batch = (val_host_pool_batch_ts *)arg;
+    uint32_t i;
+
+    for (i = 0; i < batch->count; i++)
+        batch->status[i] = val_smc_call(RMI_GRANULE_DELEGATE, batch->pa[i],
+                                                0, 0, 0, 0, 0, 0, 0, 0, 0).x0;
+
+    val_send_event(&batch->done);
+}
+
+/**
+ *   @brief    Wait for the batch worker to finish and its cpu to power off, so
+ *             that the cpu can be powered on again
+ *   @param    cpuid   - Logical cpuid running the batch worker
+ *   @return   void
+**/
+static void val_host_granule_pool_wait(uint32_t cpuid)
+{
+    val_wait_for_event(&pool_batch.done);
+
+    while (val_psci_affinity_info(val_get_mpidr(cpuid), 0) != PSCI_E_OFF)
+        ;
+}
+
+/**
+ *   @brief    Wait for the pending batch, if any, and move its granules to the pool
+ *   @param    void
+ *   @return   void
+**/
+static void val_host_granule_pool_collect(void)
+{
+    uint32_t i, busy;
+
+    /* Only one cpu collects the batch */
+    val_spin_lock(&pool_lock);
+    busy = pool_batch.busy;
+    pool_batch.busy = 0;
+    val_spin_unlock(&pool_lock);
+
+    if (!busy)
+        return;
+
+    val_host_granule_pool_wait(pool_batch.cpuid);
+
+    for (i = 0; i < pool_batch.count; i++)
+    {
+        if (pool_batch.status[i])
+        {
+            val_host_mem_free((void *)pool_batch.pa[i]);
+            continue;
+        }
+
+        val_host_update_granule_state(0, GRANULE_DELEGATED, pool_batch.pa[i], 0, 0);
+        if (!val_host_granule_pool_push(pool_batch.pa[i]))
+        {
+            (void)val_host_rmi_granule_undelegate(pool_batch.pa[i]);
+            val_host_mem_free((void *)pool_batch.pa[i]);
+        }
+    }
+}
+
+/**
+ *   @brief    Reset the pool. Called when host memory is reset for a new test.
+ *   @param    refill_cpuid   - Logical cpuid of a secondary cpu left idle by the
+ *                              test, PLATFORM_CPU_COUNT if there is none
+ *   @return   void
+**/
+void val_host_granule_pool_init(uint32_t refill_cpuid)
+{
+    /* Let an outstanding batch finish before its memory is reused */
+    if (pool_batch.busy)
+        val_host_granule_pool_wait(pool_batch.cpuid);
+
+    pool_batch.busy = 0;
+    pool_count = 0;
+    pool_cpuid = refill_cpuid;
+    val_init_spinlock(&pool_lock);
+}
+
+/**
+ *   @brief    Allocate and delegate granules into the pool
+ *   @param    count   - Number of granules to add
+ *   @return   SUCCESS/FAILURE
+**/
+uint32_t val_host_granule_pool_refill(uint32_t count)
+{
+    uint64_t pa;
+
+    while (count-- > 0)
+    {
+        pa = (uint64_t)val_host_mem_alloc(PAGE_SIZE, PAGE_SIZE);
+        if (!pa)
+            return VAL_ERROR;
+
+        if (val_host_rmi_granule_delegate(pa))
+        {
+            LOG(ERROR, "\tGranule delegation failed, PA=0x%x\n", pa, 0);
+            val_host_mem_free((void *)pa);
+            return VAL_ERROR;
+        }
+
+        if (!val_host_granule_pool_push(pa))
+        {
+            /* Pool filled up by another cpu */
+            (void)val_host_rmi_granule_undelegate(pa);
+            val_host_mem_free((void *)pa);
+            break;
+        }
+    }
+
+    return VAL_SUCCESS;
+}
+
+/**
+ *   @brief    Allocate granules and delegate them on a secondary cpu. The granules
+ *             join the pool the next time the pool runs dry or is drained.
+ *   @param    target_cpuid   - Logical cpuid of an idle secondary cpu
+ *   @param    count          - Number of granules, at most VAL_HOST_GRANULE_POOL_BATCH
+ *   @return   SUCCESS/FAILURE
+**/
+uint32_t val_host_granule_pool_refill_async(uint32_t target_cpuid, uint32_t count)
+{
+    uint32_t i;
+
+    if (count == 0 || count > VAL_HOST_GRANULE_POOL_BATCH)
+        return VAL_ERROR;
+
+    val_spin_lock(&pool_lock);
+    if (pool_batch.busy)
+    {
+        val_spin_unlock(&pool_lock);
+        return VAL_ERROR;
+    }
+    /* Claim the batch before its buffers are filled */
+    pool_batch.busy = 1;
+    val_spin_unlock(&pool_lock);
+
+    for (i = 0; i < count; i++)
+    {
+        pool_batch.pa[i] = (uint64_t)val_host_mem_alloc(PAGE_SIZE, PAGE_SIZE);
+        if (!pool_batch.pa[i])
+            goto free_batch;
+    }
+
+    pool_batch.count = count;
+    pool_batch.cpuid = target_cpuid;
+    val_init_event(&pool_batch.done);
+
+    if (val_host_run_on_cpu(target_cpuid, val_host_granule_pool_worker, &pool_batch))
+        goto free_batch;
+
+    return VAL_SUCCESS;
+
+free_batch:
+    while (i-- > 0)
+        val_host_mem_free((void *)pool_batch.pa[i]);
+    pool_batch.busy = 0;
+    return VAL_ERROR;
+}
+
+/**
+ *   @brief    Take a delegated granule from the pool, refilling it when empty.
+ *             Below the low watermark the refill cpu, if any, delegates the next
+ *             batch while the pool is used up.
+ *   @param    void
+ *   @return   PA of a delegated granule, 0 on failure
+**/
+uint64_t val_host_granule_pool_get(void)
+{
+    uint64_t pa = val_host_granule_pool_pop();
+
+    /* Fails while the previous batch is pending, it is collected once the pool is dry */
+    if (pool_count < VAL_HOST_GRANULE_POOL_LOW && pool_cpuid < PLATFORM_CPU_COUNT)
+        (void)val_host_granule_pool_refill_async(pool_cpuid, VAL_HOST_GRANULE_POOL_BATCH);
+
+    if (pa)
+        return pa;
+
+    val_host_granule_pool_collect();
+    pa = val_host_granule_pool_pop();
+    if (pa)
+        return pa;
+
+    (void)val_host_granule_pool_refill(VAL_HOST_GRANULE_POOL_BATCH);
+    return val_host_granule_pool_pop();
+}
+
+/**
+ *   @brief    Release a delegated granule after its RMI object was destroyed.
+ *             Pooled granules go back to the pool, other granules are undelegated.
+ *   @param    pa      - PA of delegated granule
+ *   @return   Returns RMI command return status
+**/
+uint64_t val_host_granule_pool_release(uint64_t pa)
+{
+    val_host_granule_ts *node = val_host_find_granule(pa);
+
+    if (node != NULL && node->is_granule_pooled && node->state == GRANULE_DELEGATED &&
+        val_host_granule_pool_push(pa))
+        return RMI_SUCCESS;
+
+    return val_host_rmi_granule_undelegate(pa);
+}
+
+/**
+ *   @brief    Collect any outstanding batch and empty the pool. The granules stay
+ *             delegated in mem_track and are undelegated by the postamble.
+ *   @param    void
+ *   @return   void
+**/
+void val_host_granule_pool_drain(void)
+{
+    val_host_granule_pool_collect();
+
+    val_spin_lock(&pool_lock);
+    pool_count = 0;
+    val_spin_unlock(&pool_lock);
+}
@@ -89,7 +89,8 @@ extern uintptr_t __BSS_START__, __BSS_END__;
 
 void val_host_add_mmap(void)
 {
-    mmap_region_t host_regions[HOST_MEM_REGIONS] = {
+    /* Zero terminated, mmap_add_ctx stops at the first empty region */
+    mmap_region_t host_regions[HOST_MEM_REGIONS + 1] = {
             NS_UART,
             WDOG,
             NS_WDOG,
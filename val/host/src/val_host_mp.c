@@ -9,6 +9,9 @@
 
 #define CONTEXT_ID_VALUE 0x5555
 
+/* Work queued for a secondary cpu, run instead of the current host test */
+static val_host_cpu_job_ts cpu_job[PLATFORM_CPU_COUNT];
+
 /**
  *   @brief    Power up the given core
  *   @param    target_cpuid     - Logical cpuid value of the core
@@ -41,3 +44,51 @@ uint64_t val_host_power_off_cpu(void)
     LOG(WARN, "\tPSCI_CPU_OFF failed, ret=0x%x\n", ret, 0);
     return VAL_ERROR;
 }
+
+/**
+ *   @brief    Power up the given core to run fn(arg) instead of the current test.
+ *             The core powers itself off once fn returns.
+ *   @param    target_cpuid     - Logical cpuid value of the core
+ *   @param    fn               - Job function
+ *   @param    arg              - Job argument
+ *   @return   SUCCESS/FAILURE
+**/
+uint64_t val_host_run_on_cpu(uint32_t target_cpuid, val_host_cpu_job_fn fn, void *arg)
+{
+    if (target_cpuid >= PLATFORM_CPU_COUNT)
+        return VAL_ERROR;
+
+    cpu_job[target_cpuid].arg = arg;
+    cpu_job[target_cpuid].fn = fn;
+
+    /* Make the job visible before the core is released */
+    dsbsy();
+
+    if (val_host_power_on_cpu(target_cpuid))
+    {
+        cpu_job[target_cpuid].fn = NULL;
+        return VAL_ERROR;
+    }
+
+    return VAL_SUCCESS;
+}
+
+/**
+ *   @brief    Run the job queued for the calling secondary core, if any, and power it off.
+ *   @param    void
+ *   @return   Returns only when no job is queued for the calling core.
+**/
+void val_host_run_secondary_job(void)
+{
+    uint32_t cpuid = val_get_cpuid(val_read_mpidr());
+    val_host_cpu_job_fn fn;
+
+    if (cpuid >= PLATFORM_CPU_COUNT || cpu_job[cpuid].fn == NULL)
+        return;
+
+    fn = cpu_job[cpuid].fn;
+    cpu_job[cpuid].fn = NULL;
+    fn(cpu_job[cpuid].arg);
+
+    (void)val_host_power_off_cpu();
+}
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Opt-in per-test profile of the host. The PE that runs a test accounts the
+ * CNTPCT ticks, and when it has a PMU the cycles and retired instructions, to
+ * the setup, body and postamble of the test. The profiles are printed after
+ * the regression report as the slowest tests and as CSV. Tests of the
+ * pmu_debug suite program the PMU themselves and only get the ticks.
+ */
+#ifdef VAL_TEST_PROFILE
+
+#include "val_host_profile.h"
+#include "test_database.h"
+#include "val_mp_supp.h"
+#include "val_libc.h"
+#include "val_pmu.h"
+
+extern const uint32_t  total_tests;
+extern const test_db_t test_list[];
+
+/* Entries of test_list[], the registry IDs and the two dummy entries */
+#define VAL_HOST_PROFILE_TESTS      (TEST_ID_END + 1)
+
+/* Test, phase and counters at the last phase change of a PE */
+typedef struct {
+    uint32_t test_num;              /* 0 when the PE runs no test */
+    val_host_profile_phase_te phase;
+    val_host_profile_count_ts last;
+    bool pmu;
+    uint32_t inst_counter;          /* Event counter of INST_RETIRED */
+} val_host_profile_cpu_ts;
+
+static val_host_profile_ts profile[VAL_HOST_PROFILE_TESTS];
+static val_host_profile_cpu_ts profile_cpu[PLATFORM_CPU_COUNT];
+
+static val_host_profile_cpu_ts *val_host_profile_self(void)
+{
+    uint32_t cpu = val_get_cpuid(val_read_mpidr());
+
+    return (cpu < PLATFORM_CPU_COUNT) ? &profile_cpu[cpu] : NULL;
+}
+
+/**
+ *   @brief    Count the cycles and, on the last event counter, the retired
+ *             instructions of the calling PE at EL2
+ *   @param    state    - Profile state of the calling PE
+ *   @return   true if the PE has a PMU
+**/
+static bool val_host_profile_pmu_enable(val_host_profile_cpu_ts *state)
+{
+    uint64_t pmuver = VAL_EXTRACT_BITS(read_id_aa64dfr0_el1(), 8, 11);
+    uint64_t enable = PMCNTENSET_EL0_C_BIT;
+    uint32_t counters;
+
+    if (pmuver == 0 || pmuver == 0xF)
+        return false;
+
+    /* PMCR_EL0_N_MASK when there is no event counter */
+    counters = (uint32_t)((read_pmcr_el0() >> PMCR_EL0_N_SHIFT) & PMCR_EL0_N_MASK);
+    state->inst_counter = PMCR_EL0_N_MASK;
+    if (counters)
+    {
+        state->inst_counter = counters - 1;
+        write_pmevtypern_el0(state->inst_counter,
+                             PMEVTYPER_EL0_NSH_BIT | PMU_EVT_INST_RETIRED);
+        enable |= PMCNTENSET_EL0_P_BIT(state->inst_counter);
+    }
+
+    write_pmccfiltr_el0(PMCCFILTR_EL0_NSH_BIT);
+    write_pmcntenset_el0(read_pmcntenset_el0() | enable);
+    write_pmcr_el0(read_pmcr_el0() | PMCR_EL0_LC_BIT | PMCR_EL0_E_BIT);
+    isb();
+
+    return true;
+}
+
+static void val_host_profile_read(val_host_profile_cpu_ts *state, val_host_profile_count_ts *now)
+{
+    now->ticks = syscounter_read();
+    now->cycles = 0;
+    now->instructions = 0;
+
+    if (!state->pmu)
+        return;
+
+    now->cycles = read_pmccntr_el0();
+    if (state->inst_counter < PMCR_EL0_N_MASK)
+        now->instructions = read_pmevcntrn_el0(state->inst_counter);
+}
+
+/**
+ *   @brief    Start the profile of a test in its body on the calling PE
+ *   @param    test_num     - Test number
+ *   @return   void
+**/
+void val_host_profile_start(uint32_t test_num)
+{
+    val_host_profile_cpu_ts *state = val_host_profile_self();
+
+    if (state == NULL || test_num == 0 || test_num >= VAL_HOST_PROFILE_TESTS)
+        return;
+
+    val_memset(&profile[test_num], 0, sizeof(profile[test_num]));
+
+    state->pmu = false;
+    if (!(test_list[test_num].tags & TEST_TAG_SUITE(pmu_debug)))
+        state->pmu = val_host_profile_pmu_enable(state);
+
+    profile[test_num].pmu = state->pmu;
+    state->test_num = test_num;
+    state->phase = VAL_HOST_PROFILE_BODY;
+    val_host_profile_read(state, &state->last);
+}
+
+/**
+ *   @brief    Account the counters since the last change to the current phase
+ *             of the test of the calling PE and enter a new phase
+ *   @param    phase        - New phase
+ *   @return   Previous phase, to return to it
+**/
+val_host_profile_phase_te val_host_profile_phase(val_host_profile_phase_te phase)
+{
+    val_host_profile_cpu_ts *state = val_host_profile_self();
+    val_host_profile_count_ts now, *count;
+    val_host_profile_phase_te prev;
+
+    if (state == NULL || state->test_num == 0)
+        return phase;
+
+    val_host_profile_read(state, &now);
+
+    count = &profile[state->test_num].phase[state->phase];
+    count->ticks += now.ticks - state->last.ticks;
+    count->cycles += now.cycles - state->last.cycles;
+    /* Event counters are 32 bits wide without FEAT_PMUv3p5 */
+    count->instructions += (uint32_t)(now.instructions - state->last.instructions);
+
+    state->last = now;
+    prev = state->phase;
+    state->phase = phase;
+
+    return prev;
+}
+
+/**
+ *   @brief    End the profile of the test of the calling PE
+ *   @param    void
+ *   @return   void
+**/
+void val_host_profile_stop(void)
+{
+    val_host_profile_cpu_ts *state = val_host_profile_self();
+
+    val_host_profile_phase(VAL_HOST_PROFILE_BODY);
+    if (state != NULL)
+        state->test_num = 0;
+}
+
+/**
+ *   @brief    Return the profile of a test
+ *   @param    test_num     - Test number
+ *   @return   Profile, NULL if the test number is out of range
+**/
+const val_host_profile_ts *val_host_profile_get(uint32_t test_num)
+{
+    return (test_num < VAL_HOST_PROFILE_TESTS) ? &profile[test_num] : NULL;
+}
+
+static void val_host_profile_sum(uint32_t test_num, val_host_profile_count_ts *sum)
+{
+    val_host_profile_count_ts *count;
+    uint32_t i;
+
+    val_memset(sum, 0, sizeof(*sum));
+
+    for (i = 0; i < VAL_HOST_PROFILE_PHASES; i++)
+    {
+        count = &profile[test_num].phase[i];
+        sum->ticks += count->ticks;
+        sum->cycles += count->cycles;
+        sum->instructions += count->instructions;
+    }
+}
+
+static uint64_t val_host_profile_us(uint64_t ticks, uint64_t freq)
+{
+    return freq ? (ticks * 1000000) / freq : 0;
+}
+
+static void val_host_profile_print_name(uint32_t test_num, const char *prefix, const char *suffix)
+{
+    if (*prefix)
+        LOG(ALWAYS, prefix, 0, 0);
+    LOG(ALWAYS, test_list[test_num].test_name, 0, 0);
+    LOG(ALWAYS, suffix, 0, 0);
+}
+
+/**
+ *   @brief    Print the slowest tests, the most ticks first
+ *   @param    freq         - CNTFRQ_EL0
+ *   @return   void
+**/
+static void val_host_profile_print_slowest(uint64_t freq)
+{
+    bool shown[VAL_HOST_PROFILE_TESTS] = {false};
+    val_host_profile_count_ts *count, sum;
+    uint32_t row, i, slowest;
+    uint64_t max;
+
+    LOG(ALWAYS, "SLOWEST TESTS (us, CNTFRQ %d Hz): \n", freq, 0);
+    LOG(ALWAYS, "==================\n", 0, 0);
+
+    for (row = 0; row < VAL_HOST_PROFILE_SLOWEST; row++)
+    {
+        slowest = 0;
+        max = 0;
+        for (i = 1; i < total_tests && i < VAL_HOST_PROFILE_TESTS; i++)
+        {
+            val_host_profile_sum(i, &sum);
+            if (!shown[i] && sum.ticks > max)
+            {
+                slowest = i;
+                max = sum.ticks;
+            }
+        }
+
+        if (slowest == 0)
+            break;
+
+        shown[slowest] = true;
+        val_host_profile_sum(slowest, &sum);
+        count = profile[slowest].phase;
+        val_host_profile_print_name(slowest, "   ", "\n");
+        LOG(ALWAYS, "      TOTAL : %d    SETUP     : %d\n", val_host_profile_us(max, freq),
+            val_host_profile_us(count[VAL_HOST_PROFILE_SETUP].ticks, freq));
+        LOG(ALWAYS, "      BODY  : %d    POSTAMBLE : %d\n",
+            val_host_profile_us(count[VAL_HOST_PROFILE_BODY].ticks, freq),
+            val_host_profile_us(count[VAL_HOST_PROFILE_POSTAMBLE].ticks, freq));
+        if (profile[slowest].pmu)
+            LOG(ALWAYS, "      CYCLES : %d    INSTRUCTIONS : %d\n",
+                sum.cycles, sum.instructions);
+    }
+    LOG(ALWAYS, "\n", 0, 0);
+}
+
+/**
+ *   @brief    Print one line per profiled test, the PMU columns are empty when
+ *             the cycles and instructions were not counted
+ *   @param    freq         - CNTFRQ_EL0
+ *   @return   void
+**/
+static void val_host_profile_print_csv(uint64_t freq)
+{
+    val_host_profile_count_ts *count, sum;
+    uint32_t i;
+
+    LOG(ALWAYS, "TEST PROFILE CSV: \n", 0, 0);
+    LOG(ALWAYS, "==================\n", 0, 0);
+    LOG(ALWAYS, "test_num,test,total_us,setup_us,body_us,postamble_us,cycles,instructions\n",
+        0, 0);
+
+    for (i = 1; i < total_tests && i < VAL_HOST_PROFILE_TESTS; i++)
+    {
+        val_host_profile_sum(i, &sum);
+        if (sum.ticks == 0)
+            continue;
+
+        count = profile[i].phase;
+        LOG(ALWAYS, "%d,", i, 0);
+        val_host_profile_print_name(i, "", ",");
+        LOG(ALWAYS, "%d,%d,", val_host_profile_us(sum.ticks, freq),
+            val_host_profile_us(count[VAL_HOST_PROFILE_SETUP].ticks, freq));
+        LOG(ALWAYS, "%d,%d,", val_host_profile_us(count[VAL_HOST_PROFILE_BODY].ticks, freq),
+            val_host_profile_us(count[VAL_HOST_PROFILE_POSTAMBLE].ticks, freq));
+        if (profile[i].pmu)
+        {
+            LOG(ALWAYS, "%d,%d\n", sum.cycles, sum.instructions);
+        } else
+        {
+            LOG(ALWAYS, ",\n", 0, 0);
+        }
+    }
+    LOG(ALWAYS, "\n", 0, 0);
+}
+
+/**
+ *   @brief    Print the profiles of the tests run since the last reset
+ *   @param    void
+ *   @return   void
+**/
+void val_host_profile_print(void)
+{
+    uint64_t freq = read_cntfrq_el0();
+
+    val_host_profile_print_slowest(freq);
+    val_host_profile_print_csv(freq);
+}
+
+#endif /* VAL_TEST_PROFILE */
@@ -8,25 +8,49 @@
 #include "val_host_realm.h"
 #include "val_host_alloc.h"
 #include "val_host_helpers.h"
+#include "val_host_granule_pool.h"
+#include "val_host_shadow.h"
+#include "val_host_profile.h"
+#include "val_mp_supp.h"
 
-int current_realm = 1;
-val_host_granule_ts *head = NULL;
-val_host_granule_ts *current = NULL;
-val_host_granule_ts *tail = NULL;
-
-val_host_memory_track_ts mem_track[VAL_HOST_MAX_REALMS] = {
-    {.rd = 0x00000000FFFFFFFF},
-    {.rd = 0x00000000FFFFFFFF},
-    {.rd = 0x00000000FFFFFFFF},
-    {.rd = 0x00000000FFFFFFFF},
-    {.rd = 0x00000000FFFFFFFF},
-    {.rd = 0x00000000FFFFFFFF},
-    {.rd = 0x00000000FFFFFFFF},
-    {.rd = 0x00000000FFFFFFFF},
-    {.rd = 0x00000000FFFFFFFF},
-    {.rd = 0x00000000FFFFFFFF}
+val_host_memory_track_ts mem_track[VAL_HOST_REALM_CHUNK_SLOTS] = {
+    [0 ... VAL_HOST_REALM_CHUNK_SLOTS - 1] = {.rd = 0x00000000FFFFFFFF}
 };
 
+/* Handle table of mem_track slots. Chunks are allocated from the heap as realms
+   are created and stay in place until the next reset, so slot pointers and
+   their locks are stable. */
+static val_host_memory_track_ts *mem_track_chunk[VAL_HOST_MAX_REALMS /
+                                                 VAL_HOST_REALM_CHUNK_SLOTS] = {mem_track};
+/* Number of slots in the allocated chunks */
+static uint32_t mem_track_count = VAL_HOST_REALM_CHUNK_SLOTS;
+/* RD keyed index of the realm slots */
+static uint32_t realm_rd_index[VAL_HOST_REALM_INDEX_SIZE];
+
+#define VAL_HOST_REALM_INDEX(rd) \
+    (((rd) >> VAL_PAGE_SHIFT) & (VAL_HOST_REALM_INDEX_SIZE - 1))
+
+/* REC tables handed out by val_host_realm_reserve_recs(), keyed by descriptor.
+   The tables of a descriptor are only used when they are listed here for it,
+   a descriptor on the stack that only carries an RD holds garbage in them. */
+typedef struct {
+    val_host_realm_ts *realm;
+    uint64_t *rec;
+    uint64_t *run;
+    uint64_t *aux;
+    uint64_t capacity;
+} val_host_rec_tables_ts;
+
+static val_host_rec_tables_ts *rec_tables;
+static uint64_t rec_tables_count;
+static uint64_t rec_tables_capacity;
+static s_lock_t rec_tables_lock;
+
+#ifdef VAL_PARALLEL_DISPATCH
+/* The VMID ranges of the PEs fit in 8 bits, FEAT_VMID16 is optional */
+CASSERT(PLATFORM_CPU_COUNT * VAL_HOST_TEST_VMIDS <= 0x100, assert_test_vmids);
+#endif
+
 static uint64_t val_host_rtt_level_mapsize(uint64_t rtt_level)
 {
     if (rtt_level > VAL_RTT_MAX_LEVEL)
@@ -35,29 +59,263 @@ static uint64_t val_host_rtt_level_mapsize(uint64_t rtt_level)
     return (1UL << VAL_RTT_LEVEL_SHIFT(rtt_level));
 }
 
+/**
+ *   @brief    Return the capacity a realm table needs to hold count entries
+ *   @param    capacity   - Current capacity of the table
+ *   @param    count      - Number of entries needed
+ *   @return   Returns the new capacity
+**/
+static uint64_t val_host_realm_table_capacity(uint64_t capacity, uint64_t count)
+{
+    if (capacity == 0)
+        capacity = VAL_HOST_REALM_TABLE_MIN;
+
+    while (capacity < count)
+        capacity *= 2;
+
+    return capacity;
+}
+
+/**
+ *   @brief    Move a realm table to a larger allocation. New entries are zeroed
+ *             and the old allocation is freed.
+ *   @param    table        - Table base, NULL if the table is not allocated yet
+ *   @param    count        - Number of entries of the old table
+ *   @param    new_count    - Number of entries of the new table
+ *   @param    entry_size   - Size of a table entry
+ *   @return   Returns the new table base, NULL on failure
+**/
+static void *val_host_realm_table_resize(void *table, uint64_t count,
+                                         uint64_t new_count, uint64_t entry_size)
+{
+    void *new_table = mem_alloc(sizeof(uint64_t), new_count * entry_size);
+
+    if (new_table == NULL)
+    {
+        LOG(ERROR, "\tFailed to grow realm table, entries=0x%x\n", new_count, 0);
+        return NULL;
+    }
+
+    val_memset(new_table, 0, new_count * entry_size);
+    if (table != NULL)
+    {
+        val_memcpy(new_table, table, count * entry_size);
+        val_host_mem_free(table);
+    }
+
+    return new_table;
+}
+
+/**
+ *   @brief    Record an RTT in one of the per level RTT tables of the realm
+ *   @param    table      - RTT table of the level
+ *   @param    count      - Number of RTTs in the table
+ *   @param    capacity   - Capacity of the table
+ *   @param    phys       - PA of the RTT
+ *   @param    ipa        - Base IPA covered by the RTT
+ *   @return   SUCCESS/FAILURE
+**/
+static uint32_t val_host_realm_add_rtt(val_host_rtt_db_ts **table, uint64_t *count,
+                                       uint64_t *capacity, uint64_t phys, uint64_t ipa)
+{
+    uint64_t new_capacity;
+    val_host_rtt_db_ts *new_table;
+
+    if (*count == *capacity)
+    {
+        new_capacity = val_host_realm_table_capacity(*capacity, *count + 1);
+        new_table = val_host_realm_table_resize(*table, *count, new_capacity,
+                                                sizeof(val_host_rtt_db_ts));
+        if (new_table == NULL)
+            return VAL_ERROR;
+
+        *table = new_table;
+        *capacity = new_capacity;
+    }
+
+    (*table)[*count].rtt_addr = phys;
+    (*table)[*count].ipa = ipa;
+    (*count)++;
+
+    return VAL_SUCCESS;
+}
+
+/**
+ *   @brief    Record a mapped region in the granules table of the realm
+ *   @param    realm      - Realm strucrure
+ *   @param    ipa        - Base IPA of the region
+ *   @param    size       - Size of the region
+ *   @param    level      - RTT level the region is mapped at
+ *   @param    pa         - Base PA of the region
+ *   @return   SUCCESS/FAILURE
+**/
+uint32_t val_host_realm_add_granules(val_host_realm_ts *realm, uint64_t ipa,
+                        uint64_t size, uint64_t level, uint64_t pa)
+{
+    uint64_t new_capacity;
+    val_host_granules_mapped_ts *new_table;
+
+    if (realm->granules_mapped_count == realm->granules_capacity)
+    {
+        new_capacity = val_host_realm_table_capacity(realm->granules_capacity,
+                                                     realm->granules_mapped_count + 1);
+        new_table = val_host_realm_table_resize(realm->granules,
+                                                realm->granules_mapped_count, new_capacity,
+                                                sizeof(val_host_granules_mapped_ts));
+        if (new_table == NULL)
+            return VAL_ERROR;
+
+        realm->granules = new_table;
+        realm->granules_capacity = new_capacity;
+    }
+
+    realm->granules[realm->granules_mapped_count].ipa = ipa;
+    realm->granules[realm->granules_mapped_count].size = size;
+    realm->granules[realm->granules_mapped_count].level = level;
+    realm->granules[realm->granules_mapped_count].pa = pa;
+    realm->granules_mapped_count++;
+
+    return VAL_SUCCESS;
+}
+
+/**
+ *   @brief    Find the REC tables entry of a realm descriptor.
+ *             Called with rec_tables_lock held.
+ *   @param    realm      - Realm strucrure
+ *   @return   Returns the entry, NULL if no tables were handed out to it
+**/
+static val_host_rec_tables_ts *val_host_rec_tables_find(val_host_realm_ts *realm)
+{
+    uint64_t i;
+
+    for (i = 0; i < rec_tables_count; i++)
+    {
+        if (rec_tables[i].realm == realm)
+            return &rec_tables[i];
+    }
+
+    return NULL;
+}
+
+/**
+ *   @brief    Make room for count RECs in the rec, run and rec_aux_granules
+ *             tables of the realm. Needed before the tables are written directly.
+ *             A descriptor built for an existing RD, with only rd and rec_count
+ *             set, gets new tables: tables not handed out to it are ignored.
+ *   @param    realm      - Realm strucrure
+ *   @param    count      - Number of RECs
+ *   @return   SUCCESS/FAILURE
+**/
+uint32_t val_host_realm_reserve_recs(val_host_realm_ts *realm, uint64_t count)
+{
+    uint64_t capacity, new_capacity;
+    uint64_t *rec, *run, *aux;
+    val_host_rec_tables_ts *entry, *new_table;
+    uint32_t status = VAL_ERROR;
+
+    val_spin_lock(&rec_tables_lock);
+
+    entry = val_host_rec_tables_find(realm);
+    if (entry == NULL || entry->rec != realm->rec)
+    {
+        realm->rec = NULL;
+        realm->run = NULL;
+        realm->rec_aux_granules = NULL;
+        realm->rec_capacity = 0;
+    } else {
+        realm->run = entry->run;
+        realm->rec_aux_granules = entry->aux;
+        realm->rec_capacity = entry->capacity;
+    }
+
+    if (count <= realm->rec_capacity)
+    {
+        status = VAL_SUCCESS;
+        goto unlock;
+    }
+
+    if (entry == NULL)
+    {
+        if (rec_tables_count == rec_tables_capacity)
+        {
+            new_capacity = val_host_realm_table_capacity(rec_tables_capacity,
+                                                         rec_tables_count + 1);
+            new_table = val_host_realm_table_resize(rec_tables, rec_tables_count,
+                                                    new_capacity,
+                                                    sizeof(val_host_rec_tables_ts));
+            if (new_table == NULL)
+                goto unlock;
+
+            rec_tables = new_table;
+            rec_tables_capacity = new_capacity;
+        }
+
+        entry = &rec_tables[rec_tables_count++];
+        entry->realm = realm;
+    }
+
+    capacity = val_host_realm_table_capacity(realm->rec_capacity, count);
+
+    rec = val_host_realm_table_resize(realm->rec, realm->rec_capacity, capacity,
+                                      sizeof(uint64_t));
+    if (rec == NULL)
+        goto unlock;
+    realm->rec = rec;
+
+    run = val_host_realm_table_resize(realm->run, realm->rec_capacity, capacity,
+                                      sizeof(uint64_t));
+    if (run == NULL)
+        goto unlock;
+    realm->run = run;
+
+    aux = val_host_realm_table_resize(realm->rec_aux_granules,
+                                      realm->rec_capacity * VAL_MAX_REC_AUX_GRANULES,
+                                      capacity * VAL_MAX_REC_AUX_GRANULES, sizeof(uint64_t));
+    if (aux == NULL)
+        goto unlock;
+    realm->rec_aux_granules = aux;
+
+    realm->rec_capacity = capacity;
+    status = VAL_SUCCESS;
+
+unlock:
+    if (entry != NULL)
+    {
+        entry->rec = realm->rec;
+        entry->run = realm->run;
+        entry->aux = realm->rec_aux_granules;
+        entry->capacity = realm->rec_capacity;
+    }
+    val_spin_unlock(&rec_tables_lock);
+    return status;
+}
+
 static uint64_t val_host_rtt_create(uint64_t phys,
                 val_host_realm_ts *realm,
                 uint64_t rtt_addr,
                 uint64_t rtt_level
                 )
 {
+    uint32_t ret = VAL_SUCCESS;
+
     rtt_addr = ADDR_ALIGN_DOWN(rtt_addr, val_host_rtt_level_mapsize(rtt_level - 1));
     if (rtt_level == 3)
     {
-        realm->rtt_l3[realm->rtt_l3_count].rtt_addr = phys;
-        realm->rtt_l3[realm->rtt_l3_count].ipa = rtt_addr;
-        realm->rtt_l3_count++;
+        ret = val_host_realm_add_rtt(&realm->rtt_l3, &realm->rtt_l3_count,
+                                     &realm->rtt_l3_capacity, phys, rtt_addr);
     } else if (rtt_level == 2)
     {
-        realm->rtt_l2[realm->rtt_l2_count].rtt_addr = phys;
-        realm->rtt_l2[realm->rtt_l2_count].ipa = rtt_addr;
-        realm->rtt_l2_count++;
+        ret = val_host_realm_add_rtt(&realm->rtt_l2, &realm->rtt_l2_count,
+                                     &realm->rtt_l2_capacity, phys, rtt_addr);
     } else if (rtt_level == 1)
     {
-        realm->rtt_l1[realm->rtt_l1_count].rtt_addr = phys;
-        realm->rtt_l1[realm->rtt_l1_count].ipa = rtt_addr;
-        realm->rtt_l1_count++;
+        ret = val_host_realm_add_rtt(&realm->rtt_l1, &realm->rtt_l1_count,
+                                     &realm->rtt_l1_capacity, phys, rtt_addr);
     }
+
+    if (ret)
+        return ret;
+
     return val_host_rmi_rtt_create(realm->rd, phys, rtt_addr, rtt_level);
 }
 
@@ -83,21 +341,32 @@ uint32_t val_host_create_rtt_levels(val_host_realm_ts *realm,
 
     for (; rtt_level++ < rtt_max_level;)
     {
-        rtt = (uint64_t)val_host_mem_alloc(rtt_alignment, PAGE_SIZE);
-        if (!rtt)
-        {
-            LOG(ERROR, "\tFailed to allocate memory for rtt\n", 0, 0);
-            return VAL_ERROR;
-        } else if (val_host_rmi_granule_delegate(rtt))
+        /* Pool granules are page aligned, larger alignments are allocated directly */
+        if (rtt_alignment <= PAGE_SIZE)
         {
-            LOG(ERROR, "\tRtt delegation failed, rtt=0x%x\n", rtt, 0);
-            return VAL_ERROR;
+            rtt = val_host_granule_pool_get();
+            if (!rtt)
+            {
+                LOG(ERROR, "\tFailed to get delegated granule for rtt\n", 0, 0);
+                return VAL_ERROR;
+            }
+        } else {
+            rtt = (uint64_t)val_host_mem_alloc(rtt_alignment, PAGE_SIZE);
+            if (!rtt)
+            {
+                LOG(ERROR, "\tFailed to allocate memory for rtt\n", 0, 0);
+                return VAL_ERROR;
+            } else if (val_host_rmi_granule_delegate(rtt))
+            {
+                LOG(ERROR, "\tRtt delegation failed, rtt=0x%x\n", rtt, 0);
+                return VAL_ERROR;
+            }
         }
 
         if (val_host_rtt_create(rtt, realm, ipa, rtt_level))
         {
             LOG(ERROR, "\tRtt create failed, rtt=0x%x\n", rtt, 0);
-            val_host_rmi_granule_undelegate(rtt);
+            val_host_granule_pool_release(rtt);
             val_host_mem_free((void *)rtt);
             return VAL_ERROR;
         }
@@ -107,213 +376,335 @@ uint32_t val_host_create_rtt_levels(val_host_realm_ts *realm,
 }
 
 /**
- *   @brief    Maps protected memory into the realm
- *   @param    realm        - Realm strucrure
- *   @param    target_pa    - PA of target data
- *   @param    ipa          - IPA Address
- *   @param    rtt_map_size - size of memory to be mapped
- *   @param    src_pa       - PA of source granule
+ *   @brief    Split a block entry into a table of the next level
+ *   @param    rd         - Realm RD granule address
+ *   @param    ipa        - IPA within the block
+ *   @param    rtt_level  - Level of the block entry
  *   @return   SUCCESS/FAILURE
 **/
-uint32_t val_host_map_protected_data(val_host_realm_ts *realm,
-                uint64_t target_pa,
-                uint64_t ipa,
-                uint64_t rtt_map_size,
-                uint64_t src_pa)
+static uint32_t val_host_rtt_unfold(uint64_t rd, uint64_t ipa, uint64_t rtt_level)
 {
-    uint64_t rd = realm->rd;
-    uint64_t map_level, rtt_level;
-    uint64_t ret = 0;
-    uint64_t size = 0;
-    uint64_t phys = target_pa;
-    uint64_t flags = RMI_NO_MEASURE_CONTENT;
-    val_host_rtt_entry_ts  rtte;
-    val_host_data_destroy_ts data_destroy;
+    uint64_t rtt, ret;
 
-    if (!ADDR_IS_ALIGNED(ipa, rtt_map_size))
+    rtt = val_host_granule_pool_get();
+    if (!rtt)
+    {
+        LOG(ERROR, "\tFailed to get delegated granule for rtt\n", 0, 0);
         return VAL_ERROR;
+    }
 
-    if (rtt_map_size == PAGE_SIZE)
-        map_level = 3;
-    else if (rtt_map_size == VAL_RTT_L2_BLOCK_SIZE)
-        map_level = 2;
-    else
-        {
-            LOG(ERROR, "\tUnknown rtt_map_size=0x%x\n", rtt_map_size, 0);
-            return VAL_ERROR;
-        }
-
-    while (size < rtt_map_size)
+    ret = val_host_rmi_rtt_create(rd, rtt,
+              ADDR_ALIGN_DOWN(ipa, val_host_rtt_level_mapsize(rtt_level)), rtt_level + 1);
+    if (ret)
     {
-        if (val_host_rmi_granule_delegate(phys))
-        {
-            LOG(ERROR, "\tGranule delegation failed, PA=0x%x\n", phys, 0);
-            return VAL_ERROR;
-        }
+        LOG(ERROR, "\tRtt create failed, ipa=0x%x, ret=0x%x\n", ipa, ret);
+        val_host_granule_pool_release(rtt);
+        return VAL_ERROR;
+    }
 
-        ret = val_host_rmi_data_create(rd, phys, ipa, src_pa, flags);
+    return VAL_SUCCESS;
+}
 
-        if (RMI_STATUS(ret) == RMI_ERROR_RTT)
-        {
-            rtt_level = RMI_INDEX(ret);
-            ret = val_host_rmi_rtt_read_entry(realm->rd,
-                        val_host_addr_align_to_level(ipa, rtt_level), rtt_level, &rtte);
-            if (ret)
-            {
-                LOG(ERROR, "\tval_host_rmi_rtt_read_entry, ret=0x%x\n", ret, 0);
-                return VAL_ERROR;
-            }
+/* L1 block support of the RMM. RMI_FEATURES does not report it, so it is
+   learned from the first L1 RTT_MAP_UNPROTECTED and kept for the whole run. */
+#define VAL_HOST_RTT_L1_BLOCK_UNKNOWN        0
+#define VAL_HOST_RTT_L1_BLOCK_SUPPORTED      1
+#define VAL_HOST_RTT_L1_BLOCK_UNSUPPORTED    2
+static uint32_t rtt_l1_block = VAL_HOST_RTT_L1_BLOCK_UNKNOWN;
 
-            if (rtte.state == RMI_UNASSIGNED)
-            {
-                /* Create missing RTT levels and retry data create again */
-                ret = val_host_create_rtt_levels(realm, ipa, (uint32_t)rtte.walk_level,
-                                map_level, PAGE_SIZE);
-                if (ret)
-                {
-                    LOG(ERROR, "\tval_realm_create_rtt_levels failed, ret=0x%x\n", ret, 0);
-                    goto error;
-                }
+/**
+ *   @brief    Return whether RMM accepted an L1 block mapping
+ *   @param    void
+ *   @return   true if an L1 block has been mapped, false otherwise
+**/
+bool val_host_rtt_l1_block_supported(void)
+{
+    return (rtt_l1_block == VAL_HOST_RTT_L1_BLOCK_SUPPORTED);
+}
 
-                ret = val_host_rmi_data_create(rd, phys, ipa, src_pa, flags);
-            }
-        }
+/**
+ *   @brief    Return the largest legal RTT level for the next chunk of a range.
+ *             Unprotected IPA is block mapped where the IPA, PA and remaining
+ *             size allow it, at L1 unless RMM has rejected L1 blocks, and
+ *             protected data is always created at page level.
+ *   @param    range        - Range descriptor
+ *   @param    ipa          - IPA of the chunk
+ *   @param    pa           - PA of the chunk
+ *   @return   Returns RTT level
+**/
+static uint64_t val_host_map_range_level(val_host_map_range_ts *range, uint64_t ipa,
+                                                                     uint64_t pa)
+{
+    if (range->kind != VAL_HOST_MAP_UNPROTECTED)
+        return VAL_RTT_MAX_LEVEL;
 
-        if (ret)
-        {
-            LOG(ERROR, "\tval_rmi_data_create failed, ret=0x%x\n", ret, 0);
-            goto error;
-        }
+    if (rtt_l1_block != VAL_HOST_RTT_L1_BLOCK_UNSUPPORTED &&
+        ADDR_IS_ALIGNED(ipa, VAL_RTT_L1_BLOCK_SIZE) &&
+        ADDR_IS_ALIGNED(pa, VAL_RTT_L1_BLOCK_SIZE) &&
+        (range->top - ipa) >= VAL_RTT_L1_BLOCK_SIZE)
+        return VAL_RTT_BLOCK_LEVEL - 1;
+
+    if (ADDR_IS_ALIGNED(ipa, VAL_RTT_L2_BLOCK_SIZE) &&
+        ADDR_IS_ALIGNED(pa, VAL_RTT_L2_BLOCK_SIZE) &&
+        (range->top - ipa) >= VAL_RTT_L2_BLOCK_SIZE)
+        return VAL_RTT_BLOCK_LEVEL;
 
-        phys += PAGE_SIZE;
-        src_pa += PAGE_SIZE;
-        ipa += PAGE_SIZE;
-        size += PAGE_SIZE;
+    return VAL_RTT_MAX_LEVEL;
+}
+
+/**
+ *   @brief    Map one chunk of a range
+ *   @param    realm        - Realm strucrure
+ *   @param    range        - Range descriptor
+ *   @param    ipa          - IPA of the chunk
+ *   @param    pa           - PA of the chunk
+ *   @param    src_pa       - PA of source granule, used only for VAL_HOST_MAP_DATA
+ *   @param    level        - RTT level of the chunk
+ *   @return   Returns RMI command return status
+**/
+static uint64_t val_host_map_range_entry(val_host_realm_ts *realm,
+                                         val_host_map_range_ts *range, uint64_t ipa,
+                                         uint64_t pa, uint64_t src_pa, uint64_t level)
+{
+    switch (range->kind)
+    {
+        case VAL_HOST_MAP_DATA:
+            return val_host_rmi_data_create(realm->rd, pa, ipa, src_pa, range->flags);
+        case VAL_HOST_MAP_DATA_UNKNOWN:
+            return val_host_rmi_data_create_unknown(realm->rd, pa, ipa);
+        default:
+            return val_host_rmi_rtt_map_unprotected(realm->rd, ipa, level, pa | range->flags);
     }
+}
 
-    return VAL_SUCCESS;
+/**
+ *   @brief    Unmap the part of a range below the given top, in the chunks it
+ *             was mapped with. Protected granules are destroyed and undelegated.
+ *   @param    realm        - Realm strucrure
+ *   @param    range        - Range descriptor
+ *   @param    top          - Top of the IPA region to unmap
+ *   @return   SUCCESS/FAILURE
+**/
+uint32_t val_host_unmap_range(val_host_realm_ts *realm, val_host_map_range_ts *range,
+                                                                   uint64_t top)
+{
+    uint64_t ipa = range->base, pa = range->pa;
+    uint64_t level, size, ret, unmap_top;
+    uint32_t status = VAL_SUCCESS;
+    val_host_data_destroy_ts data_destroy;
 
-error:
-    for (; size > 0;)
+    while (ipa < top)
     {
-        ret = val_host_rmi_data_destroy(rd, ipa, &data_destroy);
-        if (ret)
-            LOG(ERROR, "\tval_rmi_rtt_mapprotected failed, ret=0x%x\n", ret, 0);
+        level = val_host_map_range_level(range, ipa, pa);
+        size = val_host_rtt_level_mapsize(level);
+
+        if (range->kind == VAL_HOST_MAP_UNPROTECTED)
+        {
+            ret = val_host_rmi_rtt_unmap_unprotected(realm->rd, ipa, level, &unmap_top);
+        } else {
+            ret = val_host_rmi_data_destroy(realm->rd, ipa, &data_destroy);
+            if (RMI_STATUS(ret) == RMI_ERROR_RTT && RMI_INDEX(ret) < VAL_RTT_MAX_LEVEL)
+            {
+                /* Granule is part of a folded block, unfold it and retry */
+                if (val_host_rtt_unfold(realm->rd, ipa, RMI_INDEX(ret)))
+                    return VAL_ERROR;
+                continue;
+            }
+
+            if (!ret)
+                ret = val_host_rmi_granule_undelegate(pa);
+        }
 
-        ret = val_host_rmi_granule_undelegate(phys);
         if (ret)
         {
-            LOG(ERROR, "\tval_rmi_granule_undelegate failed\n", 0, 0);
+            LOG(ERROR, "\tUnmap failed, ipa=0x%x, ret=0x%x\n", ipa, ret);
+            status = VAL_ERROR;
         }
-        phys -= PAGE_SIZE;
-        size -= PAGE_SIZE;
-        ipa -= PAGE_SIZE;
+
+        ipa += size;
+        pa += size;
     }
 
-    return VAL_ERROR;
+    return status;
 }
 
 /**
- *   @brief    Maps protected memory into the realm with unknown contents
+ *   @brief    Map an IPA range into the realm. Each chunk is mapped at the
+ *             largest legal RTT level, missing RTTs are created once per table
+ *             and, when requested, full L3 tables of protected data are folded.
+ *             On failure the chunks mapped so far are unmapped again.
  *   @param    realm        - Realm strucrure
- *   @param    target_pa    - PA of target data
- *   @param    ipa          - IPA Address
- *   @param    rtt_map_size - size of memory to be mapped
+ *   @param    range        - Range descriptor
  *   @return   SUCCESS/FAILURE
 **/
-uint32_t val_host_map_protected_data_unknown(val_host_realm_ts *realm,
-                        uint64_t target_pa,
-                        uint64_t ipa,
-                        uint64_t rtt_map_size)
+uint32_t val_host_map_range(val_host_realm_ts *realm, val_host_map_range_ts *range)
 {
-    uint64_t rd = realm->rd;
-    uint32_t map_level, rtt_level;
-    uint64_t ret = 0;
-    uint64_t size = 0;
-    uint64_t phys = target_pa;
+    uint64_t ipa = range->base, pa = range->pa, src_pa = range->src_pa;
+    uint64_t level, size, ret, rtt, table_top = 0, table_level = 0;
+    bool is_protected = (range->kind != VAL_HOST_MAP_UNPROTECTED);
     val_host_rtt_entry_ts rtte;
-    val_host_data_destroy_ts data_destroy;
 
-    if (!ADDR_IS_ALIGNED(ipa, rtt_map_size))
+    if (range->top <= range->base || !ADDR_IS_ALIGNED(range->base, PAGE_SIZE) ||
+        !ADDR_IS_ALIGNED(range->top, PAGE_SIZE) || !ADDR_IS_ALIGNED(range->pa, PAGE_SIZE))
+    {
+        LOG(ERROR, "\tInvalid range, base=0x%x, top=0x%x\n", range->base, range->top);
         return VAL_ERROR;
+    }
 
-    if (rtt_map_size == PAGE_SIZE)
-        map_level = 3;
-    else if (rtt_map_size == VAL_RTT_L2_BLOCK_SIZE)
-        map_level = 2;
-    else
+    while (ipa < range->top)
+    {
+        level = val_host_map_range_level(range, ipa, pa);
+        size = val_host_rtt_level_mapsize(level);
+
+        /* Create the RTTs of a table once, before its first entry is mapped */
+        if (ipa >= table_top || level != table_level)
         {
-            LOG(ERROR, "\tUnknown rtt_map_size=0x%x\n", rtt_map_size, 0);
-            return VAL_ERROR;
+            (void)val_host_shadow_create_rtt_levels(realm, ipa, ipa + size, level,
+                                                            range->rtt_alignment);
+            table_top = ADDR_ALIGN_DOWN(ipa, val_host_rtt_level_mapsize(level - 1)) +
+                                             val_host_rtt_level_mapsize(level - 1);
+            table_level = level;
         }
 
-    while (size < rtt_map_size)
-    {
-        if (val_host_rmi_granule_delegate(phys))
+        if (is_protected && val_host_rmi_granule_delegate(pa))
         {
-            LOG(ERROR, "\tGranule delegation failed, PA=0x%x\n", phys, 0);
-            return VAL_ERROR;
+            LOG(ERROR, "\tGranule delegation failed, PA=0x%x\n", pa, 0);
+            goto rollback;
         }
 
-        ret = val_host_rmi_data_create_unknown(rd, phys, ipa);
+        ret = val_host_map_range_entry(realm, range, ipa, pa, src_pa, level);
+
+        /* Shadow and RMM disagree, create the missing RTTs reported by RMM */
+        if (RMI_STATUS(ret) == RMI_ERROR_RTT &&
+            !val_host_rmi_rtt_read_entry(realm->rd,
+                       val_host_addr_align_to_level(ipa, RMI_INDEX(ret)), RMI_INDEX(ret), &rtte) &&
+            rtte.state == RMI_UNASSIGNED &&
+            !val_host_create_rtt_levels(realm, ipa, rtte.walk_level, level,
+                                                            range->rtt_alignment))
+            ret = val_host_map_range_entry(realm, range, ipa, pa, src_pa, level);
 
-        if (RMI_STATUS(ret) == RMI_ERROR_RTT)
+        /* Learn L1 block support from the first L1 mapping, retry with L2 blocks */
+        if (level < VAL_RTT_BLOCK_LEVEL)
         {
-            rtt_level = RMI_INDEX(ret);
-            ret = val_host_rmi_rtt_read_entry(realm->rd,
-                            val_host_addr_align_to_level(ipa, rtt_level), rtt_level, &rtte);
-            if (ret)
+            if (RMI_STATUS(ret) == RMI_ERROR_INPUT &&
+                rtt_l1_block == VAL_HOST_RTT_L1_BLOCK_UNKNOWN)
             {
-                LOG(ERROR, "\tval_host_rmi_rtt_read_entry, ret=0x%x\n", ret, 0);
-                return VAL_ERROR;
+                rtt_l1_block = VAL_HOST_RTT_L1_BLOCK_UNSUPPORTED;
+                continue;
             }
 
-            if (rtte.state == RMI_UNASSIGNED)
-            {
-                /* Create missing RTT levels and retry data create unknown again */
-                ret = val_host_create_rtt_levels(realm, ipa, (uint32_t)rtte.walk_level,
-                                map_level, PAGE_SIZE);
-                if (ret)
-                {
-                    LOG(ERROR, "\tval_realm_create_rtt_levels failed, ret=0x%x\n", ret, 0);
-                    goto error;
-                }
-
-                ret = val_host_rmi_data_create_unknown(rd, phys, ipa);
-            }
+            if (!ret)
+                rtt_l1_block = VAL_HOST_RTT_L1_BLOCK_SUPPORTED;
         }
 
         if (ret)
         {
-            LOG(ERROR, "\tval_rmi_data_create_unknown failed, ret=0x%x\n", ret, 0);
-            goto error;
+            LOG(ERROR, "\tMapping failed, ipa=0x%x, ret=0x%x\n", ipa, ret);
+            if (is_protected)
+                (void)val_host_rmi_granule_undelegate(pa);
+            goto rollback;
         }
 
-        phys += PAGE_SIZE;
-        ipa += PAGE_SIZE;
-        size += PAGE_SIZE;
+        ipa += size;
+        pa += size;
+        src_pa += size;
+
+        /* Fold a completed L3 table of protected data into a block entry */
+        if (range->fold && is_protected && ADDR_IS_ALIGNED(ipa, VAL_RTT_L2_BLOCK_SIZE) &&
+            (ipa - VAL_RTT_L2_BLOCK_SIZE) >= range->base &&
+            ADDR_IS_ALIGNED(pa, VAL_RTT_L2_BLOCK_SIZE))
+        {
+            ret = val_host_rmi_rtt_fold(realm->rd, ipa - VAL_RTT_L2_BLOCK_SIZE,
+                                                      VAL_RTT_MAX_LEVEL, &rtt);
+            if (ret)
+            {
+                LOG(ERROR, "\trtt_fold failed, ipa=0x%x, ret=0x%x\n",
+                                      ipa - VAL_RTT_L2_BLOCK_SIZE, ret);
+                goto rollback;
+            }
+            (void)val_host_granule_pool_release(rtt);
+        }
     }
 
     return VAL_SUCCESS;
 
-error:
-    for (; size > 0;)
+rollback:
+    (void)val_host_unmap_range(realm, range, ipa);
+    return VAL_ERROR;
+}
+
+/**
+ *   @brief    Maps protected memory into the realm.
+ *             An L2 sized mapping is folded into a block entry
+ *   @param    realm        - Realm strucrure
+ *   @param    target_pa    - PA of target data
+ *   @param    ipa          - IPA Address
+ *   @param    rtt_map_size - size of memory to be mapped
+ *   @param    src_pa       - PA of source granule
+ *   @return   SUCCESS/FAILURE
+**/
+uint32_t val_host_map_protected_data(val_host_realm_ts *realm,
+                uint64_t target_pa,
+                uint64_t ipa,
+                uint64_t rtt_map_size,
+                uint64_t src_pa)
+{
+    val_host_map_range_ts range = {
+        .kind = VAL_HOST_MAP_DATA,
+        .base = ipa,
+        .top = ipa + rtt_map_size,
+        .pa = target_pa,
+        .src_pa = src_pa,
+        .flags = RMI_NO_MEASURE_CONTENT,
+        .rtt_alignment = PAGE_SIZE,
+        .fold = (rtt_map_size == VAL_RTT_L2_BLOCK_SIZE),
+    };
+
+    if (!ADDR_IS_ALIGNED(ipa, rtt_map_size))
+        return VAL_ERROR;
+
+    if (rtt_map_size != PAGE_SIZE && rtt_map_size != VAL_RTT_L2_BLOCK_SIZE)
     {
-        val_host_rmi_data_destroy(rd, ipa, &data_destroy);
-        if (ret)
-            LOG(ERROR, "\tval_rmi_rtt_mapprotected failed, ret=0x%x\n", ret, 0);
+        LOG(ERROR, "\tUnknown rtt_map_size=0x%x\n", rtt_map_size, 0);
+        return VAL_ERROR;
+    }
 
-        ret = val_host_rmi_granule_undelegate(phys);
-        if (ret)
-        {
-            LOG(ERROR, "\tval_rmi_granule_undelegate failed\n", 0, 0);
-        }
-        phys -= PAGE_SIZE;
-        size -= PAGE_SIZE;
-        ipa -= PAGE_SIZE;
+    return val_host_map_range(realm, &range);
+}
+
+/**
+ *   @brief    Maps protected memory into the realm with unknown contents.
+ *             An L2 sized mapping is folded into a block entry
+ *   @param    realm        - Realm strucrure
+ *   @param    target_pa    - PA of target data
+ *   @param    ipa          - IPA Address
+ *   @param    rtt_map_size - size of memory to be mapped
+ *   @return   SUCCESS/FAILURE
+**/
+uint32_t val_host_map_protected_data_unknown(val_host_realm_ts *realm,
+                        uint64_t target_pa,
+                        uint64_t ipa,
+                        uint64_t rtt_map_size)
+{
+    val_host_map_range_ts range = {
+        .kind = VAL_HOST_MAP_DATA_UNKNOWN,
+        .base = ipa,
+        .top = ipa + rtt_map_size,
+        .pa = target_pa,
+        .rtt_alignment = PAGE_SIZE,
+        .fold = (rtt_map_size == VAL_RTT_L2_BLOCK_SIZE),
+    };
+
+    if (!ADDR_IS_ALIGNED(ipa, rtt_map_size))
+        return VAL_ERROR;
+
+    if (rtt_map_size != PAGE_SIZE && rtt_map_size != VAL_RTT_L2_BLOCK_SIZE)
+    {
+        LOG(ERROR, "\tUnknown rtt_map_size=0x%x\n", rtt_map_size, 0);
+        return VAL_ERROR;
     }
-    return VAL_ERROR;
 
+    return val_host_map_range(realm, &range);
 }
 
 /**
@@ -331,61 +722,8 @@ uint32_t val_host_map_unprotected(val_host_realm_ts *realm,
                         uint64_t rtt_map_size,
                         uint64_t rtt_alignment)
 {
-    uint64_t rd = realm->rd;
-    uint64_t map_level, rtt_level;
-    uint64_t ret = 0;
-    uint64_t mem_desc = ns_pa | ATTR_NORMAL_WB | ATTR_STAGE2_MASK | ATTR_INNER_SHARED;
-    val_host_rtt_entry_ts rtte;
-
-    if (!ADDR_IS_ALIGNED(ipa, rtt_map_size))
-        return VAL_ERROR;
-
-    if (rtt_map_size == PAGE_SIZE)
-        map_level = 3;
-    else if (rtt_map_size == VAL_RTT_L2_BLOCK_SIZE)
-        map_level = 2;
-    else
-        {
-            LOG(ERROR, "\tUnknown rtt_map_size=0x%x\n", rtt_map_size, 0);
-            return VAL_ERROR;
-        }
-
-    ret = val_host_rmi_rtt_map_unprotected(rd, ipa, map_level, mem_desc);
-
-    if (RMI_STATUS(ret) == RMI_ERROR_RTT)
-        {
-            rtt_level = RMI_INDEX(ret);
-            ret = val_host_rmi_rtt_read_entry(realm->rd,
-                       val_host_addr_align_to_level(ipa, rtt_level), rtt_level, &rtte);
-
-            if (ret)
-            {
-                LOG(ERROR, "\tval_host_rmi_rtt_read_entry, ret=0x%x\n", ret, 0);
-                return VAL_ERROR;
-            }
-
-            if (rtte.state == RMI_UNASSIGNED)
-            {
-                /* Create missing RTT levels and retry map unprotected again */
-                ret = val_host_create_rtt_levels(realm, ipa, rtte.walk_level,
-                                                   map_level, rtt_alignment);
-                if (ret)
-                {
-                    LOG(ERROR, "\tval_realm_create_rtt_levels failed, ret=0x%x\n", ret, 0);
-                    return VAL_ERROR;
-                }
-
-                ret = val_host_rmi_rtt_map_unprotected(rd, ipa, map_level, mem_desc);
-            }
-    }
-
-    if (ret)
-    {
-        LOG(ERROR, "\tval_rmi_rtt_map_unprotected failed, ret=0x%x\n", ret, 0);
-        return VAL_ERROR;
-    }
-
-    return VAL_SUCCESS;
+    return val_host_map_unprotected_attr(realm, ns_pa, ipa, rtt_map_size, rtt_alignment,
+                                ATTR_NORMAL_WB | ATTR_STAGE2_MASK | ATTR_INNER_SHARED);
 }
 
 /**
@@ -404,60 +742,57 @@ uint32_t val_host_map_unprotected_attr(val_host_realm_ts *realm,
                         uint64_t rtt_map_size,
                         uint64_t rtt_alignment, uint64_t mem_attr)
 {
-    uint64_t rd = realm->rd;
-    uint64_t map_level, rtt_level;
-    uint64_t ret = 0;
-    uint64_t mem_desc = 0;
-    val_host_rtt_entry_ts rtte;
-
-    mem_desc = ns_pa | mem_attr;
+    val_host_map_range_ts range = {
+        .kind = VAL_HOST_MAP_UNPROTECTED,
+        .base = ipa,
+        .top = ipa + rtt_map_size,
+        .pa = ns_pa,
+        .flags = mem_attr,
+        .rtt_alignment = rtt_alignment,
+    };
 
     if (!ADDR_IS_ALIGNED(ipa, rtt_map_size))
         return VAL_ERROR;
 
-    if (rtt_map_size == PAGE_SIZE)
-        map_level = 3;
-    else if (rtt_map_size == VAL_RTT_L2_BLOCK_SIZE)
-        map_level = 2;
-    else
-        {
-            LOG(ERROR, "\tUnknown rtt_map_size=0x%x\n", rtt_map_size, 0);
-            return VAL_ERROR;
-        }
-
-    ret = val_host_rmi_rtt_map_unprotected(rd, ipa, map_level, mem_desc);
-
-    if (RMI_STATUS(ret) == RMI_ERROR_RTT)
-        {
-            rtt_level = RMI_INDEX(ret);
-            ret = val_host_rmi_rtt_read_entry(realm->rd,
-                        val_host_addr_align_to_level(ipa, rtt_level), rtt_level, &rtte);
-            if (ret)
-            {
-                LOG(ERROR, "\tval_host_rmi_rtt_read_entry, ret=0x%x\n", ret, 0);
-                return VAL_ERROR;
-            }
-
-            if (rtte.state == RMI_UNASSIGNED)
-            {
-                /* Create missing RTT levels and retry map unprotected again */
-                ret = val_host_create_rtt_levels(realm, ipa, rtt_level, map_level, rtt_alignment);
-                if (ret)
-                {
-                    LOG(ERROR, "\tval_realm_create_rtt_levels failed, ret=0x%x\n", ret, 0);
-                return VAL_ERROR;
-                }
-
-                ret = val_host_rmi_rtt_map_unprotected(rd, ipa, map_level, mem_desc);
-            }
-    }
-
-    if (ret)
+    if (rtt_map_size != PAGE_SIZE && rtt_map_size != VAL_RTT_L2_BLOCK_SIZE)
     {
+        LOG(ERROR, "\tUnknown rtt_map_size=0x%x\n", rtt_map_size, 0);
         return VAL_ERROR;
     }
 
-    return VAL_SUCCESS;
+    return val_host_map_range(realm, &range);
+}
+
+/**
+ *   @brief    Return the VMID to create a realm with. Tests pick their VMIDs
+ *             from 0, so each PE of a parallel batch gets its own range of
+ *             VAL_HOST_TEST_VMIDS VMIDs, else the realms that two PEs create
+ *             at the same time can ask for the same VMID.
+ *   @param    vmid             - VMID picked by the test
+ *   @return   VMID for the calling PE
+**/
+uint16_t val_host_realm_vmid(uint16_t vmid)
+{
+#ifdef VAL_PARALLEL_DISPATCH
+    uint32_t cpu = val_get_cpuid(val_read_mpidr());
+
+    if (vmid < VAL_HOST_TEST_VMIDS && cpu < PLATFORM_CPU_COUNT)
+        return (uint16_t)(vmid + cpu * VAL_HOST_TEST_VMIDS);
+#endif
+    return vmid;
+}
+
+/**
+ *   @brief    Clear the fields that realm creation sets, the test inputs are
+ *             kept. A realm descriptor on the stack then has no stale table
+ *             pointers or capacities.
+ *   @param    realm            - Realm strucrure
+ *   @return   void
+**/
+void val_host_realm_clear(val_host_realm_ts *realm)
+{
+    val_memset(&realm->image_pa_base, 0,
+               (size_t)((uint8_t *)(realm + 1) - (uint8_t *)&realm->image_pa_base));
 }
 
 /**
@@ -470,13 +805,20 @@ uint32_t val_host_realm_create(val_host_realm_ts *realm)
     val_host_realm_params_ts *params;
     uint64_t ret, i;
 
+    uint64_t image_align = PAGE_SIZE;
+
+    val_host_realm_clear(realm);
     realm->image_pa_size = PLATFORM_REALM_IMAGE_SIZE;
 
+    /* Block align an image that fills whole L3 tables, so that they can be folded */
+    if (realm->image_pa_size >= VAL_RTT_L2_BLOCK_SIZE)
+        image_align = VAL_RTT_L2_BLOCK_SIZE;
+
     realm->state = REALM_STATE_NULL;
 
     /* Allocate memory for realm image. Granule delegation
      * for it will be performed during rtt creation.  */
-    realm->image_pa_base = (uint64_t)val_host_mem_alloc(PAGE_SIZE, realm->image_pa_size);
+    realm->image_pa_base = (uint64_t)val_host_mem_alloc(image_align, realm->image_pa_size);
     if (!realm->image_pa_base)
     {
         LOG(ERROR, "\tval_host_mem_alloc failed, base=0x%x, size=0x%x\n",
@@ -506,19 +848,12 @@ uint32_t val_host_realm_create(val_host_realm_ts *realm)
         }
     }
 
-    /* Allocate and delegate RD */
-    realm->rd = (uint64_t)val_host_mem_alloc(PAGE_SIZE, PAGE_SIZE);
+    /* Get delegated RD */
+    realm->rd = val_host_granule_pool_get();
     if (!realm->rd)
-    {
-        LOG(ERROR, "\tFailed to allocate memory for rd\n", 0, 0);
-        goto free_par;
-    } else {
-        ret = val_host_rmi_granule_delegate(realm->rd);
-        if (ret)
-        {
-            LOG(ERROR, "\trd delegation failed, rd=0x%x, ret=0x%x\n", realm->rd, ret);
-            goto free_rd;
-        }
+    {
+        LOG(ERROR, "\tFailed to get delegated granule for rd\n", 0, 0);
+        goto free_par;
     }
 
     /* Allocate memory for params */
@@ -539,7 +874,7 @@ uint32_t val_host_realm_create(val_host_realm_ts *realm)
     params->hash_algo = realm->hash_algo;
     params->rtt_level_start = realm->s2_starting_level;
     params->rtt_num_start = realm->num_s2_sl_rtts;
-    params->vmid = realm->vmid;
+    params->vmid = val_host_realm_vmid(realm->vmid);
     val_memcpy(&params->rpv, &realm->rpv, sizeof(realm->rpv));
 
     /* Create realm */
@@ -569,13 +904,11 @@ free_rtt:
      val_host_mem_free((void *)realm->rtt_l0_addr);
 
 undelegate_rd:
-    ret = val_host_rmi_granule_undelegate(realm->rd);
+    ret = val_host_granule_pool_release(realm->rd);
     if (ret)
     {
         LOG(WARN, "\trd undelegation failed, rd=0x%x, ret=0x%x\n", realm->rd, ret);
     }
-free_rd:
-     val_host_mem_free((void *)realm->rd);
 
 free_par:
      val_host_mem_free((void *)realm->image_pa_base);
@@ -600,6 +933,7 @@ int val_host_ripas_init(val_host_realm_ts *realm, uint64_t base,
 
     do
     {
+        (void)val_host_shadow_create_rtt_levels(realm, base, top, rtt_level, rtt_alignment);
         ret = val_host_rmi_rtt_init_ripas(realm->rd, base, top, &out_top);
         rtt_level1 = RMI_INDEX(ret);
 
@@ -629,6 +963,9 @@ int val_host_ripas_init(val_host_realm_ts *realm, uint64_t base,
         {
             return VAL_ERROR;
         }
+
+        /* Continue from the end of the range initialised by this call */
+        base = out_top;
     } while (out_top != top);
 
     return VAL_SUCCESS;
@@ -641,8 +978,16 @@ int val_host_ripas_init(val_host_realm_ts *realm, uint64_t base,
 **/
 static uint32_t val_host_image_map(val_host_realm_ts *realm)
 {
-    uint64_t src_pa = PLATFORM_REALM_IMAGE_BASE;
-    uint32_t i = 0;
+    val_host_map_range_ts image = {
+        .kind = VAL_HOST_MAP_DATA,
+        .base = VAL_REALM_IMAGE_BASE_IPA,
+        .top = VAL_REALM_IMAGE_BASE_IPA + realm->image_pa_size,
+        .pa = realm->image_pa_base,
+        .src_pa = PLATFORM_REALM_IMAGE_BASE,
+        .flags = RMI_NO_MEASURE_CONTENT,
+        .rtt_alignment = PAGE_SIZE,
+        .fold = true,
+    };
 
     if (val_host_ripas_init(realm,
             VAL_REALM_IMAGE_BASE_IPA,
@@ -650,32 +995,55 @@ static uint32_t val_host_image_map(val_host_realm_ts *realm)
             VAL_RTT_MAX_LEVEL, PAGE_SIZE))
     {
         LOG(ERROR, "\trealm_init_ipa_state failed, ipa=0x%x\n",
-                realm->image_pa_base + i * PAGE_SIZE, 0);
+                realm->image_pa_base, 0);
         return VAL_ERROR;
     }
     /* MAP image regions */
-    while (i < (realm->image_pa_size/PAGE_SIZE))
-    {
-        if (val_host_map_protected_data(realm,
-                realm->image_pa_base + i * PAGE_SIZE,
-                VAL_REALM_IMAGE_BASE_IPA + i * PAGE_SIZE,
-                PAGE_SIZE,
-                src_pa + i * PAGE_SIZE
-                ))
+    if (val_host_map_range(realm, &image))
+    {
+        LOG(ERROR, "\tval_realm_map_protected_data failed, par_base=0x%x\n",
+                realm->image_pa_base, 0);
+        return VAL_ERROR;
+    }
+    return val_host_realm_add_granules(realm, VAL_REALM_IMAGE_BASE_IPA, realm->image_pa_size,
+                                       VAL_RTT_MAX_LEVEL, realm->image_pa_base);
+}
+/**
+ *   @brief    Record the chunks of a mapped range in the realm granules table,
+ *             one entry per run of chunks mapped at the same RTT level
+ *   @param    realm        - Realm strucrure
+ *   @param    range        - Range descriptor
+ *   @return   SUCCESS/FAILURE
+**/
+uint32_t val_host_map_range_add_granules(val_host_realm_ts *realm,
+                                         val_host_map_range_ts *range)
+{
+    uint64_t ipa = range->base, pa = range->pa;
+    uint64_t run_ipa = ipa, run_pa = pa, level, size;
+    uint64_t run_level = val_host_map_range_level(range, ipa, pa);
+
+    while (ipa < range->top)
+    {
+        level = val_host_map_range_level(range, ipa, pa);
+        size = val_host_rtt_level_mapsize(level);
+
+        if (level != run_level)
         {
-            LOG(ERROR, "\tval_realm_map_protected_data failed, par_base=0x%x\n",
-                    realm->image_pa_base, 0);
-            return VAL_ERROR;
+            if (val_host_realm_add_granules(realm, run_ipa, ipa - run_ipa, run_level, run_pa))
+                return VAL_ERROR;
+
+            run_ipa = ipa;
+            run_pa = pa;
+            run_level = level;
         }
-        i++;
+
+        ipa += size;
+        pa += size;
     }
-    realm->granules[realm->granules_mapped_count].ipa = VAL_REALM_IMAGE_BASE_IPA;
-    realm->granules[realm->granules_mapped_count].size = realm->image_pa_size;
-    realm->granules[realm->granules_mapped_count].level = VAL_RTT_MAX_LEVEL;
-    realm->granules[realm->granules_mapped_count].pa = realm->image_pa_base;
-    realm->granules_mapped_count++;
-    return VAL_SUCCESS;
+
+    return val_host_realm_add_granules(realm, run_ipa, ipa - run_ipa, run_level, run_pa);
 }
+
 /**
  *   @brief    Maps protected memory into the realm
  *   @param    realm            - Realm strucrure
@@ -685,40 +1053,34 @@ static uint32_t val_host_image_map(val_host_realm_ts *realm)
 uint32_t val_host_map_protected_data_to_realm(val_host_realm_ts *realm,
                                             val_data_create_ts *data_create)
 {
-    uint32_t i = 0;
+    val_host_map_range_ts range = {
+        .kind = VAL_HOST_MAP_DATA,
+        .base = data_create->ipa,
+        .top = data_create->ipa + data_create->size,
+        .pa = data_create->target_pa,
+        .src_pa = data_create->src_pa,
+        .flags = RMI_NO_MEASURE_CONTENT,
+        .rtt_alignment = PAGE_SIZE,
+    };
 
     if (val_host_ripas_init(realm,
             data_create->ipa,
             data_create->ipa + data_create->size,
             VAL_RTT_MAX_LEVEL, data_create->rtt_alignment))
     {
-        LOG(ERROR, "\tval_host_ripas_init failed, ipa=0x%x\n",
-                data_create->ipa + i * PAGE_SIZE, 0);
+        LOG(ERROR, "\tval_host_ripas_init failed, ipa=0x%x\n", data_create->ipa, 0);
         return VAL_ERROR;
     }
     /* MAP image regions */
-    while (i < (data_create->size/PAGE_SIZE))
-    {
-        if (val_host_map_protected_data(realm,
-                data_create->target_pa + i * PAGE_SIZE,
-                data_create->ipa + i * PAGE_SIZE,
-                PAGE_SIZE,
-                data_create->src_pa + i * PAGE_SIZE
-                ))
-        {
-            LOG(ERROR, "\tval_realm_map_protected_data failed, par_base=0x%x\n",
-                    data_create->target_pa, 0);
-            return VAL_ERROR;
-        }
-        i++;
+    if (val_host_map_range(realm, &range))
+    {
+        LOG(ERROR, "\tval_realm_map_protected_data failed, par_base=0x%x\n",
+                data_create->target_pa, 0);
+        return VAL_ERROR;
     }
 
-    realm->granules[realm->granules_mapped_count].ipa = data_create->ipa;
-    realm->granules[realm->granules_mapped_count].size = data_create->size;
-    realm->granules[realm->granules_mapped_count].level = VAL_RTT_MAX_LEVEL;
-    realm->granules[realm->granules_mapped_count].pa = data_create->target_pa;
-    realm->granules_mapped_count++;
-    return VAL_SUCCESS;
+    return val_host_realm_add_granules(realm, data_create->ipa, data_create->size,
+                                       VAL_RTT_MAX_LEVEL, data_create->target_pa);
 }
 
 /**
@@ -728,31 +1090,26 @@ uint32_t val_host_map_protected_data_to_realm(val_host_realm_ts *realm,
 **/
 static uint32_t val_host_map_shared_region(val_host_realm_ts *realm)
 {
-    uint32_t i = 0;
     uint64_t ns_shared_base_pa = (uint64_t)val_get_shared_region_base_pa();
     uint64_t ns_shared_base_ipa =
                             (uint64_t)val_get_shared_region_base_ipa(realm->s2sz & 0xff);
-
-    /* MAP SHARED_NS region */
-    while (i < PLATFORM_SHARED_REGION_SIZE/PAGE_SIZE)
-    {
-        if (val_host_map_unprotected(realm,
-                ns_shared_base_pa + i * PAGE_SIZE,
-                ns_shared_base_ipa + i * PAGE_SIZE,
-                PAGE_SIZE, PAGE_SIZE
-                ))
-        {
-            LOG(ERROR, "\tval_realm_map_unprotected_data failed\n", 0, 0);
-            return VAL_ERROR;
-        }
-        i++;
+    val_host_map_range_ts range = {
+        .kind = VAL_HOST_MAP_UNPROTECTED,
+        .base = ns_shared_base_ipa,
+        .top = ns_shared_base_ipa + PLATFORM_SHARED_REGION_SIZE,
+        .pa = ns_shared_base_pa,
+        .flags = ATTR_NORMAL_WB | ATTR_STAGE2_MASK | ATTR_INNER_SHARED,
+        .rtt_alignment = PAGE_SIZE,
+    };
+
+    /* MAP SHARED_NS region, with block entries where it is aligned */
+    if (val_host_map_range(realm, &range))
+    {
+        LOG(ERROR, "\tval_realm_map_unprotected_data failed\n", 0, 0);
+        return VAL_ERROR;
     }
-    realm->granules[realm->granules_mapped_count].ipa = ns_shared_base_ipa;
-    realm->granules[realm->granules_mapped_count].size = PLATFORM_SHARED_REGION_SIZE;
-    realm->granules[realm->granules_mapped_count].level = VAL_RTT_MAX_LEVEL;
-    realm->granules[realm->granules_mapped_count].pa = ns_shared_base_pa;
-    realm->granules_mapped_count++;
-    return VAL_SUCCESS;
+
+    return val_host_map_range_add_granules(realm, &range);
 }
 
 /**
@@ -764,9 +1121,12 @@ static uint32_t val_host_map_shared_region(val_host_realm_ts *realm)
 **/
 uint32_t val_host_map_ns_shared_region(val_host_realm_ts *realm, uint64_t size, uint64_t mem_attr)
 {
-    uint32_t i = 0;
     uint64_t pa = 0;
     uint64_t ns_shared_base_ipa = 0;
+    val_host_map_range_ts range = {
+        .kind = VAL_HOST_MAP_UNPROTECTED,
+        .rtt_alignment = PAGE_SIZE,
+    };
 
     /* Allocate the NS memory */
     pa = (uint64_t)val_host_mem_alloc(PAGE_SIZE, size);
@@ -779,24 +1139,16 @@ uint32_t val_host_map_ns_shared_region(val_host_realm_ts *realm, uint64_t size,
     ns_shared_base_ipa =
         (uint64_t)val_get_ns_shared_region_base_ipa(realm->s2sz & 0xff, pa);
     /* MAP SHARED_NS region */
-    while (i < size/PAGE_SIZE)
-    {
-        if (val_host_map_unprotected_attr(realm,
-                pa + i * PAGE_SIZE,
-                ns_shared_base_ipa + i * PAGE_SIZE,
-                PAGE_SIZE, PAGE_SIZE,
-                mem_attr
-                ))
-        {
-            return 0;
-        }
-        i++;
-    }
-    realm->granules[realm->granules_mapped_count].ipa = ns_shared_base_ipa;
-    realm->granules[realm->granules_mapped_count].size = size;
-    realm->granules[realm->granules_mapped_count].level = VAL_RTT_MAX_LEVEL;
-    realm->granules[realm->granules_mapped_count].pa = pa;
-    realm->granules_mapped_count++;
+    range.base = ns_shared_base_ipa;
+    range.top = ns_shared_base_ipa + size;
+    range.pa = pa;
+    range.flags = mem_attr;
+    if (val_host_map_range(realm, &range))
+        return 0;
+
+    if (val_host_map_range_add_granules(realm, &range))
+        return 0;
+
     return (uint32_t)(realm->granules_mapped_count - 1);
 }
 
@@ -812,11 +1164,8 @@ uint32_t val_host_rec_create(val_host_realm_ts *realm)
 
     uint64_t ret, i, mpidr = 0x0, aux_count, j;
 
-    if (realm->rec_count > VAL_MAX_REC_COUNT)
-    {
-        LOG(ERROR, "\tmax supported recs are VAL_MAX_REC_COUNT\n", 0, 0);
+    if (val_host_realm_reserve_recs(realm, realm->rec_count))
         return VAL_ERROR;
-    }
 
     /* Get aux granules count */
     ret = val_host_rmi_rec_aux_count(realm->rd, &aux_count);
@@ -873,36 +1222,21 @@ uint32_t val_host_rec_create(val_host_realm_ts *realm)
         }
         val_memset((void *)realm->run[i], 0x0, PAGE_SIZE);
 
-        /* Allocate and delegate REC */
-        realm->rec[i] = (uint64_t)val_host_mem_alloc(PAGE_SIZE, PAGE_SIZE);
+        /* Get delegated REC */
+        realm->rec[i] = val_host_granule_pool_get();
         if (!realm->rec[i])
         {
-            LOG(ERROR, "\tFailed to allocate memory for REC\n", 0, 0);
+            LOG(ERROR, "\tFailed to get delegated granule for REC\n", 0, 0);
             goto free_rec_params;
-        } else {
-            ret = val_host_rmi_granule_delegate(realm->rec[i]);
-            if (ret)
-            {
-                LOG(ERROR, "\trec delegation failed, rec=0x%x, ret=0x%x\n", realm->rec[i], ret);
-                goto free_rec_params;
-            }
         }
 
         for (j = 0; j < aux_count; j++)
         {
-            rec_params->aux[j] = (uint64_t)val_host_mem_alloc(PAGE_SIZE, PAGE_SIZE);
+            rec_params->aux[j] = val_host_granule_pool_get();
             if (!rec_params->aux[j])
             {
-                LOG(ERROR, "\tFailed to allocate memory for aux rec\n", 0, 0);
+                LOG(ERROR, "\tFailed to get delegated granule for aux rec\n", 0, 0);
                 goto free_rec_params;
-            } else {
-                ret = val_host_rmi_granule_delegate(rec_params->aux[j]);
-                if (ret)
-                {
-                    LOG(ERROR, "\trec delegation failed, rec=0x%x, ret=0x%x\n",
-                                         rec_params->aux[j], ret);
-                    goto free_rec_params;
-                }
             }
             realm->rec_aux_granules[j + (i * aux_count)] = rec_params->aux[j];
         }
@@ -975,13 +1309,7 @@ uint32_t val_host_realm_activate(val_host_realm_ts *realm)
     return VAL_SUCCESS;
 }
 
-/**
- *   @brief    Setting up realm
- *   @param    realm      - Realm strucrure
- *   @param    activate   - Boolean value for actiate realm
- *   @return   SUCCESS/FAILURE
-**/
-uint32_t val_host_realm_setup(val_host_realm_ts *realm, bool activate)
+static uint32_t val_host_realm_setup_steps(val_host_realm_ts *realm, bool activate)
 {
     /* Create realm */
     if (val_host_realm_create(realm))
@@ -1022,6 +1350,25 @@ uint32_t val_host_realm_setup(val_host_realm_ts *realm, bool activate)
    return VAL_SUCCESS;
 }
 
+/**
+ *   @brief    Setting up realm
+ *   @param    realm      - Realm strucrure
+ *   @param    activate   - Boolean value for actiate realm
+ *   @return   SUCCESS/FAILURE
+**/
+uint32_t val_host_realm_setup(val_host_realm_ts *realm, bool activate)
+{
+#ifdef VAL_TEST_PROFILE
+    val_host_profile_phase_te phase = val_host_profile_phase(VAL_HOST_PROFILE_SETUP);
+    uint32_t ret = val_host_realm_setup_steps(realm, activate);
+
+    val_host_profile_phase(phase);
+    return ret;
+#else
+    return val_host_realm_setup_steps(realm, activate);
+#endif
+}
+
 /**
  *   @brief    Set the default realm params
  *   @param    realm      - Realm structure
@@ -1079,6 +1426,355 @@ uint32_t val_host_check_realm_exit_psci(val_host_rec_run_ts *run, uint32_t psci_
     return VAL_ERROR;
 }
 
+/* Per-cpu shard of the NS list, so cpus tracking granules do not contend */
+typedef struct {
+    val_host_granule_ts *head;
+    val_host_granule_ts *tail;
+    s_lock_t lock;
+} val_host_ns_shard_ts;
+
+/* PA keyed index over all NS list shards */
+static val_host_granule_ts *granule_index[VAL_HOST_GRANULE_INDEX_SIZE];
+static val_host_ns_shard_ts ns_shard[PLATFORM_CPU_COUNT];
+
+/* Lock order is index stripe, then NS shard. Realm locks are never held
+   together with either of them. No lock is held across an RMI call. */
+static s_lock_t granule_index_lock[VAL_HOST_GRANULE_INDEX_LOCKS];
+/* Protects mem_track slot allocation and the realm index */
+static s_lock_t realm_slot_lock;
+
+#define VAL_HOST_GRANULE_INDEX(pa) \
+    (((pa) >> VAL_PAGE_SHIFT) & (VAL_HOST_GRANULE_INDEX_SIZE - 1))
+#define VAL_HOST_GRANULE_INDEX_LOCK(pa) \
+    (&granule_index_lock[VAL_HOST_GRANULE_INDEX(pa) & (VAL_HOST_GRANULE_INDEX_LOCKS - 1)])
+
+/**
+ *   @brief    Append the node to the NS list shard of the calling cpu and PA index
+ *   @param    node       - node pointer
+ *   @return   void
+**/
+static void val_host_ns_list_append(val_host_granule_ts *node)
+{
+    val_host_granule_ts **bucket = &granule_index[VAL_HOST_GRANULE_INDEX(node->PA)];
+    uint32_t shard_id = val_host_get_arena_index();
+    val_host_ns_shard_ts *shard = &ns_shard[shard_id];
+
+    node->next = NULL;
+    node->hash_next = NULL;
+    node->ns_shard = (uint8_t)shard_id;
+
+    val_spin_lock(VAL_HOST_GRANULE_INDEX_LOCK(node->PA));
+
+    /* Keep insertion order in the chain so lookup returns the oldest node first */
+    while (*bucket != NULL)
+        bucket = &(*bucket)->hash_next;
+    *bucket = node;
+
+    val_spin_lock(&shard->lock);
+    if (shard->head == NULL)
+    {
+        node->prev = NULL;
+        shard->head = node;
+        if (shard_id == 0)
+            mem_track[0].gran_type.ns = shard->head;
+    } else
+    {
+        node->prev = shard->tail;
+        shard->tail->next = node;
+    }
+    shard->tail = node;
+    val_spin_unlock(&shard->lock);
+
+    val_spin_unlock(VAL_HOST_GRANULE_INDEX_LOCK(node->PA));
+}
+
+/**
+ *   @brief    Unlink the node from its NS list shard and PA index
+ *   @param    node       - node pointer
+ *   @return   void
+**/
+static void val_host_ns_list_unlink(val_host_granule_ts *node)
+{
+    val_host_granule_ts **bucket = &granule_index[VAL_HOST_GRANULE_INDEX(node->PA)];
+    val_host_ns_shard_ts *shard = &ns_shard[node->ns_shard];
+
+    val_spin_lock(VAL_HOST_GRANULE_INDEX_LOCK(node->PA));
+
+    while (*bucket != NULL && *bucket != node)
+        bucket = &(*bucket)->hash_next;
+    if (*bucket != NULL)
+        *bucket = node->hash_next;
+
+    val_spin_lock(&shard->lock);
+    if (node->prev != NULL)
+        node->prev->next = node->next;
+    else
+        shard->head = node->next;
+
+    if (node->next != NULL)
+        node->next->prev = node->prev;
+    else
+        shard->tail = node->prev;
+
+    if (node->ns_shard == 0)
+        mem_track[0].gran_type.ns = shard->head;
+    val_spin_unlock(&shard->lock);
+
+    val_spin_unlock(VAL_HOST_GRANULE_INDEX_LOCK(node->PA));
+
+    node->next = NULL;
+    node->prev = NULL;
+    node->hash_next = NULL;
+}
+
+/**
+ *   @brief    Merge the NS list shards of all cpus into the shard of cpu 0
+ *   @param    void
+ *   @return   void
+**/
+static void val_host_ns_list_merge(void)
+{
+    val_host_ns_shard_ts *primary = &ns_shard[0], *shard;
+    val_host_granule_ts *node;
+    uint32_t i;
+
+    val_spin_lock(&primary->lock);
+    for (i = 1; i < PLATFORM_CPU_COUNT; i++)
+    {
+        shard = &ns_shard[i];
+        val_spin_lock(&shard->lock);
+        if (shard->head != NULL)
+        {
+            for (node = shard->head; node != NULL; node = node->next)
+                node->ns_shard = 0;
+
+            shard->head->prev = primary->tail;
+            if (primary->tail != NULL)
+                primary->tail->next = shard->head;
+            else
+                primary->head = shard->head;
+            primary->tail = shard->tail;
+
+            shard->head = NULL;
+            shard->tail = NULL;
+        }
+        val_spin_unlock(&shard->lock);
+    }
+    mem_track[0].gran_type.ns = primary->head;
+    val_spin_unlock(&primary->lock);
+}
+
+/**
+ *   @brief    Return the sort key of a granule in the realm data/RTT index
+ *   @param    ipa        - IPA of granule
+ *   @param    level      - RTT level, used only for RTT index
+ *   @param    is_rtt     - true for RTT index, false for data index
+ *   @return   Returns the index key
+**/
+static uint64_t val_host_index_key(uint64_t ipa, uint64_t level, bool is_rtt)
+{
+    if (!is_rtt)
+        return ipa;
+
+    /* Order by level leaf first, then by base of the IPA range covered by the RTT */
+    if (level > 0)
+        ipa = ADDR_ALIGN_DOWN(ipa, val_host_rtt_level_mapsize(level - 1));
+
+    return ((VAL_RTT_MAX_LEVEL - level) << 60) | (ipa >> VAL_PAGE_SHIFT);
+}
+
+static int32_t val_host_index_height(val_host_granule_ts *node)
+{
+    return (node == NULL) ? 0 : node->height;
+}
+
+static void val_host_index_update(val_host_granule_ts *node)
+{
+    int32_t l = val_host_index_height(node->left);
+    int32_t r = val_host_index_height(node->right);
+
+    node->height = ((l > r) ? l : r) + 1;
+}
+
+static val_host_granule_ts *val_host_index_rotate_right(val_host_granule_ts *node)
+{
+    val_host_granule_ts *pivot = node->left;
+
+    node->left = pivot->right;
+    pivot->right = node;
+    val_host_index_update(node);
+    val_host_index_update(pivot);
+    return pivot;
+}
+
+static val_host_granule_ts *val_host_index_rotate_left(val_host_granule_ts *node)
+{
+    val_host_granule_ts *pivot = node->right;
+
+    node->right = pivot->left;
+    pivot->left = node;
+    val_host_index_update(node);
+    val_host_index_update(pivot);
+    return pivot;
+}
+
+/**
+ *   @brief    Restore the AVL balance of the given subtree
+ *   @param    node       - subtree root
+ *   @return   Returns the new subtree root
+**/
+static val_host_granule_ts *val_host_index_balance(val_host_granule_ts *node)
+{
+    int32_t bf;
+
+    val_host_index_update(node);
+    bf = val_host_index_height(node->left) - val_host_index_height(node->right);
+
+    if (bf > 1)
+    {
+        if (val_host_index_height(node->left->left) < val_host_index_height(node->left->right))
+            node->left = val_host_index_rotate_left(node->left);
+        return val_host_index_rotate_right(node);
+    }
+
+    if (bf < -1)
+    {
+        if (val_host_index_height(node->right->right) < val_host_index_height(node->right->left))
+            node->right = val_host_index_rotate_right(node->right);
+        return val_host_index_rotate_left(node);
+    }
+
+    return node;
+}
+
+/**
+ *   @brief    Insert granule into a realm data/RTT index
+ *   @param    root       - index root
+ *   @param    node       - granule to insert
+ *   @param    is_rtt     - true for RTT index, false for data index
+ *   @return   Returns the new index root
+**/
+static val_host_granule_ts *val_host_index_insert(val_host_granule_ts *root,
+                                      val_host_granule_ts *node, bool is_rtt)
+{
+    if (root == NULL)
+    {
+        node->next = NULL;
+        node->left = NULL;
+        node->right = NULL;
+        node->height = 1;
+        return node;
+    }
+
+    if (val_host_index_key(node->ipa, node->level, is_rtt) <
+        val_host_index_key(root->ipa, root->level, is_rtt))
+        root->left = val_host_index_insert(root->left, node, is_rtt);
+    else
+        root->right = val_host_index_insert(root->right, node, is_rtt);
+
+    return val_host_index_balance(root);
+}
+
+/**
+ *   @brief    Detach the lowest keyed granule of the given subtree
+ *   @param    root       - subtree root
+ *   @param    min        - Pointer to store the detached granule
+ *   @return   Returns the new subtree root
+**/
+static val_host_granule_ts *val_host_index_remove_min(val_host_granule_ts *root,
+                                                  val_host_granule_ts **min)
+{
+    if (root->left == NULL)
+    {
+        *min = root;
+        return root->right;
+    }
+
+    root->left = val_host_index_remove_min(root->left, min);
+    return val_host_index_balance(root);
+}
+
+/**
+ *   @brief    Remove granule with given key from a realm data/RTT index
+ *   @param    root       - index root
+ *   @param    key        - index key of the granule
+ *   @param    is_rtt     - true for RTT index, false for data index
+ *   @param    removed    - Pointer to store the removed granule, NULL if not found
+ *   @return   Returns the new index root
+**/
+static val_host_granule_ts *val_host_index_remove(val_host_granule_ts *root, uint64_t key,
+                                      bool is_rtt, val_host_granule_ts **removed)
+{
+    val_host_granule_ts *min;
+    uint64_t root_key;
+
+    if (root == NULL)
+        return NULL;
+
+    root_key = val_host_index_key(root->ipa, root->level, is_rtt);
+    if (key < root_key)
+    {
+        root->left = val_host_index_remove(root->left, key, is_rtt, removed);
+    } else if (key > root_key) {
+        root->right = val_host_index_remove(root->right, key, is_rtt, removed);
+    } else {
+        *removed = root;
+        if (root->right == NULL)
+            return root->left;
+
+        root->right = val_host_index_remove_min(root->right, &min);
+        min->left = root->left;
+        min->right = root->right;
+        root = min;
+    }
+
+    return val_host_index_balance(root);
+}
+
+/**
+ *   @brief    Return the lowest keyed granule of a realm data/RTT index
+ *   @param    root       - index root
+ *   @return   Returns the granule or NULL for an empty index
+**/
+static val_host_granule_ts *val_host_index_min(val_host_granule_ts *root)
+{
+    while (root != NULL && root->left != NULL)
+        root = root->left;
+
+    return root;
+}
+
+/**
+ *   @brief    Return the node with the smallest key not below the given key
+ *   @param    root       - Index root
+ *   @param    key        - Index key
+ *   @param    is_rtt     - true for RTT index, false for data index
+ *   @return   Returns the node, NULL if all keys are below the given key
+**/
+static val_host_granule_ts *val_host_index_ceil(val_host_granule_ts *root, uint64_t key,
+                                                                        bool is_rtt)
+{
+    val_host_granule_ts *ceil = NULL;
+    uint64_t root_key;
+
+    while (root != NULL)
+    {
+        root_key = val_host_index_key(root->ipa, root->level, is_rtt);
+        if (root_key == key)
+            return root;
+
+        if (root_key > key)
+        {
+            ceil = root;
+            root = root->left;
+        } else {
+            root = root->right;
+        }
+    }
+
+    return ceil;
+}
+
 /**
  *   @brief    Add granule to the NS mem track[0]
  *   @param    state      - state of granule
@@ -1094,28 +1790,18 @@ void val_host_add_granule(uint32_t state, uint64_t PA, val_host_granule_ts *node
        else add node directly to the list */
     if (node == NULL)
     {
-        granule_list = (val_host_granule_ts *) mem_alloc(sizeof(val_host_granule_ts),
-                                                              sizeof(val_host_granule_ts));
+        granule_list = val_host_granule_node_alloc();
+        if (granule_list == NULL)
+            return;
         granule_list->state = state;
         granule_list->PA = PA;
-        granule_list->next = NULL;
         granule_list->is_granule_sliced = 0;
     } else
     {
         granule_list = node;
     }
 
-    if (head == NULL)
-    {
-        head = granule_list;
-        mem_track[0].gran_type.ns = head;
-        mem_track[0].gran_type.ns->next = NULL;
-        tail = granule_list;
-    } else
-    {
-        tail->next = granule_list;
-        tail = tail->next;
-    }
+    val_host_ns_list_append(granule_list);
 }
 
 /**
@@ -1125,16 +1811,116 @@ void val_host_add_granule(uint32_t state, uint64_t PA, val_host_granule_ts *node
 **/
 int val_host_get_curr_realm(uint64_t rd)
 {
-    int i;
+    uint32_t i;
+
+    val_spin_lock(&realm_slot_lock);
+    i = realm_rd_index[VAL_HOST_REALM_INDEX(rd)];
+    while (i != 0 && val_host_mem_track((int)i)->rd != rd)
+        i = val_host_mem_track((int)i)->rd_next;
+    val_spin_unlock(&realm_slot_lock);
+
+    return (int)i;
+}
+
+/**
+ *   @brief    Return the mem_track slot of a realm index
+ *   @param    realm_index   - realm index in mem track
+ *   @return   Returns the mem_track slot
+**/
+val_host_memory_track_ts *val_host_mem_track(int realm_index)
+{
+    uint32_t i = (uint32_t)realm_index;
+
+    return &mem_track_chunk[i / VAL_HOST_REALM_CHUNK_SLOTS][i % VAL_HOST_REALM_CHUNK_SLOTS];
+}
+
+/**
+ *   @brief    Allocate a mem_track slot for a realm and add it to the realm index.
+ *             Called with realm_slot_lock held.
+ *   @param    rd      -  Realm RD granule address
+ *   @return   Returns the realm index, 0 if the RD is tracked or no slot is left
+**/
+static int val_host_realm_slot_alloc(uint64_t rd)
+{
+    uint32_t i, *bucket = &realm_rd_index[VAL_HOST_REALM_INDEX(rd)];
+    val_host_memory_track_ts *chunk, *slot = NULL;
 
-    for (i = 1; i < VAL_HOST_MAX_REALMS; i++)
+    for (i = *bucket; i != 0; i = val_host_mem_track((int)i)->rd_next)
     {
-        if (mem_track[i].rd == rd)
+        if (val_host_mem_track((int)i)->rd == rd)
+        {
+            LOG(ERROR, "\tRealm already exists\n", 0, 0);
+            return 0;
+        }
+    }
+
+    for (i = 1; i < mem_track_count; i++)
+    {
+        slot = val_host_mem_track((int)i);
+        if (slot->rd == 0x00000000FFFFFFFF)
+            break;
+    }
+
+    if (i == mem_track_count)
+    {
+        if (mem_track_count == VAL_HOST_MAX_REALMS)
+        {
+            LOG(ERROR, "\tmax supported realms are VAL_HOST_MAX_REALMS\n", 0, 0);
+            return 0;
+        }
+
+        chunk = mem_alloc(sizeof(uint64_t),
+                          VAL_HOST_REALM_CHUNK_SLOTS * sizeof(val_host_memory_track_ts));
+        if (chunk == NULL)
+        {
+            LOG(ERROR, "\tFailed to allocate mem_track slots\n", 0, 0);
+            return 0;
+        }
+        val_memset(chunk, 0, VAL_HOST_REALM_CHUNK_SLOTS * sizeof(val_host_memory_track_ts));
+        for (i = 0; i < VAL_HOST_REALM_CHUNK_SLOTS; i++)
         {
-            return i;
+            chunk[i].rd = 0x00000000FFFFFFFF;
+            val_init_spinlock(&chunk[i].lock);
         }
+
+        i = mem_track_count;
+        mem_track_chunk[i / VAL_HOST_REALM_CHUNK_SLOTS] = chunk;
+        mem_track_count += VAL_HOST_REALM_CHUNK_SLOTS;
+        slot = val_host_mem_track((int)i);
     }
-    return 0;
+
+    slot->rd = rd;
+    slot->rd_next = *bucket;
+    slot->owner = val_host_get_arena_index();
+    *bucket = i;
+
+    return (int)i;
+}
+
+/**
+ *   @brief    Remove a realm slot from the realm index and free it.
+ *             Called with realm_slot_lock held.
+ *   @param    realm_index   - realm index in mem track
+ *   @return   void
+**/
+static void val_host_realm_slot_free(int realm_index)
+{
+    val_host_memory_track_ts *slot = val_host_mem_track(realm_index);
+    uint32_t *link = &realm_rd_index[VAL_HOST_REALM_INDEX(slot->rd)];
+
+    while (*link != 0 && *link != (uint32_t)realm_index)
+        link = &val_host_mem_track((int)*link)->rd_next;
+    if (*link != 0)
+        *link = slot->rd_next;
+
+    slot->rd = 0x00000000FFFFFFFF;
+    slot->rd_next = 0;
+
+    if (slot->ripas != NULL)
+        val_host_mem_free(slot->ripas);
+    slot->ripas = NULL;
+    slot->ripas_count = 0;
+    slot->ripas_capacity = 0;
 }
 
 /**
@@ -1149,8 +1935,8 @@ int val_host_get_curr_realm(uint64_t rd)
 void val_host_update_granule_state(uint64_t rd, uint32_t state, uint64_t PA,
                                                uint64_t ipa, uint64_t rtt_level)
 {
-    val_host_granule_ts *granule_node = NULL;
-    int i;
+    val_host_granule_ts *granule_node = NULL, *current;
+    int current_realm = 0;
 
     /* Get the current realm index for given realm rd */
     if (state != GRANULE_DELEGATED)
@@ -1164,29 +1950,34 @@ void val_host_update_granule_state(uint64_t rd, uint32_t state, uint64_t PA,
     /* if node is not found add to the NS/VALID_NS list */
     if (granule_node == NULL)
     {
-        val_host_granule_ts *granule_list_delegated =
-                             (val_host_granule_ts *) mem_alloc(sizeof(val_host_granule_ts),
-                                                                    sizeof(val_host_granule_ts));
+        val_host_granule_ts *granule_list_delegated = val_host_granule_node_alloc();
+
+        if (granule_list_delegated == NULL)
+            return;
+        if (state == GRANULE_DELEGATED)
+            val_host_mem_pin(PA);
+
         granule_list_delegated->rd = rd;
         granule_list_delegated->state = state;
         granule_list_delegated->PA = PA;
         granule_list_delegated->ipa = ipa;
         granule_list_delegated->level = rtt_level;
         granule_list_delegated->next = NULL;
+        granule_list_delegated->is_granule_sliced = 0;
 
         if (state == GRANULE_DELEGATED)
         {
             granule_list_delegated->is_granule_sliced = 1;
-            tail->next = granule_list_delegated;
-            tail = tail->next;
+            val_host_ns_list_append(granule_list_delegated);
         }
 
         if (state == GRANULE_UNPROTECTED)
         {
-            current = mem_track[current_realm].gran_type.valid_ns;
+            val_spin_lock(&val_host_mem_track(current_realm)->lock);
+            current = val_host_mem_track(current_realm)->gran_type.valid_ns;
             if (current == NULL)
             {
-                 mem_track[current_realm].gran_type.valid_ns = granule_list_delegated;
+                 val_host_mem_track(current_realm)->gran_type.valid_ns = granule_list_delegated;
             } else
             {
                 while (current->next != NULL)
@@ -1195,21 +1986,22 @@ void val_host_update_granule_state(uint64_t rd, uint32_t state, uint64_t PA,
                 }
                 current->next = granule_list_delegated;
             }
+            val_spin_unlock(&val_host_mem_track(current_realm)->lock);
         }
         return;
     }
 
     /* Update state from NS mem_track or remove node and add to the respective state list */
-    current = head;
 
     switch (state)
     {
         case GRANULE_DELEGATED:
             granule_node->state = state;
+            val_host_mem_pin(PA);
             break;
 
         case GRANULE_RD:
-            val_host_remove_granule(&mem_track[0].gran_type.ns, PA);
+            val_host_ns_list_unlink(granule_node);
             granule_node->rd = rd;
             granule_node->state = state;
             granule_node->ipa = ipa;
@@ -1217,34 +2009,26 @@ void val_host_update_granule_state(uint64_t rd, uint32_t state, uint64_t PA,
             granule_node->next = NULL;
 
             /* Add realm rd to the mem_track */
-            for (i = 1; i < VAL_HOST_MAX_REALMS; i++)
-            {
-                if (mem_track[i].rd == PA)
-                {
-                    LOG(ERROR, "\tRealm already exists\n", 0, 0);
-                    break;
-                } else if (mem_track[i].rd == 0x00000000FFFFFFFF) {
-                    current_realm = i;
-                    mem_track[current_realm].rd = PA;
-                    break;
-                }
-            }
-
-            mem_track[current_realm].gran_type.rd = granule_node;
+            val_spin_lock(&realm_slot_lock);
+            current_realm = val_host_realm_slot_alloc(PA);
+            val_host_mem_track(current_realm)->gran_type.rd = granule_node;
+            val_spin_unlock(&realm_slot_lock);
             break;
 
         case GRANULE_REC:
-            val_host_remove_granule(&mem_track[0].gran_type.ns, PA);
+            val_host_ns_list_unlink(granule_node);
             granule_node->rd = rd;
             granule_node->state = state;
             granule_node->ipa = ipa;
             granule_node->level = rtt_level;
             granule_node->next = NULL;
-            current = mem_track[current_realm].gran_type.rec;
+
+            val_spin_lock(&val_host_mem_track(current_realm)->lock);
+            current = val_host_mem_track(current_realm)->gran_type.rec;
 
             if (current == NULL)
             {
-                 mem_track[current_realm].gran_type.rec = granule_node;
+                 val_host_mem_track(current_realm)->gran_type.rec = granule_node;
             } else {
                 while (current->next != NULL)
                 {
@@ -1252,64 +2036,54 @@ void val_host_update_granule_state(uint64_t rd, uint32_t state, uint64_t PA,
                 }
                 current->next = granule_node;
             }
+            val_spin_unlock(&val_host_mem_track(current_realm)->lock);
 
             break;
 
         case GRANULE_RTT:
-            val_host_remove_granule(&mem_track[0].gran_type.ns, PA);
+            val_host_ns_list_unlink(granule_node);
             granule_node->rd = rd;
             granule_node->state = state;
             granule_node->ipa = ipa;
             granule_node->level = rtt_level;
             granule_node->next = NULL;
 
-            current = mem_track[current_realm].gran_type.rtt;
-            if (current == NULL)
-            {
-                 mem_track[current_realm].gran_type.rtt = granule_node;
-            } else {
-                while (current->next != NULL)
-                {
-                    current = current->next;
-                }
-                current->next = granule_node;
-            }
+            val_spin_lock(&val_host_mem_track(current_realm)->lock);
+            val_host_mem_track(current_realm)->gran_type.rtt =
+                    val_host_index_insert(val_host_mem_track(current_realm)->gran_type.rtt,
+                                          granule_node, true);
+            val_spin_unlock(&val_host_mem_track(current_realm)->lock);
 
             break;
 
         case GRANULE_DATA:
-            val_host_remove_granule(&mem_track[0].gran_type.ns, PA);
+            val_host_ns_list_unlink(granule_node);
             granule_node->rd = rd;
             granule_node->state = state;
             granule_node->ipa = ipa;
             granule_node->level = rtt_level;
             granule_node->next = NULL;
 
-            current = mem_track[current_realm].gran_type.data;
-            if (current == NULL)
-            {
-                 mem_track[current_realm].gran_type.data = granule_node;
-            } else {
-                while (current->next != NULL)
-                {
-                    current = current->next;
-                }
-                current->next = granule_node;
-            }
+            val_spin_lock(&val_host_mem_track(current_realm)->lock);
+            val_host_mem_track(current_realm)->gran_type.data =
+                    val_host_index_insert(val_host_mem_track(current_realm)->gran_type.data,
+                                          granule_node, false);
+            val_spin_unlock(&val_host_mem_track(current_realm)->lock);
 
             break;
 
         case GRANULE_UNPROTECTED:
-            val_host_remove_granule(&mem_track[0].gran_type.ns, PA);
+            val_host_ns_list_unlink(granule_node);
             granule_node->rd = rd;
             granule_node->ipa = ipa;
             granule_node->level = rtt_level;
             granule_node->next = NULL;
 
-            current = mem_track[current_realm].gran_type.valid_ns;
+            val_spin_lock(&val_host_mem_track(current_realm)->lock);
+            current = val_host_mem_track(current_realm)->gran_type.valid_ns;
             if (current == NULL)
             {
-                 mem_track[current_realm].gran_type.valid_ns = granule_node;
+                 val_host_mem_track(current_realm)->gran_type.valid_ns = granule_node;
             } else {
                 while (current->next != NULL)
                 {
@@ -1317,6 +2091,7 @@ void val_host_update_granule_state(uint64_t rd, uint32_t state, uint64_t PA,
                 }
                 current->next = granule_node;
             }
+            val_spin_unlock(&val_host_mem_track(current_realm)->lock);
 
             break;
 
@@ -1332,16 +2107,19 @@ void val_host_update_granule_state(uint64_t rd, uint32_t state, uint64_t PA,
 **/
 val_host_granule_ts *val_host_find_granule(uint64_t PA)
 {
-    val_host_granule_ts *find = head;
+    val_host_granule_ts *find;
 
+    val_spin_lock(VAL_HOST_GRANULE_INDEX_LOCK(PA));
+    find = granule_index[VAL_HOST_GRANULE_INDEX(PA)];
     while (find != NULL)
     {
         if (find->PA == PA)
-            return find;
-        find = find->next;
+            break;
+        find = find->hash_next;
     }
+    val_spin_unlock(VAL_HOST_GRANULE_INDEX_LOCK(PA));
 
-    return NULL;
+    return find;
 }
 
 /**
@@ -1352,57 +2130,35 @@ val_host_granule_ts *val_host_find_granule(uint64_t PA)
 **/
 val_host_granule_ts *val_host_remove_granule(val_host_granule_ts **gran_list_head, uint64_t PA)
 {
-    val_host_granule_ts *current = *gran_list_head, *prev = NULL, *temp = NULL;
+    val_host_granule_ts *current = *gran_list_head, *prev = NULL;
 
-    temp = mem_track[0].gran_type.ns;
-
-    if ((current != NULL) && (current->PA == PA))
+    /* NS mem_track list is indexed by PA */
+    if (gran_list_head == &mem_track[0].gran_type.ns)
     {
-        /* If its NS mem_track list update head */
-        if (temp == *gran_list_head)
-        {
-            head = current->next;
-            mem_track[0].gran_type.ns = head;
-            current->next = NULL;
-            return current;
-        } else {
-            prev = current;
-            current = current->next;
-            *gran_list_head = current;
-            prev->next = NULL;
-            return prev;
-        }
+        current = val_host_find_granule(PA);
+        if (current != NULL)
+            val_host_ns_list_unlink(current);
+        return current;
     }
 
     while (NULL != current)
     {
-        if (current->PA != PA)
-        {
-            prev = current;
-            current = current->next;
-        } else {
+        if (current->PA == PA)
             break;
-        }
+        prev = current;
+        current = current->next;
     }
 
     if (current == NULL)
         return NULL;
-    else if (current->PA == PA)
-    {
-        prev->next = current->next;
-        if (mem_track[0].gran_type.ns == *gran_list_head)
-        {
-            if (current->next == NULL)
-                tail = prev;
-        }
-        current->next = NULL;
-        return current;
-    } else {
-        return NULL;
-    }
 
-    return NULL;
+    if (prev == NULL)
+        *gran_list_head = current->next;
+    else
+        prev->next = current->next;
 
+    current->next = NULL;
+    return current;
 }
 
 /**
@@ -1420,22 +2176,19 @@ void val_host_update_destroy_granule_state(uint64_t rd, uint64_t PA,
                            uint32_t state, uint32_t gran_list_state)
 {
     val_host_granule_ts *node = NULL;
-    int i;
+    int i, current_realm = 0;
 
     if (state == GRANULE_UNDELEGATED)
     {
-        node = val_host_find_granule(PA);
+        val_host_mem_unpin(PA);
+        node = val_host_remove_granule(&mem_track[0].gran_type.ns, PA);
         if (node != NULL)
         {
+            /* Sliced granules belong to a larger allocation which is freed
+               once its last granule is undelegated */
             if (node->is_granule_sliced == 0)
-            {
-                node = val_host_remove_granule(&mem_track[0].gran_type.ns, PA);
                 val_host_mem_free((void *)node->PA);
-                val_host_mem_free(node);
-                return;
-            } else if (node->is_granule_sliced == 1) {
-                     node->state = state;
-            }
+            val_host_granule_node_free(node);
         }
         return;
     }
@@ -1448,20 +2201,30 @@ void val_host_update_destroy_granule_state(uint64_t rd, uint64_t PA,
     switch (gran_list_state)
     {
         case GRANULE_RTT:
-            node = val_host_remove_rtt_granule(&mem_track[current_realm].gran_type.rtt, ipa, level);
+            val_spin_lock(&val_host_mem_track(current_realm)->lock);
+            node = val_host_remove_rtt_granule(&val_host_mem_track(current_realm)->gran_type.rtt, ipa, level);
+            val_spin_unlock(&val_host_mem_track(current_realm)->lock);
+            if (node == NULL)
+                break;
             node->state = state;
             val_host_add_granule(state, node->PA, node);
             break;
         case GRANULE_DATA:
-            node = val_host_remove_data_granule(&mem_track[current_realm].gran_type.data, ipa);
+            val_spin_lock(&val_host_mem_track(current_realm)->lock);
+            node = val_host_remove_data_granule(&val_host_mem_track(current_realm)->gran_type.data, ipa);
+            val_spin_unlock(&val_host_mem_track(current_realm)->lock);
+            if (node == NULL)
+                break;
             node->state = state;
             val_host_add_granule(state, node->PA, node);
             break;
 
         case GRANULE_REC:
-            for (i = 1; i < VAL_HOST_MAX_REALMS; i++)
+            for (i = 1; i < (int)mem_track_count; i++)
             {
-                node = val_host_remove_granule(&mem_track[i].gran_type.rec, PA);
+                val_spin_lock(&val_host_mem_track(i)->lock);
+                node = val_host_remove_granule(&val_host_mem_track(i)->gran_type.rec, PA);
+                val_spin_unlock(&val_host_mem_track(i)->lock);
                 if (node != NULL)
                 {
                     node->state = state;
@@ -1472,14 +2235,23 @@ void val_host_update_destroy_granule_state(uint64_t rd, uint64_t PA,
             break;
 
         case GRANULE_RD:
-            node = val_host_remove_granule(&mem_track[current_realm].gran_type.rd, PA);
+            val_spin_lock(&realm_slot_lock);
+            node = val_host_remove_granule(&val_host_mem_track(current_realm)->gran_type.rd, PA);
+            if (node != NULL && current_realm != 0)
+                val_host_realm_slot_free(current_realm);
+            val_spin_unlock(&realm_slot_lock);
+            if (node == NULL)
+                break;
             node->state = state;
             val_host_add_granule(state, PA, node);
-            mem_track[current_realm].rd = 0x00000000FFFFFFFF;
             break;
 
         case GRANULE_UNPROTECTED:
-            node = val_host_remove_granule(&mem_track[current_realm].gran_type.valid_ns, PA);
+            val_spin_lock(&val_host_mem_track(current_realm)->lock);
+            node = val_host_remove_granule(&val_host_mem_track(current_realm)->gran_type.valid_ns, PA);
+            val_spin_unlock(&val_host_mem_track(current_realm)->lock);
+            if (node == NULL)
+                break;
             node->state = GRANULE_UNDELEGATED;
             val_host_add_granule(state, PA, node);
             break;
@@ -1487,162 +2259,162 @@ void val_host_update_destroy_granule_state(uint64_t rd, uint64_t PA,
 }
 
 /**
- *   @brief    Remove data granule from data list and add to the NS mem_track
- *   @param    gran_list_head      - Data granule which needs to remove from data list
- *                                   and add to NS mem track
- *   @param    ipa                 - IPA which needs to remove from data list
- *   @return   Returns the node from data list
+ *   @brief    Remove data granule from the realm data index
+ *   @param    gran_list_head      - Root of the realm data index
+ *   @param    ipa                 - IPA which needs to remove from data index
+ *   @return   Returns the removed node from data index
 **/
 val_host_granule_ts *val_host_remove_data_granule(val_host_granule_ts **gran_list_head,
                                                                           uint64_t ipa)
 {
-    val_host_granule_ts *current = *gran_list_head, *prev = NULL, *temp = NULL;
+    val_host_granule_ts *node = NULL;
 
-    temp = mem_track[0].gran_type.ns;
-    if ((current != NULL) && (current->ipa == ipa))
-    {
-        if (temp == *gran_list_head)
-        {
-            head = current->next;
-            mem_track[0].gran_type.ns = head;
-            current->next = NULL;
-            return current;
-        } else {
-            prev = current;
-            current = current->next;
-            *gran_list_head = current;
-            prev->next = NULL;
-            return prev;
-        }
-    }
+    *gran_list_head = val_host_index_remove(*gran_list_head,
+                                  val_host_index_key(ipa, 0, false), false, &node);
+    return node;
+}
 
-    while (NULL != current)
-    {
-        if (current->ipa != ipa)
-        {
-            prev = current;
-            current = current->next;
-        } else {
-            break;
-        }
-    }
+/**
+ *   @brief    Remove RTT granule from the realm RTT index
+ *   @param    gran_list_head      - Root of the realm RTT index
+ *   @param    ipa                 - Base IPA of the RTT which needs to remove from RTT index
+ *   @param    level               - RTT level
+ *   @return   Returns the removed node from RTT index
+**/
+val_host_granule_ts *val_host_remove_rtt_granule(val_host_granule_ts **gran_list_head,
+                                                         uint64_t ipa, uint64_t level)
+{
+    val_host_granule_ts *node = NULL;
 
-    if (current == NULL)
-        return NULL;
-    else if (current->ipa == ipa)
-    {
-        prev->next = current->next;
-        if (mem_track[0].gran_type.ns == *gran_list_head)
-        {
-            if (current->next == NULL)
-                tail = prev;
-        }
-        current->next = NULL;
-        return current;
-    } else {
-        return NULL;
-    }
+    *gran_list_head = val_host_index_remove(*gran_list_head,
+                                  val_host_index_key(ipa, level, true), true, &node);
+    return node;
+}
 
-    return NULL;
+/**
+ *   @brief    Find the RTT covering the given IPA at the given level
+ *   @param    realm_index   - realm index in mem track
+ *   @param    ipa           - IPA within the range covered by the RTT
+ *   @param    level         - RTT level
+ *   @return   Returns the RTT granule, NULL if there is none
+**/
+val_host_granule_ts *val_host_find_rtt_granule(int realm_index, uint64_t ipa, uint64_t level)
+{
+    val_host_granule_ts *node;
+    uint64_t key = val_host_index_key(ipa, level, true);
+
+    val_spin_lock(&val_host_mem_track(realm_index)->lock);
+    node = val_host_index_ceil(val_host_mem_track(realm_index)->gran_type.rtt, key, true);
+    if (node != NULL && val_host_index_key(node->ipa, node->level, true) != key)
+        node = NULL;
+    val_spin_unlock(&val_host_mem_track(realm_index)->lock);
+
+    return node;
 }
 
 /**
- *   @brief    Remove data granule from data list and add to the NS mem_track
- *   @param    gran_list_head      - Data granule which needs to remove from data list
- *                                   and add to NS mem track
- *   @param    ipa                 - IPA which needs to remove from data list
- *   @return   Returns the node from data list
+ *   @brief    Find the data granule with the lowest IPA in the given IPA range
+ *   @param    realm_index   - realm index in mem track
+ *   @param    base          - Base of IPA range
+ *   @param    top           - Top of IPA range
+ *   @return   Returns the data granule, NULL if there is none
 **/
-val_host_granule_ts *val_host_remove_rtt_granule(val_host_granule_ts **gran_list_head,
-                                                         uint64_t ipa, uint64_t level)
+val_host_granule_ts *val_host_find_data_granule(int realm_index, uint64_t base, uint64_t top)
 {
-    val_host_granule_ts *current = *gran_list_head, *prev = NULL, *temp = NULL;
+    val_host_granule_ts *node;
 
-    temp = mem_track[0].gran_type.ns;
-    if ((current != NULL) && (current->level == level) && (current->ipa == ipa))
-    {
-        if (temp == *gran_list_head)
-        {
-            head = current->next;
-            mem_track[0].gran_type.ns = head;
-            current->next = NULL;
-            return current;
-        } else {
-            prev = current;
-            current = current->next;
-            *gran_list_head = current;
-            prev->next = NULL;
-            return prev;
-        }
-    }
+    val_spin_lock(&val_host_mem_track(realm_index)->lock);
+    node = val_host_index_ceil(val_host_mem_track(realm_index)->gran_type.data, base, false);
+    if (node != NULL && node->ipa >= top)
+        node = NULL;
+    val_spin_unlock(&val_host_mem_track(realm_index)->lock);
 
-    while (NULL != current)
-    {
-        if ((current->level != level) || (current->ipa != ipa))
-        {
-            prev = current;
-            current = current->next;
-        } else {
-            break;
-        }
-    }
+    return node;
+}
 
-    if (current == NULL)
-        return NULL;
-    else if ((current->level == level) && (current->ipa == ipa))
+/**
+ *   @brief    Find the unprotected mapping of the given IPA at the given level
+ *   @param    realm_index   - realm index in mem track
+ *   @param    ipa           - IPA of mapping
+ *   @param    level         - RTT level of mapping
+ *   @return   Returns the unprotected granule, NULL if there is none
+**/
+val_host_granule_ts *val_host_find_unprotected_granule(int realm_index, uint64_t ipa,
+                                                                      uint64_t level)
+{
+    val_host_granule_ts *node;
+
+    val_spin_lock(&val_host_mem_track(realm_index)->lock);
+    node = val_host_mem_track(realm_index)->gran_type.valid_ns;
+    while (node != NULL && (node->ipa != ipa || node->level != level))
+        node = node->next;
+    val_spin_unlock(&val_host_mem_track(realm_index)->lock);
+
+    return node;
+}
+
+/**
+ *   @brief    Find the REC granule of the given PA in any realm
+ *   @param    rec           - PA of the REC
+ *   @return   Returns the REC granule, NULL if there is none
+**/
+val_host_granule_ts *val_host_find_rec_granule(uint64_t rec)
+{
+    val_host_granule_ts *node = NULL;
+    uint32_t i;
+
+    for (i = 1; i < mem_track_count && node == NULL; i++)
     {
-        prev->next = current->next;
-        if (mem_track[0].gran_type.ns == *gran_list_head)
-        {
-            if (current->next == NULL)
-                tail = prev;
-        }
-        current->next = NULL;
-        return current;
-    } else {
-        return NULL;
+        val_spin_lock(&val_host_mem_track((int)i)->lock);
+        node = val_host_mem_track((int)i)->gran_type.rec;
+        while (node != NULL && node->PA != rec)
+            node = node->next;
+        val_spin_unlock(&val_host_mem_track((int)i)->lock);
     }
 
-    return NULL;
+    return node;
 }
 
 /**
- *   @brief    Destroy rtt levels
- *   @param    rtt_level      - RTT level to destroy
+ *   @brief    Destroy and undelegate RTTs at given level and all levels below it.
+ *             The RTT index is ordered leaf level first, so RTTs are destroyed
+ *             in a single ordered sweep from the lowest keyed entry.
+ *   @param    rtt_level      - Lowest RTT level to destroy
  *   @param    current_realm  - current realm index in mem track
  *   @return   SUCCESS/FAILURE
 **/
 uint64_t val_host_destroy_rtt_levels(uint64_t rtt_level, int current_realm)
 {
-    val_host_granule_ts *curr_gran = NULL, *next_gran = NULL;
-    uint64_t ret;
+    val_host_granule_ts *curr_gran = NULL;
+    uint64_t ret, pa;
     val_host_rtt_destroy_ts rtt_destroy;
 
-    curr_gran = mem_track[current_realm].gran_type.rtt;
-    while (curr_gran != NULL)
+    while ((curr_gran = val_host_index_min(val_host_mem_track(current_realm)->gran_type.rtt)) != NULL)
     {
-        next_gran = curr_gran->next;
-        if (curr_gran->level == rtt_level)
+        if (curr_gran->level < rtt_level)
+            break;
+
+        pa = curr_gran->PA;
+        ret = val_host_rmi_rtt_destroy(curr_gran->rd,
+                                       curr_gran->ipa, curr_gran->level, &rtt_destroy);
+        if (ret)
         {
+            LOG(ERROR, "\trealm_rtt_destroy failed, rtt=0x%x, ret=0x%x\n", curr_gran->ipa, ret);
+            return VAL_ERROR;
+        }
 
-            ret = val_host_rmi_rtt_destroy(curr_gran->rd,
-                                           curr_gran->ipa, curr_gran->level, &rtt_destroy);
-            if (ret)
-            {
-                LOG(ERROR, "\trealm_rtt_destroy failed, rtt=0x%x, ret=0x%x\n", curr_gran->ipa, ret);
-                return VAL_ERROR;
-            }
-            ret = val_host_rmi_granule_undelegate(curr_gran->PA);
-            if (ret)
-            {
-                LOG(ERROR, "\tval_rmi_granule_undelegate failed, rtt=0x%x, ret=0x%x\n",
-                                                                   curr_gran->PA, ret);
-                return VAL_ERROR;
-            }
+        if (val_host_index_min(val_host_mem_track(current_realm)->gran_type.rtt) == curr_gran)
+        {
+            LOG(ERROR, "\tRTT not released from mem_track, ipa=0x%x\n", curr_gran->ipa, 0);
+            return VAL_ERROR;
+        }
 
-            curr_gran = next_gran;
-        } else {
-            curr_gran = next_gran;
+        ret = val_host_granule_pool_release(pa);
+        if (ret)
+        {
+            LOG(ERROR, "\tval_rmi_granule_undelegate failed, rtt=0x%x, ret=0x%x\n",
+                                                                   pa, ret);
+            return VAL_ERROR;
         }
     }
     return VAL_SUCCESS;
@@ -1659,11 +2431,17 @@ uint64_t val_host_postamble(void)
     uint64_t ret;
     val_host_granule_ts *curr_gran = NULL, *next_gran = NULL;
 
-    for (i = 1 ; i < VAL_HOST_MAX_REALMS ; i++)
+    /* Pooled granules stay delegated in NS mem_track and are undelegated below */
+    val_host_granule_pool_drain();
+
+    /* Secondary cpus are idle now, collect their NS granules on mem_track[0] */
+    val_host_ns_list_merge();
+
+    for (i = 1 ; i < (int)mem_track_count ; i++)
     {
-        if (mem_track[i].rd != 0x00000000FFFFFFFF)
+        if (val_host_mem_track(i)->rd != 0x00000000FFFFFFFF)
         {
-            ret = val_host_realm_destroy((uint64_t)mem_track[i].rd);
+            ret = val_host_realm_destroy((uint64_t)val_host_mem_track(i)->rd);
             if (ret)
             {
                 LOG(ERROR, "\tval_host_realm_destroy failed, ret=0x%x\n", ret, 0);
@@ -1707,7 +2485,7 @@ uint64_t val_host_postamble(void)
                 next_gran = curr_gran->next;
                 node_temp1 = val_host_remove_granule(&mem_track[0].gran_type.ns, curr_gran->PA);
                 val_host_mem_free((void *)node_temp1->PA);
-                val_host_mem_free(node_temp1);
+                val_host_granule_node_free(node_temp1);
                 curr_gran = next_gran;
 
             } else {
@@ -1719,6 +2497,106 @@ uint64_t val_host_postamble(void)
     return VAL_SUCCESS;
 }
 
+/**
+ *   @brief    Return a realm created by a cpu
+ *   @param    cpu      - Logical cpuid of the creator
+ *   @return   Returns the RD of the realm, 0 if the cpu has no realm left
+**/
+static uint64_t val_host_find_cpu_realm(uint32_t cpu)
+{
+    val_host_memory_track_ts *slot;
+    uint64_t rd = 0;
+    uint32_t i;
+
+    val_spin_lock(&realm_slot_lock);
+    for (i = 1; i < mem_track_count; i++)
+    {
+        slot = val_host_mem_track((int)i);
+        if (slot->rd != 0x00000000FFFFFFFF && slot->owner == cpu)
+        {
+            rd = slot->rd;
+            break;
+        }
+    }
+    val_spin_unlock(&realm_slot_lock);
+
+    return rd;
+}
+
+/**
+ *   @brief    Return a granule of a NS list shard in the given state. Delegated
+ *             granules that went through the granule pool are skipped, they may
+ *             be in use by another cpu.
+ *   @param    shard_id   - NS list shard
+ *   @param    state      - Granule state
+ *   @return   Returns the PA of the granule, 0 if there is none
+**/
+static uint64_t val_host_ns_shard_find(uint32_t shard_id, uint32_t state)
+{
+    val_host_ns_shard_ts *shard = &ns_shard[shard_id];
+    val_host_granule_ts *node;
+    uint64_t pa = 0;
+
+    val_spin_lock(&shard->lock);
+    for (node = shard->head; node != NULL; node = node->next)
+    {
+        if (node->state == state &&
+            (state != GRANULE_DELEGATED || !node->is_granule_pooled))
+        {
+            pa = node->PA;
+            break;
+        }
+    }
+    val_spin_unlock(&shard->lock);
+
+    return pa;
+}
+
+/**
+ *   @brief    Rollback the changes of the calling cpu while other cpus run tests.
+ *             The realms the cpu created are destroyed and the granules of its
+ *             NS list shard are undelegated and freed. The granule pool is left
+ *             to val_host_postamble, once every cpu is done.
+ *   @param    void
+ *   @return   SUCCESS/FAILURE
+**/
+uint64_t val_host_postamble_cpu(void)
+{
+    uint32_t cpu = val_host_get_arena_index();
+    val_host_granule_ts *node;
+    uint64_t ret, pa;
+
+    while ((pa = val_host_find_cpu_realm(cpu)) != 0)
+    {
+        ret = val_host_realm_destroy(pa);
+        if (ret)
+        {
+            LOG(ERROR, "\tval_host_realm_destroy failed, ret=0x%x\n", ret, 0);
+            return VAL_ERROR;
+        }
+    }
+
+    /* Undelegation removes the granule from the shard */
+    while ((pa = val_host_ns_shard_find(cpu, GRANULE_DELEGATED)) != 0)
+    {
+        ret = val_host_rmi_granule_undelegate(pa);
+        if (ret)
+        {
+            LOG(ERROR, "\tgranule undelegation failed, pa=0x%x, ret=0x%x\n", pa, ret);
+            return VAL_ERROR;
+        }
+    }
+
+    while ((pa = val_host_ns_shard_find(cpu, GRANULE_UNDELEGATED)) != 0)
+    {
+        node = val_host_remove_granule(&mem_track[0].gran_type.ns, pa);
+        val_host_mem_free((void *)node->PA);
+        val_host_granule_node_free(node);
+    }
+
+    return VAL_SUCCESS;
+}
+
 /**
  *   @brief    Destroy Realm
  *   @param    rd      -  Realm RD granule address
@@ -1729,11 +2607,11 @@ uint32_t val_host_realm_destroy(uint64_t rd)
     uint64_t ret;
     val_host_granule_ts *curr_gran = NULL, *next_gran = NULL;
     val_host_data_destroy_ts data_destroy;
-    current_realm = val_host_get_curr_realm(rd);
-    uint64_t top;
+    int current_realm = val_host_get_curr_realm(rd);
+    uint64_t top, pa;
 
     /* For each REC - Destroy, undelegate */
-    curr_gran = mem_track[current_realm].gran_type.rec;
+    curr_gran = val_host_mem_track(current_realm)->gran_type.rec;
     while (curr_gran != NULL)
     {
         next_gran = curr_gran->next;
@@ -1744,7 +2622,7 @@ uint32_t val_host_realm_destroy(uint64_t rd)
             return VAL_ERROR;
         }
 
-        ret = val_host_rmi_granule_undelegate(curr_gran->PA);
+        ret = val_host_granule_pool_release(curr_gran->PA);
         if (ret)
         {
             LOG(ERROR, "\trec undelegation failed, rec=0x%x, ret=0x%x\n", curr_gran->PA, ret);
@@ -1753,57 +2631,41 @@ uint32_t val_host_realm_destroy(uint64_t rd)
        curr_gran = next_gran;
     }
 
-    // Destroy and undelegate realm protected granules
-    curr_gran = mem_track[current_realm].gran_type.data;
-    while (curr_gran != NULL)
+    // Destroy and undelegate realm protected granules in IPA order
+    while ((curr_gran = val_host_index_min(val_host_mem_track(current_realm)->gran_type.data)) != NULL)
     {
-        next_gran = curr_gran->next;
-        if (curr_gran->is_granule_sliced == 1)
+        pa = curr_gran->PA;
+        ret = val_host_rmi_data_destroy(curr_gran->rd, curr_gran->ipa, &data_destroy);
+        if (RMI_STATUS(ret) == RMI_ERROR_RTT && RMI_INDEX(ret) < VAL_RTT_MAX_LEVEL)
         {
-            ret = val_host_rmi_data_destroy(curr_gran->rd, curr_gran->ipa, &data_destroy);
-            if (ret)
-            {
-                LOG(ERROR, "\tData destroy failed, data=0x%x, ret=0x%x\n", curr_gran->PA, ret);
+            /* Granule is part of a folded block, unfold it and retry */
+            if (val_host_rtt_unfold(curr_gran->rd, curr_gran->ipa, RMI_INDEX(ret)))
                 return VAL_ERROR;
-            }
+            continue;
+        }
 
-            ret = val_host_rmi_granule_undelegate(curr_gran->PA);
-            if (ret)
-            {
-                LOG(ERROR, "\tdata undelegation failed, pa=0x%x, ret=0x%x\n", curr_gran->PA, ret);
-                return VAL_ERROR;
-            }
+        if (ret)
+        {
+            LOG(ERROR, "\tData destroy failed, data=0x%x, ret=0x%x\n", pa, ret);
+            return VAL_ERROR;
         }
-        curr_gran = next_gran;
-    }
 
-    curr_gran = mem_track[current_realm].gran_type.data;
-    while (curr_gran != NULL)
-    {
-        next_gran = curr_gran->next;
-        if (curr_gran->is_granule_sliced == 0)
+        if (val_host_index_min(val_host_mem_track(current_realm)->gran_type.data) == curr_gran)
         {
-            ret = val_host_rmi_data_destroy(curr_gran->rd, curr_gran->ipa, &data_destroy);
-            if (ret)
-            {
-                LOG(ERROR, "\tData destroy failed, data=0x%x, ret=0x%x\n", curr_gran->PA, ret);
-                return VAL_ERROR;
-            }
+            LOG(ERROR, "\tData not released from mem_track, ipa=0x%x\n", curr_gran->ipa, 0);
+            return VAL_ERROR;
+        }
 
-            ret = val_host_rmi_granule_undelegate(curr_gran->PA);
-            if (ret)
-            {
-                LOG(ERROR, "\tdata undelegation failed, pa=0x%x, ret=0x%x\n", curr_gran->PA, ret);
-                return VAL_ERROR;
-            }
-            curr_gran = next_gran;
-        } else {
-            curr_gran = next_gran;
+        ret = val_host_rmi_granule_undelegate(pa);
+        if (ret)
+        {
+            LOG(ERROR, "\tdata undelegation failed, pa=0x%x, ret=0x%x\n", pa, ret);
+            return VAL_ERROR;
         }
     }
 
     // Unmap unprotected granules
-    curr_gran = mem_track[current_realm].gran_type.valid_ns;
+    curr_gran = val_host_mem_track(current_realm)->gran_type.valid_ns;
     while (curr_gran != NULL)
     {
         next_gran = curr_gran->next;
@@ -1818,19 +2680,15 @@ uint32_t val_host_realm_destroy(uint64_t rd)
         curr_gran = next_gran;
     }
 
-    // Destroy leaf rtt hirerachy
-    if (val_host_destroy_rtt_levels(3, current_realm))
-        return VAL_ERROR;
-    if (val_host_destroy_rtt_levels(2, current_realm))
-        return VAL_ERROR;
+    // Destroy rtt hirerachy, leaf level first
     if (val_host_destroy_rtt_levels(1, current_realm))
         return VAL_ERROR;
 
     // RD destroy, undelegate and free
-    ret = val_host_rmi_realm_destroy(mem_track[current_realm].rd);
+    ret = val_host_rmi_realm_destroy(val_host_mem_track(current_realm)->rd);
     if (ret)
     {
-        LOG(ERROR, "\tRealm destroy failed, rd=0x%x, ret=0x%x\n", mem_track[current_realm].rd, ret);
+        LOG(ERROR, "\tRealm destroy failed, rd=0x%x, ret=0x%x\n", val_host_mem_track(current_realm)->rd, ret);
         return VAL_ERROR;
     }
 
@@ -1846,7 +2704,8 @@ void val_host_reset_mem_tack(void)
 
     uint32_t i = 0;
 
-    while (i < VAL_HOST_MAX_REALMS)
+    /* Slots beyond the first chunk live in the heap, which is reset as well */
+    while (i < VAL_HOST_REALM_CHUNK_SLOTS)
     {
         /* Reset mem_track.rd to default value */
         mem_track[i].rd = 0x00000000FFFFFFFF;
@@ -1858,7 +2717,28 @@ void val_host_reset_mem_tack(void)
         mem_track[i].gran_type.rec = NULL;
         mem_track[i].gran_type.data = NULL;
         mem_track[i].gran_type.valid_ns = NULL;
+        mem_track[i].rd_next = 0;
+        mem_track[i].ripas = NULL;
+        mem_track[i].ripas_count = 0;
+        mem_track[i].ripas_capacity = 0;
+        val_init_spinlock(&mem_track[i].lock);
 
         i++;
     }
+
+    /* Reset NS list shards, PA index and locks */
+    val_memset(ns_shard, 0, sizeof(ns_shard));
+    val_memset(granule_index, 0, sizeof(granule_index));
+    val_memset(granule_index_lock, 0, sizeof(granule_index_lock));
+    val_memset(mem_track_chunk, 0, sizeof(mem_track_chunk));
+    mem_track_chunk[0] = mem_track;
+    mem_track_count = VAL_HOST_REALM_CHUNK_SLOTS;
+    val_memset(realm_rd_index, 0, sizeof(realm_rd_index));
+    val_init_spinlock(&realm_slot_lock);
+
+    /* The REC tables live in the heap as well */
+    rec_tables = NULL;
+    rec_tables_count = 0;
+    rec_tables_capacity = 0;
+    val_init_spinlock(&rec_tables_lock);
 }
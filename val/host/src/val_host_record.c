@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Result record of each test, one line of key=value fields after the result
+ * of the test:
+ *   ACS_RECORD: num=<n> id=<id> test=<name> status=0x<status> us=<us>
+ *               ticks=<ticks> rmi=<calls> heap=<bytes> [profile fields]
+ * rmi counts the RMI calls of every PE for a test that runs alone and of the
+ * calling PE for a test of a parallel batch. heap is the peak heap use of the
+ * test, or of the batch so far. The setup_us, body_us, postamble_us, and with
+ * a PMU the cycles and inst fields are added by -DTEST_PROFILE=ON builds.
+ * A test that reset the platform only gets num, id, test and status.
+ */
+
+#include "val_host_record.h"
+#include "val_host_alloc.h"
+#include "val_host_profile.h"
+#include "test_database.h"
+#include "val_framework.h"
+#include "val_mp_supp.h"
+#include "val_smc.h"
+#include "val_libc.h"
+
+extern const test_db_t test_list[];
+
+/* Counters when the test of a PE started */
+typedef struct {
+    bool started;
+    bool all_pes;
+    uint64_t ticks;
+    uint64_t rmi_calls;
+} val_host_record_cpu_ts;
+
+static val_host_record_cpu_ts record_cpu[PLATFORM_CPU_COUNT];
+
+static val_host_record_cpu_ts *val_host_record_self(void)
+{
+    uint32_t cpu = val_get_cpuid(val_read_mpidr());
+
+    return (cpu < PLATFORM_CPU_COUNT) ? &record_cpu[cpu] : NULL;
+}
+
+static uint64_t val_host_record_us(uint64_t ticks, uint64_t freq)
+{
+    return freq ? (ticks * 1000000) / freq : 0;
+}
+
+/**
+ *   @brief    Take the counters at the start of a test of the calling PE
+ *   @param    all_pes      - Count the RMI calls of every PE
+ *   @return   void
+**/
+void val_host_record_start(bool all_pes)
+{
+    val_host_record_cpu_ts *state = val_host_record_self();
+
+    if (state == NULL)
+        return;
+
+    state->all_pes = all_pes;
+    state->rmi_calls = val_smc_rmi_calls(all_pes);
+    state->ticks = syscounter_read();
+    state->started = true;
+}
+
+#ifdef VAL_TEST_PROFILE
+static void val_host_record_print_profile(uint32_t test_num, uint64_t freq)
+{
+    const val_host_profile_ts *profile = val_host_profile_get(test_num);
+    const val_host_profile_count_ts *count;
+    uint64_t cycles = 0, instructions = 0;
+    uint32_t i;
+
+    if (profile == NULL)
+        return;
+
+    count = profile->phase;
+    LOG(ALWAYS, " setup_us=%d body_us=%d",
+        val_host_record_us(count[VAL_HOST_PROFILE_SETUP].ticks, freq),
+        val_host_record_us(count[VAL_HOST_PROFILE_BODY].ticks, freq));
+    LOG(ALWAYS, " postamble_us=%d",
+        val_host_record_us(count[VAL_HOST_PROFILE_POSTAMBLE].ticks, freq), 0);
+
+    if (!profile->pmu)
+        return;
+
+    for (i = 0; i < VAL_HOST_PROFILE_PHASES; i++)
+    {
+        cycles += count[i].cycles;
+        instructions += count[i].instructions;
+    }
+    LOG(ALWAYS, " cycles=%d inst=%d", cycles, instructions);
+}
+#endif
+
+/**
+ *   @brief    Print the result record of the test of the calling PE, after
+ *             its result is known
+ *   @param    test_num     - Test number
+ *   @return   void
+**/
+void val_host_record_print(uint32_t test_num)
+{
+    val_host_record_cpu_ts *state = val_host_record_self();
+    uint64_t freq = read_cntfrq_el0();
+    uint64_t ticks;
+
+    LOG(ALWAYS, VAL_HOST_RECORD_MARKER " num=%d id=%d", test_num, test_list[test_num].id);
+    LOG(ALWAYS, " test=", 0, 0);
+    LOG(ALWAYS, test_list[test_num].test_name, 0, 0);
+    LOG(ALWAYS, " status=0x%x", val_get_status(), 0);
+
+    if (state != NULL && state->started)
+    {
+        ticks = syscounter_read() - state->ticks;
+        LOG(ALWAYS, " us=%d ticks=%d", val_host_record_us(ticks, freq), ticks);
+        LOG(ALWAYS, " rmi=%d heap=%d",
+            val_smc_rmi_calls(state->all_pes) - state->rmi_calls, val_host_mem_peak());
+#ifdef VAL_TEST_PROFILE
+        val_host_record_print_profile(test_num, freq);
+#endif
+        state->started = false;
+    }
+
+    LOG(ALWAYS, "\n", 0, 0);
+}
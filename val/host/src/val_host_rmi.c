@@ -8,6 +8,7 @@
 #include "val_host_rmi.h"
 #include "val_libc.h"
 #include "val_host_realm.h"
+#include "val_host_shadow.h"
 
 /**
  *   @brief    Returns RMI version
@@ -80,6 +81,7 @@ uint64_t val_host_rmi_data_create(uint64_t rd, uint64_t data,
         return ret;
     }
     val_host_update_granule_state(rd, GRANULE_DATA, data, ipa, 0);
+    val_host_shadow_set_ripas(rd, ipa, ipa + PAGE_SIZE, RMI_RAM);
     return ret;
 
 }
@@ -225,6 +227,7 @@ uint64_t val_host_rmi_data_destroy(uint64_t rd, uint64_t ipa,
         return args.x0;
     }
     val_host_update_destroy_granule_state(rd, 0, ipa, 0, GRANULE_DELEGATED, GRANULE_DATA);
+    val_host_shadow_data_destroy(rd, ipa);
     return args.x0;
 }
 
@@ -282,9 +285,14 @@ uint64_t val_host_rmi_rec_enter(uint64_t rec, uint64_t run_ptr)
 rec_enter:
     ret = (val_smc_call(RMI_REC_ENTER, rec, run_ptr, 0, 0, 0, 0, 0, 0, 0, 0)).x0;
 
-    /* In case of realm exit due to hvc print functionality,
-     * re-enter rec after printing the realm message onto
-     * console.
+    /* Print what the realm logged before the caller handles the exit */
+    val_host_realm_printf_msg_service();
+
+    if (!ret && run->exit.exit_reason == RMI_EXIT_RIPAS_CHANGE)
+        val_host_shadow_request_ripas(rec, run->exit.ripas_value);
+
+    /* In case of realm exit due to a full log ring, re-enter rec
+     * once the realm messages are printed onto console.
      */
     if (!ret &&
         (run->exit.exit_reason == RMI_EXIT_HOST_CALL) &&
@@ -293,7 +301,6 @@ rec_enter:
         rec_enter_flags.emul_mmio = 0;
         rec_enter_flags.inject_sea = 0;
         val_memcpy(&run->enter.flags, &rec_enter_flags, sizeof(rec_enter_flags));
-        val_host_realm_printf_msg_service();
         goto rec_enter;
     }
 
@@ -370,6 +377,10 @@ uint64_t val_host_rmi_rtt_destroy(uint64_t rd,
     }
 
     val_host_update_destroy_granule_state(rd, 0, ipa, level, GRANULE_DELEGATED, GRANULE_RTT);
+    /* The parent entry of a protected IPA becomes DESTROYED, the shadow reports
+       unprotected IPAs as EMPTY whatever is recorded */
+    val_host_shadow_set_ripas(rd, ipa, ipa + (1UL << VAL_RTT_LEVEL_SHIFT(level - 1)),
+                              RMI_DESTROYED);
     return args.x0;
 }
 
@@ -392,6 +403,7 @@ uint64_t val_host_rmi_rtt_map_unprotected(uint64_t rd, uint64_t ipa,
         return ret;
     }
     val_host_update_granule_state(rd, GRANULE_UNPROTECTED, ipa, ipa, level);
+    val_host_shadow_map_unprotected(rd, ipa, level, desc);
     return ret;
 }
 
@@ -459,6 +471,8 @@ uint64_t val_host_rmi_rtt_init_ripas(uint64_t rd, uint64_t base,
     args = val_smc_call(RMI_RTT_INIT_RIPAS, rd, base, top, 0, 0, 0, 0, 0, 0, 0);
 
     *out_top = args.x1;
+    if (!args.x0)
+        val_host_shadow_set_ripas(rd, base, args.x1, RMI_RAM);
     return args.x0;
 }
 
@@ -479,5 +493,7 @@ uint64_t val_host_rmi_rtt_set_ripas(uint64_t rd, uint64_t rec,
     args = val_smc_call(RMI_RTT_SET_RIPAS, rd, rec, base, top, 0, 0, 0, 0, 0, 0);
 
     *out_top = args.x1;
+    if (!args.x0)
+        val_host_shadow_complete_ripas(rd, rec, base, args.x1);
     return args.x0;
 }
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* The shadow stage 2 view of a realm is derived from its mem_track RTT, data
+ * and unprotected granules, which are updated by every successful RTT_CREATE,
+ * RTT_DESTROY, RTT_FOLD, DATA_CREATE and RTT_MAP_UNPROTECTED, and from the
+ * RIPAS ranges of its mem_track slot, which are updated by RTT_INIT_RIPAS,
+ * RTT_SET_RIPAS, DATA_CREATE, DATA_DESTROY and RTT_DESTROY. */
+
+#include "val_host_shadow.h"
+
+/**
+ *   @brief    Return the RIPAS of a protected IPA, from the latest range holding it.
+ *             Called with the slot lock held.
+ *   @param    slot       - mem_track slot of the realm
+ *   @param    ipa        - IPA
+ *   @return   Returns the RIPAS, RMI_EMPTY if it was never changed
+**/
+static uint64_t val_host_shadow_ripas_lookup(val_host_memory_track_ts *slot, uint64_t ipa)
+{
+    uint32_t i = slot->ripas_count;
+
+    while (i-- > 0)
+    {
+        if (ipa >= slot->ripas[i].base && ipa < slot->ripas[i].top)
+            return slot->ripas[i].ripas;
+    }
+
+    return RMI_EMPTY;
+}
+
+/**
+ *   @brief    Record the RIPAS given to an IPA range. A range continuing the
+ *             latest one with the same RIPAS extends it.
+ *   @param    rd         - Realm RD granule address
+ *   @param    base       - Base of IPA range
+ *   @param    top        - Top of IPA range
+ *   @param    ripas      - RIPAS of the range
+ *   @return   void
+**/
+void val_host_shadow_set_ripas(uint64_t rd, uint64_t base, uint64_t top, uint64_t ripas)
+{
+    int realm_index = val_host_get_curr_realm(rd);
+    val_host_memory_track_ts *slot;
+    val_host_ripas_range_ts *last, *table;
+    uint32_t capacity;
+
+    if (realm_index == 0 || top <= base)
+        return;
+
+    slot = val_host_mem_track(realm_index);
+    val_spin_lock(&slot->lock);
+
+    /* A single granule that keeps its RIPAS, as for DATA_CREATE after RTT_INIT_RIPAS */
+    if ((top - base) == PAGE_SIZE && val_host_shadow_ripas_lookup(slot, base) == ripas)
+        goto unlock;
+
+    last = slot->ripas_count ? &slot->ripas[slot->ripas_count - 1] : NULL;
+    if (last != NULL && last->ripas == ripas && base >= last->base && base <= last->top)
+    {
+        if (top > last->top)
+            last->top = top;
+        goto unlock;
+    }
+
+    if (slot->ripas_count == slot->ripas_capacity)
+    {
+        capacity = slot->ripas_capacity ? (2 * slot->ripas_capacity) : 8;
+        table = mem_alloc(sizeof(uint64_t), capacity * sizeof(val_host_ripas_range_ts));
+        if (table == NULL)
+        {
+            LOG(ERROR, "\tFailed to grow the shadow RIPAS table\n", 0, 0);
+            goto unlock;
+        }
+
+        if (slot->ripas != NULL)
+        {
+            val_memcpy(table, slot->ripas, slot->ripas_count * sizeof(val_host_ripas_range_ts));
+            val_host_mem_free(slot->ripas);
+        }
+        slot->ripas = table;
+        slot->ripas_capacity = capacity;
+    }
+
+    slot->ripas[slot->ripas_count].base = base;
+    slot->ripas[slot->ripas_count].top = top;
+    slot->ripas[slot->ripas_count].ripas = ripas;
+    slot->ripas_count++;
+
+unlock:
+    val_spin_unlock(&slot->lock);
+}
+
+/**
+ *   @brief    Update the RIPAS of a data granule destroyed by DATA_DESTROY,
+ *             RAM becomes DESTROYED and other values are kept
+ *   @param    rd         - Realm RD granule address
+ *   @param    ipa        - IPA of the data granule
+ *   @return   void
+**/
+void val_host_shadow_data_destroy(uint64_t rd, uint64_t ipa)
+{
+    int realm_index = val_host_get_curr_realm(rd);
+    uint64_t ripas;
+
+    if (realm_index == 0)
+        return;
+
+    val_spin_lock(&val_host_mem_track(realm_index)->lock);
+    ripas = val_host_shadow_ripas_lookup(val_host_mem_track(realm_index), ipa);
+    val_spin_unlock(&val_host_mem_track(realm_index)->lock);
+
+    if (ripas == RMI_RAM)
+        val_host_shadow_set_ripas(rd, ipa, ipa + PAGE_SIZE, RMI_DESTROYED);
+}
+
+/**
+ *   @brief    Record the RIPAS requested by the RIPAS change exit of a REC, it
+ *             is applied by RTT_SET_RIPAS
+ *   @param    rec        - PA of the REC
+ *   @param    ripas      - Requested RIPAS
+ *   @return   void
+**/
+void val_host_shadow_request_ripas(uint64_t rec, uint64_t ripas)
+{
+    val_host_granule_ts *node = val_host_find_rec_granule(rec);
+
+    if (node != NULL)
+        node->ripas = (uint8_t)ripas;
+}
+
+/**
+ *   @brief    Apply the RIPAS requested by a REC to the range changed by RTT_SET_RIPAS
+ *   @param    rd         - Realm RD granule address
+ *   @param    rec        - PA of the REC
+ *   @param    base       - Base of IPA range
+ *   @param    top        - Top of the IPA range which was changed
+ *   @return   void
+**/
+void val_host_shadow_complete_ripas(uint64_t rd, uint64_t rec, uint64_t base, uint64_t top)
+{
+    val_host_granule_ts *node = val_host_find_rec_granule(rec);
+
+    if (node != NULL)
+        val_host_shadow_set_ripas(rd, base, top, node->ripas);
+}
+
+/**
+ *   @brief    Record the descriptor of an unprotected mapping
+ *   @param    rd         - Realm RD granule address
+ *   @param    ipa        - IPA of the mapping
+ *   @param    level      - RTT level of the mapping
+ *   @param    desc       - RTTE descriptor
+ *   @return   void
+**/
+void val_host_shadow_map_unprotected(uint64_t rd, uint64_t ipa, uint64_t level, uint64_t desc)
+{
+    int realm_index = val_host_get_curr_realm(rd);
+    val_host_granule_ts *node;
+
+    if (realm_index == 0)
+        return;
+
+    node = val_host_find_unprotected_granule(realm_index, ipa, level);
+    if (node != NULL)
+        node->desc = desc;
+}
+
+/**
+ *   @brief    Return the RTT entry for the given IPA as tracked by the host,
+ *             following RMI_RTT_READ_ENTRY semantics for walk level, state,
+ *             descriptor and RIPAS. Unprotected and table entries report RMI_EMPTY.
+ *   @param    realm      - Realm strucrure
+ *   @param    ipa        - IPA of the entry
+ *   @param    level      - RTT level to walk to
+ *   @param    rtte       - Returned RTT entry
+ *   @return   SUCCESS, or FAILURE if the realm is not tracked
+**/
+uint32_t val_host_shadow_read_entry(val_host_realm_ts *realm, uint64_t ipa,
+                                    uint64_t level, val_host_rtt_entry_ts *rtte)
+{
+    int realm_index = val_host_get_curr_realm(realm->rd);
+    uint64_t walk_level = realm->s2_starting_level, base, size, map_level;
+    bool is_protected = ipa < (1UL << ((realm->s2sz & 0xff) - 1));
+    val_host_granule_ts *node;
+
+    if (realm_index == 0 || level > VAL_RTT_MAX_LEVEL || level < walk_level)
+        return VAL_ERROR;
+
+    while (walk_level < level &&
+           val_host_find_rtt_granule(realm_index, ipa, walk_level + 1) != NULL)
+        walk_level++;
+
+    size = 1UL << VAL_RTT_LEVEL_SHIFT(walk_level);
+    base = ADDR_ALIGN_DOWN(ipa, size);
+
+    rtte->walk_level = walk_level;
+    rtte->state = RMI_UNASSIGNED;
+    rtte->desc = 0;
+    rtte->ripas = RMI_EMPTY;
+
+    if (walk_level < VAL_RTT_MAX_LEVEL)
+    {
+        node = val_host_find_rtt_granule(realm_index, ipa, walk_level + 1);
+        if (node != NULL)
+        {
+            rtte->state = RMI_TABLE;
+            rtte->desc = node->PA;
+            return VAL_SUCCESS;
+        }
+    }
+
+    if (is_protected)
+    {
+        val_spin_lock(&val_host_mem_track(realm_index)->lock);
+        rtte->ripas = val_host_shadow_ripas_lookup(val_host_mem_track(realm_index), base);
+        val_spin_unlock(&val_host_mem_track(realm_index)->lock);
+
+        /* A block entry holds data granules which were folded into it */
+        node = val_host_find_data_granule(realm_index, base, base + size);
+        if (node != NULL)
+        {
+            rtte->state = RMI_ASSIGNED;
+            rtte->desc = node->PA - (node->ipa - base);
+        }
+        return VAL_SUCCESS;
+    }
+
+    /* A block entry folded from unprotected pages keeps the first page's descriptor */
+    for (map_level = walk_level; map_level <= VAL_RTT_MAX_LEVEL; map_level++)
+    {
+        node = val_host_find_unprotected_granule(realm_index, base, map_level);
+        if (node != NULL)
+        {
+            rtte->state = RMI_ASSIGNED;
+            rtte->desc = node->desc;
+            break;
+        }
+    }
+
+    return VAL_SUCCESS;
+}
+
+/**
+ *   @brief    Compare the RTT entry of an IPA read back from RMM with the shadow
+ *   @param    realm      - Realm strucrure
+ *   @param    ipa        - IPA of the entry
+ *   @param    level      - RTT level to walk to
+ *   @return   SUCCESS, or FAILURE if they differ or the entry cannot be read
+**/
+uint32_t val_host_shadow_check_entry(val_host_realm_ts *realm, uint64_t ipa, uint64_t level)
+{
+    val_host_rtt_entry_ts rtte, shadow;
+    uint64_t ret;
+
+    ret = val_host_rmi_rtt_read_entry(realm->rd, ipa, level, &rtte);
+    if (ret || val_host_shadow_read_entry(realm, ipa, level, &shadow))
+    {
+        LOG(ERROR, "\tRTT entry read failed, ipa=0x%x, ret=0x%x\n", ipa, ret);
+        return VAL_ERROR;
+    }
+
+    if (rtte.walk_level != shadow.walk_level || rtte.state != shadow.state ||
+        rtte.desc != shadow.desc || rtte.ripas != shadow.ripas)
+    {
+        LOG(ERROR, "\tShadow RTT entry differs, ipa=0x%x, level=%d\n", ipa, level);
+        LOG(ERROR, "\tRMM state=%d ripas=%d\n", rtte.state, rtte.ripas);
+        LOG(ERROR, "\tShadow state=%d ripas=%d\n", shadow.state, shadow.ripas);
+        LOG(ERROR, "\tRMM desc=0x%x, shadow desc=0x%x\n", rtte.desc, shadow.desc);
+        return VAL_ERROR;
+    }
+
+    return VAL_SUCCESS;
+}
+
+/**
+ *   @brief    Create the RTTs missing below an unassigned entry before a range
+ *             is mapped, instead of waiting for RMI_ERROR_RTT and reading back
+ *             the entry. Nothing is created when [base, top) covers the whole
+ *             entry, or when the entry is not unassigned in the shadow.
+ *   @param    realm          - Realm strucrure
+ *   @param    base           - Base of target IPA region
+ *   @param    top            - Top of target IPA region
+ *   @param    level          - RTT level the range is mapped at
+ *   @param    rtt_alignment  - RTT Address Alignment
+ *   @return   SUCCESS/FAILURE
+**/
+uint32_t val_host_shadow_create_rtt_levels(val_host_realm_ts *realm, uint64_t base,
+                                    uint64_t top, uint64_t level, uint64_t rtt_alignment)
+{
+    val_host_rtt_entry_ts rtte;
+    uint64_t size;
+
+    if (val_host_shadow_read_entry(realm, base, level, &rtte) ||
+        rtte.walk_level == level || rtte.state != RMI_UNASSIGNED)
+        return VAL_SUCCESS;
+
+    size = 1UL << VAL_RTT_LEVEL_SHIFT(rtte.walk_level);
+    if (ADDR_IS_ALIGNED(base, size) && (top - base) >= size)
+        return VAL_SUCCESS;
+
+    return val_host_create_rtt_levels(realm, base, rtte.walk_level, level, rtt_alignment);
+}
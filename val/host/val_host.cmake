@@ -17,6 +17,11 @@ file(GLOB VAL_SRC
 )
 
 #Create compile list files
+if(${TARGET} STREQUAL "tgt_linux_native")
+    # Assembly sources are replaced by the native PAL
+    list(FILTER VAL_SRC EXCLUDE REGEX "\\.S$")
+endif()
+
 list(APPEND COMPILE_LIST ${VAL_SRC})
 set(COMPILE_LIST ${COMPILE_LIST} PARENT_SCOPE)
 
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2023, Arm Limited or its affiliates. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* C replacement of val_realm_boot_entry.S for native builds */
+#ifdef LINUX_NATIVE_BUILD
+
+#include "val_realm_framework.h"
+#include "val_mp_supp.h"
+
+extern uint64_t val_primary_mpidr;
+
+/* The image is linked at its run-time address */
+uint64_t val_image_load_offset;
+
+/**
+ *   @brief    Realm entry point for every REC. The RMM model runs each REC
+ *             on a thread with its own stack and gives every realm its own
+ *             copy of the image data, so only the primary cpu detection is
+ *             left.
+ *   @param    void
+ *   @return   void
+**/
+void acs_realm_entry(void)
+{
+    bool primary_cpu_boot = false;
+
+    write_sctlr_el1(read_sctlr_el1() | SCTLR_I_BIT);
+
+    if (val_primary_mpidr == INVALID_MPIDR)
+    {
+        val_primary_mpidr = val_read_mpidr();
+        primary_cpu_boot = true;
+    }
+
+    val_realm_main(primary_cpu_boot);
+}
+
+#endif /* LINUX_NATIVE_BUILD */
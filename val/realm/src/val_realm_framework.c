@@ -12,6 +12,7 @@
 #include "val_realm_rsi.h"
 #include "val.h"
 #include "val_realm_memory.h"
+#include "val_realm_log.h"
 
 extern uint64_t realm_ipa_width;
 extern uint64_t val_image_load_offset;
@@ -36,22 +37,8 @@ uint64_t val_realm_get_secondary_cpu_entry(void)
 **/
 uint32_t val_realm_printf(const char *msg, uint64_t data1, uint64_t data2)
 {
-    size_t length = 0;
-
-    while (msg[length] != '\0')
-    {
-      ++length;
-    }
-
-    /* Write realm message to shared printf location */
-    val_memcpy((char *)(val_get_shared_region_base() + REALM_PRINTF_MSG_OFFSET),
-                (char *)msg,
-                length+1);
-    *(uint64_t *)(val_get_shared_region_base() + REALM_PRINTF_DATA1_OFFSET) = (uint64_t)data1;
-    *(uint64_t *)(val_get_shared_region_base() + REALM_PRINTF_DATA2_OFFSET) = (uint64_t)data2;
-
-    /* Print from realm through RSI_HOST_CALL */
-    val_realm_rsi_host_call((uint16_t)VAL_REALM_PRINT_MSG);
+    /* Queued for the host, which prints it on the next REC exit */
+    val_realm_log_write(msg, data1, data2);
     return VAL_SUCCESS;
 }
 
@@ -75,7 +62,7 @@ static void val_realm_test_dispatch(void)
 {
     test_fptr_t       fn_ptr;
 
-    fn_ptr = (test_fptr_t)(test_list[val_get_curr_test_num()].realm_fn);
+    fn_ptr = (test_fptr_t)(test_list[val_test_index_by_id(val_get_curr_test_id())].realm_fn);
     if (fn_ptr == NULL)
     {
         LOG(ERROR, "Invalid realm test address\n", 0, 0);
@@ -118,6 +105,9 @@ void val_realm_main(bool primary_cpu_boot)
     /* Enable Stage-1 MMU */
     val_enable_mmu(realm_xlat_ctx);
 
+    if (primary_cpu_boot == true)
+        val_test_registry_init();
+
     val_irq_setup();
     /* Ready to run test regression */
     val_realm_test_dispatch();
@@ -10,7 +10,6 @@
 #include "val_irq.h"
 #include "pal_interfaces.h"
 
-extern const uint32_t  total_tests;
 extern const test_db_t test_list[];
 
 /**
@@ -43,27 +42,6 @@ uint32_t val_secure_return_to_preempted_host(void)
     return VAL_SUCCESS;
 }
 
-/**
- *   @brief    Finds current test index
- *   @param    void
- *   @return   0
-**/
-static uint32_t val_secure_find_current_test_index(void)
-{
-    uint32_t          index;
-
-    for (index = 1; index < total_tests ; index++)
-    {
-        /* Is this the current test */
-        if (!val_is_current_test((void *)test_list[index].test_name))
-            return index;
-        else
-            continue;
-    }
-    VAL_PANIC("No valid secure test found, something went wrong\n");
-    return 0;
-}
-
 /**
  *   @brief    Query test database and execute test from each suite one by one
  *   @param    void
@@ -87,7 +65,7 @@ static void val_secure_test_dispatch(void)
 
     while (1)
     {
-        fn_ptr = (test_fptr_t)(test_list[val_secure_find_current_test_index()].secure_fn);
+        fn_ptr = (test_fptr_t)(test_list[val_test_index_by_id(val_get_curr_test_id())].secure_fn);
         if (fn_ptr == NULL)
         {
             VAL_PANIC("Invalid secure test address\n");
@@ -131,6 +109,9 @@ void val_secure_main(bool primary_cpu_boot)
     /* Enable Stage-1 MMU */
     val_enable_mmu(secure_xlat_ctx);
 
+    if (primary_cpu_boot == true)
+        val_test_registry_init();
+
     /* Ready to run test regression */
     val_secure_test_dispatch();
 